@@ -0,0 +1,383 @@
+#include "ArenaAllocator.h"
+#include <algorithm>
+#include <iostream>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    //index of the highest / lowest set bit, v must not be 0
+    inline int highestBit(uint32_t v) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse(&index, v);
+        return static_cast<int>(index);
+#else
+        return 31 - __builtin_clz(v);
+#endif
+    }
+
+    inline int lowestBit(uint32_t v) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, v);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(v);
+#endif
+    }
+}
+
+ArenaAllocator::ArenaAllocator(uint32_t capacity) : capacity(0) {
+    for (int fl = 0; fl < FL_COUNT; fl++) {
+        for (int sl = 0; sl < SL_COUNT; sl++) {
+            freeHeads[fl][sl] = -1;
+        }
+    }
+    allocations.push_back(-1);//handle 0 is invalidHandle
+    grow(capacity);
+}
+
+void ArenaAllocator::mapping(uint32_t size, int& fl, int& sl) {
+    if (size < SL_COUNT) {
+        fl = 0;//small sizes get one class each
+        sl = static_cast<int>(size);
+    }
+    else {
+        fl = highestBit(size);
+        sl = static_cast<int>((size >> (fl - SL_BITS)) & (SL_COUNT - 1));
+    }
+}
+
+void ArenaAllocator::mappingSearch(uint32_t size, int& fl, int& sl) {
+    uint64_t rounded = size;
+    if (size >= SL_COUNT) {
+        rounded += (1ull << (highestBit(size) - SL_BITS)) - 1;
+    }
+    mapping(static_cast<uint32_t>(std::min<uint64_t>(rounded, 0xFFFFFFFFull)), fl, sl);
+}
+
+int ArenaAllocator::newBlock() {
+    if (!unusedBlocks.empty()) {
+        int index = unusedBlocks.back();
+        unusedBlocks.pop_back();
+        return index;
+    }
+    blocks.push_back(Block());
+    return static_cast<int>(blocks.size() - 1);
+}
+
+void ArenaAllocator::recycleBlock(int index) {
+    unusedBlocks.push_back(index);
+}
+
+void ArenaAllocator::insertFree(int index) {
+    Block& block = blocks[index];
+    int fl, sl;
+    mapping(block.size, fl, sl);
+
+    block.isFree = true;
+    block.prevFree = -1;
+    block.nextFree = freeHeads[fl][sl];
+    if (block.nextFree != -1) blocks[block.nextFree].prevFree = index;
+    freeHeads[fl][sl] = index;
+
+    flBitmap |= 1u << fl;
+    slBitmap[fl] |= 1u << sl;
+    freeBlocks++;
+}
+
+void ArenaAllocator::removeFree(int index) {
+    Block& block = blocks[index];
+    int fl, sl;
+    mapping(block.size, fl, sl);
+
+    if (block.prevFree != -1) blocks[block.prevFree].nextFree = block.nextFree;
+    else freeHeads[fl][sl] = block.nextFree;
+    if (block.nextFree != -1) blocks[block.nextFree].prevFree = block.prevFree;
+
+    if (freeHeads[fl][sl] == -1) {
+        slBitmap[fl] &= ~(1u << sl);
+        if (slBitmap[fl] == 0) flBitmap &= ~(1u << fl);
+    }
+    block.isFree = false;
+    freeBlocks--;
+}
+
+int ArenaAllocator::findFree(uint32_t size) const {
+    int fl, sl;
+    mappingSearch(size, fl, sl);
+
+    //same first level, this second level class or bigger
+    uint32_t slMap = slBitmap[fl] & (~0u << sl);
+    if (slMap == 0) {
+        //otherwise the smallest non empty class in a bigger first level
+        uint32_t flMap = fl + 1 < FL_COUNT ? flBitmap & (~0u << (fl + 1)) : 0;
+        if (flMap == 0) return -1;
+        fl = lowestBit(flMap);
+        slMap = slBitmap[fl];
+    }
+    sl = lowestBit(slMap);
+    return freeHeads[fl][sl];
+}
+
+//only the free lists of classes that can hold size are walked, the size's own class may have blocks that are too small
+int ArenaAllocator::lowestFit(uint32_t size, uint32_t below) const {
+    int fl, sl;
+    mapping(size, fl, sl);
+    int lowest = -1;
+    for (uint32_t flMap = flBitmap & (~0u << fl); flMap != 0; flMap &= flMap - 1) {
+        int f = lowestBit(flMap);
+        for (uint32_t slMap = f == fl ? slBitmap[f] & (~0u << sl) : slBitmap[f]; slMap != 0; slMap &= slMap - 1) {
+            for (int index = freeHeads[f][lowestBit(slMap)]; index != -1; index = blocks[index].nextFree) {
+                const Block& block = blocks[index];
+                if (block.size >= size && block.offset < below && (lowest == -1 || block.offset < blocks[lowest].offset)) lowest = index;
+            }
+        }
+    }
+    return lowest;
+}
+
+void ArenaAllocator::split(int index, uint32_t size) {
+    if (blocks[index].size == size) return;
+
+    int rest = newBlock();
+    Block& block = blocks[index];//newBlock may have reallocated
+    Block& remainder = blocks[rest];
+    remainder.offset = block.offset + size;
+    remainder.size = block.size - size;
+    remainder.prevPhys = index;
+    remainder.nextPhys = block.nextPhys;
+    remainder.handle = invalidHandle;
+    if (block.nextPhys != -1) blocks[block.nextPhys].prevPhys = rest;
+    else lastPhys = rest;
+    block.nextPhys = rest;
+    block.size = size;
+
+    insertFree(rest);
+}
+
+unsigned int ArenaAllocator::allocate(uint32_t size) {
+    if (size == 0) return invalidHandle;
+
+    int index = findFree(size);
+    if (index == -1) return invalidHandle;
+
+    removeFree(index);
+    split(index, size);
+
+    unsigned int handle;
+    if (!unusedHandles.empty()) {
+        handle = unusedHandles.back();
+        unusedHandles.pop_back();
+    }
+    else {
+        handle = static_cast<unsigned int>(allocations.size());
+        allocations.push_back(-1);
+    }
+    allocations[handle] = index;
+    blocks[index].handle = handle;
+
+    used += size;
+    live++;
+    layoutChanged();
+    return handle;
+}
+
+int ArenaAllocator::release(int index) {
+    Block* block = &blocks[index];
+    block->handle = invalidHandle;
+
+    //merge with the next block
+    int next = block->nextPhys;
+    if (next != -1 && blocks[next].isFree) {
+        removeFree(next);
+        block->size += blocks[next].size;
+        block->nextPhys = blocks[next].nextPhys;
+        if (block->nextPhys != -1) blocks[block->nextPhys].prevPhys = index;
+        else lastPhys = index;
+        recycleBlock(next);
+    }
+
+    //and the previous one, which then takes over this block
+    int prev = block->prevPhys;
+    if (prev != -1 && blocks[prev].isFree) {
+        removeFree(prev);
+        blocks[prev].size += block->size;
+        blocks[prev].nextPhys = block->nextPhys;
+        if (block->nextPhys != -1) blocks[block->nextPhys].prevPhys = prev;
+        else lastPhys = prev;
+        recycleBlock(index);
+        index = prev;
+    }
+
+    insertFree(index);
+    return index;
+}
+
+void ArenaAllocator::free(unsigned int handle) {
+    if (handle == invalidHandle || handle >= allocations.size() || allocations[handle] == -1) {
+        std::cerr << "ArenaAllocator: free of invalid handle " << handle << std::endl;
+        return;
+    }
+    int index = allocations[handle];
+    used -= blocks[index].size;
+    live--;
+
+    allocations[handle] = -1;
+    unusedHandles.push_back(handle);
+    release(index);
+    layoutChanged();
+}
+
+void ArenaAllocator::grow(uint32_t newCapacity) {
+    if (newCapacity <= capacity) return;
+    uint32_t extra = newCapacity - capacity;
+
+    if (lastPhys != -1 && blocks[lastPhys].isFree) {
+        //free space at the end just gets longer
+        removeFree(lastPhys);
+        blocks[lastPhys].size += extra;
+        insertFree(lastPhys);
+    }
+    else {
+        int index = newBlock();
+        Block& block = blocks[index];
+        block.offset = capacity;
+        block.size = extra;
+        block.prevPhys = lastPhys;
+        block.nextPhys = -1;
+        block.handle = invalidHandle;
+        if (lastPhys != -1) blocks[lastPhys].nextPhys = index;
+        else firstPhys = index;
+        lastPhys = index;
+        insertFree(index);
+    }
+    capacity = newCapacity;
+    layoutChanged();
+}
+
+//the next call picks up from where this one stopped. Freeing a moved block can merge into the hole under it and
+//make room for a block the walk already passed, so a pass that moved anything is followed by another from the top,
+//and only a pass that moved nothing ends it. Returns 0 only then
+size_t ArenaAllocator::defragment(size_t maxMoves, std::vector<Move>& moves) {
+    if (defragDone) return 0;
+    size_t made = 0;
+
+    //walk used blocks from the top down, each one goes into the lowest hole below it that can take it
+    int current = defragNext != -1 ? defragNext : lastPhys;
+    while (true) {
+        if (current == -1) {
+            if (passMoves == 0) {
+                defragDone = true;
+                break;
+            }
+            passMoves = 0;
+            current = lastPhys;
+        }
+        if (made == maxMoves) break;
+        int below = blocks[current].prevPhys;
+        if (blocks[current].isFree) {
+            current = below;
+            continue;
+        }
+
+        uint32_t size = blocks[current].size;
+        uint32_t top = blocks[current].offset;
+        int hole = lowestFit(size, top);
+        if (hole == -1) {
+            current = below;//nothing lower fits, leave it where it is
+            continue;
+        }
+
+        //take the start of the hole, the old block is freed and merged
+        unsigned int handle = blocks[current].handle;
+        removeFree(hole);
+        split(hole, size);
+        blocks[hole].handle = handle;
+        allocations[handle] = hole;
+        moves.push_back({ handle, top, blocks[hole].offset, size });
+        made++;
+        passMoves++;
+
+        //merging can swallow the block below, so continue from whatever is now below the freed space
+        int merged = release(current);
+        current = blocks[merged].prevPhys;
+    }
+    defragNext = current;
+    return made;
+}
+
+uint32_t ArenaAllocator::largestFreeBlock() const {
+    if (flBitmap == 0) return 0;
+    int fl = highestBit(flBitmap);
+    int sl = highestBit(slBitmap[fl]);
+
+    //the top class isnt sorted so check every block in it
+    uint32_t largest = 0;
+    for (int index = freeHeads[fl][sl]; index != -1; index = blocks[index].nextFree) {
+        largest = std::max(largest, blocks[index].size);
+    }
+    return largest;
+}
+
+float ArenaAllocator::fragmentation() const {
+    uint32_t freeTotal = freeSize();
+    if (freeTotal == 0) return 0.0f;
+    return 1.0f - static_cast<float>(largestFreeBlock()) / static_cast<float>(freeTotal);
+}
+
+bool ArenaAllocator::validate() const {
+    uint32_t expectedOffset = 0, usedTotal = 0, largestHole = 0;
+    size_t freeCount = 0, liveCount = 0;
+    int prev = -1;
+    bool prevFree = false;
+
+    for (int index = firstPhys; index != -1; index = blocks[index].nextPhys) {
+        const Block& block = blocks[index];
+        if (block.offset != expectedOffset || block.prevPhys != prev || block.size == 0) {
+            std::cerr << "ArenaAllocator: broken physical list at offset " << block.offset << std::endl;
+            return false;
+        }
+        if (block.isFree) {
+            if (prevFree) {
+                std::cerr << "ArenaAllocator: unmerged free blocks at offset " << block.offset << std::endl;
+                return false;
+            }
+            int fl, sl;
+            mapping(block.size, fl, sl);
+            bool listed = false;
+            for (int f = freeHeads[fl][sl]; f != -1; f = blocks[f].nextFree) {
+                if (f == index) listed = true;
+            }
+            if (!listed || !(slBitmap[fl] & (1u << sl))) {
+                std::cerr << "ArenaAllocator: free block at offset " << block.offset << " missing from its size class" << std::endl;
+                return false;
+            }
+            largestHole = std::max(largestHole, block.size);
+            freeCount++;
+        }
+        else {
+            if (block.handle == invalidHandle || allocations[block.handle] != index) {
+                std::cerr << "ArenaAllocator: used block at offset " << block.offset << " has a bad handle" << std::endl;
+                return false;
+            }
+            if (defragDone && block.size <= largestHole) {
+                std::cerr << "ArenaAllocator: compacted but the block at offset " << block.offset << " fits a hole below it" << std::endl;
+                return false;
+            }
+            usedTotal += block.size;
+            liveCount++;
+        }
+        expectedOffset += block.size;
+        prevFree = block.isFree;
+        prev = index;
+    }
+
+    if (expectedOffset != capacity || prev != lastPhys || usedTotal != used || freeCount != freeBlocks || liveCount != live) {
+        std::cerr << "ArenaAllocator: totals dont match (capacity " << expectedOffset << "/" << capacity
+            << ", used " << usedTotal << "/" << used << ", free blocks " << freeCount << "/" << freeBlocks << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//cpu side bookkeeping for one big gpu buffer, hands out [offset, offset + size) ranges in elements (vertices, indices)
+//TLSF: free blocks are bucketed by size class with two bitmaps so allocate and free are O(1),
+//neighbouring free blocks are merged straight away. No gl in here, the owner copies data when blocks move.
+class ArenaAllocator
+{
+public:
+	static const unsigned int invalidHandle = 0;
+
+	//one block the owner has to copy from -> to after defragment, ranges never overlap
+	struct Move {
+		unsigned int handle;
+		uint32_t from, to, size;
+	};
+
+	ArenaAllocator(uint32_t capacity);
+
+	unsigned int allocate(uint32_t size);//invalidHandle if nothing fits, grow and retry
+	void free(unsigned int handle);
+	void grow(uint32_t newCapacity);//new space is added at the end, nothing moves
+
+	uint32_t offset(unsigned int handle) const { return blocks[allocations[handle]].offset; }
+	uint32_t size(unsigned int handle) const { return blocks[allocations[handle]].size; }
+
+	//moves up to maxMoves blocks from the top of the arena into the lowest holes they fit in,
+	//call a few moves a frame to compact over time, returns how many moves were appended, 0 once compacted. Each
+	//call carries on from where the last one stopped, and once a whole pass has moved nothing it does nothing
+	//until the next allocate, free or grow
+	size_t defragment(size_t maxMoves, std::vector<Move>& moves);
+	bool compacted() const { return defragDone; }//no block above a hole fits into it, defragment would move nothing
+
+	uint32_t getCapacity() const { return capacity; }
+	uint32_t usedSize() const { return used; }
+	uint32_t freeSize() const { return capacity - used; }
+	uint32_t largestFreeBlock() const;
+	size_t freeBlockCount() const { return freeBlocks; }
+	size_t liveAllocations() const { return live; }
+	float fragmentation() const;//0 when all free space is one block, towards 1 as it splinters
+
+	bool validate() const;//walks every block and checks the lists, bitmaps and totals agree, and that compacted holds
+
+private:
+	static const int SL_BITS = 4;//16 second level classes per power of two, worst case waste 1/16
+	static const int SL_COUNT = 1 << SL_BITS;
+	static const int FL_COUNT = 32;
+
+	struct Block {
+		uint32_t offset, size;
+		int prevPhys, nextPhys;//neighbours in address order
+		int prevFree, nextFree;//size class list, only while free
+		bool isFree;
+		unsigned int handle;//only while used
+	};
+
+	std::vector<Block> blocks;
+	std::vector<int> unusedBlocks;
+	std::vector<int> allocations;//handle -> block, handle 0 never used
+	std::vector<unsigned int> unusedHandles;
+
+	uint32_t flBitmap = 0;
+	uint32_t slBitmap[FL_COUNT] = {};
+	int freeHeads[FL_COUNT][SL_COUNT];
+
+	uint32_t capacity;
+	uint32_t used = 0;
+	size_t freeBlocks = 0;
+	size_t live = 0;
+	int firstPhys = -1, lastPhys = -1;
+	int defragNext = -1;//block the next defragment call looks at first, -1 = start from the top
+	size_t passMoves = 0;//moves since the walk last started from the top
+	bool defragDone = false;//a whole pass from the top moved nothing
+
+	static void mapping(uint32_t size, int& fl, int& sl);
+	static void mappingSearch(uint32_t size, int& fl, int& sl);//rounds up so any block in the class fits
+
+	int newBlock();
+	void recycleBlock(int index);
+	void insertFree(int index);
+	void removeFree(int index);
+	int findFree(uint32_t size) const;
+	int lowestFit(uint32_t size, uint32_t below) const;//lowest free block under offset below that size fits in, -1 if none
+	void layoutChanged() { defragNext = -1; passMoves = 0; defragDone = false; }//allocate, free and grow can open or close holes
+	void split(int index, uint32_t size);//leaves index as the first size elements, remainder goes on the free lists
+	int release(int index);//marks free and merges with neighbours, returns the merged block
+};
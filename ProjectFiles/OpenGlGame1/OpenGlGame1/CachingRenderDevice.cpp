@@ -0,0 +1,236 @@
+#include "CachingRenderDevice.h"
+
+CachingRenderDevice::CachingRenderDevice(RenderDevice& device) : device(device) {
+    invalidate();
+}
+
+void CachingRenderDevice::invalidate() {
+    framebuffer = program = vertexArray = UNKNOWN;
+    for (unsigned int i = 0; i < UNITS; i++) textures[i] = bufferTextures[i] = UNKNOWN;
+    for (unsigned int i = 0; i < BINDINGS; i++) uniformBuffers[i] = UNKNOWN;
+    for (unsigned int i = 0; i < CAPS; i++) caps[i] = UNKNOWN;
+    depthFunc = depthMask = UNKNOWN;
+    viewportKnown = scissorKnown = clearColourKnown = false;
+}
+
+bool CachingRenderDevice::changes(unsigned int& tracked, unsigned int value) {
+    if (enabled && tracked == value) {
+        current.elided++;
+        return false;
+    }
+    tracked = value;
+    current.issued++;
+    return true;
+}
+
+bool CachingRenderDevice::changes(bool& known, int* tracked, int x, int y, int width, int height) {
+    if (enabled && known && tracked[0] == x && tracked[1] == y && tracked[2] == width && tracked[3] == height) {
+        current.elided++;
+        return false;
+    }
+    known = true;
+    tracked[0] = x;
+    tracked[1] = y;
+    tracked[2] = width;
+    tracked[3] = height;
+    current.issued++;
+    return true;
+}
+
+void CachingRenderDevice::forget(unsigned int* tracked, unsigned int count, unsigned int handle) {
+    for (unsigned int i = 0; i < count; i++) {
+        if (tracked[i] == handle) tracked[i] = 0;
+    }
+}
+
+unsigned int CachingRenderDevice::createVertexArray() {
+    return device.createVertexArray();
+}
+
+void CachingRenderDevice::deleteVertexArray(unsigned int vertexArray) {
+    if (vertexArray != 0) forget(&this->vertexArray, 1, vertexArray);
+    device.deleteVertexArray(vertexArray);
+}
+
+unsigned int CachingRenderDevice::createBuffer() {
+    return device.createBuffer();
+}
+
+void CachingRenderDevice::deleteBuffer(unsigned int buffer) {
+    if (buffer != 0) forget(uniformBuffers, BINDINGS, buffer);
+    device.deleteBuffer(buffer);
+}
+
+//binds to the plain target, not an indexed uniform binding, so nothing tracked moves
+void CachingRenderDevice::bufferData(BufferTarget target, unsigned int buffer, size_t bytes, const void* data, BufferUsage usage) {
+    device.bufferData(target, buffer, bytes, data, usage);
+}
+
+void CachingRenderDevice::bufferSubData(unsigned int buffer, size_t offset, size_t bytes, const void* data) {
+    device.bufferSubData(buffer, offset, bytes, data);
+}
+
+void CachingRenderDevice::copyBufferData(unsigned int source, unsigned int destination, size_t sourceOffset, size_t destinationOffset, size_t bytes) {
+    device.copyBufferData(source, destination, sourceOffset, destinationOffset, bytes);
+}
+
+void CachingRenderDevice::vertexAttrib(const VertexAttrib& attrib) {
+    device.vertexAttrib(attrib);
+}
+
+//the gl device binds the new texture on whatever unit is active and then binds 0 there,
+//which unit that is isnt tracked, so every unit of that target is forgotten
+unsigned int CachingRenderDevice::createTexture(const TextureDesc& desc, const void* pixels) {
+    for (unsigned int i = 0; i < UNITS; i++) textures[i] = UNKNOWN;
+    return device.createTexture(desc, pixels);
+}
+
+void CachingRenderDevice::deleteTexture(unsigned int texture) {
+    if (texture != 0) {
+        forget(textures, UNITS, texture);
+        forget(bufferTextures, UNITS, texture);
+    }
+    device.deleteTexture(texture);
+}
+
+unsigned int CachingRenderDevice::createBufferTexture(unsigned int buffer) {
+    for (unsigned int i = 0; i < UNITS; i++) bufferTextures[i] = UNKNOWN;
+    return device.createBufferTexture(buffer);
+}
+
+//binds the new framebuffer to check it and goes back to the default one
+unsigned int CachingRenderDevice::createDepthTarget(unsigned int depthTexture) {
+    framebuffer = UNKNOWN;
+    return device.createDepthTarget(depthTexture);
+}
+
+void CachingRenderDevice::deleteFramebuffer(unsigned int framebuffer) {
+    if (framebuffer != 0) forget(&this->framebuffer, 1, framebuffer);
+    device.deleteFramebuffer(framebuffer);
+}
+
+unsigned int CachingRenderDevice::createProgram(const std::string& vertexPath, const std::string& fragmentPath) {
+    return device.createProgram(vertexPath, fragmentPath);
+}
+
+int CachingRenderDevice::getUniformLocation(unsigned int program, const char* name) {
+    return device.getUniformLocation(program, name);
+}
+
+bool CachingRenderDevice::bindUniformBlock(unsigned int program, const char* block, unsigned int binding) {
+    return device.bindUniformBlock(program, block, binding);
+}
+
+void CachingRenderDevice::bindFramebuffer(unsigned int framebuffer) {
+    if (changes(this->framebuffer, framebuffer)) device.bindFramebuffer(framebuffer);
+}
+
+void CachingRenderDevice::setViewport(int x, int y, int width, int height) {
+    if (changes(viewportKnown, viewport, x, y, width, height)) device.setViewport(x, y, width, height);
+}
+
+void CachingRenderDevice::setScissor(int x, int y, int width, int height) {
+    if (changes(scissorKnown, scissor, x, y, width, height)) device.setScissor(x, y, width, height);
+}
+
+void CachingRenderDevice::setClearColour(const glm::vec4& colour) {
+    if (enabled && clearColourKnown && clearColour == colour) {
+        current.elided++;
+        return;
+    }
+    clearColourKnown = true;
+    clearColour = colour;
+    current.issued++;
+    device.setClearColour(colour);
+}
+
+//not state, every clear does work
+void CachingRenderDevice::clear(bool colour, bool depth) {
+    device.clear(colour, depth);
+}
+
+void CachingRenderDevice::setEnabled(RenderCap cap, bool enabled) {
+    unsigned int index = static_cast<unsigned int>(cap);
+    if (changes(caps[index], enabled ? 1 : 0)) device.setEnabled(cap, enabled);
+}
+
+void CachingRenderDevice::setDepthFunc(DepthFunc func) {
+    if (changes(depthFunc, static_cast<unsigned int>(func))) device.setDepthFunc(func);
+}
+
+void CachingRenderDevice::setDepthMask(bool write) {
+    if (changes(depthMask, write ? 1 : 0)) device.setDepthMask(write);
+}
+
+void CachingRenderDevice::useProgram(unsigned int program) {
+    if (changes(this->program, program)) device.useProgram(program);
+}
+
+void CachingRenderDevice::bindVertexArray(unsigned int vertexArray) {
+    if (changes(this->vertexArray, vertexArray)) device.bindVertexArray(vertexArray);
+}
+
+void CachingRenderDevice::bindTexture(unsigned int unit, unsigned int texture) {
+    if (unit >= UNITS) {
+        current.issued++;
+        device.bindTexture(unit, texture);
+        return;
+    }
+    if (changes(textures[unit], texture)) device.bindTexture(unit, texture);
+}
+
+void CachingRenderDevice::bindBufferTexture(unsigned int unit, unsigned int texture) {
+    if (unit >= UNITS) {
+        current.issued++;
+        device.bindBufferTexture(unit, texture);
+        return;
+    }
+    if (changes(bufferTextures[unit], texture)) device.bindBufferTexture(unit, texture);
+}
+
+void CachingRenderDevice::bindUniformBuffer(unsigned int binding, unsigned int buffer) {
+    if (binding >= BINDINGS) {
+        current.issued++;
+        device.bindUniformBuffer(binding, buffer);
+        return;
+    }
+    if (changes(uniformBuffers[binding], buffer)) device.bindUniformBuffer(binding, buffer);
+}
+
+void CachingRenderDevice::setUniform(int location, int value) {
+    device.setUniform(location, value);
+}
+
+void CachingRenderDevice::setUniform(int location, const glm::vec3& value) {
+    device.setUniform(location, value);
+}
+
+void CachingRenderDevice::setUniform(int location, const glm::vec4& value) {
+    device.setUniform(location, value);
+}
+
+void CachingRenderDevice::setUniform(int location, const glm::mat4& value) {
+    device.setUniform(location, value);
+}
+
+void CachingRenderDevice::drawIndexed(Primitive primitive, size_t indexCount, size_t firstIndex, int baseVertex) {
+    device.drawIndexed(primitive, indexCount, firstIndex, baseVertex);
+}
+
+void CachingRenderDevice::multiDrawIndexed(Primitive primitive, const int* indexCounts, const size_t* firstIndices, const int* baseVertices, size_t drawCount) {
+    device.multiDrawIndexed(primitive, indexCounts, firstIndices, baseVertices, drawCount);
+}
+
+void CachingRenderDevice::drawIndexedInstanced(Primitive primitive, size_t indexCount, size_t firstIndex, size_t instanceCount) {
+    device.drawIndexedInstanced(primitive, indexCount, firstIndex, instanceCount);
+}
+
+void CachingRenderDevice::beginFrame() {
+    device.beginFrame();
+}
+
+void CachingRenderDevice::endFrame() {
+    last = current;
+    current = StateCacheStats();
+    device.endFrame();
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include "RenderDevice.h"
+
+//state calls that reached the device and state calls dropped because they changed nothing
+struct StateCacheStats {
+	size_t issued = 0;
+	size_t elided = 0;
+};
+
+//sits in front of another device and remembers the bound framebuffer, viewport, scissor, clear colour, program,
+//vertex array, textures per unit, uniform buffers per binding, enables and depth state, so setting something
+//to what it already is never gets to gl. Everything else is passed straight through.
+//No gl in here either, so headless runs can put it in front of the recording device and count what it saves
+class CachingRenderDevice : public RenderDevice
+{
+public:
+	explicit CachingRenderDevice(RenderDevice& device);
+
+	bool enabled = true;//false passes every state call on, still tracked so turning it back on stays correct
+	void invalidate();//forget everything, for when something outside the device changed gl state
+
+	const StateCacheStats& frameStats() const { return current; }//frame in progress
+	const StateCacheStats& lastFrameStats() const { return last; }
+
+	unsigned int createVertexArray() override;
+	void deleteVertexArray(unsigned int vertexArray) override;
+	unsigned int createBuffer() override;
+	void deleteBuffer(unsigned int buffer) override;
+	void bufferData(BufferTarget target, unsigned int buffer, size_t bytes, const void* data, BufferUsage usage) override;
+	void bufferSubData(unsigned int buffer, size_t offset, size_t bytes, const void* data) override;
+	void copyBufferData(unsigned int source, unsigned int destination, size_t sourceOffset, size_t destinationOffset, size_t bytes) override;
+	void vertexAttrib(const VertexAttrib& attrib) override;
+
+	unsigned int createTexture(const TextureDesc& desc, const void* pixels) override;
+	void deleteTexture(unsigned int texture) override;
+	unsigned int createBufferTexture(unsigned int buffer) override;
+	unsigned int createDepthTarget(unsigned int depthTexture) override;
+	void deleteFramebuffer(unsigned int framebuffer) override;
+
+	unsigned int createProgram(const std::string& vertexPath, const std::string& fragmentPath) override;
+	int getUniformLocation(unsigned int program, const char* name) override;
+	bool bindUniformBlock(unsigned int program, const char* block, unsigned int binding) override;
+
+	void bindFramebuffer(unsigned int framebuffer) override;
+	void setViewport(int x, int y, int width, int height) override;
+	void setScissor(int x, int y, int width, int height) override;
+	void setClearColour(const glm::vec4& colour) override;
+	void clear(bool colour, bool depth) override;
+	void setEnabled(RenderCap cap, bool enabled) override;
+	void setDepthFunc(DepthFunc func) override;
+	void setDepthMask(bool write) override;
+
+	void useProgram(unsigned int program) override;
+	void bindVertexArray(unsigned int vertexArray) override;
+	void bindTexture(unsigned int unit, unsigned int texture) override;
+	void bindBufferTexture(unsigned int unit, unsigned int texture) override;
+	void bindUniformBuffer(unsigned int binding, unsigned int buffer) override;
+
+	void setUniform(int location, int value) override;
+	void setUniform(int location, const glm::vec3& value) override;
+	void setUniform(int location, const glm::vec4& value) override;
+	void setUniform(int location, const glm::mat4& value) override;
+
+	void drawIndexed(Primitive primitive, size_t indexCount, size_t firstIndex, int baseVertex) override;
+	void multiDrawIndexed(Primitive primitive, const int* indexCounts, const size_t* firstIndices, const int* baseVertices, size_t drawCount) override;
+	void drawIndexedInstanced(Primitive primitive, size_t indexCount, size_t firstIndex, size_t instanceCount) override;
+
+	void beginFrame() override;
+	void endFrame() override;
+
+private:
+	RenderDevice& device;
+	StateCacheStats current, last;
+
+	static const unsigned int UNKNOWN = ~0u;//nothing is known about the gl value, the next set always goes through
+	static const unsigned int UNITS = 16;//texture units tracked, higher ones always go through
+	static const unsigned int BINDINGS = 8;//uniform buffer bindings, same
+	static const unsigned int CAPS = 4;//RenderCap values
+
+	unsigned int framebuffer, program, vertexArray;
+	unsigned int textures[UNITS], bufferTextures[UNITS];//a unit has a binding per target
+	unsigned int uniformBuffers[BINDINGS];
+	unsigned int caps[CAPS];//0 off, 1 on
+	unsigned int depthFunc, depthMask;
+	bool viewportKnown, scissorKnown, clearColourKnown;
+	int viewport[4], scissor[4];
+	glm::vec4 clearColour;
+
+	bool changes(unsigned int& tracked, unsigned int value);//true if the call has to go through, counts it either way
+	bool changes(bool& known, int* tracked, int x, int y, int width, int height);
+	void forget(unsigned int* tracked, unsigned int count, unsigned int handle);//gl unbinds deleted objects
+};
@@ -1,25 +1,25 @@
 #include "Chunk.h"
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <iostream>
+#include <algorithm>
 #include <glm/vec2.hpp>
 
-#include "Main.h"//need for full main deffinition
+#include "TerrainGenerator.h"
 #include "BlockConstants.h"
 
 
-Chunk::Chunk(glm::ivec3 position,int seed, Main* m)
-	: chunkPosition(position),main(m),fullRebuildNeeded(true),blocks(chunkSize* chunkHeight* chunkSize, BlockType::AIR), currentTallestBlock(0),
-		VAO(0), VBO(0), EBO(0) {
+Chunk::Chunk(glm::ivec3 position,int seed, ChunkSource* w)
+	: chunkPosition(position),world(w),fullRebuildNeeded(true),blocks(chunkSize* chunkHeight* chunkSize, BlockType::AIR), currentTallestBlock(0),
+		vertexBlock(0), indexBlock(0) {
 
 	size_t maxBlocks = chunkSize * chunkHeight * chunkSize; // Worst case: fully solid
 	size_t expectedBlocks = chunkSize * (chunkHeight / 2) * chunkSize; // Assume half height
 	blocks.reserve(std::min(expectedBlocks, blocks.max_size() / 2));
 
-	//use noise, with caching, from main
-	if (!main) std::cerr << "main nullptr" << "\n";
-	 
-	std::lock_guard<std::mutex> lock(main->noiseMutex); 
+	//use noise, with caching, from the owning world
+	if (!world) std::cerr << "world nullptr" << "\n";
+
+	TerrainGenerator& terrain = world->getTerrain();
+	std::lock_guard<std::mutex> lock(terrain.noiseMutex); 
 
 	for (int x = 0; x < chunkSize; x++) { 
 		for (int z = 0; z < chunkSize; z++) {
@@ -27,9 +27,9 @@ Chunk::Chunk(glm::ivec3 position,int seed, Main* m)
 			float worldX = chunkPosition.x + x;
 			float worldZ = chunkPosition.z + z;
 
-			float height = main->getNoise(static_cast<float>(worldX), static_cast<float>(worldZ));//returns cached noise or gens new noise
+			float height = terrain.getNoise(static_cast<float>(worldX), static_cast<float>(worldZ));//returns cached noise or gens new noise
 			
-			//height = main->noiseGen.GetNoise(worldX, worldZ);
+			//height = terrain.noiseGen.GetNoise(worldX, worldZ);
 
 			//int terrainHeight = baseTerrainHeight + static_cast<int>((height + 1.0f) * 0.5f * (maxTerrainHeight - 1));
 			int terrainHeight = height;
@@ -55,139 +55,165 @@ Chunk::Chunk(glm::ivec3 position,int seed, Main* m)
 			}
 		}
 	}
+	rebuildOccupancy();
 }
 
-Chunk::~Chunk() {
-	if (VAO != 0) glDeleteVertexArrays(1, &VAO);
-	if (VBO != 0) glDeleteBuffers(1, &VBO); 
-	if (EBO != 0) glDeleteBuffers(1, &EBO); 
-}
+static_assert(Chunk::chunkSize == 16, "occupancy rows are 16 bit");
 
-void Chunk::initializeBuffers() {
-	if (VAO != 0 || VBO != 0 || EBO != 0) {
-		// Already initialized
-		return;
+void Chunk::rebuildOccupancy() {
+	occupancy.assign(chunkHeight * chunkSize, 0);
+	for (int y = 0; y < chunkHeight; y++) {
+		for (int z = 0; z < chunkSize; z++) {
+			const BlockType* row = blocks.data() + getBlockIndex(0, y, z);
+			uint16_t bits = 0;
+			for (int x = 0; x < chunkSize; x++) bits |= static_cast<uint16_t>(row[x] != BlockType::AIR) << x;
+			occupancy[y * chunkSize + z] = bits;
+		}
 	}
+	//top down, each column takes the first row that has its bit
+	std::fill(columnTops, columnTops + chunkSize * chunkSize, int16_t(-1));
+	uint16_t found[chunkSize] = {};
+	for (int y = chunkHeight - 1; y >= 0; y--) {
+		for (int z = 0; z < chunkSize; z++) {
+			uint16_t fresh = occupancy[y * chunkSize + z] & ~found[z];
+			found[z] |= fresh;
+			for (int x = 0; fresh; x++, fresh >>= 1) {
+				if (fresh & 1) columnTops[z * chunkSize + x] = static_cast<int16_t>(y);
+			}
+		}
+	}
+	currentTallestBlock = *std::max_element(columnTops, columnTops + chunkSize * chunkSize);
 
-	glGenVertexArrays(1, &VAO);
-	GLenum err = glGetError();
-	if (err != GL_NO_ERROR) std::cerr << "Error after glGenVertexArrays: " << err << std::endl;
-
-	glGenBuffers(1, &VBO);
-	err = glGetError();
-	if (err != GL_NO_ERROR) std::cerr << "Error after glGenBuffers (VBO): " << err << std::endl;
-
-	glGenBuffers(1, &EBO);
-	err = glGetError();
-	if (err != GL_NO_ERROR) std::cerr << "Error after glGenBuffers (EBO): " << err << std::endl;
-
-	glBindVertexArray(VAO);
-	err = glGetError();
-	if (err != GL_NO_ERROR) std::cerr << "Error after glBindVertexArray: " << err << std::endl;
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	err = glGetError();
-	if (err != GL_NO_ERROR) std::cerr << "Error after glBindBuffer (VBO): " << err << std::endl;
+	for (int s = 0; s < MeshData::sectionCount; s++) {
+		sectionBricks[s] = 0;
+		for (int brick = 0; brick < 64; brick++) {
+			int x = (brick & 3) * 4, z = (brick >> 2 & 3) * 4, y = s * MeshData::sectionHeight + (brick >> 4) * 4;
+			if (brickSolid(x, y, z)) sectionBricks[s] |= 1ull << brick;
+		}
+	}
+}
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	err = glGetError();
-	if (err != GL_NO_ERROR) std::cerr << "Error after glBindBuffer (EBO): " << err << std::endl;
+bool Chunk::brickSolid(int x, int y, int z) const {
+	uint16_t mask = static_cast<uint16_t>(0xF << (x & ~3));
+	const uint16_t* rows = occupancy.data() + (y & ~3) * chunkSize + (z & ~3);
+	for (int dy = 0; dy < 4; dy++) {
+		for (int dz = 0; dz < 4; dz++) {
+			if (rows[dy * chunkSize + dz] & mask) return true;
+		}
+	}
+	return false;
+}
 
-	glBindVertexArray(0);
-	err = glGetError();
-	if (err != GL_NO_ERROR) std::cerr << "Error after unbinding VAO: " << err << std::endl; 
+static_assert(MeshData::sectionCount * MeshData::sectionHeight == Chunk::chunkHeight, "sections must tile the chunk height");
+static_assert(MeshData::solidCells * MeshData::solidCell == Chunk::chunkSize, "solid patches must tile the chunk");
 
-	GLenum error = glGetError();
-	if (error != GL_NO_ERROR) {
-		std::cerr << "OpenGL Error after initializing buffers for chunk "
-			<< ": " << error << std::endl;
-	}
+Chunk::~Chunk() {
+	//gl buffers are released by the renderer, see Main::deleteChunkBuffers
 }
 
 MeshData Chunk::generateMeshData() {
 	cacheNeighbors();
 	MeshData meshData;
 
-	int localMaxHeight = 0; // Maximum Y value of non-air blocks in this chunk
+	// Step 1: Counting pass to determine visible faces per section and direction, in face order (Front, Back, Left, Right, Top, Bottom)
+	int faceCount[MeshData::sectionCount][MeshSection::faceDirections] = {};
 
-	// Step 1: Counting pass to determine visible faces per block type
-	std::map<BlockType, int> faceCount;
-
-	for (int x = 0; x < chunkSize; x++) {
-		for (int y = 0; y < chunkHeight; y++) {
-			for (int z = 0; z < chunkSize; z++) {
+	for (int y = 0; y < chunkHeight; y++) {
+		int* counts = faceCount[y / MeshData::sectionHeight];
+		for (int z = 0; z < chunkSize; z++) {
+			for (int x = 0; x < chunkSize; x++) {
 				size_t index = getBlockIndex(x, y, z);
 				if (blocks[index] == BlockType::AIR) continue; // Skip air blocks
 
-				BlockType type = blocks[index];
-
 				// Check visibility of each face
-				if (!isBlockSolid(x + 0, y + 0, z - 1)) faceCount[type]++; // Front 
-				if (!isBlockSolid(x + 0, y + 0, z + 1)) faceCount[type]++; // Back
-				if (!isBlockSolid(x - 1, y + 0, z + 0)) faceCount[type]++; // Left  
-				if (!isBlockSolid(x + 1, y + 0, z + 0)) faceCount[type]++; // Right 
-				if (!isBlockSolid(x + 0, y + 1, z + 0)) faceCount[type]++; // Top 
-				if (!isBlockSolid(x + 0, y - 1, z + 0)) faceCount[type]++; // Bottom 
-
-				// Update max height
-				localMaxHeight = std::max(localMaxHeight, y);
+				if (!isBlockSolid(x + 0, y + 0, z - 1)) counts[0]++; // Front 
+				if (!isBlockSolid(x + 0, y + 0, z + 1)) counts[1]++; // Back
+				if (!isBlockSolid(x - 1, y + 0, z + 0)) counts[2]++; // Left  
+				if (!isBlockSolid(x + 1, y + 0, z + 0)) counts[3]++; // Right 
+				if (!isBlockSolid(x + 0, y + 1, z + 0)) counts[4]++; // Top 
+				if (!isBlockSolid(x + 0, y - 1, z + 0)) counts[5]++; // Bottom 
 			}
 		}
-	} 
-
-	//Step 2: Reserve space in vectors based on face counts
-    for (const auto& pair : faceCount) {
-        BlockType type = pair.first;
-        int faces = pair.second;
-        meshData.packedVerticesByType[type].resize(faces * 4); // 4 vertices 
-        meshData.indicesByType[type].resize(faces * 6);       // 6 indices per face
-    }
-
-	//gen mesh using pointers
-	for (auto& pair : meshData.packedVerticesByType) {
-		BlockType type = pair.first;
-		std::vector<PackedVertex>& vertices = pair.second; 
-		std::vector<unsigned int>& indices = meshData.indicesByType[type];
-
-		//pointers to the start of the vectors
-		PackedVertex* vertexPtr = vertices.data();
-		unsigned int* indexPtr = indices.data();
-		unsigned int baseVertexIndex = 0;
+	}
 
-		for (int x = 0; x < chunkSize; x++) {
-			for (int y = 0; y < chunkHeight; y++) {
-				for (int z = 0; z < chunkSize; z++) {
-					size_t index = getBlockIndex(x, y, z);
-					if (blocks[index] != type || blocks[index] == BlockType::AIR) continue;
-
-					// Basic occlusion culling: skip fully surrounded blocks
-					bool isSurrounded = true;
-					for (int dx = -1; dx <= 1 && isSurrounded; dx += 2) {
-						if (!isBlockSolid(x + dx, y, z)) { isSurrounded = false; break; }
-					}
-					if (isSurrounded) {
-						for (int dy = -1; dy <= 1 && isSurrounded; dy += 2) {
-							if (!isBlockSolid(x, y + dy, z)) { isSurrounded = false; break; }
-						}
+	//Step 2: size the buffers and lay the sections out back to back, each split into its six direction buckets
+	//faceCursor is the next free face slot of each bucket, face n owns vertices [4n, 4n + 4) and indices [6n, 6n + 6)
+	unsigned int faceCursor[MeshData::sectionCount][MeshSection::faceDirections];
+	unsigned int totalFaces = 0;
+	for (int s = 0; s < MeshData::sectionCount; s++) {
+		MeshSection& section = meshData.sections[s];
+		section.firstIndex = totalFaces * 6;
+		for (int f = 0; f < MeshSection::faceDirections; f++) {
+			faceCursor[s][f] = totalFaces;
+			section.bucketCounts[f] = faceCount[s][f] * 6;
+			totalFaces += faceCount[s][f];
+		}
+		section.indexCount = totalFaces * 6 - section.firstIndex;
+	}
+	meshData.vertices.resize(totalFaces * 4); // 4 vertices 
+	meshData.indices.resize(totalFaces * 6);  // 6 indices per face
+
+	for (int y = 0; y < chunkHeight; y++) {
+		int s = y / MeshData::sectionHeight;
+		MeshSection& section = meshData.sections[s];
+		for (int z = 0; z < chunkSize; z++) {
+			for (int x = 0; x < chunkSize; x++) {
+				size_t index = getBlockIndex(x, y, z);
+				BlockType type = blocks[index];
+				if (type == BlockType::AIR) continue;
+
+				// Basic occlusion culling: skip fully surrounded blocks
+				bool isSurrounded = true;
+				for (int dx = -1; dx <= 1 && isSurrounded; dx += 2) {
+					if (!isBlockSolid(x + dx, y, z)) { isSurrounded = false; break; }
+				}
+				if (isSurrounded) {
+					for (int dy = -1; dy <= 1 && isSurrounded; dy += 2) {
+						if (!isBlockSolid(x, y + dy, z)) { isSurrounded = false; break; }
 					}
-					if (isSurrounded) {
-						for (int dz = -1; dz <= 1 && isSurrounded; dz += 2) {
-							if (!isBlockSolid(x, y, z + dz)) { isSurrounded = false; break; }
-						}
+				}
+				if (isSurrounded) {
+					for (int dz = -1; dz <= 1 && isSurrounded; dz += 2) {
+						if (!isBlockSolid(x, y, z + dz)) { isSurrounded = false; break; }
 					}
-					if (isSurrounded) continue;
+				}
+				if (isSurrounded) continue;
 
-					// Generate faces for this block using pointers
-					generateBlockFaces(vertexPtr, indexPtr, baseVertexIndex, glm::ivec3(x, y, z), type);
+				//section box only grows around blocks that have a face
+				glm::ivec3 blockPos(x, y, z);
+				if (section.min == section.max) {
+					section.min = blockPos;
+					section.max = blockPos + 1;
+				}
+				else {
+					section.min = glm::min(section.min, blockPos);
+					section.max = glm::max(section.max, blockPos + 1);
 				}
+
+				// Generate faces for this block into its section's buckets
+				generateBlockFaces(meshData, faceCursor[s], blockPos, type);
 			}
 		}
 	}
-	currentTallestBlock = localMaxHeight;
+	//solid columns for occluders, a patch is only as tall as its lowest column so the box is solid throughout
+	for (int& height : meshData.solidHeights) height = chunkHeight;
+	for (int z = 0; z < chunkSize; z++) {
+		for (int x = 0; x < chunkSize; x++) {
+			int solid = 0;
+			while (solid < chunkHeight && blocks[getBlockIndex(x, solid, z)] != BlockType::AIR) solid++;
+			int& height = meshData.solidHeights[(z / MeshData::solidCell) * MeshData::solidCells + x / MeshData::solidCell];
+			height = std::min(height, solid);
+		}
+	}
+
+	for (int s = 0; s < MeshData::sectionCount; s++) {
+		meshData.sections[s].connectivity = sectionConnectivity(s);
+	}
+
 	return meshData;
 }
 
-void Chunk::generateBlockFaces(PackedVertex*& vertexPtr, unsigned int*& indexPtr, unsigned int& baseVertexIndex, const glm::ivec3 blockPos,const BlockType& type) {
+void Chunk::generateBlockFaces(MeshData& meshData, unsigned int* faceCursor, const glm::ivec3 blockPos,const BlockType& type) {
 
 	//block position in chunk local space  
 	glm::vec3 pos = blockPos;
@@ -247,22 +273,89 @@ void Chunk::generateBlockFaces(PackedVertex*& vertexPtr, unsigned int*& indexPtr
 			faceVerts[i].normal = packNormal(normals[f]);
 		}
 
-		// Write the 4 vertices into our output pointer.
+		// Write the 4 vertices into the next slot of this face's bucket
+		unsigned int slot = faceCursor[f]++;
+		unsigned int baseVertexIndex = slot * 4;
+		PackedVertex* vertexPtr = meshData.vertices.data() + baseVertexIndex;
 		for (int i = 0; i < 4; i++) {
-			*vertexPtr = faceVerts[i];
-			vertexPtr++;
+			vertexPtr[i] = faceVerts[i];
 		}
 
 		// Write 6 indices (two triangles) for this face
+		unsigned int* indexPtr = meshData.indices.data() + slot * 6;
 		*indexPtr++ = baseVertexIndex;     // Triangle 1
 		*indexPtr++ = baseVertexIndex + 1;
 		*indexPtr++ = baseVertexIndex + 2;
 		*indexPtr++ = baseVertexIndex;     // Triangle 2
 		*indexPtr++ = baseVertexIndex + 2;
 		*indexPtr++ = baseVertexIndex + 3;
+	}
+}
+
+//flood fills the air of one 16^3 section, every pocket joins all the section faces it touches to each other
+uint64_t Chunk::sectionConnectivity(int section) const {
+	const int size = MeshData::sectionHeight;
+	const int cells = size * size * size;
+	//blocks are stored y then z then x, so a section is one run of the array in the same order as its cells
+	const BlockType* block = blocks.data() + getBlockIndex(0, section * size, 0);
+
+	//most sections are all rock or all air
+	int air = 0;
+	for (int cell = 0; cell < cells; cell++) air += block[cell] == BlockType::AIR;
+	if (air == 0) return 0;
+	if (air == cells) return MeshSection::allConnected;
+
+	//faces in the same order as the mesh buckets, Front z-, Back z+, Left x-, Right x+, Top, Bottom
+	auto facesOf = [size](int x, int y, int z) {
+		unsigned int faces = 0;
+		if (z == 0) faces |= 1u << 0;
+		if (z == size - 1) faces |= 1u << 1;
+		if (x == 0) faces |= 1u << 2;
+		if (x == size - 1) faces |= 1u << 3;
+		if (y == size - 1) faces |= 1u << 4;
+		if (y == 0) faces |= 1u << 5;
+		return faces;
+	};
+
+	bool visited[cells] = {};
+	uint16_t stack[cells];
+	uint64_t connected = 0;
+
+	for (int start = 0; start < cells; start++) {
+		if (visited[start] || block[start] != BlockType::AIR) continue;
+		visited[start] = true;
+
+		unsigned int touched = 0;
+		int top = 0;
+		stack[top++] = static_cast<uint16_t>(start);
+		while (top > 0) {
+			int cell = stack[--top];
+			int x = cell % size, z = (cell / size) % size, y = cell / (size * size);
+			touched |= facesOf(x, y, z);
+
+			auto visit = [&](bool inside, int next) {
+				if (inside && !visited[next] && block[next] == BlockType::AIR) {
+					visited[next] = true;
+					stack[top++] = static_cast<uint16_t>(next);
+				}
+			};
+			visit(x > 0, cell - 1);
+			visit(x < size - 1, cell + 1);
+			visit(z > 0, cell - size);
+			visit(z < size - 1, cell + size);
+			visit(y > 0, cell - size * size);
+			visit(y < size - 1, cell + size * size);
+		}
 
-		baseVertexIndex += 4; // Increment for the next face		
+		for (int a = 0; a < MeshSection::faceDirections; a++) {
+			if (!(touched & (1u << a))) continue;
+			for (int b = 0; b < MeshSection::faceDirections; b++) {
+				if (touched & (1u << b)) connected |= 1ull << (a * MeshSection::faceDirections + b);
+			}
+		}
+		if (connected == MeshSection::allConnected) break;
 	}
+	return connected;
 }
 
 bool Chunk::isBlockSolid(int x, int y, int z) {
@@ -313,12 +406,26 @@ void Chunk::setBlock(int x, int y, int z, BlockType type) {
 
 	size_t index = getBlockIndex(x, y, z); 
 
-	//technically incorrect as there could be >1 blocks at max height
-	if (type == BlockType::AIR)//if broken was tallest, lower tallest block to broken
-		currentTallestBlock = std::min(currentTallestBlock, y - 1);
-	else
-		currentTallestBlock = std::max(currentTallestBlock, y);
-
+	if ((blocks[index] != BlockType::AIR) != (type != BlockType::AIR)) {
+		occupancy[y * chunkSize + z] ^= static_cast<uint16_t>(1u << x);
+		uint64_t brick = 1ull << (x / 4 + z / 4 * 4 + y % MeshData::sectionHeight / 4 * 16);
+		uint64_t& bricks = sectionBricks[y / MeshData::sectionHeight];
+		bricks = brickSolid(x, y, z) ? bricks | brick : bricks & ~brick;
+
+		//breaking the top of a column looks down it for the next block
+		int16_t& top = columnTops[z * chunkSize + x];
+		if (type != BlockType::AIR) top = std::max(top, static_cast<int16_t>(y));
+		else if (y == top) {
+			top = -1;
+			for (int below = y - 1; below >= 0; below--) {
+				if (occupancy[below * chunkSize + z] & (1u << x)) {
+					top = static_cast<int16_t>(below);
+					break;
+				}
+			}
+		}
+		currentTallestBlock = *std::max_element(columnTops, columnTops + chunkSize * chunkSize);
+	}
 	blocks[index] = type; 
 	fullRebuildNeeded = true;  
 
@@ -336,8 +443,8 @@ size_t Chunk::getBlockIndex(int x, int y, int z) const {
 }
 
 void Chunk::cacheNeighbors() { 
-	neighbors[0] = main->getChunk(chunkPosition + glm::vec3(chunkSize, 0, 0));  // +X
-	neighbors[1] = main->getChunk(chunkPosition + glm::vec3(-chunkSize, 0, 0)); // -X
-	neighbors[2] = main->getChunk(chunkPosition + glm::vec3(0, 0, chunkSize));  // +Z
-	neighbors[3] = main->getChunk(chunkPosition + glm::vec3(0, 0, -chunkSize)); // -Z
+	neighbors[0] = world->getChunk(chunkPosition + glm::vec3(chunkSize, 0, 0));  // +X
+	neighbors[1] = world->getChunk(chunkPosition + glm::vec3(-chunkSize, 0, 0)); // -X
+	neighbors[2] = world->getChunk(chunkPosition + glm::vec3(0, 0, chunkSize));  // +Z
+	neighbors[3] = world->getChunk(chunkPosition + glm::vec3(0, 0, -chunkSize)); // -Z
 }
\ No newline at end of file
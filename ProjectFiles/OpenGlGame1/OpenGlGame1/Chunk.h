@@ -2,12 +2,11 @@
 #include<vector>
 #include<glm/glm.hpp>
 #include<map>
-#include <glad/glad.h>
-#include<GLFW/glfw3.h>
 #include "Vec3Hash.h"
 #include <unordered_map>
 #include "BlockType.h"
 #include "MeshData.h"
+#include "ChunkSource.h"
 
 #include "VertexPacking.h"
 #include <glm/packing.hpp> 
@@ -18,63 +17,58 @@ struct Block
 	BlockType type;
 };
 
-class Main;//forward declaration
-
+//no gl in here, mesh storage is owned and cleaned up by the renderer so chunks can be built headless
 class Chunk
 {
-	Main* main;//main pointer
+	ChunkSource* world;//owner, gives terrain noise and neighbour lookups
 
 public:
 	static constexpr int chunkSize = 16;
 	static constexpr int chunkHeight = 256;
 	static constexpr int baseTerrainHeight = 64;
-	int currentTallestBlock;//for fustrum culling , avoids it detecting air as in culling view
+	int currentTallestBlock;//local y of the highest non air block, -1 for none, for fustrum culling , avoids it detecting air as in culling view
 	bool isActive = true;
 
-	Chunk(glm::ivec3 position, int seed, Main* m = nullptr);//constructor
+	Chunk(glm::ivec3 position, int seed, ChunkSource* w = nullptr);//constructor
 	~Chunk();
 	// Delete copy constructor and copy assignment operator
 	Chunk(const Chunk&) = delete; 
 	Chunk& operator=(const Chunk&) = delete; 
 	// Define move constructor
 	Chunk(Chunk&& other) noexcept
-		: chunkPosition(other.chunkPosition),main(other.main),
-		verticesByType(std::move(other.verticesByType)),
-		indicesByType(std::move(other.indicesByType)),
-		baseIndicesByType(std::move(other.baseIndicesByType)),
+		: world(other.world),
+		vertexBlock(other.vertexBlock),
+		indexBlock(other.indexBlock),
+		mesh(std::move(other.mesh)),
+		chunkPosition(other.chunkPosition),
 		blocks(std::move(other.blocks)),
-		VAO(other.VAO),
-		VBO(other.VBO),
-		EBO(other.EBO) 
+		occupancy(std::move(other.occupancy))
 	{
-		// Reset the other object's buffer IDs to prevent double deletion
-		other.VAO = 0;
-		other.VBO = 0;
-		other.EBO = 0;
+		std::copy(other.sectionBricks, other.sectionBricks + MeshData::sectionCount, sectionBricks);
+		std::copy(other.columnTops, other.columnTops + chunkSize * chunkSize, columnTops);
+		currentTallestBlock = other.currentTallestBlock;
+		// Reset the other object's arena blocks to prevent double freeing
+		other.vertexBlock = 0;
+		other.indexBlock = 0;
 	} 
 	// Define move assignment operator
 	Chunk& operator=(Chunk&& other) noexcept
 	{
 		if (this != &other) {
-			// Delete existing resources
-			glDeleteVertexArrays(1, &VAO);
-			glDeleteBuffers(1, &VBO);
-			glDeleteBuffers(1, &EBO);
-
-			// Transfer ownership
+			// Transfer ownership, existing buffers must already be released by the renderer
 			chunkPosition = other.chunkPosition;
-			verticesByType = std::move(other.verticesByType);
-			indicesByType = std::move(other.indicesByType);
-			baseIndicesByType = std::move(other.baseIndicesByType);
+			mesh = std::move(other.mesh);
 			blocks = std::move(other.blocks);
-			VAO = other.VAO;
-			VBO = other.VBO;
-			EBO = other.EBO;
-
-			// Reset the other object's buffer IDs
-			other.VAO = 0;
-			other.VBO = 0;
-			other.EBO = 0;
+			occupancy = std::move(other.occupancy);
+			std::copy(other.sectionBricks, other.sectionBricks + MeshData::sectionCount, sectionBricks);
+			std::copy(other.columnTops, other.columnTops + chunkSize * chunkSize, columnTops);
+			currentTallestBlock = other.currentTallestBlock;
+			vertexBlock = other.vertexBlock;
+			indexBlock = other.indexBlock;
+
+			// Reset the other object's arena blocks
+			other.vertexBlock = 0;
+			other.indexBlock = 0;
 		}
 		return *this;
 	} 
@@ -87,25 +81,30 @@ public:
 
 	//void updateMesh();
 
-	unsigned int VBO, VAO, EBO;
+	unsigned int vertexBlock, indexBlock;//mesh location in the renderers ChunkArena, 0 = not uploaded
 
-	std::map < BlockType, std::vector <PackedVertex>> verticesByType;//vertexes packed to 16bytes
-	std::map<BlockType, std::vector<unsigned int>> indicesByType; 
-	std::map<BlockType, unsigned int> baseIndicesByType; // Track base index per type 
+	MeshData mesh;//last finished mesh, handed to the renderer on upload
 	glm::vec3 chunkPosition;
 
 	std::vector<BlockType> blocks;//dense array, uses more ram, quicker lookup  
+	//bit x of occupancy[y * chunkSize + z] is set when that block is not air, and per 16 tall section a bit per 4^3
+	//brick (x / 4 + z / 4 * 4 + y % 16 / 4 * 16) set when the brick has a block that is not air. Kept in step with
+	//blocks so rays test bits and jump over empty bricks and sections whole
+	std::vector<uint16_t> occupancy;
+	uint64_t sectionBricks[MeshData::sectionCount] = {};
+	int16_t columnTops[chunkSize * chunkSize];//local y of the highest non air block in column z * chunkSize + x, -1 for none
+	void rebuildOccupancy();//and the column tops
 	bool fullRebuildNeeded = true;
 
-	void initializeBuffers(); // New method to initialize OpenGL buffers 
-
 private:
 	
-	void generateBlockFaces(PackedVertex*& vertexPtr, unsigned int*& indexPtr, unsigned int& baseVertexIndex, const glm::ivec3 blockPos,const BlockType& type);
+	void generateBlockFaces(MeshData& meshData, unsigned int* faceCursor, const glm::ivec3 blockPos,const BlockType& type);//faceCursor is the section's next slot per face direction
 	bool isBlockSolid(int x, int y, int z); 
+	bool brickSolid(int x, int y, int z) const;//from occupancy, any corner of the brick
+	uint64_t sectionConnectivity(int section) const;//MeshSection::connectivity
 	void cacheNeighbors();
  
-	Chunk* neighbors[4]; // +X, -X, +Z, -Z 
+	Chunk* neighbors[4] = {}; // +X, -X, +Z, -Z, null until the first mesh caches them
 
 	//pre made faces, texcoords, and normals, saves re making them per block
 	//stored in "blockConstants.cpp"
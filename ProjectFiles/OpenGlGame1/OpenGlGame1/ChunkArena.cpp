@@ -0,0 +1,119 @@
+#include "ChunkArena.h"
+#include <iostream>
+#include <cstddef>
+#include "Chunk.h"
+
+ChunkArena::ChunkArena(RenderDevice& device, uint32_t initialVertices, uint32_t initialIndices)
+    : device(device), vertices(initialVertices), indices(initialIndices) {
+}
+
+ChunkArena::~ChunkArena() {
+    device.deleteTexture(originTex);
+    device.deleteBuffer(originBuffer);
+    device.deleteVertexArray(VAO);
+    device.deleteBuffer(VBO);
+    device.deleteBuffer(EBO);
+}
+
+void ChunkArena::init() {
+    VAO = device.createVertexArray();
+    VBO = device.createBuffer();
+    EBO = device.createBuffer();
+
+    device.bindVertexArray(VAO);
+    device.bufferData(BufferTarget::Vertex, VBO, vertices.getCapacity() * sizeof(PackedVertex), nullptr, BufferUsage::Dynamic);
+    device.bufferData(BufferTarget::Index, EBO, indices.getCapacity() * sizeof(unsigned int), nullptr, BufferUsage::Dynamic);
+    setVertexLayout();
+    device.bindVertexArray(0);
+
+    //one vec4 per possible vertex handle, handles are reused so this never grows
+    originBuffer = device.createBuffer();
+    device.bufferData(BufferTarget::Texture, originBuffer, MAX_CHUNKS * sizeof(glm::vec4), nullptr, BufferUsage::Dynamic);
+    originTex = device.createBufferTexture(originBuffer);
+}
+
+//attribute pointers capture the vertex buffer bound at the time, so this is redone when the buffer is replaced
+void ChunkArena::setVertexLayout() {
+    device.vertexAttrib({ 0, 3, AttribType::Short, true, sizeof(PackedVertex), offsetof(PackedVertex, pos) });
+    device.vertexAttrib({ 1, 1, AttribType::UnsignedInt, true, sizeof(PackedVertex), offsetof(PackedVertex, colour) });
+    device.vertexAttrib({ 2, 2, AttribType::UnsignedShort, true, sizeof(PackedVertex), offsetof(PackedVertex, tex) });
+    device.vertexAttrib({ 3, 1, AttribType::Int, true, sizeof(PackedVertex), offsetof(PackedVertex, normal) });
+    device.vertexAttrib({ 4, 1, AttribType::UnsignedShort, true, sizeof(PackedVertex), offsetof(PackedVertex, originSlot) });
+}
+
+void ChunkArena::growBuffer(ArenaAllocator& allocator, unsigned int& buffer, uint32_t newCapacity, size_t elementSize, BufferTarget target) {
+    unsigned int bigger = device.createBuffer();
+
+    //new store is attached to the vao (index buffer) or picked up by the attributes (vertex buffer)
+    device.bindVertexArray(VAO);
+    device.bufferData(target, bigger, static_cast<size_t>(newCapacity) * elementSize, nullptr, BufferUsage::Dynamic);
+    if (target == BufferTarget::Vertex) setVertexLayout();
+    device.bindVertexArray(0);
+
+    size_t oldBytes = static_cast<size_t>(allocator.getCapacity()) * elementSize;
+    device.copyBufferData(buffer, bigger, 0, 0, oldBytes);
+    device.deleteBuffer(buffer);
+    buffer = bigger;
+
+    allocator.grow(newCapacity);
+    totalMovedBytes += oldBytes;
+}
+
+unsigned int ChunkArena::allocate(ArenaAllocator& allocator, unsigned int& buffer, uint32_t count, size_t elementSize, BufferTarget target) {
+    unsigned int handle = allocator.allocate(count);
+    while (handle == ArenaAllocator::invalidHandle) {
+        //double until it fits, the free tail merges with the new space
+        uint32_t newCapacity = allocator.getCapacity() * 2;
+        while (newCapacity - allocator.getCapacity() < count) newCapacity *= 2;
+        growBuffer(allocator, buffer, newCapacity, elementSize, target);
+        handle = allocator.allocate(count);
+    }
+    return handle;
+}
+
+void ChunkArena::upload(Chunk& chunk, std::vector<PackedVertex>& meshVertices, const std::vector<unsigned int>& meshIndices) {
+    //free first so a remesh of about the same size can land back in its own spot
+    release(chunk);
+    if (meshVertices.empty() || meshIndices.empty()) return;
+
+    chunk.vertexBlock = allocate(vertices, VBO, static_cast<uint32_t>(meshVertices.size()), sizeof(PackedVertex), BufferTarget::Vertex);
+    if (chunk.vertexBlock >= MAX_CHUNKS) {
+        std::cerr << "Chunk arena is out of origin slots, chunk not drawn" << std::endl;
+        release(chunk);
+        return;
+    }
+    chunk.indexBlock = allocate(indices, EBO, static_cast<uint32_t>(meshIndices.size()), sizeof(unsigned int), BufferTarget::Index);
+
+    //vertex handles stay the same when blocks move, so they double as the origin slot
+    uint16_t slot = static_cast<uint16_t>(chunk.vertexBlock);
+    for (PackedVertex& vertex : meshVertices) vertex.originSlot = slot;
+    glm::vec4 origin(chunk.chunkPosition, 0.0f);
+    device.bufferSubData(originBuffer, slot * sizeof(glm::vec4), sizeof(glm::vec4), &origin);
+
+    device.bufferSubData(VBO, vertices.offset(chunk.vertexBlock) * sizeof(PackedVertex), meshVertices.size() * sizeof(PackedVertex), meshVertices.data());
+    device.bufferSubData(EBO, indices.offset(chunk.indexBlock) * sizeof(unsigned int), meshIndices.size() * sizeof(unsigned int), meshIndices.data());
+}
+
+void ChunkArena::release(Chunk& chunk) {
+    if (chunk.vertexBlock != 0) vertices.free(chunk.vertexBlock);
+    if (chunk.indexBlock != 0) indices.free(chunk.indexBlock);
+    chunk.vertexBlock = chunk.indexBlock = 0;
+}
+
+void ChunkArena::compact(ArenaAllocator& allocator, unsigned int buffer, size_t elementSize, size_t maxMoves) {
+    //compacted means the last pass found nothing to move, it stays that way until a chunk is uploaded or released
+    if (allocator.compacted() || allocator.fragmentation() < defragThreshold || allocator.freeBlockCount() < 2) return;
+
+    moves.clear();
+    allocator.defragment(maxMoves, moves);
+    for (const ArenaAllocator::Move& move : moves) {
+        size_t bytes = move.size * elementSize;
+        device.copyBufferData(buffer, buffer, move.from * elementSize, move.to * elementSize, bytes);
+        totalMovedBytes += bytes;
+    }
+}
+
+void ChunkArena::maintain(size_t maxMoves) {
+    compact(vertices, VBO, sizeof(PackedVertex), maxMoves);
+    compact(indices, EBO, sizeof(unsigned int), maxMoves);
+}
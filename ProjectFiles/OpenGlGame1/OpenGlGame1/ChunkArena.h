@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include "RenderDevice.h"
+#include "ArenaAllocator.h"
+#include "VertexPacking.h"
+
+class Chunk;
+
+//every chunk mesh lives in one shared vertex buffer + one shared index buffer drawn through a single vao,
+//ArenaAllocator decides where each chunk goes. Chunks keep 0 based indices and draw with a base vertex.
+//Buffers double when full (one gpu copy) and are compacted a few blocks a frame once they get fragmented.
+//Chunk origins live in a buffer texture indexed by each vertex's originSlot (the chunk's vertex handle),
+//so any number of chunks can go in one multi draw without a model matrix each.
+class ChunkArena
+{
+public:
+	ChunkArena(RenderDevice& device, uint32_t initialVertices, uint32_t initialIndices);
+	~ChunkArena();
+
+	void init();//creates the buffers and vao, needs the device ready
+
+	//chunk mesh flattened by the renderer, replaces whatever the chunk had before, stamps originSlot into the vertices
+	void upload(Chunk& chunk, std::vector<PackedVertex>& vertices, const std::vector<unsigned int>& indices);
+	void release(Chunk& chunk);
+
+	//call once a frame before drawing, moves at most maxMoves blocks when fragmentation is above the threshold
+	void maintain(size_t maxMoves);
+
+	unsigned int vertexArray() const { return VAO; }
+	unsigned int originTexture() const { return originTex; }//bind as a samplerBuffer, xyz = chunk origin
+	//where a chunk's blocks (Chunk::vertexBlock / indexBlock) currently are, changes when the arena compacts
+	int baseVertex(unsigned int vertexBlock) const { return static_cast<int>(vertices.offset(vertexBlock)); }
+	size_t firstIndex(unsigned int indexBlock) const { return indices.offset(indexBlock); }
+	size_t indexCount(unsigned int indexBlock) const { return indices.size(indexBlock); }
+
+	const ArenaAllocator& vertexAllocator() const { return vertices; }
+	const ArenaAllocator& indexAllocator() const { return indices; }
+	size_t movedBytes() const { return totalMovedBytes; }//defrag + growth copies since start
+
+	static constexpr float defragThreshold = 0.3f;
+	static const uint32_t MAX_CHUNKS = 1 << 16;//originSlot is 16 bits
+
+private:
+	RenderDevice& device;
+	ArenaAllocator vertices, indices;
+	unsigned int VAO = 0, VBO = 0, EBO = 0;
+	unsigned int originBuffer = 0, originTex = 0;
+	std::vector<ArenaAllocator::Move> moves;//reused scratch
+	size_t totalMovedBytes = 0;
+
+	unsigned int allocate(ArenaAllocator& allocator, unsigned int& buffer, uint32_t count, size_t elementSize, BufferTarget target);
+	void growBuffer(ArenaAllocator& allocator, unsigned int& buffer, uint32_t newCapacity, size_t elementSize, BufferTarget target);
+	void setVertexLayout();
+	void compact(ArenaAllocator& allocator, unsigned int buffer, size_t elementSize, size_t maxMoves);
+};
@@ -0,0 +1,89 @@
+#include "ChunkDrawList.h"
+#include "ChunkRenderRecords.h"
+#include "ChunkArena.h"
+#include "Frustum.h"
+#include "FaceBuckets.h"
+
+void ChunkDrawList::clear() {
+    counts.clear();
+    firsts.clear();
+    bases.clear();
+    indexTotal = 0;
+}
+
+void ChunkDrawList::add(int indexCount, size_t firstIndex, int baseVertex) {
+    if (indexCount <= 0) return;
+    counts.push_back(indexCount);
+    firsts.push_back(firstIndex);
+    bases.push_back(baseVertex);
+    indexTotal += indexCount;
+}
+
+void ChunkDrawList::build(const ChunkRenderRecords& records, const ChunkArena& arena, const Frustum* frustum) {
+    clear();
+    size_t count = records.size();
+    visible.resize(count);
+    size_t visibleCount = count;
+    if (frustum) {
+        visibleCount = frustum->cullBoxes(records.minX.data(), records.minY.data(), records.minZ.data(),
+            records.maxX.data(), records.maxY.data(), records.maxZ.data(), count, visible.data());
+    }
+    else {
+        for (size_t i = 0; i < count; i++) visible[i] = static_cast<uint32_t>(i);
+    }
+
+    visible.resize(visibleCount);
+    addRecords(records, arena, visible);
+}
+
+void ChunkDrawList::build(const ChunkRenderRecords& records, const ChunkArena& arena, const std::vector<uint32_t>& visibleRecords) {
+    clear();
+    addRecords(records, arena, visibleRecords);
+}
+
+void ChunkDrawList::buildFacing(const ChunkRenderRecords& records, const ChunkArena& arena, const std::vector<uint32_t>& visibleRecords, const glm::vec3& eye) {
+    clear();
+    addRecords(records, arena, visibleRecords, FaceFilter::Eye, eye);
+}
+
+void ChunkDrawList::buildFacingDirection(const ChunkRenderRecords& records, const ChunkArena& arena, const std::vector<uint32_t>& visibleRecords, const glm::vec3& viewDirection) {
+    clear();
+    addRecords(records, arena, visibleRecords, FaceFilter::Direction, viewDirection);
+}
+
+void ChunkDrawList::addRecords(const ChunkRenderRecords& records, const ChunkArena& arena, const std::vector<uint32_t>& recordIndices,
+    FaceFilter filter, const glm::vec3& viewer) {
+    unsigned int directionMask = filter == FaceFilter::Direction ? visibleFaceBuckets(viewer) : allFaceBuckets;
+
+    //each record is one section, a contiguous run inside its chunk's index block
+    for (uint32_t i : recordIndices) {
+        if (!records.active[i]) continue;
+        size_t first = arena.firstIndex(records.indexBlocks[i]) + records.firstIndices[i];
+        int base = arena.baseVertex(records.vertexBlocks[i]);
+
+        unsigned int mask = directionMask;
+        if (filter == FaceFilter::Eye) {
+            mask = visibleFaceBuckets(viewer, glm::vec3(records.minX[i], records.minY[i], records.minZ[i]),
+                glm::vec3(records.maxX[i], records.maxY[i], records.maxZ[i]));
+        }
+        if (mask == allFaceBuckets) {
+            add(static_cast<int>(records.indexCounts[i]), first, base);
+            continue;
+        }
+
+        //buckets sit back to back, neighbouring visible ones go out as one range
+        const auto& buckets = records.bucketCounts[i];
+        size_t runStart = first;
+        int runCount = 0;
+        for (int f = 0; f < MeshSection::faceDirections; f++) {
+            if (mask & (1u << f)) {
+                runCount += static_cast<int>(buckets[f]);
+                continue;
+            }
+            add(runCount, runStart, base);
+            runStart += runCount + buckets[f];
+            runCount = 0;
+        }
+        add(runCount, runStart, base);
+    }
+}
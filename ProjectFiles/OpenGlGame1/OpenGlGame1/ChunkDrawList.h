@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class ChunkRenderRecords;
+class ChunkArena;
+class Frustum;
+
+//the chunk section ranges one pass draws, built on the cpu and handed to RenderDevice::multiDrawIndexed in one go
+//no gl in here so the list can be built and checked headless
+class ChunkDrawList
+{
+public:
+	void clear();
+	void add(int indexCount, size_t firstIndex, int baseVertex);
+
+	//every active record whose box is in the frustum, null frustum takes them all
+	void build(const ChunkRenderRecords& records, const ChunkArena& arena, const Frustum* frustum);
+	//the given record indices, already culled (ChunkQuadtree::cull), inactive ones are skipped
+	void build(const ChunkRenderRecords& records, const ChunkArena& arena, const std::vector<uint32_t>& visibleRecords);
+	//same, minus the face buckets that face away from a perspective eye
+	void buildFacing(const ChunkRenderRecords& records, const ChunkArena& arena, const std::vector<uint32_t>& visibleRecords, const glm::vec3& eye);
+	//same, minus the face buckets that face away from an orthographic view direction
+	void buildFacingDirection(const ChunkRenderRecords& records, const ChunkArena& arena, const std::vector<uint32_t>& visibleRecords, const glm::vec3& viewDirection);
+
+	size_t size() const { return counts.size(); }
+	bool empty() const { return counts.empty(); }
+	size_t totalIndices() const { return indexTotal; }
+
+	const int* indexCounts() const { return counts.data(); }
+	const size_t* firstIndices() const { return firsts.data(); }
+	const int* baseVertices() const { return bases.data(); }
+
+private:
+	std::vector<int> counts;
+	std::vector<size_t> firsts;
+	std::vector<int> bases;
+	size_t indexTotal = 0;
+	std::vector<uint32_t> visible;//cull output, reused
+
+	enum class FaceFilter { None, Eye, Direction };
+	void addRecords(const ChunkRenderRecords& records, const ChunkArena& arena, const std::vector<uint32_t>& recordIndices,
+		FaceFilter filter = FaceFilter::None, const glm::vec3& viewer = glm::vec3(0.0f));
+};
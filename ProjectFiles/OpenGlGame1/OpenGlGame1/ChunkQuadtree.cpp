@@ -0,0 +1,213 @@
+#include "ChunkQuadtree.h"
+#include <algorithm>
+#include <cmath>
+#include "ChunkRenderRecords.h"
+#include "Frustum.h"
+#include "Chunk.h"
+
+namespace {
+    //spreads the low 16 bits out to the even bits
+    uint32_t spreadBits(uint32_t v) {
+        v &= 0xFFFF;
+        v = (v | (v << 8)) & 0x00FF00FF;
+        v = (v | (v << 4)) & 0x0F0F0F0F;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+
+    int highestBit(uint32_t v) {
+        int bit = 0;
+        while (v >>= 1) bit++;
+        return bit;
+    }
+}
+
+void ChunkQuadtree::update(const ChunkRenderRecords& records) {
+    if (records.structureVersion() != builtStructure) {
+        rebuild(records);
+    }
+    else if (records.boundsVersion() != builtBounds) {
+        refit(records);
+    }
+    builtStructure = records.structureVersion();
+    builtBounds = records.boundsVersion();
+}
+
+bool ChunkQuadtree::heightRange(float& bottom, float& top) const {
+    if (nodes.empty()) return false;
+    bottom = nodes[0].bounds[1];
+    top = nodes[0].bounds[4];
+    return true;
+}
+
+void ChunkQuadtree::rebuild(const ChunkRenderRecords& records) {
+    nodes.clear();
+    order.clear();
+    keys.clear();
+    size_t count = records.size();
+    if (count == 0) return;
+
+    //chunk grid coords relative to the lowest loaded chunk, so they are small and positive
+    int lowX = INT32_MAX, lowZ = INT32_MAX;
+    for (size_t i = 0; i < count; i++) {
+        lowX = std::min(lowX, static_cast<int>(std::floor(records.minX[i] / Chunk::chunkSize)));
+        lowZ = std::min(lowZ, static_cast<int>(std::floor(records.minZ[i] / Chunk::chunkSize)));
+    }
+    keys.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t x = static_cast<uint32_t>(static_cast<int>(std::floor(records.minX[i] / Chunk::chunkSize)) - lowX);
+        uint32_t z = static_cast<uint32_t>(static_cast<int>(std::floor(records.minZ[i] / Chunk::chunkSize)) - lowZ);
+        uint64_t morton = spreadBits(x) | (spreadBits(z) << 1);
+        keys[i] = (morton << 32) | i;
+    }
+
+    //radix sort on the morton half, a byte per pass, this runs whenever a chunk is added or removed
+    sortScratch.resize(count);
+    for (int shift = 32; shift < 64; shift += 8) {
+        size_t offsets[257] = {};
+        for (uint64_t key : keys) offsets[((key >> shift) & 0xFF) + 1]++;
+        if (offsets[((keys[0] >> shift) & 0xFF) + 1] == count) continue;//every key has the same byte here
+        for (int digit = 0; digit < 256; digit++) offsets[digit + 1] += offsets[digit];
+        for (uint64_t key : keys) sortScratch[offsets[(key >> shift) & 0xFF]++] = key;
+        keys.swap(sortScratch);
+    }
+
+    order.resize(count);
+    for (size_t i = 0; i < count; i++) order[i] = static_cast<uint32_t>(keys[i] & 0xFFFFFFFF);
+    copyBoxes(records);
+
+    nodes.push_back(Node());
+    buildNode(0, 0, static_cast<uint32_t>(count));
+}
+
+void ChunkQuadtree::buildNode(int index, uint32_t begin, uint32_t end) {
+    nodes[index].begin = begin;
+    nodes[index].end = end;
+    nodes[index].firstChild = -1;
+    nodes[index].childCount = 0;
+
+    //keys are sorted, so the highest bit where the first and last differ is the level this range splits at
+    uint32_t first = static_cast<uint32_t>(keys[begin] >> 32);
+    uint32_t last = static_cast<uint32_t>(keys[end - 1] >> 32);
+    if (end - begin > static_cast<uint32_t>(LEAF_SIZE) && first != last) {
+        int shift = (highestBit(first ^ last) / 2) * 2;
+        uint32_t splits[5];
+        splits[4] = end;
+        int childCount = 0;
+        uint32_t at = begin;
+        for (uint32_t quadrant = 0; quadrant < 4; quadrant++) {
+            splits[quadrant] = at;
+            while (at < end && ((keys[at] >> (32 + shift)) & 3) == quadrant) at++;
+            if (at > splits[quadrant]) childCount++;
+        }
+
+        int firstChild = static_cast<int>(nodes.size());
+        nodes[index].firstChild = firstChild;
+        nodes[index].childCount = childCount;
+        nodes.resize(nodes.size() + childCount);
+
+        int child = firstChild;
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            if (splits[quadrant + 1] == splits[quadrant]) continue;
+            buildNode(child++, splits[quadrant], splits[quadrant + 1]);
+        }
+    }
+    fitNode(index);
+}
+
+void ChunkQuadtree::copyBoxes(const ChunkRenderRecords& records) {
+    size_t count = order.size();
+    minX.resize(count); minY.resize(count); minZ.resize(count);
+    maxX.resize(count); maxY.resize(count); maxZ.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t r = order[i];
+        minX[i] = records.minX[r]; minY[i] = records.minY[r]; minZ[i] = records.minZ[r];
+        maxX[i] = records.maxX[r]; maxY[i] = records.maxY[r]; maxZ[i] = records.maxZ[r];
+    }
+}
+
+void ChunkQuadtree::fitNode(int index) {
+    Node& node = nodes[index];
+    float* b = node.bounds;
+    b[0] = b[1] = b[2] = INFINITY;
+    b[3] = b[4] = b[5] = -INFINITY;
+    if (node.firstChild == -1) {
+        for (uint32_t i = node.begin; i < node.end; i++) {
+            b[0] = std::min(b[0], minX[i]); b[3] = std::max(b[3], maxX[i]);
+            b[1] = std::min(b[1], minY[i]); b[4] = std::max(b[4], maxY[i]);
+            b[2] = std::min(b[2], minZ[i]); b[5] = std::max(b[5], maxZ[i]);
+        }
+        return;
+    }
+    for (int c = node.firstChild; c < node.firstChild + node.childCount; c++) {
+        const float* child = nodes[c].bounds;
+        for (int k = 0; k < 3; k++) {
+            b[k] = std::min(b[k], child[k]);
+            b[k + 3] = std::max(b[k + 3], child[k + 3]);
+        }
+    }
+}
+
+void ChunkQuadtree::refit(const ChunkRenderRecords& records) {
+    //children are always after their parent, so going backwards fits every child first
+    copyBoxes(records);
+    for (int i = static_cast<int>(nodes.size()) - 1; i >= 0; i--) {
+        fitNode(i);
+    }
+}
+
+size_t ChunkQuadtree::cull(const Frustum& frustum, std::vector<uint32_t>& visible) {
+    for (int p = 0; p < 6; p++) {
+        const glm::vec4& plane = frustum.planes[p];
+        CullPlane& cullPlane = cullPlanes[p];
+        cullPlane = { plane.x, plane.y, plane.z, plane.w, { 0, 1, 2 }, { 3, 4, 5 } };
+        for (int k = 0; k < 3; k++) {
+            if (plane[k] > 0) std::swap(cullPlane.outer[k], cullPlane.inner[k]);
+        }
+    }
+
+    size_t before = visible.size();
+    visited = 0;
+    cullFrustum = &frustum;
+    leafVisible.resize(LEAF_SIZE);
+    if (!nodes.empty()) cullNode(0, 0x3F, visible);
+    return visible.size() - before;
+}
+
+void ChunkQuadtree::cullNode(int index, unsigned int planeMask, std::vector<uint32_t>& visible) {
+    const Node& node = nodes[index];
+    const float* b = node.bounds;
+    visited++;
+
+    for (int p = 0; p < 6; p++) {
+        if (!(planeMask & (1u << p))) continue;
+        const CullPlane& plane = cullPlanes[p];
+        //corner furthest along the normal decides outside, the opposite corner decides fully inside
+        if (plane.w + plane.x * b[plane.outer[0]] + plane.y * b[plane.outer[1]] + plane.z * b[plane.outer[2]] < 0) return;
+        if (plane.w + plane.x * b[plane.inner[0]] + plane.y * b[plane.inner[1]] + plane.z * b[plane.inner[2]] >= 0) {
+            planeMask &= ~(1u << p);
+        }
+    }
+
+    if (planeMask == 0) {
+        takeAll(node, visible);
+        return;
+    }
+    if (node.firstChild != -1) {
+        for (int c = node.firstChild; c < node.firstChild + node.childCount; c++) {
+            cullNode(c, planeMask, visible);
+        }
+        return;
+    }
+
+    //leaf, only the planes it straddles are left to test
+    uint32_t b0 = node.begin;
+    size_t found = cullFrustum->cullBoxes(&minX[b0], &minY[b0], &minZ[b0], &maxX[b0], &maxY[b0], &maxZ[b0],
+        node.end - b0, leafVisible.data(), planeMask);
+    for (size_t i = 0; i < found; i++) visible.push_back(order[b0 + leafVisible[i]]);
+}
+
+void ChunkQuadtree::takeAll(const Node& node, std::vector<uint32_t>& visible) const {
+    visible.insert(visible.end(), order.begin() + node.begin, order.begin() + node.end);
+}
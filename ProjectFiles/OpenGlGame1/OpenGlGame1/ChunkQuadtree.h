@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class ChunkRenderRecords;
+class Frustum;
+
+//quadtree over the chunk grid of a ChunkRenderRecords, each node has the box around everything under it
+//(so its height is the tallest chunk below). Culling descends from the root and drops a plane from the
+//test mask once a node is fully on the inside of it, so whole visible quadrants are taken without
+//testing their chunks and the work follows the visible chunks instead of the loaded ones.
+//Leaves are small patches of chunks tested together with the sse kernel against the planes left.
+class ChunkQuadtree
+{
+public:
+	//rebuilds if records were added or removed, refits the boxes if only bounds changed, otherwise nothing
+	void update(const ChunkRenderRecords& records);
+
+	//appends the record index of every chunk in or touching the frustum, returns how many
+	//inactive records are not filtered here, ChunkDrawList skips them
+	size_t cull(const Frustum& frustum, std::vector<uint32_t>& visible);
+
+	//lowest and highest point of any record, false when there are none
+	bool heightRange(float& bottom, float& top) const;
+
+	size_t nodeCount() const { return nodes.size(); }
+	size_t nodesVisited() const { return visited; }//by the last cull
+
+	static const int LEAF_SIZE = 64;//chunks, an 8x8 patch tested with Frustum::cullBoxes
+
+private:
+	struct Node {
+		float bounds[6];//min xyz then max xyz
+		uint32_t begin, end;//range of order[] under this node
+		int firstChild;//children are contiguous, -1 for a leaf
+		int childCount;
+	};
+
+	//plane with its corners picked once per cull, indexes into Node::bounds
+	struct CullPlane {
+		float x, y, z, w;
+		int outer[3];//furthest along the normal
+		int inner[3];//opposite corner
+	};
+	CullPlane cullPlanes[6];
+
+	std::vector<Node> nodes;//parents always before their children
+	std::vector<uint32_t> order;//record indices sorted along a z curve so every node covers one range
+	std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;//record boxes in order[] order, so leaves are contiguous
+	std::vector<uint32_t> leafVisible;//cull scratch
+	const Frustum* cullFrustum = nullptr;
+	std::vector<uint64_t> keys, sortScratch;//build scratch, morton code << 32 | record index
+	uint64_t builtStructure = ~0ull, builtBounds = ~0ull;
+	size_t visited = 0;
+
+	void rebuild(const ChunkRenderRecords& records);
+	void refit(const ChunkRenderRecords& records);
+	void copyBoxes(const ChunkRenderRecords& records);
+	void fitNode(int index);
+	void buildNode(int index, uint32_t begin, uint32_t end);
+	void cullNode(int index, unsigned int planeMask, std::vector<uint32_t>& visible);
+	void takeAll(const Node& node, std::vector<uint32_t>& visible) const;
+};
@@ -0,0 +1,126 @@
+#include "ChunkRenderRecords.h"
+#include <algorithm>
+
+void ChunkRenderRecords::update(const Chunk* chunk, const glm::vec3& origin, const MeshSection* sections, size_t sectionCount,
+    unsigned int vertexBlock, unsigned int indexBlock, bool isActive) {
+    size_t used = 0;
+    for (size_t s = 0; s < sectionCount; s++) {
+        if (sections[s].indexCount > 0) used++;
+    }
+    if (used == 0) {
+        remove(chunk);
+        return;
+    }
+
+    //same number of sections is the common remesh, overwrite in place so the cull structures only refit
+    auto it = indexOf.find(chunk);
+    if (it != indexOf.end() && it->second.size() != used) {
+        remove(chunk);
+        it = indexOf.end();
+    }
+    if (it == indexOf.end()) {
+        std::vector<uint32_t>& owned = indexOf[chunk];
+        for (size_t n = 0; n < used; n++) {
+            owned.push_back(static_cast<uint32_t>(chunks.size()));
+            chunks.push_back(chunk);
+            push();
+        }
+        it = indexOf.find(chunk);
+        structure++;
+    }
+    else {
+        bounds++;
+    }
+
+    size_t n = 0;
+    for (size_t s = 0; s < sectionCount; s++) {
+        const MeshSection& section = sections[s];
+        if (section.indexCount == 0) continue;
+        uint32_t i = it->second[n++];
+        glm::vec3 min = origin + glm::vec3(section.min);
+        glm::vec3 max = origin + glm::vec3(section.max);
+        minX[i] = min.x; minY[i] = min.y; minZ[i] = min.z;
+        maxX[i] = max.x; maxY[i] = max.y; maxZ[i] = max.z;
+        vertexBlocks[i] = vertexBlock;
+        indexBlocks[i] = indexBlock;
+        firstIndices[i] = section.firstIndex;
+        indexCounts[i] = section.indexCount;
+        std::copy(section.bucketCounts, section.bucketCounts + MeshSection::faceDirections, bucketCounts[i].begin());
+        active[i] = isActive ? 1 : 0;
+        sectionIndices[i] = static_cast<uint8_t>(s);
+    }
+}
+
+void ChunkRenderRecords::push() {
+    minX.push_back(0); minY.push_back(0); minZ.push_back(0);
+    maxX.push_back(0); maxY.push_back(0); maxZ.push_back(0);
+    vertexBlocks.push_back(0);
+    indexBlocks.push_back(0);
+    firstIndices.push_back(0);
+    indexCounts.push_back(0);
+    bucketCounts.push_back({});
+    active.push_back(0);
+    sectionIndices.push_back(0);
+}
+
+void ChunkRenderRecords::remove(const Chunk* chunk) {
+    auto it = indexOf.find(chunk);
+    if (it == indexOf.end()) return;
+
+    //highest first, so the record swapped into a gap is never one of this chunk's
+    std::vector<uint32_t> owned = std::move(it->second);
+    indexOf.erase(it);
+    std::sort(owned.begin(), owned.end(), [](uint32_t a, uint32_t b) { return a > b; });
+    for (uint32_t i : owned) removeAt(i);
+    structure++;
+}
+
+void ChunkRenderRecords::removeAt(uint32_t i) {
+    uint32_t last = static_cast<uint32_t>(chunks.size() - 1);
+    if (i != last) {
+        chunks[i] = chunks[last];
+        minX[i] = minX[last]; minY[i] = minY[last]; minZ[i] = minZ[last];
+        maxX[i] = maxX[last]; maxY[i] = maxY[last]; maxZ[i] = maxZ[last];
+        vertexBlocks[i] = vertexBlocks[last];
+        indexBlocks[i] = indexBlocks[last];
+        firstIndices[i] = firstIndices[last];
+        indexCounts[i] = indexCounts[last];
+        bucketCounts[i] = bucketCounts[last];
+        active[i] = active[last];
+        sectionIndices[i] = sectionIndices[last];
+        for (uint32_t& index : indexOf[chunks[i]]) {
+            if (index == last) index = i;
+        }
+    }
+    chunks.pop_back();
+    minX.pop_back(); minY.pop_back(); minZ.pop_back();
+    maxX.pop_back(); maxY.pop_back(); maxZ.pop_back();
+    vertexBlocks.pop_back();
+    indexBlocks.pop_back();
+    firstIndices.pop_back();
+    indexCounts.pop_back();
+    bucketCounts.pop_back();
+    active.pop_back();
+    sectionIndices.pop_back();
+}
+
+void ChunkRenderRecords::setActive(const Chunk* chunk, bool isActive) {
+    auto it = indexOf.find(chunk);
+    if (it == indexOf.end()) return;
+    for (uint32_t i : it->second) active[i] = isActive ? 1 : 0;
+}
+
+void ChunkRenderRecords::clear() {
+    structure++;
+    chunks.clear();
+    indexOf.clear();
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+    vertexBlocks.clear();
+    indexBlocks.clear();
+    firstIndices.clear();
+    indexCounts.clear();
+    bucketCounts.clear();
+    active.clear();
+    sectionIndices.clear();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include "MeshData.h"
+
+class Chunk;
+
+//what the renderer needs to cull and draw each uploaded mesh section, packed per field so culling
+//streams through a few flat arrays instead of the chunk map. A chunk owns one record per non empty
+//section, each with its own tight box. Kept in step by the renderer on upload, release and when world
+//flips a chunk active / inactive. Draw ranges are arena handles plus an offset into the index block,
+//looked up at draw time so defrag moves need no update here.
+class ChunkRenderRecords
+{
+public:
+	//insert or replace the chunk's records, section boxes are chunk local and offset by origin
+	void update(const Chunk* chunk, const glm::vec3& origin, const MeshSection* sections, size_t sectionCount,
+		unsigned int vertexBlock, unsigned int indexBlock, bool active);
+	void remove(const Chunk* chunk);//swaps the last records into the gaps
+	void setActive(const Chunk* chunk, bool active);
+	void clear();
+
+	size_t size() const { return chunks.size(); }
+	size_t chunkCount() const { return indexOf.size(); }
+	uint64_t structureVersion() const { return structure; }//bumped when records are added or removed
+	uint64_t boundsVersion() const { return bounds; }//bumped when existing records are updated
+
+	//soa, all size() long
+	std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+	std::vector<unsigned int> vertexBlocks, indexBlocks;
+	std::vector<unsigned int> firstIndices, indexCounts;//section range inside the index block
+	std::vector<std::array<unsigned int, MeshSection::faceDirections>> bucketCounts;//face direction split of that range
+	std::vector<uint8_t> active;
+	std::vector<uint8_t> sectionIndices;//which of the chunk's MeshData::sections
+
+	const Chunk* owner(size_t i) const { return chunks[i]; }
+
+private:
+	std::vector<const Chunk*> chunks;//owner of each record
+	std::unordered_map<const Chunk*, std::vector<uint32_t>> indexOf;
+	uint64_t structure = 0, bounds = 0;
+
+	void push();
+	void removeAt(uint32_t i);
+};
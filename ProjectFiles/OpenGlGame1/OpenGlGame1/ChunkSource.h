@@ -0,0 +1,15 @@
+#pragma once
+#include <glm/glm.hpp>
+
+class Chunk;
+class TerrainGenerator;
+
+//what a chunk needs from whoever owns it, lets chunks be built by the game or by headless tools
+class ChunkSource
+{
+public:
+	virtual ~ChunkSource() {}
+
+	virtual Chunk* getChunk(const glm::vec3& pos) = 0;//chunk at a world space chunk position, nullptr if not loaded
+	virtual TerrainGenerator& getTerrain() = 0;
+};
@@ -0,0 +1,194 @@
+#include "EntityGrid.h"
+#include "Chunk.h"
+#include "Vec3Hash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+static_assert(EntityGrid::CELL_SIZE == Chunk::chunkSize, "entity cells have to line up with chunk columns");
+
+int EntityGrid::cellOf(float coordinate) {
+    return static_cast<int>(std::floor(coordinate / CELL_SIZE));
+}
+
+const EntityGrid::Cell* EntityGrid::findCell(int cellX, int cellZ) const {
+    auto it = cells.find(getChunkKey(cellX, cellZ));
+    return it != cells.end() ? &it->second : nullptr;
+}
+
+void EntityGrid::addTo(uint64_t key, EntityId id, const glm::vec3& position) {
+    auto made = cells.try_emplace(key);
+    Cell& cell = made.first->second;
+    if (made.second) {
+        int cellX = cellOf(position.x), cellZ = cellOf(position.z);
+        bool first = cells.size() == 1;
+        minCellX = first ? cellX : std::min(minCellX, cellX);
+        maxCellX = first ? cellX : std::max(maxCellX, cellX);
+        minCellZ = first ? cellZ : std::min(minCellZ, cellZ);
+        maxCellZ = first ? cellZ : std::max(maxCellZ, cellZ);
+    }
+    Location& location = locations[id.index];
+    location.cell = &cell;
+    location.key = key;
+    location.slot = static_cast<uint32_t>(cell.ids.size());
+    location.generation = id.generation;
+    cell.ids.push_back(id);
+    cell.positions.push_back(position);
+    count++;
+}
+
+//the last entity of the cell fills the hole
+void EntityGrid::removeFrom(Location& location) {
+    Cell& cell = *location.cell;
+    uint32_t last = static_cast<uint32_t>(cell.ids.size() - 1);
+    if (location.slot != last) {
+        cell.ids[location.slot] = cell.ids[last];
+        cell.positions[location.slot] = cell.positions[last];
+        locations[cell.ids[location.slot].index].slot = location.slot;
+    }
+    cell.ids.pop_back();
+    cell.positions.pop_back();
+    location.cell = nullptr;
+    count--;
+}
+
+void EntityGrid::insert(EntityId id, const glm::vec3& position) {
+    if (id.index >= locations.size()) locations.resize(id.index + 1);
+    //a slot still held by an older generation means that entity is gone
+    if (locations[id.index].cell) removeFrom(locations[id.index]);
+    addTo(getChunkKey(cellOf(position.x), cellOf(position.z)), id, position);
+}
+
+void EntityGrid::move(EntityId id, const glm::vec3& position) {
+    if (!contains(id)) {
+        insert(id, position);
+        return;
+    }
+    Location& location = locations[id.index];
+    uint64_t key = getChunkKey(cellOf(position.x), cellOf(position.z));
+    if (key == location.key) {
+        location.cell->positions[location.slot] = position;
+        return;
+    }
+    removeFrom(location);
+    addTo(key, id, position);
+}
+
+void EntityGrid::remove(EntityId id) {
+    if (contains(id)) removeFrom(locations[id.index]);
+}
+
+void EntityGrid::clear() {
+    for (auto& pair : cells) {
+        pair.second.ids.clear();
+        pair.second.positions.clear();
+    }
+    for (Location& location : locations) location.cell = nullptr;
+    count = 0;
+}
+
+void EntityGrid::rebuild(const EntityStore& store) {
+    clear();
+    for (size_t i = 0; i < store.size(); i++) {
+        insert(store.ids[i], glm::vec3(store.posX[i], store.posY[i], store.posZ[i]));
+    }
+}
+
+bool EntityGrid::contains(EntityId id) const {
+    return id.index < locations.size() && locations[id.index].cell && locations[id.index].generation == id.generation;
+}
+
+size_t EntityGrid::queryRange(const glm::vec3& center, float radius, std::vector<EntityId>& found) const {
+    size_t before = found.size();
+    float radiusSquared = radius * radius;
+    for (int x = cellOf(center.x - radius); x <= cellOf(center.x + radius); x++) {
+        for (int z = cellOf(center.z - radius); z <= cellOf(center.z + radius); z++) {
+            const Cell* cell = findCell(x, z);
+            if (!cell) continue;
+            for (size_t i = 0; i < cell->ids.size(); i++) {
+                glm::vec3 offset = cell->positions[i] - center;
+                if (glm::dot(offset, offset) <= radiusSquared) found.push_back(cell->ids[i]);
+            }
+        }
+    }
+    return found.size() - before;
+}
+
+size_t EntityGrid::queryBox(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<EntityId>& found) const {
+    size_t before = found.size();
+    for (int x = cellOf(boxMin.x); x <= cellOf(boxMax.x); x++) {
+        for (int z = cellOf(boxMin.z); z <= cellOf(boxMax.z); z++) {
+            const Cell* cell = findCell(x, z);
+            if (!cell) continue;
+            for (size_t i = 0; i < cell->ids.size(); i++) {
+                const glm::vec3& p = cell->positions[i];
+                if (p.x >= boxMin.x && p.y >= boxMin.y && p.z >= boxMin.z && p.x <= boxMax.x && p.y <= boxMax.y && p.z <= boxMax.z) {
+                    found.push_back(cell->ids[i]);
+                }
+            }
+        }
+    }
+    return found.size() - before;
+}
+
+//rings of cells outward from the center's cell, keeping the k best in a max heap. Every cell in ring r is at
+//least r - 1 cells away, so once that is past the worst of a full heap nothing further out can get in. Past the
+//ring that takes in every cell made there is nothing left either, which bounds an infinite maxDistance and a
+//large one with fewer than k entities in reach
+size_t EntityGrid::queryNearest(const glm::vec3& center, size_t k, float maxDistance, std::vector<EntityId>& found) const {
+    if (k == 0 || count == 0 || !(maxDistance >= 0.0f)) return 0;
+    std::vector<std::pair<float, EntityId>>& best = nearestScratch;
+    best.clear();
+    auto further = [](const std::pair<float, EntityId>& a, const std::pair<float, EntityId>& b) { return a.first < b.first; };
+    float maxSquared = maxDistance * maxDistance;
+
+    auto visit = [&](int x, int z) {
+        const Cell* cell = findCell(x, z);
+        if (!cell) return;
+        for (size_t i = 0; i < cell->ids.size(); i++) {
+            glm::vec3 offset = cell->positions[i] - center;
+            float distanceSquared = glm::dot(offset, offset);
+            if (distanceSquared > maxSquared) continue;
+            if (best.size() < k) {
+                best.push_back({ distanceSquared, cell->ids[i] });
+                std::push_heap(best.begin(), best.end(), further);
+            }
+            else if (distanceSquared < best.front().first) {
+                std::pop_heap(best.begin(), best.end(), further);
+                best.back() = { distanceSquared, cell->ids[i] };
+                std::push_heap(best.begin(), best.end(), further);
+            }
+        }
+    };
+
+    //in 64 bits, a center far off can be more than an int of cells from the cells made. Rings are cut to their bounds
+    int64_t centerX = cellOf(center.x), centerZ = cellOf(center.z);
+    int64_t first = std::max(std::max(minCellX - centerX, centerX - maxCellX), std::max(minCellZ - centerZ, centerZ - maxCellZ));
+    int64_t last = std::max(std::max(centerX - minCellX, maxCellX - centerX), std::max(centerZ - minCellZ, maxCellZ - centerZ));
+    double reachable = std::ceil(static_cast<double>(maxDistance) / CELL_SIZE) + 1.0;
+    if (reachable < static_cast<double>(last)) last = static_cast<int64_t>(reachable);
+    for (int64_t ring = std::max<int64_t>(first, 0); ring <= last; ring++) {
+        float reach = static_cast<float>((ring - 1) * CELL_SIZE);
+        if (reach > 0.0f && best.size() == k && reach * reach > best.front().first) break;
+        int64_t lowX = std::max(centerX - ring, int64_t(minCellX)), highX = std::min(centerX + ring, int64_t(maxCellX));
+        int64_t lowZ = std::max(centerZ - ring + 1, int64_t(minCellZ)), highZ = std::min(centerZ + ring - 1, int64_t(maxCellZ));
+        for (int64_t x = lowX; x <= highX; x++) {
+            if (centerZ - ring >= minCellZ) visit(static_cast<int>(x), static_cast<int>(centerZ - ring));
+            if (ring > 0 && centerZ + ring <= maxCellZ) visit(static_cast<int>(x), static_cast<int>(centerZ + ring));
+        }
+        for (int64_t z = lowZ; z <= highZ; z++) {
+            if (centerX - ring >= minCellX) visit(static_cast<int>(centerX - ring), static_cast<int>(z));
+            if (centerX + ring <= maxCellX) visit(static_cast<int>(centerX + ring), static_cast<int>(z));
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end(), further);
+    for (const auto& entry : best) found.push_back(entry.second);
+    return best.size();
+}
+
+const std::vector<EntityId>& EntityGrid::chunkEntities(int chunkX, int chunkZ) const {
+    static const std::vector<EntityId> none;
+    const Cell* cell = findCell(chunkX, chunkZ);
+    return cell ? cell->ids : none;
+}
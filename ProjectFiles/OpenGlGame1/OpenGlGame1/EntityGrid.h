@@ -0,0 +1,62 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "EntityStore.h"
+
+//uniform grid over the entities, one cell per chunk column keyed like World::chunks, so a chunk's entities are
+//one list. Every cell keeps its entities' handles and positions side by side so a query reads the cells it
+//overlaps and never goes back to the store. Entities are added, moved and removed one at a time and moving
+//inside a cell is just a position write; cells are kept once made so crossing back and forth never allocates.
+//Queries ignore height when picking cells and test the full 3d position. No gl in here
+class EntityGrid
+{
+public:
+	void insert(EntityId id, const glm::vec3& position);
+	void move(EntityId id, const glm::vec3& position);//inserts if it was not in the grid
+	void remove(EntityId id);//ignored if it is not in the grid
+	void clear();
+	void rebuild(const EntityStore& store);//everything in the store, nothing else
+	bool contains(EntityId id) const;
+	size_t size() const { return count; }
+	size_t cellCount() const { return cells.size(); }
+
+	//each appends every entity inside and returns how many it appended
+	size_t queryRange(const glm::vec3& center, float radius, std::vector<EntityId>& found) const;
+	size_t queryBox(const glm::vec3& boxMin, const glm::vec3& boxMax, std::vector<EntityId>& found) const;
+	//the k closest within maxDistance, nearest first. maxDistance can be infinite or FLT_MAX for the k closest
+	//anywhere, the search never goes past the cells that have been made
+	size_t queryNearest(const glm::vec3& center, size_t k, float maxDistance, std::vector<EntityId>& found) const;
+
+	//everything in chunk column (chunkX, chunkZ), for taking entities out and putting them back with their chunk
+	const std::vector<EntityId>& chunkEntities(int chunkX, int chunkZ) const;
+
+	static constexpr int CELL_SIZE = 16;//blocks, Chunk::chunkSize
+
+private:
+	struct Cell {
+		std::vector<EntityId> ids;
+		std::vector<glm::vec3> positions;
+	};
+
+	//where each entity slot sits, by EntityId::index. Cells are map nodes so the pointer survives rehashing
+	struct Location {
+		Cell* cell = nullptr;
+		uint64_t key = 0;
+		uint32_t slot = 0;
+		uint32_t generation = 0;
+	};
+
+	std::unordered_map<uint64_t, Cell> cells;
+	std::vector<Location> locations;
+	size_t count = 0;
+	int minCellX = 0, maxCellX = -1, minCellZ = 0, maxCellZ = -1;//bounds of every cell made, empty while none are
+	mutable std::vector<std::pair<float, EntityId>> nearestScratch;//so nearest queries are one thread at a time
+
+	static int cellOf(float coordinate);
+	const Cell* findCell(int cellX, int cellZ) const;
+	void addTo(uint64_t key, EntityId id, const glm::vec3& position);
+	void removeFrom(Location& location);
+};
@@ -0,0 +1,146 @@
+#include "EntityStore.h"
+#include <cmath>
+#include <utility>
+
+EntityId EntityStore::create(uint32_t model, const glm::vec3& position, float health) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<uint32_t>(dense.size());
+        dense.push_back(NONE);
+        generations.push_back(0);
+    }
+    EntityId id{ slot, generations[slot] };
+    dense[slot] = static_cast<uint32_t>(ids.size());
+
+    ids.push_back(id);
+    posX.push_back(position.x);
+    posY.push_back(position.y);
+    posZ.push_back(position.z);
+    velX.push_back(0.0f);
+    velY.push_back(0.0f);
+    velZ.push_back(0.0f);
+    yaw.push_back(0.0f);
+    this->health.push_back(health);
+    maxHealth.push_back(health);
+    models.push_back(model);
+    aiStates.push_back(AIState::Idle);
+    aiTimers.push_back(0.0f);//picks on its first update
+    nextSeed = nextSeed * 1664525u + 1013904223u;
+    aiSeeds.push_back(nextSeed | 1u);//xorshift state must not be 0
+    updatedAt.push_back(-1.0);
+    return id;
+}
+
+void EntityStore::destroy(EntityId id) {
+    if (!alive(id)) return;
+    uint32_t hole = dense[id.index];
+    uint32_t last = static_cast<uint32_t>(ids.size() - 1);
+
+    //move the last entity into the hole, then drop the last element of every array
+    auto fill = [hole, last](auto& array) {
+        array[hole] = array[last];
+        array.pop_back();
+    };
+    fill(ids);
+    fill(posX);
+    fill(posY);
+    fill(posZ);
+    fill(velX);
+    fill(velY);
+    fill(velZ);
+    fill(yaw);
+    fill(health);
+    fill(maxHealth);
+    fill(models);
+    fill(aiStates);
+    fill(aiTimers);
+    fill(aiSeeds);
+    fill(updatedAt);
+    if (hole != last) dense[ids[hole].index] = hole;
+
+    dense[id.index] = NONE;
+    generations[id.index]++;
+    freeSlots.push_back(id.index);
+}
+
+void EntityStore::clear() {
+    for (const EntityId& id : ids) {
+        dense[id.index] = NONE;
+        generations[id.index]++;
+        freeSlots.push_back(id.index);
+    }
+    ids.clear();
+    posX.clear();
+    posY.clear();
+    posZ.clear();
+    velX.clear();
+    velY.clear();
+    velZ.clear();
+    yaw.clear();
+    health.clear();
+    maxHealth.clear();
+    models.clear();
+    aiStates.clear();
+    aiTimers.clear();
+    aiSeeds.clear();
+    updatedAt.clear();
+}
+
+void EntityStore::swap(size_t a, size_t b) {
+    if (a == b) return;
+    auto exchange = [a, b](auto& array) { std::swap(array[a], array[b]); };
+    exchange(ids);
+    exchange(posX);
+    exchange(posY);
+    exchange(posZ);
+    exchange(velX);
+    exchange(velY);
+    exchange(velZ);
+    exchange(yaw);
+    exchange(health);
+    exchange(maxHealth);
+    exchange(models);
+    exchange(aiStates);
+    exchange(aiTimers);
+    exchange(aiSeeds);
+    exchange(updatedAt);
+    dense[ids[a].index] = static_cast<uint32_t>(a);
+    dense[ids[b].index] = static_cast<uint32_t>(b);
+}
+
+bool EntityStore::alive(EntityId id) const {
+    return id.index < dense.size() && dense[id.index] != NONE && generations[id.index] == id.generation;
+}
+
+size_t EntityStore::indexOf(EntityId id) const {
+    return dense[id.index];
+}
+
+uint32_t EntityStore::modelHandle(const std::string& path) {
+    for (size_t i = 0; i < modelPaths.size(); i++) {
+        if (modelPaths[i] == path) return static_cast<uint32_t>(i);
+    }
+    modelPaths.push_back(path);
+    return static_cast<uint32_t>(modelPaths.size() - 1);
+}
+
+void EntityStore::changeHealth(EntityId id, float amount) {
+    if (!alive(id)) return;
+    size_t i = dense[id.index];
+    health[i] = std::fmin(health[i] + amount, maxHealth[i]);
+}
+
+//written out since it runs for every entity every frame
+glm::mat4 EntityStore::modelMatrix(size_t i) const {
+    float c = std::cos(yaw[i]) * MODEL_SCALE;
+    float s = std::sin(yaw[i]) * MODEL_SCALE;
+    return glm::mat4(
+        c, 0.0f, -s, 0.0f,
+        0.0f, MODEL_SCALE, 0.0f, 0.0f,
+        s, 0.0f, c, 0.0f,
+        posX[i], posY[i], posZ[i], 1.0f);
+}
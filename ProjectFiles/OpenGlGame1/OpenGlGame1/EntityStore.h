@@ -0,0 +1,61 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+//handle to an entity, the generation goes up every time its slot is reused so old handles stop resolving
+struct EntityId {
+	uint32_t index = 0;
+	uint32_t generation = 0;
+	bool operator==(const EntityId& other) const { return index == other.index && generation == other.generation; }
+};
+
+enum class AIState : uint8_t { Idle, Wander };
+
+//every mob in the world as a sparse set: handles map through a slot table to a dense index, and every
+//component is its own array over the dense range, so a system reads only the fields it needs front to back.
+//Destroying swaps the last entity into the hole, so dense indices are only stable until the next destroy.
+//No gl, the renderer reads the transforms and model handles straight out of the arrays
+class EntityStore
+{
+public:
+	EntityId create(uint32_t model, const glm::vec3& position, float health);
+	void destroy(EntityId id);//stale handles are ignored
+	void clear();
+	bool alive(EntityId id) const;
+	size_t indexOf(EntityId id) const;//dense index, the handle must be alive
+	size_t size() const { return ids.size(); }
+	void swap(size_t a, size_t b);//exchange two dense slots, handles follow their entity
+
+	//render handles, one per model path, the renderer resolves each once
+	uint32_t modelHandle(const std::string& path);
+	const std::string& modelPath(uint32_t model) const { return modelPaths[model]; }
+	size_t modelCount() const { return modelPaths.size(); }
+
+	void changeHealth(EntityId id, float amount);//clamped to max health, 0 or less and the health system removes it
+	glm::mat4 modelMatrix(size_t i) const;//translate, turn about y, scale
+
+	static constexpr float MODEL_SCALE = 4.0f;
+
+	//components, all size() long, index i is the same entity in every array
+	std::vector<EntityId> ids;
+	std::vector<float> posX, posY, posZ;
+	std::vector<float> velX, velY, velZ;
+	std::vector<float> yaw;//radians, 0 faces +z
+	std::vector<float> health, maxHealth;
+	std::vector<uint32_t> models;//render handle
+	std::vector<AIState> aiStates;
+	std::vector<float> aiTimers;//seconds until the ai picks again
+	std::vector<uint32_t> aiSeeds;//per entity random state, so threads never share one
+	std::vector<double> updatedAt;//simulation time of its last update, negative until the first one
+
+private:
+	static constexpr uint32_t NONE = ~0u;
+	std::vector<uint32_t> dense;//slot to dense index, NONE when the slot is free
+	std::vector<uint32_t> generations;//per slot
+	std::vector<uint32_t> freeSlots;
+	uint32_t nextSeed = 0x9E3779B9u;
+	std::vector<std::string> modelPaths;
+};
@@ -0,0 +1,266 @@
+#include "EntitySystems.h"
+#include "EntityGrid.h"
+#include <future>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    uint32_t xorshift(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float unitFloat(uint32_t& state) {
+        return (xorshift(state) >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+void EntitySystems::setThreads(int count) {
+    threads = std::max(1, count);
+}
+
+void EntitySystems::setGrid(EntityGrid* grid) {
+    this->grid = grid;
+}
+
+//the calling thread takes the first range itself
+template <typename Work>
+void EntitySystems::forRanges(size_t begin, size_t end, Work work) {
+    size_t count = end - begin;
+    size_t ranges = std::min(static_cast<size_t>(threads), std::max<size_t>(1, count / MIN_RANGE));
+    if (ranges <= 1) {
+        work(begin, end);
+        return;
+    }
+    size_t step = (count + ranges - 1) / ranges;
+    std::vector<std::future<void>> running;
+    for (size_t first = begin + step; first < end; first += step) {
+        size_t last = std::min(end, first + step);
+        running.push_back(std::async(std::launch::async, [&work, first, last]() { work(first, last); }));
+    }
+    work(begin, std::min(end, begin + step));
+    for (std::future<void>& range : running) range.get();
+}
+
+template <typename Work>
+void EntitySystems::forUpdated(Work work) {
+    for (const Range& range : ranges) forRanges(range.begin, range.end, work);
+}
+
+EntityTier EntitySystems::tierOf(size_t i) const {
+    if (i < nearEnd) return TIER_NEAR;
+    return i < farBegin ? TIER_MEDIUM : TIER_FAR;
+}
+
+void EntitySystems::update(EntityStore& store, float deltaTime, const glm::vec3& focus) {
+    clock += deltaTime;
+    size_t count = store.size();
+    tierStats = EntityTierStats();
+    ranges.clear();
+
+    Clock::time_point start = Clock::now();
+    if (!tiers.enabled) {
+        nearEnd = farBegin = count;
+        ranges.push_back({ 0, count });
+    }
+    else {
+        nearEnd = std::min(nearEnd, count);
+        farBegin = std::min(std::max(farBegin, nearEnd), count);
+        //new entities were appended to the far end, place them before they miss an update they should get
+        classify(store, std::min(classified, count), count, focus, deltaTime);
+        size_t slice = (count + std::max(1, tiers.reclassifyFrames) - 1) / std::max(1, tiers.reclassifyFrames);
+        if (classifyCursor >= count) classifyCursor = 0;
+        size_t end = std::min(count, classifyCursor + slice);
+        classify(store, classifyCursor, end, focus, deltaTime);
+        classifyCursor = end;
+
+        ranges.push_back({ 0, nearEnd });
+        addSlice(nearEnd, farBegin, mediumCursor, tiers.mediumInterval);
+        if (tiers.farInterval > 0) addSlice(farBegin, count, farCursor, tiers.farInterval);
+    }
+    steps.resize(count);
+    for (const Range& range : ranges) {
+        tierStats.updated[tierOf(range.begin)] += range.end - range.begin;
+        for (size_t i = range.begin; i < range.end; i++) {
+            double last = store.updatedAt[i];
+            steps[i] = last < 0.0 ? deltaTime : static_cast<float>(clock - last);
+            store.updatedAt[i] = clock;
+        }
+    }
+    tierStats.entities[TIER_NEAR] = nearEnd;
+    tierStats.entities[TIER_MEDIUM] = farBegin - nearEnd;
+    tierStats.entities[TIER_FAR] = count - farBegin;
+    times.tiers = msSince(start);
+
+    const float* step = steps.data();
+    start = Clock::now();
+    forUpdated([&](size_t begin, size_t end) { updateAI(store, begin, end, step); });
+    times.ai = msSince(start);
+
+    start = Clock::now();
+    forUpdated([&](size_t begin, size_t end) { updateMovement(store, begin, end, step); });
+    times.movement = msSince(start);
+
+    //one thread, an entity changing cell touches two cells' lists
+    start = Clock::now();
+    if (grid) {
+        for (const Range& range : ranges) {
+            for (size_t i = range.begin; i < range.end; i++) {
+                grid->move(store.ids[i], glm::vec3(store.posX[i], store.posY[i], store.posZ[i]));
+            }
+        }
+    }
+    times.grid = msSince(start);
+
+    start = Clock::now();
+    std::atomic<size_t> died(0);
+    forUpdated([&](size_t begin, size_t end) { died += updateHealth(store, begin, end, step); });
+    times.health = msSince(start);
+
+    //destroying swaps entities around, so it stays on one thread and only looks when something died. Each one
+    //is walked out to the very end first so the entity that fills its hole comes from the same tier
+    start = Clock::now();
+    if (died > 0) {
+        dead.clear();
+        for (const Range& range : ranges) {
+            for (size_t i = range.begin; i < range.end; i++) {
+                if (store.health[i] <= 0.0f) dead.push_back(store.ids[i]);
+            }
+        }
+        for (const EntityId& id : dead) {
+            if (grid) grid->remove(id);
+            if (tiers.enabled) {
+                moveTier(store, store.indexOf(id), TIER_FAR, deltaTime);
+                store.swap(store.indexOf(id), store.size() - 1);
+            }
+            store.destroy(id);
+        }
+        nearEnd = std::min(nearEnd, store.size());
+        farBegin = std::min(farBegin, store.size());
+    }
+    classified = store.size();
+    times.removal = msSince(start);
+}
+
+//puts every entity in [begin, end) in the tier its distance asks for. A move swaps another entity into i, which
+//then gets looked at too; entities swapped around by a move always stay inside their own tier, so every move
+//settles one entity for good and this ends
+void EntitySystems::classify(EntityStore& store, size_t begin, size_t end, const glm::vec3& focus, float deltaTime) {
+    float nearSquared = tiers.nearDistance * tiers.nearDistance;
+    float farSquared = tiers.farDistance * tiers.farDistance;
+    size_t i = begin;
+    while (i < end) {
+        float dx = store.posX[i] - focus.x;
+        float dy = store.posY[i] - focus.y;
+        float dz = store.posZ[i] - focus.z;
+        float distanceSquared = dx * dx + dy * dy + dz * dz;
+        EntityTier wanted = distanceSquared < nearSquared ? TIER_NEAR : distanceSquared < farSquared ? TIER_MEDIUM : TIER_FAR;
+        if (wanted == tierOf(i)) {
+            i++;
+            continue;
+        }
+        moveTier(store, i, wanted, deltaTime);
+        tierStats.moved++;
+    }
+}
+
+//one boundary at a time, each step swaps with the entity on the other side of it and moves the boundary
+void EntitySystems::moveTier(EntityStore& store, size_t i, EntityTier to, float deltaTime) {
+    EntityTier from = tierOf(i);
+    //frozen time does not count, it carries on from one frame ago
+    if (from == TIER_FAR && to != TIER_FAR && tiers.farInterval <= 0) store.updatedAt[i] = clock - deltaTime;
+    while (from != to) {
+        if (from == TIER_NEAR) {
+            store.swap(i, nearEnd - 1);
+            i = --nearEnd;
+            from = TIER_MEDIUM;
+        }
+        else if (from == TIER_FAR) {
+            store.swap(i, farBegin);
+            i = farBegin++;
+            from = TIER_MEDIUM;
+        }
+        else if (to == TIER_NEAR) {
+            store.swap(i, nearEnd);
+            i = nearEnd++;
+            from = TIER_NEAR;
+        }
+        else {
+            store.swap(i, farBegin - 1);
+            i = --farBegin;
+            from = TIER_FAR;
+        }
+    }
+}
+
+//the next 1/interval of [begin, end) from the cursor, wrapping round to the start
+void EntitySystems::addSlice(size_t begin, size_t end, size_t& cursor, int interval) {
+    size_t count = end - begin;
+    if (count == 0) return;
+    size_t slice = (count + std::max(1, interval) - 1) / std::max(1, interval);
+    if (cursor >= count) cursor = 0;
+    ranges.push_back({ begin + cursor, begin + std::min(count, cursor + slice) });
+    if (cursor + slice > count) ranges.push_back({ begin, begin + cursor + slice - count });
+    cursor = (cursor + slice) % count;
+}
+
+//idle for a while, then wander in a random direction for a while, and so on
+void EntitySystems::updateAI(EntityStore& store, size_t begin, size_t end, const float* steps) {
+    for (size_t i = begin; i < end; i++) {
+        store.aiTimers[i] -= steps[i];
+        if (store.aiTimers[i] > 0.0f) continue;
+
+        uint32_t& seed = store.aiSeeds[i];
+        if (store.aiStates[i] == AIState::Idle) {
+            float angle = unitFloat(seed) * 6.2831853f;
+            store.aiStates[i] = AIState::Wander;
+            store.velX[i] = std::sin(angle) * WANDER_SPEED;
+            store.velY[i] = (unitFloat(seed) - 0.5f) * 0.5f * WANDER_SPEED;
+            store.velZ[i] = std::cos(angle) * WANDER_SPEED;
+            store.yaw[i] = angle;
+        }
+        else {
+            store.aiStates[i] = AIState::Idle;
+            store.velX[i] = store.velY[i] = store.velZ[i] = 0.0f;
+        }
+        store.aiTimers[i] = 1.0f + unitFloat(seed) * 3.0f;
+    }
+}
+
+void EntitySystems::updateMovement(EntityStore& store, size_t begin, size_t end, const float* steps) {
+    float* posX = store.posX.data();
+    float* posY = store.posY.data();
+    float* posZ = store.posZ.data();
+    const float* velX = store.velX.data();
+    const float* velY = store.velY.data();
+    const float* velZ = store.velZ.data();
+    for (size_t i = begin; i < end; i++) {
+        posX[i] += velX[i] * steps[i];
+        posY[i] += velY[i] * steps[i];
+        posZ[i] += velZ[i] * steps[i];
+    }
+}
+
+size_t EntitySystems::updateHealth(EntityStore& store, size_t begin, size_t end, const float* steps) {
+    float* health = store.health.data();
+    const float* maxHealth = store.maxHealth.data();
+    size_t died = 0;
+    //no branches so it vectorizes, the dead keep their health for removal to find
+    for (size_t i = begin; i < end; i++) {
+        bool dead = health[i] <= 0.0f;
+        died += dead;
+        float healed = std::min(health[i] + HEALTH_REGEN * steps[i], maxHealth[i]);
+        health[i] = dead ? health[i] : healed;
+    }
+    return died;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "EntityStore.h"
+
+class EntityGrid;
+
+//wall time each system took in the last update
+struct EntitySystemTimes {
+	double tiers = 0.0, ai = 0.0, movement = 0.0, grid = 0.0, health = 0.0, removal = 0.0;//ms
+	double total() const { return tiers + ai + movement + grid + health + removal; }
+};
+
+//how often entities are simulated by their distance to the player. Near ones update every frame, medium ones
+//every mediumInterval frames and far ones every farInterval frames or not at all, each time with all the time
+//they missed, so something that walks into view is where it would have been
+struct EntityTierSettings {
+	bool enabled = true;//false updates everything every frame
+	float nearDistance = 48.0f;//blocks
+	float farDistance = 128.0f;
+	int mediumInterval = 4;//frames
+	int farInterval = 0;//0 freezes far entities, time stops for them until they come closer
+	int reclassifyFrames = 8;//each entity's distance is checked once every this many frames
+};
+
+enum EntityTier { TIER_NEAR, TIER_MEDIUM, TIER_FAR, TIER_COUNT };
+
+//entities in each tier and how many of them were updated in the last update
+struct EntityTierStats {
+	size_t entities[TIER_COUNT] = {};
+	size_t updated[TIER_COUNT] = {};
+	size_t moved = 0;//changed tier
+};
+
+//the per frame entity update: tiers, ai, movement, health, then the dead are removed. Each system walks the
+//component arrays it needs in order, split into contiguous ranges over a few threads once there are enough
+//entities to pay for them. Every entity only touches its own elements, so the result does not depend on
+//the thread count.
+//The dense arrays are kept partitioned by tier, near first and far last, so a tier is one range. Medium and far
+//entities are updated a slice of their range per frame, turning round the range, and only a slice of all
+//entities has its distance checked per frame, so the work per frame follows the entities near the player rather
+//than the population. No gl in here
+class EntitySystems
+{
+public:
+	EntityTierSettings tiers;
+
+	void setThreads(int count);//1 runs everything on the calling thread
+	int getThreads() const { return threads; }
+	void setGrid(EntityGrid* grid);//kept up to date with the entities that moved and the ones removed, null for none
+	void update(EntityStore& store, float deltaTime, const glm::vec3& focus);
+	const EntitySystemTimes& lastTimes() const { return times; }
+	const EntityTierStats& lastTierStats() const { return tierStats; }
+	EntityTier tierOf(size_t i) const;//by where dense index i sits, not by its distance
+	double simulationTime() const { return clock; }
+
+	static constexpr size_t MIN_RANGE = 8192;//entities per thread below which splitting costs more than it saves
+	static constexpr float WANDER_SPEED = 2.0f;//blocks per second
+	static constexpr float HEALTH_REGEN = 1.0f;//per second
+
+	//the systems on their own, over dense indices [begin, end), steps[i] is the time entity i moves on by
+	static void updateAI(EntityStore& store, size_t begin, size_t end, const float* steps);
+	static void updateMovement(EntityStore& store, size_t begin, size_t end, const float* steps);
+	static size_t updateHealth(EntityStore& store, size_t begin, size_t end, const float* steps);//returns how many died
+
+private:
+	struct Range {
+		size_t begin, end;
+	};
+
+	int threads = 1;
+	EntityGrid* grid = nullptr;
+	EntitySystemTimes times;
+	EntityTierStats tierStats;
+	std::vector<EntityId> dead;
+	std::vector<float> steps;
+	std::vector<Range> ranges;//updated this frame
+
+	double clock = 0.0;//simulation seconds
+	size_t nearEnd = 0, farBegin = 0;//tier partition of the dense range, [0, nearEnd) near, [farBegin, size) far
+	size_t classified = 0;//entities below this were there last update, the ones above are new
+	size_t classifyCursor = 0, mediumCursor = 0, farCursor = 0;//where the next slice starts
+
+	void classify(EntityStore& store, size_t begin, size_t end, const glm::vec3& focus, float deltaTime);
+	void moveTier(EntityStore& store, size_t i, EntityTier to, float deltaTime);
+	void addSlice(size_t begin, size_t end, size_t& cursor, int interval);
+
+	template <typename Work>
+	void forRanges(size_t begin, size_t end, Work work);
+	template <typename Work>
+	void forUpdated(Work work);
+};
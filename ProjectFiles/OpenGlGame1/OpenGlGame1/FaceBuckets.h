@@ -0,0 +1,34 @@
+#pragma once
+#include <glm/glm.hpp>
+
+//which face direction buckets of a mesh section can face the viewer, bit f is bucket f in Chunk face order
+//(Front z-, Back z+, Left x-, Right x+, Top y+, Bottom y-). The rest are back facing, the gpu would shade
+//their vertices and then cull them. Plain functions, no renderer needed to check them.
+
+static const unsigned int allFaceBuckets = 0x3F;
+
+//perspective pass: a bucket faces away when the eye is behind the box on that axis, every face plane in it
+//is then behind or edge on to the eye. Boxes are conservative so faces on the box boundary count as visible.
+inline unsigned int visibleFaceBuckets(const glm::vec3& eye, const glm::vec3& boxMin, const glm::vec3& boxMax) {
+	unsigned int mask = 0;
+	if (eye.z < boxMax.z) mask |= 1u << 0;//front faces look down -z
+	if (eye.z > boxMin.z) mask |= 1u << 1;
+	if (eye.x < boxMax.x) mask |= 1u << 2;
+	if (eye.x > boxMin.x) mask |= 1u << 3;
+	if (eye.y > boxMin.y) mask |= 1u << 4;
+	if (eye.y < boxMax.y) mask |= 1u << 5;
+	return mask;
+}
+
+//orthographic pass (shadow map): only the view direction matters, the same for every section
+//faces exactly edge on make no fragments so they are dropped too
+inline unsigned int visibleFaceBuckets(const glm::vec3& viewDirection) {
+	unsigned int mask = 0;
+	if (viewDirection.z > 0.0f) mask |= 1u << 0;
+	if (viewDirection.z < 0.0f) mask |= 1u << 1;
+	if (viewDirection.x > 0.0f) mask |= 1u << 2;
+	if (viewDirection.x < 0.0f) mask |= 1u << 3;
+	if (viewDirection.y < 0.0f) mask |= 1u << 4;
+	if (viewDirection.y > 0.0f) mask |= 1u << 5;
+	return mask;
+}
@@ -1,5 +1,10 @@
 #include "Frustum.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_SSE 1
+#endif
+
 
 void Frustum::update(const glm::mat4& viewProj) {
 
@@ -64,4 +69,58 @@ bool Frustum::isBoxInFrustum(const glm::vec3& min, const glm::vec3& max) const {
         }
     }
     return true; // Box is inside or intersects the frustum
-}
\ No newline at end of file
+}
+size_t Frustum::cullBoxes(const float* minX, const float* minY, const float* minZ,
+    const float* maxX, const float* maxY, const float* maxZ, size_t count, uint32_t* visible, unsigned int planeMask) const {
+
+    //the corner furthest along each plane normal is picked per plane, not per box, so it is just a choice of array
+    const float* px[6]; const float* py[6]; const float* pz[6];
+    int used[6];
+    int planeCount = 0;
+    for (int p = 0; p < 6; p++) {
+        if (!(planeMask & (1u << p))) continue;
+        used[planeCount] = p;
+        px[planeCount] = planes[p].x > 0 ? maxX : minX;
+        py[planeCount] = planes[p].y > 0 ? maxY : minY;
+        pz[planeCount] = planes[p].z > 0 ? maxZ : minZ;
+        planeCount++;
+    }
+
+    size_t visibleCount = 0;
+    size_t i = 0;
+#ifdef FRUSTUM_SSE
+    __m128 nx[6], ny[6], nz[6], nw[6];
+    for (int p = 0; p < planeCount; p++) {
+        const glm::vec4& plane = planes[used[p]];
+        nx[p] = _mm_set1_ps(plane.x);
+        ny[p] = _mm_set1_ps(plane.y);
+        nz[p] = _mm_set1_ps(plane.z);
+        nw[p] = _mm_set1_ps(plane.w);
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        int inside = 0xF;
+        for (int p = 0; p < planeCount && inside; p++) {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(px[p] + i), nx[p]), _mm_mul_ps(_mm_loadu_ps(py[p] + i), ny[p])),
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pz[p] + i), nz[p]), nw[p]));
+            inside &= _mm_movemask_ps(_mm_cmpge_ps(distance, zero));
+        }
+        for (int lane = 0; lane < 4; lane++) {
+            if (inside & (1 << lane)) visible[visibleCount++] = static_cast<uint32_t>(i + lane);
+        }
+    }
+#endif
+    //tail, or everything without sse
+    for (; i < count; i++) {
+        bool inside = true;
+        for (int p = 0; p < planeCount && inside; p++) {
+            const glm::vec4& plane = planes[used[p]];
+            float distance = px[p][i] * plane.x + py[p][i] * plane.y + pz[p][i] * plane.z + plane.w;
+            inside = distance >= 0;
+        }
+        if (inside) visible[visibleCount++] = static_cast<uint32_t>(i);
+    }
+    return visibleCount;
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cstddef>
+#include <cstdint>
 
 class Frustum
 {
@@ -8,5 +10,11 @@ public:
 	glm::vec4 planes[6];
 	void update(const glm::mat4& viewProj);
 	bool isBoxInFrustum(const glm::vec3& min, const glm::vec3& max) const;
+
+	//same test for count boxes given as separate min / max arrays, 4 at a time with sse
+	//writes the index of every box that is in or touching the frustum to visible (room for count), returns how many
+	//planeMask bit i set = test planes[i], callers that already know boxes are inside some planes can skip them
+	size_t cullBoxes(const float* minX, const float* minY, const float* minZ,
+		const float* maxX, const float* maxY, const float* maxZ, size_t count, uint32_t* visible, unsigned int planeMask = 0x3F) const;
 };
 
@@ -0,0 +1,99 @@
+#include "GLDebug.h"
+#include <iostream>
+#include <unordered_map>
+
+//KHR_debug is core in 4.3 and an extension on 3.3, the glad header is 3.3 core so the little used here is declared here
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DONT_CARE 0x1100
+typedef void (APIENTRYP DebugMessageCallbackProc)(GLDEBUGPROC callback, const void* userParam);
+typedef void (APIENTRYP DebugMessageControlProc)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled);
+
+namespace GLDebug {
+    CallCounts current;
+    static CallCounts last;
+
+    size_t CallCounts::total() const {
+        size_t sum = 0;
+        for (size_t count : calls) sum += count;
+        return sum;
+    }
+
+    const CallCounts& lastFrame() {
+        return last;
+    }
+
+    const char* kindName(GLCallKind kind) {
+        static const char* names[] = { "resource", "upload", "bind", "state", "uniform", "draw", "query" };
+        return names[static_cast<int>(kind)];
+    }
+
+#if defined(GL_DEBUG_LAYER)
+    static const char* siteCall = "";
+    static const char* siteFile = "";
+    static int siteLine = 0;
+    static bool debugOutput = false;
+    static std::unordered_map<GLuint, int> reported;//per message id, so one bad call every frame doesnt flood cerr
+    static const int REPORTS_PER_MESSAGE = 3;
+
+    void setCallSite(const char* call, const char* file, int line) {
+        siteCall = call;
+        siteFile = file;
+        siteLine = line;
+    }
+
+    //output is synchronous, so this runs inside the call that raised it and the site is still that call's
+    static void APIENTRY onMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam) {
+        int& count = reported[id];
+        if (++count > REPORTS_PER_MESSAGE) return;
+
+        const char* level = severity == GL_DEBUG_SEVERITY_HIGH ? "high" : severity == GL_DEBUG_SEVERITY_MEDIUM ? "medium" : "low";
+        std::cerr << "GL " << (type == GL_DEBUG_TYPE_ERROR ? "error" : "warning") << " (" << level << ", id " << id << "): " << message
+            << "\n  at " << siteFile << ":" << siteLine << " " << siteCall << std::endl;
+        if (count == REPORTS_PER_MESSAGE) std::cerr << "  further messages with id " << id << " are not shown" << std::endl;
+    }
+
+    void init(GLADloadproc load) {
+        DebugMessageCallbackProc callback = (DebugMessageCallbackProc)load("glDebugMessageCallback");
+        if (!callback) callback = (DebugMessageCallbackProc)load("glDebugMessageCallbackKHR");
+        DebugMessageControlProc control = (DebugMessageControlProc)load("glDebugMessageControl");
+        if (!control) control = (DebugMessageControlProc)load("glDebugMessageControlKHR");
+        if (!callback || !control) {
+            std::cerr << "GL debug layer: no KHR_debug, checking glGetError once a frame instead" << std::endl;
+            return;
+        }
+
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        callback(onMessage, nullptr);
+        control(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);//buffer placement chatter
+        debugOutput = true;
+    }
+
+    //without debug output errors still show up, just a frame late and without the call that raised them
+    static void checkFrameErrors() {
+        if (debugOutput) return;
+        static std::unordered_map<GLenum, int> errors;
+        for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError()) {
+            int& count = errors[error];
+            if (++count > REPORTS_PER_MESSAGE) continue;
+            std::cerr << "GL error 0x" << std::hex << error << std::dec << " during the last frame" << std::endl;
+        }
+    }
+#else
+    void setCallSite(const char* call, const char* file, int line) {}
+    void init(GLADloadproc load) {}
+    static void checkFrameErrors() {}
+#endif
+
+    void endFrame() {
+        checkFrameErrors();
+        last = current;
+        current = CallCounts();
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+
+//every gl call in the gl code goes through GL_CALL(kind, call), what that turns into is picked at compile time:
+//  GL_DEBUG_LAYER  the call site is noted before each call and KHR_debug output is synchronous, so a message names
+//                  the file, line and call that raised it. On by default in debug builds (no NDEBUG)
+//  GL_COUNT_CALLS  each call bumps a per frame counter for its kind. On with the debug layer, define it on its
+//                  own for a release build that still reports counts
+//  neither         GL_CALL(kind, call) is just call, nothing is left in a release build
+//nothing here calls glGetError per call, that stalls the driver
+
+#if !defined(NDEBUG) && !defined(GL_DEBUG_LAYER)
+#define GL_DEBUG_LAYER
+#endif
+#if defined(GL_DEBUG_LAYER) && !defined(GL_COUNT_CALLS)
+#define GL_COUNT_CALLS
+#endif
+
+enum class GLCallKind { Resource, Upload, Bind, State, Uniform, Draw, Query, Count };//draw includes clears
+
+namespace GLDebug {
+	struct CallCounts {
+		size_t calls[static_cast<int>(GLCallKind::Count)] = {};
+		size_t total() const;
+	};
+
+	void init(GLADloadproc load);//after glad is loaded, hooks up KHR_debug if the context has it
+	void endFrame();//rolls the counts over to lastFrame
+	const CallCounts& lastFrame();//all zero unless GL_COUNT_CALLS
+	const char* kindName(GLCallKind kind);
+
+	extern CallCounts current;
+	inline void count(GLCallKind kind) { current.calls[static_cast<int>(kind)]++; }
+	void setCallSite(const char* call, const char* file, int line);
+}
+
+#if defined(GL_DEBUG_LAYER)
+#define GL_CALL(kind, call) (GLDebug::setCallSite(#call, __FILE__, __LINE__), GLDebug::count(GLCallKind::kind), call)
+#elif defined(GL_COUNT_CALLS)
+#define GL_CALL(kind, call) (GLDebug::count(GLCallKind::kind), call)
+#else
+#define GL_CALL(kind, call) (call)
+#endif
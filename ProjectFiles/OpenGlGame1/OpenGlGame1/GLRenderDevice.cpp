@@ -0,0 +1,282 @@
+#include "GLRenderDevice.h"
+#include <iostream>
+#include <glm/gtc/type_ptr.hpp>
+#include "Shader.h"
+#include "GLDebug.h"
+
+GLRenderDevice::GLRenderDevice() {
+    //the only blend mode anything uses, so set it once and just toggle GL_BLEND
+    GL_CALL(State, glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+}
+
+GLenum GLRenderDevice::toGL(BufferTarget target) {
+    switch (target) {
+    case BufferTarget::Index: return GL_ELEMENT_ARRAY_BUFFER;
+    case BufferTarget::Texture: return GL_TEXTURE_BUFFER;
+    case BufferTarget::Uniform: return GL_UNIFORM_BUFFER;
+    default: return GL_ARRAY_BUFFER;
+    }
+}
+
+GLenum GLRenderDevice::toGL(AttribType type) {
+    switch (type) {
+    case AttribType::Short: return GL_SHORT;
+    case AttribType::UnsignedShort: return GL_UNSIGNED_SHORT;
+    case AttribType::Int: return GL_INT;
+    case AttribType::UnsignedInt: return GL_UNSIGNED_INT;
+    default: return GL_FLOAT;
+    }
+}
+
+GLenum GLRenderDevice::toGL(RenderCap cap) {
+    switch (cap) {
+    case RenderCap::CullFace: return GL_CULL_FACE;
+    case RenderCap::DepthTest: return GL_DEPTH_TEST;
+    case RenderCap::ScissorTest: return GL_SCISSOR_TEST;
+    default: return GL_BLEND;
+    }
+}
+
+unsigned int GLRenderDevice::createVertexArray() {
+    GLuint vertexArray = 0;
+    GL_CALL(Resource, glGenVertexArrays(1, &vertexArray));
+    return vertexArray;
+}
+
+void GLRenderDevice::deleteVertexArray(unsigned int vertexArray) {
+    if (vertexArray != 0) GL_CALL(Resource, glDeleteVertexArrays(1, &vertexArray));
+}
+
+unsigned int GLRenderDevice::createBuffer() {
+    GLuint buffer = 0;
+    GL_CALL(Resource, glGenBuffers(1, &buffer));
+    return buffer;
+}
+
+void GLRenderDevice::deleteBuffer(unsigned int buffer) {
+    if (buffer != 0) GL_CALL(Resource, glDeleteBuffers(1, &buffer));
+}
+
+void GLRenderDevice::bufferData(BufferTarget target, unsigned int buffer, size_t bytes, const void* data, BufferUsage usage) {
+    GL_CALL(Bind, glBindBuffer(toGL(target), buffer));
+    GL_CALL(Upload, glBufferData(toGL(target), bytes, data, usage == BufferUsage::Static ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW));
+}
+
+void GLRenderDevice::bufferSubData(unsigned int buffer, size_t offset, size_t bytes, const void* data) {
+    //copy write target so updating an index buffer never touches the bound vertex array
+    GL_CALL(Bind, glBindBuffer(GL_COPY_WRITE_BUFFER, buffer));
+    GL_CALL(Upload, glBufferSubData(GL_COPY_WRITE_BUFFER, offset, bytes, data));
+}
+
+void GLRenderDevice::copyBufferData(unsigned int source, unsigned int destination, size_t sourceOffset, size_t destinationOffset, size_t bytes) {
+    GL_CALL(Bind, glBindBuffer(GL_COPY_READ_BUFFER, source));
+    GL_CALL(Bind, glBindBuffer(GL_COPY_WRITE_BUFFER, destination));
+    GL_CALL(Upload, glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceOffset, destinationOffset, bytes));
+}
+
+void GLRenderDevice::vertexAttrib(const VertexAttrib& attrib) {
+    if (attrib.integer) {
+        GL_CALL(Resource, glVertexAttribIPointer(attrib.index, attrib.components, toGL(attrib.type), static_cast<GLsizei>(attrib.stride), (void*)attrib.offset));
+    }
+    else {
+        GL_CALL(Resource, glVertexAttribPointer(attrib.index, attrib.components, toGL(attrib.type), GL_FALSE, static_cast<GLsizei>(attrib.stride), (void*)attrib.offset));
+    }
+    GL_CALL(Resource, glEnableVertexAttribArray(attrib.index));
+    GL_CALL(Resource, glVertexAttribDivisor(attrib.index, attrib.divisor));
+}
+
+unsigned int GLRenderDevice::createTexture(const TextureDesc& desc, const void* pixels) {
+    GLuint texture = 0;
+    GL_CALL(Resource, glGenTextures(1, &texture));
+    GL_CALL(Bind, glBindTexture(GL_TEXTURE_2D, texture));
+
+    GLenum wrap = desc.wrap == TextureWrap::Repeat ? GL_REPEAT
+        : desc.wrap == TextureWrap::ClampToBorder ? GL_CLAMP_TO_BORDER : GL_CLAMP_TO_EDGE;
+    GLenum filter = desc.filter == TextureFilter::Nearest ? GL_NEAREST : GL_LINEAR;
+    GL_CALL(Resource, glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap));
+    GL_CALL(Resource, glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap));
+    GL_CALL(Resource, glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter));
+    GL_CALL(Resource, glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter));
+    if (desc.wrap == TextureWrap::ClampToBorder) {
+        float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        GL_CALL(Resource, glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor));
+    }
+
+    if (desc.format == TextureFormat::Depth) {
+        GL_CALL(Upload, glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, desc.width, desc.height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, pixels));
+    }
+    else {
+        GLenum format = desc.format == TextureFormat::RGB ? GL_RGB : GL_RGBA;
+        GL_CALL(Resource, glPixelStorei(GL_UNPACK_ALIGNMENT, 1));//rgb rows from stb are not 4 byte aligned
+        GL_CALL(Upload, glTexImage2D(GL_TEXTURE_2D, 0, format, desc.width, desc.height, 0, format, GL_UNSIGNED_BYTE, pixels));
+    }
+    if (desc.mipmaps) GL_CALL(Resource, glGenerateMipmap(GL_TEXTURE_2D));
+
+    GL_CALL(Bind, glBindTexture(GL_TEXTURE_2D, 0));
+    return texture;
+}
+
+void GLRenderDevice::deleteTexture(unsigned int texture) {
+    if (texture != 0) GL_CALL(Resource, glDeleteTextures(1, &texture));
+}
+
+unsigned int GLRenderDevice::createBufferTexture(unsigned int buffer) {
+    GLuint texture = 0;
+    GL_CALL(Resource, glGenTextures(1, &texture));
+    GL_CALL(Bind, glBindTexture(GL_TEXTURE_BUFFER, texture));
+    GL_CALL(Resource, glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer));
+    GL_CALL(Bind, glBindTexture(GL_TEXTURE_BUFFER, 0));
+    return texture;
+}
+
+unsigned int GLRenderDevice::createDepthTarget(unsigned int depthTexture) {
+    GLuint framebuffer = 0;
+    GL_CALL(Resource, glGenFramebuffers(1, &framebuffer));
+    GL_CALL(Bind, glBindFramebuffer(GL_FRAMEBUFFER, framebuffer));
+    GL_CALL(Resource, glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0));
+    GL_CALL(Resource, glDrawBuffer(GL_NONE)); // No color buffer for shadow map
+    GL_CALL(Resource, glReadBuffer(GL_NONE));
+
+    GLenum status = GL_CALL(Query, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    GL_CALL(Bind, glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Depth framebuffer incomplete: " << status << std::endl;
+        GL_CALL(Resource, glDeleteFramebuffers(1, &framebuffer));
+        return 0;
+    }
+    return framebuffer;
+}
+
+void GLRenderDevice::deleteFramebuffer(unsigned int framebuffer) {
+    if (framebuffer != 0) GL_CALL(Resource, glDeleteFramebuffers(1, &framebuffer));
+}
+
+unsigned int GLRenderDevice::createProgram(const std::string& vertexPath, const std::string& fragmentPath) {
+    Shader shader(vertexPath.c_str(), fragmentPath.c_str());
+
+    GLint linked = GL_FALSE;
+    GL_CALL(Query, glGetProgramiv(shader.ID, GL_LINK_STATUS, &linked));
+    if (!linked) {
+        GL_CALL(Resource, glDeleteProgram(shader.ID));
+        return 0;
+    }
+    programs[shader.ID] = { shader.uniforms, shader.uniformBlocks };
+    return shader.ID;
+}
+
+int GLRenderDevice::getUniformLocation(unsigned int program, const char* name) {
+    auto it = programs.find(program);
+    return it != programs.end() ? it->second.uniforms.find(name) : -1;
+}
+
+bool GLRenderDevice::bindUniformBlock(unsigned int program, const char* block, unsigned int binding) {
+    auto it = programs.find(program);
+    if (it == programs.end()) return false;
+    int index = it->second.blocks.find(block);
+    if (index < 0) return false;
+    GL_CALL(Uniform, glUniformBlockBinding(program, static_cast<GLuint>(index), binding));
+    return true;
+}
+
+void GLRenderDevice::bindFramebuffer(unsigned int framebuffer) {
+    GL_CALL(Bind, glBindFramebuffer(GL_FRAMEBUFFER, framebuffer));
+}
+
+void GLRenderDevice::setViewport(int x, int y, int width, int height) {
+    GL_CALL(State, glViewport(x, y, width, height));
+}
+
+void GLRenderDevice::setScissor(int x, int y, int width, int height) {
+    GL_CALL(State, glScissor(x, y, width, height));
+}
+
+void GLRenderDevice::setClearColour(const glm::vec4& colour) {
+    GL_CALL(State, glClearColor(colour.r, colour.g, colour.b, colour.a));
+}
+
+void GLRenderDevice::clear(bool colour, bool depth) {
+    GLbitfield mask = (colour ? GL_COLOR_BUFFER_BIT : 0) | (depth ? GL_DEPTH_BUFFER_BIT : 0);
+    if (mask != 0) GL_CALL(Draw, glClear(mask));
+}
+
+void GLRenderDevice::setEnabled(RenderCap cap, bool enabled) {
+    if (enabled) GL_CALL(State, glEnable(toGL(cap)));
+    else GL_CALL(State, glDisable(toGL(cap)));
+}
+
+void GLRenderDevice::setDepthFunc(DepthFunc func) {
+    GL_CALL(State, glDepthFunc(func == DepthFunc::LessEqual ? GL_LEQUAL : GL_LESS));
+}
+
+void GLRenderDevice::setDepthMask(bool write) {
+    GL_CALL(State, glDepthMask(write ? GL_TRUE : GL_FALSE));
+}
+
+void GLRenderDevice::useProgram(unsigned int program) {
+    GL_CALL(Bind, glUseProgram(program));
+}
+
+void GLRenderDevice::bindVertexArray(unsigned int vertexArray) {
+    GL_CALL(Bind, glBindVertexArray(vertexArray));
+}
+
+void GLRenderDevice::bindTexture(unsigned int unit, unsigned int texture) {
+    GL_CALL(Bind, glActiveTexture(GL_TEXTURE0 + unit));
+    GL_CALL(Bind, glBindTexture(GL_TEXTURE_2D, texture));
+}
+
+void GLRenderDevice::bindBufferTexture(unsigned int unit, unsigned int texture) {
+    GL_CALL(Bind, glActiveTexture(GL_TEXTURE0 + unit));
+    GL_CALL(Bind, glBindTexture(GL_TEXTURE_BUFFER, texture));
+}
+
+void GLRenderDevice::bindUniformBuffer(unsigned int binding, unsigned int buffer) {
+    GL_CALL(Bind, glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer));
+}
+
+void GLRenderDevice::setUniform(int location, int value) {
+    GL_CALL(Uniform, glUniform1i(location, value));
+}
+
+void GLRenderDevice::setUniform(int location, const glm::vec3& value) {
+    GL_CALL(Uniform, glUniform3fv(location, 1, glm::value_ptr(value)));
+}
+
+void GLRenderDevice::setUniform(int location, const glm::vec4& value) {
+    GL_CALL(Uniform, glUniform4fv(location, 1, glm::value_ptr(value)));
+}
+
+void GLRenderDevice::setUniform(int location, const glm::mat4& value) {
+    GL_CALL(Uniform, glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value)));
+}
+
+void GLRenderDevice::drawIndexed(Primitive primitive, size_t indexCount, size_t firstIndex, int baseVertex) {
+    GLenum mode = primitive == Primitive::Lines ? GL_LINES : GL_TRIANGLES;
+    void* indexOffset = (void*)(firstIndex * sizeof(unsigned int));
+    if (baseVertex == 0) {
+        GL_CALL(Draw, glDrawElements(mode, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, indexOffset));
+    }
+    else {
+        GL_CALL(Draw, glDrawElementsBaseVertex(mode, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, indexOffset, baseVertex));
+    }
+}
+
+void GLRenderDevice::multiDrawIndexed(Primitive primitive, const int* indexCounts, const size_t* firstIndices, const int* baseVertices, size_t drawCount) {
+    if (drawCount == 0) return;
+    indexOffsets.resize(drawCount);
+    for (size_t i = 0; i < drawCount; i++) {
+        indexOffsets[i] = (const void*)(firstIndices[i] * sizeof(unsigned int));
+    }
+    GLenum mode = primitive == Primitive::Lines ? GL_LINES : GL_TRIANGLES;
+    GL_CALL(Draw, glMultiDrawElementsBaseVertex(mode, indexCounts, GL_UNSIGNED_INT, indexOffsets.data(), static_cast<GLsizei>(drawCount), const_cast<GLint*>(baseVertices)));
+}
+
+void GLRenderDevice::drawIndexedInstanced(Primitive primitive, size_t indexCount, size_t firstIndex, size_t instanceCount) {
+    GLenum mode = primitive == Primitive::Lines ? GL_LINES : GL_TRIANGLES;
+    void* indexOffset = (void*)(firstIndex * sizeof(unsigned int));
+    GL_CALL(Draw, glDrawElementsInstanced(mode, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, indexOffset, static_cast<GLsizei>(instanceCount)));
+}
+
+void GLRenderDevice::endFrame() {
+    GLDebug::endFrame();
+}
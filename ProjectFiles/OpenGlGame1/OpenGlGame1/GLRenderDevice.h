@@ -0,0 +1,68 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <unordered_map>
+#include "RenderDevice.h"
+#include "UniformTable.h"
+
+//RenderDevice straight onto opengl 3.3, needs a current context for every call
+class GLRenderDevice : public RenderDevice
+{
+public:
+	GLRenderDevice();
+
+	unsigned int createVertexArray() override;
+	void deleteVertexArray(unsigned int vertexArray) override;
+	unsigned int createBuffer() override;
+	void deleteBuffer(unsigned int buffer) override;
+	void bufferData(BufferTarget target, unsigned int buffer, size_t bytes, const void* data, BufferUsage usage) override;
+	void bufferSubData(unsigned int buffer, size_t offset, size_t bytes, const void* data) override;
+	void copyBufferData(unsigned int source, unsigned int destination, size_t sourceOffset, size_t destinationOffset, size_t bytes) override;
+	void vertexAttrib(const VertexAttrib& attrib) override;
+
+	unsigned int createTexture(const TextureDesc& desc, const void* pixels) override;
+	void deleteTexture(unsigned int texture) override;
+	unsigned int createBufferTexture(unsigned int buffer) override;
+	unsigned int createDepthTarget(unsigned int depthTexture) override;
+	void deleteFramebuffer(unsigned int framebuffer) override;
+
+	unsigned int createProgram(const std::string& vertexPath, const std::string& fragmentPath) override;
+	int getUniformLocation(unsigned int program, const char* name) override;
+	bool bindUniformBlock(unsigned int program, const char* block, unsigned int binding) override;
+
+	void bindFramebuffer(unsigned int framebuffer) override;
+	void setViewport(int x, int y, int width, int height) override;
+	void setScissor(int x, int y, int width, int height) override;
+	void setClearColour(const glm::vec4& colour) override;
+	void clear(bool colour, bool depth) override;
+	void setEnabled(RenderCap cap, bool enabled) override;
+	void setDepthFunc(DepthFunc func) override;
+	void setDepthMask(bool write) override;
+
+	void useProgram(unsigned int program) override;
+	void bindVertexArray(unsigned int vertexArray) override;
+	void bindTexture(unsigned int unit, unsigned int texture) override;
+	void bindBufferTexture(unsigned int unit, unsigned int texture) override;
+	void bindUniformBuffer(unsigned int binding, unsigned int buffer) override;
+
+	void setUniform(int location, int value) override;
+	void setUniform(int location, const glm::vec3& value) override;
+	void setUniform(int location, const glm::vec4& value) override;
+	void setUniform(int location, const glm::mat4& value) override;
+
+	void drawIndexed(Primitive primitive, size_t indexCount, size_t firstIndex, int baseVertex) override;
+	void multiDrawIndexed(Primitive primitive, const int* indexCounts, const size_t* firstIndices, const int* baseVertices, size_t drawCount) override;
+	void drawIndexedInstanced(Primitive primitive, size_t indexCount, size_t firstIndex, size_t instanceCount) override;
+
+	void endFrame() override;//rolls over the GLDebug call counts
+
+private:
+	std::vector<const void*> indexOffsets;//byte offsets for multi draws, reused
+	struct ProgramTables {
+		UniformTable uniforms, blocks;
+	};
+	std::unordered_map<unsigned int, ProgramTables> programs;//reflected when linked
+	static GLenum toGL(BufferTarget target);
+	static GLenum toGL(AttribType type);
+	static GLenum toGL(RenderCap cap);
+};
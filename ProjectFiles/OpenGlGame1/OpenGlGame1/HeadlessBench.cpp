@@ -0,0 +1,3004 @@
+// HeadlessBench - benchmarks for the engine core that run without a window, GLFW or a GL context
+//
+// build on linux (no display or gpu needed):
+//   g++ -std=c++17 -O2 -pthread -I../../../CppLibrarys/Include HeadlessBench.cpp Chunk.cpp BlockConstants.cpp TerrainGenerator.cpp World.cpp Player.cpp Renderer.cpp Frustum.cpp RecordingRenderDevice.cpp OBJLoader.cpp ModelLoader.cpp ArenaAllocator.cpp ChunkArena.cpp ChunkDrawList.cpp ChunkRenderRecords.cpp ChunkQuadtree.cpp OcclusionBuffer.cpp SectionGraph.cpp ShadowCascades.cpp CachingRenderDevice.cpp InstanceBatcher.cpp EntityStore.cpp EntitySystems.cpp EntityGrid.cpp HeightPyramid.cpp -o HeadlessBench
+//
+// the files after HeadlessBench.cpp are the gl free engine core, the game links the same files plus Main and the gl code
+//
+// usage:
+//   HeadlessBench worldgen [--seed N] [--radius R] [--threads T] [--mesh]
+//   HeadlessBench stream [--seed N] [--radius R] [--frames F]
+//   HeadlessBench frame [--seed N] [--radius R] [--frames F] [--max-draws N] [--max-upload-bytes N] [--max-state-changes N]
+//   HeadlessBench alloc [--seed N] [--ops N]
+//   HeadlessBench cull [--seed N] [--radius R] [--frames F]
+//   HeadlessBench sections [--seed N] [--radius R] [--frames F]
+//   HeadlessBench occlusion [--seed N] [--radius R] [--frames F]
+//   HeadlessBench shadows [--seed N] [--radius R] [--frames F]
+//   HeadlessBench entities [--frames F]
+//   HeadlessBench ecs [--seed N] [--entities N] [--frames F] [--threads T]
+//   HeadlessBench lod [--entities N] [--frames F] [--threads T]
+//   HeadlessBench grid [--seed N] [--entities N] [--frames F] [--ops N]
+//   HeadlessBench raycast [--seed N] [--radius R] [--ops N] [--threads T]
+//   HeadlessBench heights [--seed N] [--radius R] [--ops N]
+//   HeadlessBench collision [--seed N] [--radius R] [--ops N] [--frames F]
+//
+// worldgen generates the (2R+1)^2 chunks around the origin on T threads and optionally meshes them.
+// The content hash only depends on the seed and radius, so any change in it means worldgen output changed.
+//
+// stream runs the game's per frame world pipeline (streaming, generation, meshing, player physics) with
+// render distance R at an unthrottled fixed 60hz timestep, first until the initial load is done and then
+// for F frames of the player sprinting forward, and reports frame times and how much work got through.
+//
+// frame runs the same thing but also renders every frame through the state cache and the recording device
+// (no gpu), run it from this folder so the shaders and ../ResourceFiles are found. It reports draw calls, bytes
+// uploaded, state changes that got past the cache and the ones it dropped per frame. Then it renders one frame
+// with the cache off and again with it on and checks every draw saw the same bound state and the calls that
+// reached the device went down by exactly what the cache says it dropped, exits with 1 if not. Exits with 2 if any
+// walking frame goes over one of the given budgets (0 = no limit), looks up a uniform by name or a frame made a
+// call with nothing bound, so ci can fail on render regressions.
+//
+// alloc drives the chunk arena's ArenaAllocator on its own: fills it to about 70% with chunk mesh sized
+// blocks, then does N random free + allocate pairs and reports the cost per call and how fragmented it got,
+// then compacts until no block above a hole fits into it, which can leave smaller holes behind, and reports the
+// time and moves that took. Exits with 1 if the allocator's internal checks fail.
+//
+// cull frustum culls a (2R+1)^2 grid of chunk sized boxes with random heights from F camera directions,
+// one box at a time, with the batched sse kernel and through the quadtree, at radius 8, 16 and 32 unless
+// --radius is given. Reports the time per frame of each and exits with 1 if they ever disagree on which
+// boxes are visible.
+//
+// sections loads the world once, digs a small room deep underground under spawn and turns the camera a full
+// circle over F frames from two spots, in that room and on top of the tallest mountain in reach. It does this
+// five times: culling and drawing whole chunks, per 16 block section, per section minus the face direction
+// buckets turned away from the camera or light, minus the sections the room's air cant see into (cave culling),
+// and with the occlusion buffer on top. Reports the triangles the shadow and main passes submitted per frame for each,
+// then brute force checks the face bucket selection on random boxes and checks section connectivity and the cave
+// walk on hand dug tunnels, and marches to every face the walk dropped from both spots to make sure it is behind rock.
+// Run it from this folder like frame. Exits with 1 if a bucket with a visible face was dropped, a tunnel check
+// failed or a dropped section was in sight, 2 if a frame made a call with nothing bound.
+//
+// occlusion loads the world and looks around from ground level at 8 spots around spawn over F frames. Each
+// frame frustum culls the sections, then draws the nearby solid column boxes into the cpu occlusion buffer
+// and tests the sections against it, on one thread and on several. Reports how many sections and triangles
+// were culled and the raster and test time per frame. Also checks known answers on a hand placed wall and
+// that the sse, scalar and multi threaded buffers are identical, exits with 1 if any of that fails.
+//
+// shadows first checks the cascade math on random cameras and suns: splits, every slice inside its light box
+// with room for casters above it and the filter around it, walking moving the boxes by whole texels only, and in
+// cached mode tiles staying put in the atlas and only redrawing when they scroll in or a chunk under them changes.
+// The caster volumes are checked against marching the light down from points in random boxes: a box whose shadow
+// reaches the slice or tile must be kept, and how many the plain light boxes would keep is reported next to it.
+// Then it loads the world and turns the camera at ground level for F frames with a few cascade counts and resolutions,
+// reporting the depth atlas size and texels filled per frame against the old single 8192^2 map, the shadow pass
+// triangles, the casters submitted per frame and what each cascade's light box and caster volume cull down to.
+// Last it switches to cached tiles and reports how many tiles get redrawn per frame standing still, turning,
+// sprinting, with the sun moving and with chunks being remeshed.
+// Exits with 1 if a check fails, 2 on invalid calls.
+//
+// entities renders F frames with 0, 100, 1000 and 10000 bees spread over the spawn area, through the recording
+// device and with no terrain loaded so the mobs are all the frame does differently. Reports the render time per
+// frame, what each extra bee costs, the draw calls, uniform uploads and instance bytes per frame, and the time to
+// batch the transforms on their own. Run it from this folder like frame. Also checks the batcher keeps every
+// model's instances in order and stops allocating once the count settles. Exits with 1 if draws or uniform
+// uploads grow with the bee count or a check fails, 2 on invalid calls.
+//
+// ecs ticks N entities (100000 by default) through the entity systems for F frames at 60hz on 1 thread and on T
+// (at least 2), knocking 1% of them down every second so some die and get removed. Reports the time per frame of
+// each system and the same ai, movement and health done the old way, one heap object with a virtual update per
+// entity. First checks the entity store's handles against a reference through random creates and destroys.
+// Exits with 1 if that check fails or the thread counts end up with different entities. Update tiers are off here,
+// every entity is updated every frame.
+//
+// lod ticks N/10, N and 10N entities (N is 100000 by default) spread on a grid at the same density each time,
+// with the player walking across it, for F frames with the update tiers off and on. Reports the time per frame,
+// the entities in each tier and how many of them were updated per frame, and how many changed tier. Then stands
+// still while every medium entity catches up and for a full reclassify cycle, and checks every entity sits in the
+// tier its distance asks for, give or take what it can walk in those frames, and that every near entity was
+// updated that frame. Exits with 1 if a check fails.
+//
+// grid puts N/10 and N entities (N is 100000 by default) at random over a 512x512 block area and times building
+// the entity grid, keeping it up to date while the entity systems move everything for F frames, and OPS range
+// (radius 8), box (16 blocks) and 8 nearest (within 32) queries of each kind, next to the same range query done
+// by walking every entity. Every query kind is checked against that walk on a few hundred random queries, and
+// nearest with no distance limit from near and far, before and after the frames of movement. Exits with 1 if any
+// result differs.
+//
+// raycast checks the grid traversal on hand made edge cases (axis rays both ways, negative coordinates, starting
+// inside a block or on a boundary, rays through block edges and corners, the max distance boundary, zero and
+// unnormalized directions) and on random rays through random blocks against intersecting the ray with every block
+// box, where the old 0.1 step march is compared as well. Then loads the world at render distance R and times OPS
+// rays from the spawn in random directions at reach 5 and 64, through World::raycast and the old march. Last it
+// casts 1k, 10k and 100k rays of reach 64 from random spots just above the terrain, one at a time through
+// World::raycast, as one batch and as a batch split over T worker threads while the main thread keeps editing a
+// block through World::setBlockAt, and reports rays/s. The traversal that jumps empty cubes is checked against the
+// same random blocks and every batch result against World::raycast. Exits with 1 if a check fails.
+//
+// heights loads the world at render distance R and checks every chunk's column tops and tallest block against
+// scanning its blocks, and the height pyramid's columns against those, then again after 20000 random builds and
+// digs around the spawn through World::setBlockAt. Then it times OPS/10 region height queries from a few blocks to the whole world
+// and OPS/10 long heightfield rays from above the ground, through the pyramid and against walking every column or
+// every block, checking every walked result is the same. Exits with 1 if a check fails.
+//
+// collision checks the swept box collision on hand made cases (landing, falling 50 blocks a frame onto a one
+// block floor, walls either way, ceilings, corners, sliding, starting inside a block), on random single axis
+// sweeps against the nearest block worked out from every block, and on random fast moves that must never end
+// inside a block and come out the same twice. Then it loads the world at render distance R, drops a box onto the
+// ground at 100 blocks a frame, times OPS random moves through World::moveBox next to the old 3x3x3 scan
+// and walks two players with the same input for F frames. Exits with 1 if a check fails, the two players ever
+// differ or moving allocates.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cmath>
+#include <thread>
+#include <random>
+#include <cstring>
+#include <limits>
+#include <cstdlib>
+#include <new>
+#include <unordered_map>
+
+#include "Chunk.h"
+#include "TerrainGenerator.h"
+#include "ChunkSource.h"
+#include "World.h"
+#include "Player.h"
+#include "Renderer.h"
+#include "RecordingRenderDevice.h"
+#include "CachingRenderDevice.h"
+#include "ArenaAllocator.h"
+#include "Frustum.h"
+#include "ChunkRenderRecords.h"
+#include "ChunkQuadtree.h"
+#include "FaceBuckets.h"
+#include "OcclusionBuffer.h"
+#include "SectionGraph.h"
+#include "ShadowCascades.h"
+#include "InstanceBatcher.h"
+#include "EntityStore.h"
+#include "EntityGrid.h"
+#include "EntitySystems.h"
+
+//counts the heap allocations this thread makes while it is alive, so collision can show moving makes none.
+//Outside of one the operator new below is a plain malloc, so the other modes' timings do not pay for the count
+static thread_local size_t* allocationCounter = nullptr;
+
+struct AllocationCount {
+    size_t count = 0;
+    size_t* outer;
+
+    AllocationCount() : outer(allocationCounter) { allocationCounter = &count; }
+    ~AllocationCount() { allocationCounter = outer; }
+    AllocationCount(const AllocationCount&) = delete;
+    AllocationCount& operator=(const AllocationCount&) = delete;
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"//gcc pairs the free below with every inlined new
+#endif
+
+void* operator new(size_t size) {
+    if (allocationCounter) ++*allocationCounter;
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchOptions {
+        int seed = 1337;
+        int radius = 8;
+        bool radiusSet = false;
+        int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        bool mesh = false;
+        int frames = 600;
+        size_t maxDraws = 0;//render budgets, 0 = no limit
+        size_t maxUploadBytes = 0;
+        size_t maxStateChanges = 0;
+        int ops = 1000000;//alloc churn operations
+        int entities = 100000;
+    };
+
+    //fixed square of chunks around the origin, each slot is only written by the thread that generates it
+    class RegionChunkSource : public ChunkSource
+    {
+    public:
+        RegionChunkSource(int radius) : radius(radius), side(radius * 2 + 1), chunks(side * side) {}
+
+        Chunk* getChunk(const glm::vec3& pos) override {
+            int x = static_cast<int>(std::floor(pos.x / Chunk::chunkSize)) + radius;
+            int z = static_cast<int>(std::floor(pos.z / Chunk::chunkSize)) + radius;
+            if (x < 0 || x >= side || z < 0 || z >= side) return nullptr;
+            return chunks[z * side + x].get();
+        }
+        TerrainGenerator& getTerrain() override { return terrain; }
+
+        glm::ivec3 slotPosition(size_t slot) const {
+            int x = static_cast<int>(slot % side) - radius;
+            int z = static_cast<int>(slot / side) - radius;
+            return glm::ivec3(x * Chunk::chunkSize, -Chunk::baseTerrainHeight, z * Chunk::chunkSize);
+        }
+
+        TerrainGenerator terrain;
+        int radius, side;
+        std::vector<std::unique_ptr<Chunk>> chunks;
+    };
+
+    //FNV-1a, fed field by field so struct padding never ends up in the hash
+    struct ContentHash {
+        uint64_t value = 14695981039346656037ull;
+
+        void add(const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; i++) {
+                value ^= bytes[i];
+                value *= 1099511628211ull;
+            }
+        }
+        template <typename T>
+        void add(const T& v) { add(&v, sizeof(T)); }
+    };
+
+    //runs job(i) for every i in [0, count) on threadCount workers and returns the latency of each job in ms
+    template <typename Job>
+    std::vector<double> runParallel(size_t count, int threadCount, Job job) {
+        std::vector<double> latencies(count, 0.0);
+        std::atomic<size_t> next(0);
+
+        std::vector<std::future<void>> workers;
+        for (int t = 0; t < threadCount; t++) {
+            workers.push_back(std::async(std::launch::async, [&]() {
+                for (size_t i = next++; i < count; i = next++) {
+                    Clock::time_point start = Clock::now();
+                    job(i);
+                    latencies[i] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                }
+                }));
+        }
+        for (auto& worker : workers) worker.get();
+        return latencies;
+    }
+
+    double percentile(std::vector<double> values, double p) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        size_t rank = static_cast<size_t>(std::ceil(p * values.size()));
+        return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+
+    void printPhase(const char* name, size_t count, double wallMs, const std::vector<double>& latencies) {
+        std::cout << std::fixed << std::setprecision(2)
+            << name << ": " << count << " in " << wallMs << " ms, "
+            << (count / (wallMs / 1000.0)) << "/s, "
+            << "p50 " << percentile(latencies, 0.50) << " ms, "
+            << "p99 " << percentile(latencies, 0.99) << " ms" << std::endl;
+    }
+
+    int runWorldgen(const BenchOptions& options) {
+        RegionChunkSource region(options.radius);
+        region.terrain.init(options.seed, 0);//no prewarm, noise cost is part of what we measure
+
+        size_t count = region.chunks.size();
+        std::cout << "worldgen seed " << options.seed << ", radius " << options.radius
+            << " (" << count << " chunks), " << options.threads << " threads" << std::endl;
+
+        //generation
+        Clock::time_point start = Clock::now();
+        std::vector<double> genLatencies = runParallel(count, options.threads, [&](size_t i) {
+            region.chunks[i] = std::make_unique<Chunk>(region.slotPosition(i), options.seed, &region);
+            });
+        double genMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        printPhase("chunks", count, genMs, genLatencies);
+
+        ContentHash hash;
+        for (const auto& chunk : region.chunks) {
+            hash.add(chunk->blocks.data(), chunk->blocks.size() * sizeof(BlockType));
+        }
+
+        //meshing, runs after every chunk exists so neighbour lookups match a fully loaded world
+        if (options.mesh) {
+            std::vector<uint64_t> meshHashes(count);
+            std::vector<size_t> meshFaces(count);
+
+            start = Clock::now();
+            std::vector<double> meshLatencies = runParallel(count, options.threads, [&](size_t i) {
+                MeshData mesh = region.chunks[i]->generateMeshData();
+
+                ContentHash meshHash;
+                size_t faces = 0;
+                for (const PackedVertex& v : mesh.vertices) {
+                    meshHash.add(v.pos);
+                    meshHash.add(v.colour);
+                    meshHash.add(v.tex);
+                    meshHash.add(v.normal);
+                }
+                meshHash.add(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+                for (const MeshSection& section : mesh.sections) {
+                    meshHash.add(section.indexCount);
+                }
+                faces = mesh.vertices.size() / 4;
+                meshHashes[i] = meshHash.value;
+                meshFaces[i] = faces;
+                });
+            double meshMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            printPhase("meshes", count, meshMs, meshLatencies);
+
+            size_t totalFaces = 0;
+            for (size_t i = 0; i < count; i++) {
+                hash.add(meshHashes[i]);
+                totalFaces += meshFaces[i];
+            }
+            std::cout << "faces: " << totalFaces << std::endl;
+        }
+
+        std::cout << "content hash: 0x" << std::hex << std::setw(16) << std::setfill('0') << hash.value << std::dec << std::endl;
+        return 0;
+    }
+
+    struct StreamStats {
+        std::vector<double> frameMs;
+        size_t meshUploads = 0;
+    };
+
+    //one frame of the same work Main::run does minus input polling, renderer is null for world only runs
+    void streamFrame(World& world, Player& player, const PlayerInput& input, float deltaTime, StreamStats& stats,
+        Renderer* renderer = nullptr, RenderDevice* device = nullptr) {
+        Clock::time_point start = Clock::now();
+
+        world.updateChunks(player.getCameraPos());
+        world.tryApplyChunkGeneration();
+        player.update(deltaTime, input);
+        world.processChunkMeshingInOrder(player.getCameraPos());
+        {
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            std::vector<Chunk*> uploads = world.takeMeshUploads();
+            stats.meshUploads += uploads.size();
+            if (renderer) {
+                for (Chunk* chunk : uploads) {
+                    renderer->uploadChunkMesh(*chunk);
+                }
+            }
+            else {
+                world.takeActivityChanges();//the renderer drains these, nothing else will
+            }
+        }
+        world.updateEntities(deltaTime, player.getCameraPos());
+
+        if (renderer) {
+            FrameView frame;
+            frame.view = player.getViewMatrix();
+            frame.cameraPos = player.getCameraPos();
+            frame.width = 1280;
+            frame.height = 720;
+            frame.time = stats.frameMs.size() * deltaTime;
+            RaycastHit hit;
+            frame.hasHighlight = world.raycast(player.getCameraPos(), player.getCameraFront(), 5.0f, hit);
+            frame.highlightPos = glm::vec3(hit.block);
+
+            renderer->render(frame);
+            device->endFrame();
+        }
+
+        stats.frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    void printStream(const char* name, const StreamStats& stats, double wallMs, World& world) {
+        size_t chunkCount;
+        {
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            chunkCount = world.chunks.size();
+        }
+        double total = 0.0;
+        for (double ms : stats.frameMs) total += ms;
+
+        std::cout << std::fixed << std::setprecision(2)
+            << name << ": " << stats.frameMs.size() << " frames in " << wallMs << " ms, "
+            << "frame avg " << (stats.frameMs.empty() ? 0.0 : total / stats.frameMs.size()) << " ms, "
+            << "p50 " << percentile(stats.frameMs, 0.50) << " ms, "
+            << "p99 " << percentile(stats.frameMs, 0.99) << " ms, "
+            << chunkCount << " chunks loaded, " << stats.meshUploads << " meshes ready" << std::endl;
+    }
+
+    int runStream(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const int maxLoadFrames = 100000;//bail out instead of spinning forever if loading stalls
+
+        World world(options.radius);
+        world.init(options.seed);
+        Player player(&world);
+        player.spawn(glm::vec3(10, 200, 10));
+
+        std::cout << "stream seed " << options.seed << ", render distance " << options.radius
+            << ", " << options.frames << " frames" << std::endl;
+
+        //initial load, player stands still while the world fills in around them
+        StreamStats loadStats;
+        PlayerInput idle;
+        Clock::time_point start = Clock::now();
+        while ((world.isLoading() || world.hasPendingWork()) && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats);
+        }
+        printStream("load", loadStats, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), world);
+
+        //there was no ground under the player for most of the load, put them back on top of the terrain
+        player.spawn(glm::vec3(10, 200, 10));
+
+        //sprint and jump forward so new chunks keep streaming in ahead and going inactive behind
+        StreamStats walkStats;
+        PlayerInput walk;
+        walk.forward = true;
+        walk.sprint = true;
+        walk.jump = true;//hop up steps instead of getting stuck on the first hill
+        start = Clock::now();
+        for (int frame = 0; frame < options.frames; frame++) {
+            streamFrame(world, player, walk, deltaTime, walkStats);
+        }
+        printStream("walk", walkStats, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), world);
+
+        glm::vec3 pos = player.getCameraPos();
+        std::cout << "player ended at " << pos.x << ", " << pos.y << ", " << pos.z << std::endl;
+        return 0;
+    }
+
+    //per frame render stats for frames [first, end) of the recording device history
+    void printRenderStats(const char* name, const std::vector<RenderFrameStats>& history, size_t first, size_t end) {
+        std::vector<double> draws, ranges, uploads, states, uniforms, lookups;
+        for (size_t i = first; i < end; i++) {
+            draws.push_back(static_cast<double>(history[i].drawCalls));
+            ranges.push_back(static_cast<double>(history[i].drawRanges));
+            uploads.push_back(history[i].uploadBytes() / 1024.0);
+            states.push_back(static_cast<double>(history[i].stateChanges));
+            uniforms.push_back(static_cast<double>(history[i].uniformUploads));
+            lookups.push_back(static_cast<double>(history[i].uniformLookups));
+        }
+        auto line = [](const char* what, const std::vector<double>& values) {
+            std::cout << "  " << what << " p50 " << percentile(values, 0.50) << ", p99 " << percentile(values, 0.99)
+                << ", max " << percentile(values, 1.0) << std::endl;
+        };
+        std::cout << std::fixed << std::setprecision(1) << name << " render, " << (end - first) << " frames:" << std::endl;
+        line("draw calls     ", draws);
+        line("meshes drawn   ", ranges);
+        line("upload kb      ", uploads);
+        line("state changes  ", states);
+        line("uniform uploads", uniforms);
+        line("uniform lookups", lookups);
+    }
+
+    //returns how many frames in [first, end) broke a budget or made invalid calls
+    size_t checkBudgets(const BenchOptions& options, const std::vector<RenderFrameStats>& history, size_t first, size_t end) {
+        size_t failures = 0;
+        for (size_t i = first; i < end; i++) {
+            const RenderFrameStats& stats = history[i];
+            bool over = (options.maxDraws > 0 && stats.drawCalls > options.maxDraws)
+                || (options.maxUploadBytes > 0 && stats.uploadBytes() > options.maxUploadBytes)
+                || (options.maxStateChanges > 0 && stats.stateChanges > options.maxStateChanges)
+                || stats.invalidCalls > 0 || stats.uniformLookups > 0;
+            if (!over) continue;
+
+            if (failures < 5) {
+                std::cerr << "frame " << i << " over budget: " << stats.drawCalls << " draws, " << stats.uploadBytes() << " bytes uploaded, "
+                    << stats.stateChanges << " state changes, " << stats.invalidCalls << " invalid calls, "
+                    << stats.uniformLookups << " uniform lookups" << std::endl;
+            }
+            failures++;
+        }
+        return failures;
+    }
+
+    //the same frame with the state cache passing everything through and then dropping what it can: every draw
+    //has to see the same bindings and the device has to get exactly the calls the cache didnt count as elided
+    bool checkStateCache(Renderer& renderer, RecordingRenderDevice& device, CachingRenderDevice& stateCache, Player& player) {
+        FrameView frame;
+        frame.view = player.getViewMatrix();
+        frame.cameraPos = player.getCameraPos();
+        frame.width = 1280;
+        frame.height = 720;
+        frame.time = 20.0f;
+        frame.hasHighlight = true;
+        frame.highlightPos = glm::floor(player.getCameraPos()) - glm::vec3(0, 2, 0);
+
+        //cached shadow tiles would only be drawn by the first of the two frames
+        bool cachedShadows = renderer.shadowSettings.cached;
+        renderer.shadowSettings.cached = false;
+        renderer.render(frame);
+        stateCache.endFrame();
+
+        RenderFrameStats frames[2];
+        StateCacheStats cached[2];
+        for (int i = 0; i < 2; i++) {
+            stateCache.enabled = i == 1;
+            renderer.render(frame);
+            stateCache.endFrame();
+            frames[i] = device.frameHistory().back();
+            cached[i] = stateCache.lastFrameStats();
+        }
+        stateCache.enabled = true;
+        renderer.shadowSettings.cached = cachedShadows;
+
+        bool sameDraws = frames[0].drawState == frames[1].drawState && frames[0].drawCalls == frames[1].drawCalls
+            && frames[0].indices == frames[1].indices;
+        bool counted = cached[0].elided == 0 && frames[1].stateChanges + cached[1].elided == frames[0].stateChanges
+            && cached[0].issued == cached[1].issued + cached[1].elided;
+        std::cout << "state cache check: " << frames[0].stateChanges << " state changes uncached, " << frames[1].stateChanges
+            << " cached, " << cached[1].elided << " elided, " << frames[0].drawCalls << " draws "
+            << (sameDraws ? "saw the same state" : "SAW DIFFERENT STATE") << (counted ? "" : ", COUNTS DONT ADD UP") << std::endl;
+        return sameDraws && counted;
+    }
+
+    int runFrame(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const int maxLoadFrames = 100000;
+
+        World world(options.radius);
+        world.init(options.seed);
+        Player player(&world);
+        player.spawn(glm::vec3(10, 200, 10));
+
+        RecordingRenderDevice device;
+        device.keepCommands = false;
+        CachingRenderDevice stateCache(device);//same as the game
+        Renderer renderer(stateCache, world);
+        renderer.init();
+
+        std::cout << "frame seed " << options.seed << ", render distance " << options.radius
+            << ", " << options.frames << " frames, recording device" << std::endl;
+
+        StreamStats loadStats;
+        PlayerInput idle;
+        Clock::time_point start = Clock::now();
+        while ((world.isLoading() || world.hasPendingWork()) && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats, &renderer, &stateCache);
+        }
+        printStream("load", loadStats, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), world);
+        size_t walkStart = device.frameHistory().size();
+
+        player.spawn(glm::vec3(10, 200, 10));
+
+        StreamStats walkStats;
+        PlayerInput walk;
+        walk.forward = true;
+        walk.sprint = true;
+        walk.jump = true;
+        start = Clock::now();
+        std::vector<double> issued, elided;
+        for (int frame = 0; frame < options.frames; frame++) {
+            streamFrame(world, player, walk, deltaTime, walkStats, &renderer, &stateCache);
+            issued.push_back(static_cast<double>(stateCache.lastFrameStats().issued));
+            elided.push_back(static_cast<double>(stateCache.lastFrameStats().elided));
+        }
+        printStream("walk", walkStats, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), world);
+
+        const std::vector<RenderFrameStats>& history = device.frameHistory();
+        size_t walkEnd = history.size();
+        printRenderStats("load", history, 0, walkStart);
+        printRenderStats("walk", history, walkEnd - issued.size(), walkEnd);
+        std::cout << "  cached state   p50 " << percentile(issued, 0.50) << " issued, " << percentile(elided, 0.50)
+            << " elided, max " << percentile(elided, 1.0) << " elided" << std::endl;
+        std::cout << "resident buffers: " << device.liveBuffers() << ", " << (device.residentBufferBytes() / 1024) << " kb, textures "
+            << (device.residentTextureBytes() / 1024) << " kb" << std::endl;
+        const ChunkArena& arena = renderer.getChunkArena();
+        std::cout << std::setprecision(2) << "chunk arena: " << arena.vertexAllocator().liveAllocations() << " meshes, vertices "
+            << arena.vertexAllocator().usedSize() << "/" << arena.vertexAllocator().getCapacity()
+            << " (frag " << arena.vertexAllocator().fragmentation() << "), indices "
+            << arena.indexAllocator().usedSize() << "/" << arena.indexAllocator().getCapacity()
+            << " (frag " << arena.indexAllocator().fragmentation() << "), "
+            << (arena.movedBytes() / 1024) << " kb moved on the gpu" << std::endl;
+
+        bool cacheOk = checkStateCache(renderer, device, stateCache, player);
+
+        //load frames upload everything so only steady state frames are held to the budget, invalid calls fail anywhere
+        size_t failures = checkBudgets(options, history, walkStart, walkEnd);
+        for (size_t i = 0; i < walkStart; i++) {
+            if (history[i].invalidCalls > 0) failures++;
+        }
+        if (failures > 0) {
+            std::cerr << failures << " frames over budget" << std::endl;
+            return 2;
+        }
+        std::cout << "budgets ok" << std::endl;
+        return cacheOk ? 0 : 1;
+    }
+
+    //triangles one pass of a frame submitted, split on the framebuffer the draws went to
+    struct PassTriangles {
+        double shadow = 0, main = 0, ranges = 0;
+        double casters = 0;//records the shadow pass culled in
+    };
+
+    //world y of the highest block in the column, or the bottom of the world if the chunk isnt loaded
+    int surfaceHeight(World& world, int x, int z) {
+        Chunk* chunk = world.getChunk(glm::vec3(x, 0, z));
+        if (!chunk) return -Chunk::baseTerrainHeight;
+        int localX = x - static_cast<int>(chunk->chunkPosition.x);
+        int localZ = z - static_cast<int>(chunk->chunkPosition.z);
+        for (int y = Chunk::chunkHeight - 1; y >= 0; y--) {
+            if (chunk->blocks[chunk->getBlockIndex(localX, y, localZ)] != BlockType::AIR) {
+                return static_cast<int>(chunk->chunkPosition.y) + y;
+            }
+        }
+        return -Chunk::baseTerrainHeight;
+    }
+
+    //one full turn from a fixed spot looking a little down, averaged per frame
+    PassTriangles turnCamera(Renderer& renderer, RecordingRenderDevice& device, const glm::vec3& eye, int frames) {
+        PassTriangles total;
+        for (int i = 0; i < frames; i++) {
+            float yaw = 6.2831853f * i / frames;
+            float pitch = -0.3f;
+            glm::vec3 forward(cos(pitch) * cos(yaw), sin(pitch), cos(pitch) * sin(yaw));
+            FrameView frame;
+            frame.view = glm::lookAt(eye, eye + forward, glm::vec3(0, 1, 0));
+            frame.cameraPos = eye;
+            frame.width = 1280;
+            frame.height = 720;
+            frame.time = 20.0f;//sun high enough that the shadow box covers the camera
+            renderer.render(frame);
+
+            bool shadowPass = false;
+            for (const RecordedCommand& command : device.commands()) {
+                if (command.call == RecordedCall::BindFramebuffer) shadowPass = command.handle != 0;
+                if (command.call != RecordedCall::Draw) continue;
+                (shadowPass ? total.shadow : total.main) += command.count / 3.0;
+            }
+            total.ranges += device.frameStats().drawRanges;
+            total.casters += renderer.getShadowStats().casters;
+            device.endFrame();
+        }
+        double count = std::max(1, frames);
+        total.casters /= count;
+        total.shadow /= count;
+        total.main /= count;
+        total.ranges /= count;
+        return total;
+    }
+
+    //brute force over every face plane a box can hold: a dropped bucket must not have a single face turned
+    //towards the viewer, checked against the same normals the mesher writes so the bucket order cant drift
+    bool checkFaceBuckets(const BenchOptions& options) {
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_int_distribution<int> corner(-20, 20), extent(1, 16);
+        std::uniform_real_distribution<float> coord(-40.0f, 40.0f);
+        size_t wrong = 0, dropped = 0, checks = 20000;
+        for (size_t n = 0; n < checks; n++) {
+            glm::ivec3 min(corner(rng), corner(rng), corner(rng));
+            glm::ivec3 max = min + glm::ivec3(extent(rng), extent(rng), extent(rng));
+            glm::vec3 eye(coord(rng), coord(rng), coord(rng));
+            if (n % 4 == 0) eye = glm::floor(eye);//land on face planes as well
+            glm::vec3 direction(coord(rng), coord(rng), coord(rng));
+            unsigned int eyeMask = visibleFaceBuckets(eye, glm::vec3(min), glm::vec3(max));
+            unsigned int directionMask = visibleFaceBuckets(direction);
+
+            for (int f = 0; f < MeshSection::faceDirections; f++) {
+                int axis = normals[f].x != 0.0f ? 0 : (normals[f].y != 0.0f ? 1 : 2);
+                float sign = normals[f][axis];
+                bool anyFacing = false;
+                for (int b = min[axis]; b < max[axis]; b++) {
+                    float plane = sign > 0.0f ? b + 1.0f : static_cast<float>(b);
+                    if (sign * (eye[axis] - plane) > 0.0f) anyFacing = true;
+                }
+                bool eyeKept = (eyeMask >> f) & 1u;
+                bool directionKept = (directionMask >> f) & 1u;
+                if (anyFacing && !eyeKept) wrong++;
+                if ((glm::dot(normals[f], direction) < 0.0f) != directionKept) wrong++;
+                if (!eyeKept) dropped++;
+            }
+        }
+        std::cout << "face bucket check: " << checks << " boxes, " << dropped << " buckets dropped, " << wrong << " wrong" << std::endl;
+        return wrong == 0;
+    }
+
+    //three chunks in a row along x, solid stone except for the tunnels, known answers for the connectivity and the walk
+    bool checkCaves() {
+        RegionChunkSource source(1);
+        const int row[3] = { 3, 4, 5 };//slots z = 0, x = -1, 0, 1
+        for (int slot : row) {
+            source.chunks[slot] = std::make_unique<Chunk>(source.slotPosition(slot), 0, &source);
+            std::fill(source.chunks[slot]->blocks.begin(), source.chunks[slot]->blocks.end(), BlockType::STONE);
+        }
+        Chunk& west = *source.chunks[3];
+        Chunk& middle = *source.chunks[4];
+        Chunk& east = *source.chunks[5];
+
+        const int tunnelY = 40, tunnelZ = 8, tunnelSection = tunnelY / MeshData::sectionHeight;
+        //straight into blocks, setBlock would touch neighbours that are only cached on meshing
+        auto clear = [](Chunk& chunk, int x, int y, int z) { chunk.blocks[chunk.getBlockIndex(x, y, z)] = BlockType::AIR; };
+        auto dig = [&](Chunk& chunk) {
+            for (int x = 0; x < Chunk::chunkSize; x++) clear(chunk, x, tunnelY, tunnelZ);
+        };
+        dig(west);
+        for (int y = 52; y < 55; y++) clear(west, 8, y, 8);//sealed pocket in the next section up
+        for (int x = 0; x < Chunk::chunkSize; x++) {//open section at the top
+            for (int y = 240; y < Chunk::chunkHeight; y++) {
+                for (int z = 0; z < Chunk::chunkSize; z++) clear(west, x, y, z);
+            }
+        }
+
+        bool ok = true;
+        auto expect = [&](bool value, const char* what) {
+            if (!value) {
+                std::cerr << "cave check failed: " << what << std::endl;
+                ok = false;
+            }
+        };
+        const uint64_t leftRight = (1ull << (2 * 6 + 2)) | (1ull << (2 * 6 + 3)) | (1ull << (3 * 6 + 2)) | (1ull << (3 * 6 + 3));
+        MeshData westMesh = west.generateMeshData();
+        expect(westMesh.sections[tunnelSection].connectivity == leftRight, "tunnel joins only its two ends");
+        expect(westMesh.sections[tunnelSection + 1].connectivity == 0, "sealed pocket joins nothing");
+        expect(westMesh.sections[0].connectivity == 0, "solid section joins nothing");
+        expect(westMesh.sections[MeshData::sectionCount - 1].connectivity == MeshSection::allConnected, "open section joins everything");
+
+        //eye in the west tunnel, the walk has to stop at the middle chunk until a tunnel goes through it
+        SectionGraph graph;
+        glm::vec3 eye = west.chunkPosition + glm::vec3(4.5f, tunnelY + 0.5f, tunnelZ + 0.5f);
+        for (int pass = 0; pass < 2; pass++) {
+            if (pass == 1) dig(middle);
+            for (Chunk* chunk : { &west, &middle, &east }) graph.update(chunk, chunk->chunkPosition, chunk->generateMeshData().sections);
+            expect(graph.traverse(eye, nullptr, 0), "eye is inside the graph");
+            expect(graph.isVisible(&west, tunnelSection), "eye section is visible");
+            expect(graph.isVisible(&west, tunnelSection + 1), "rock next to the eye is visible");
+            expect(!graph.isVisible(&west, 0), "rock behind rock is hidden");
+            expect(!graph.isVisible(&west, MeshData::sectionCount - 1), "sky behind rock is hidden");
+            expect(graph.isVisible(&middle, tunnelSection), "the end of the tunnel is visible");
+            expect(graph.isVisible(&east, tunnelSection) == (pass == 1), pass == 0 ? "rock past a dead end is hidden" : "the far side of a through tunnel is visible");
+        }
+        expect(!graph.traverse(eye + glm::vec3(0, 300, 0), nullptr, 0), "eye above the world culls nothing");
+
+        std::cout << "cave check: " << (ok ? "ok" : "failed") << std::endl;
+        return ok;
+    }
+
+    bool isSolidAt(World& world, const glm::ivec3& block) {
+        Chunk* chunk = world.getChunk(glm::vec3(block));
+        if (!chunk) return false;
+        glm::ivec3 local = block - glm::ivec3(chunk->chunkPosition);
+        if (local.y < 0 || local.y >= Chunk::chunkHeight) return false;
+        return chunk->blocks[chunk->getBlockIndex(local.x, local.y, local.z)] != BlockType::AIR;
+    }
+
+    //every face of a section the cave walk dropped, in any direction, is marched to from the eye through the blocks,
+    //none may get there without hitting rock. Returns how many sections had a face that could be seen
+    size_t checkCaveWalk(World& world, const SectionGraph& graph, const glm::vec3& eye) {
+        size_t culled = 0, wrong = 0;
+        for (auto& pair : world.chunks) {
+            Chunk& chunk = pair.second;
+            if (chunk.vertexBlock == 0) continue;
+            for (int s = 0; s < MeshData::sectionCount; s++) {
+                if (chunk.mesh.sections[s].indexCount == 0 || graph.isVisible(&chunk, s)) continue;
+                culled++;
+                bool seen = false;
+                for (int y = s * MeshData::sectionHeight; y < (s + 1) * MeshData::sectionHeight && !seen; y++) {
+                    for (int z = 0; z < Chunk::chunkSize && !seen; z++) {
+                        for (int x = 0; x < Chunk::chunkSize && !seen; x++) {
+                            glm::ivec3 block = glm::ivec3(chunk.chunkPosition) + glm::ivec3(x, y, z);
+                            if (!isSolidAt(world, block)) continue;
+                            for (int f = 0; f < MeshSection::faceDirections && !seen; f++) {
+                                glm::ivec3 normal(normals[f]);
+                                if (isSolidAt(world, block + normal)) continue;
+                                glm::vec3 centre = glm::vec3(block) + 0.5f + 0.5f * normals[f];
+                                if (glm::dot(eye - centre, normals[f]) <= 0.0f) continue;
+                                glm::vec3 toFace = centre - eye;
+                                float length = glm::length(toFace);
+                                bool blocked = false;
+                                for (float t = 0.05f; t < length - 0.05f && !blocked; t += 0.05f) {
+                                    blocked = isSolidAt(world, glm::ivec3(glm::floor(eye + toFace * (t / length))));
+                                }
+                                seen = !blocked;
+                            }
+                        }
+                    }
+                }
+                if (seen) wrong++;
+            }
+        }
+        std::cout << "  cave walk check: " << culled << " sections dropped, " << wrong << " with a face in sight" << std::endl;
+        return wrong;
+    }
+
+    //turns the camera on both paths with whole chunk records and again per section, over the same meshes
+    int runSections(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const int maxLoadFrames = 100000;
+
+        World world(options.radius);
+        world.init(options.seed);
+        Player player(&world);
+        player.spawn(glm::vec3(10, 200, 10));
+
+        RecordingRenderDevice device;
+        device.keepCommands = false;
+        Renderer renderer(device, world);
+        renderer.shadowSettings.cached = false;//every stage draws its whole shadow pass each frame
+        renderer.init();
+
+        std::cout << "sections seed " << options.seed << ", render distance " << options.radius
+            << ", " << options.frames << " frames per camera path, recording device" << std::endl;
+
+        StreamStats loadStats;
+        PlayerInput idle;
+        while ((world.isLoading() || world.hasPendingWork()) && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats, &renderer, &device);
+        }
+
+        glm::vec3 caveEye, peakEye;
+        {
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            //underground: well inside the rock under spawn, mountain: just over the tallest column in reach
+            caveEye = glm::vec3(8.5f, surfaceHeight(world, 8, 8) - 24.0f, 8.5f);
+            int peak = -Chunk::baseTerrainHeight;
+            int reach = options.radius * Chunk::chunkSize / 2;
+            for (int x = -reach; x < reach; x += 2) {
+                for (int z = -reach; z < reach; z += 2) {
+                    int height = surfaceHeight(world, x, z);
+                    if (height > peak) {
+                        peak = height;
+                        peakEye = glm::vec3(x + 0.5f, height + 3.0f, z + 0.5f);
+                    }
+                }
+            }
+        }
+        //a room around the underground eye, so it looks along cave walls instead of from inside the rock
+        for (int x = -4; x <= 4; x++) {
+            for (int y = -2; y <= 3; y++) {
+                for (int z = -4; z <= 4; z++) world.setBlockAt(glm::floor(caveEye) + glm::vec3(x, y, z), BlockType::AIR);
+            }
+        }
+        while (world.hasPendingWork() && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats, &renderer, &device);
+        }
+
+        std::cout << std::fixed << std::setprecision(1) << "underground eye " << caveEye.x << ", " << caveEye.y << ", " << caveEye.z
+            << ", mountain eye " << peakEye.x << ", " << peakEye.y << ", " << peakEye.z << std::endl;
+
+        size_t caveWalkErrors = 0;
+        {
+            //no frustum, so every direction at once
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            SectionGraph graph;
+            for (auto& pair : world.chunks) {
+                if (pair.second.vertexBlock != 0) graph.update(&pair.second, pair.second.chunkPosition, pair.second.mesh.sections);
+            }
+            for (const glm::vec3& eye : { caveEye, peakEye }) {
+                graph.traverse(eye, nullptr, world.renderDistance + 1);
+                caveWalkErrors += checkCaveWalk(world, graph, eye);
+            }
+        }
+
+        //each stage keeps the ones before it: whole chunks, per section, minus back facing buckets, minus sealed off sections, minus occluded sections
+        const int stageCount = 5;
+        const char* stages[stageCount] = { "whole chunk", "per section", "face buckets", "caves", "occlusion" };
+        PassTriangles results[stageCount][2];//[stage][path]
+        size_t pathStart = device.frameHistory().size();
+        for (int stage = 0; stage < stageCount; stage++) {
+            {
+                //the world is loaded and nothing streams from here on, so every stage sees the same meshes
+                std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+                renderer.sectionCulling = stage >= 1;
+                renderer.faceBucketCulling = stage >= 2;
+                renderer.caveCulling = stage >= 3;
+                renderer.occlusionCulling = stage >= 4;
+                for (auto& pair : world.chunks) {
+                    if (pair.second.vertexBlock != 0) renderer.uploadChunkMesh(pair.second);
+                }
+                std::cout << stages[stage] << ": " << renderer.getChunkRecords().size() << " records for "
+                    << renderer.getChunkRecords().chunkCount() << " chunks" << std::endl;
+            }
+            device.endFrame();//the re uploads
+
+            device.keepCommands = true;
+            results[stage][0] = turnCamera(renderer, device, caveEye, options.frames);
+            results[stage][1] = turnCamera(renderer, device, peakEye, options.frames);
+            device.keepCommands = false;
+        }
+
+        auto line = [&](const char* path, int p) {
+            auto row = [&](const char* what, double PassTriangles::* field) {
+                std::cout << "  " << what << std::setprecision(0);
+                for (int stage = 0; stage < stageCount; stage++) {
+                    double value = results[stage][p].*field;
+                    std::cout << (stage ? " -> " : " ") << value;
+                    double from = results[0][p].*field;
+                    if (stage > 0 && from > 0) std::cout << std::setprecision(1) << " (" << 100.0 * (value - from) / from << "%)" << std::setprecision(0);
+                }
+                std::cout << std::endl;
+            };
+            std::cout << std::fixed << path << " per frame";
+            for (int stage = 0; stage < stageCount; stage++) std::cout << (stage ? " -> " : ", ") << stages[stage];
+            std::cout << ":" << std::endl;
+            row("main triangles  ", &PassTriangles::main);
+            row("shadow triangles", &PassTriangles::shadow);
+            row("draw ranges     ", &PassTriangles::ranges);
+        };
+        line("underground", 0);
+        line("mountain", 1);
+
+        if (!checkFaceBuckets(options)) return 1;
+        if (!checkCaves() || caveWalkErrors > 0) return 1;
+
+        const std::vector<RenderFrameStats>& history = device.frameHistory();
+        for (size_t i = pathStart; i < history.size(); i++) {
+            if (history[i].invalidCalls > 0) {
+                std::cerr << "a camera path frame made invalid calls" << std::endl;
+                return 2;
+            }
+        }
+        return 0;
+    }
+
+    void printArena(const char* name, const ArenaAllocator& arena) {
+        std::cout << std::fixed << std::setprecision(3) << name << ": " << arena.liveAllocations() << " blocks, used "
+            << arena.usedSize() << "/" << arena.getCapacity() << ", " << arena.freeBlockCount() << " free blocks, largest free "
+            << arena.largestFreeBlock() << ", fragmentation " << arena.fragmentation() << std::endl;
+    }
+
+    int runAlloc(const BenchOptions& options) {
+        const uint32_t capacity = 1 << 24;//vertices, the size the chunk arena reaches at a big render distance
+        ArenaAllocator arena(capacity);
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        //chunk meshes are a few thousand vertices with a long tail for busy chunks
+        std::lognormal_distribution<double> meshSize(std::log(6000.0), 0.8);
+        auto nextSize = [&]() { return static_cast<uint32_t>(std::clamp(meshSize(rng), 4.0, 200000.0)); };
+
+        std::cout << "alloc seed " << options.seed << ", capacity " << capacity << ", " << options.ops << " churn ops" << std::endl;
+
+        std::vector<unsigned int> live;
+        size_t failures = 0;
+        while (arena.usedSize() < capacity / 10 * 7) {
+            unsigned int handle = arena.allocate(nextSize());
+            if (handle == ArenaAllocator::invalidHandle) break;
+            live.push_back(handle);
+        }
+        printArena("filled", arena);
+
+        //remeshing: a random chunk frees its block and a new mesh of a different size takes its place
+        std::vector<uint32_t> sizes(options.ops);
+        std::vector<size_t> victims(options.ops);
+        for (int i = 0; i < options.ops; i++) {
+            sizes[i] = nextSize();
+            victims[i] = rng();
+        }
+        double freeNs = 0, allocNs = 0;
+        for (int i = 0; i < options.ops; i++) {
+            size_t slot = victims[i] % live.size();
+            Clock::time_point t0 = Clock::now();
+            arena.free(live[slot]);
+            Clock::time_point t1 = Clock::now();
+            unsigned int handle = arena.allocate(sizes[i]);
+            Clock::time_point t2 = Clock::now();
+            freeNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+            allocNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+
+            if (handle == ArenaAllocator::invalidHandle) {
+                failures++;
+                live[slot] = live.back();
+                live.pop_back();
+                if (live.empty()) break;
+            }
+            else {
+                live[slot] = handle;
+            }
+        }
+        //timer overhead is included, it is the same for both
+        std::cout << std::setprecision(1) << "churn: allocate " << allocNs / options.ops << " ns, free " << freeNs / options.ops
+            << " ns, " << failures << " failed allocations" << std::endl;
+        printArena("churned", arena);
+
+        std::vector<ArenaAllocator::Move> moves;
+        uint64_t movedElements = 0;
+        Clock::time_point start = Clock::now();
+        size_t calls = 0;
+        for (; arena.defragment(64, moves) > 0; calls++) {
+            for (const ArenaAllocator::Move& move : moves) movedElements += move.size;
+            moves.clear();
+        }
+        std::cout << std::setprecision(2) << "defragment: " << movedElements << " elements moved in " << calls << " calls of 64 moves, "
+            << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+        printArena("compacted", arena);
+
+        if (!arena.validate()) {
+            std::cerr << "allocator validation failed" << std::endl;
+            return 1;
+        }
+        std::cout << "validate ok" << std::endl;
+        return 0;
+    }
+
+    //one render distance of runCull, returns how many frames the three culls disagreed on
+    size_t cullAtRadius(const BenchOptions& options, int radius) {
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_int_distribution<int> height(40, 200);
+
+        //records are keyed by chunk pointer but never read through it, any unique address will do
+        size_t count = static_cast<size_t>(2 * radius + 1) * (2 * radius + 1);
+        std::vector<char> fakeChunks(count);
+        ChunkRenderRecords records;
+        size_t n = 0;
+        for (int x = -radius; x <= radius; x++) {
+            for (int z = -radius; z <= radius; z++) {
+                glm::vec3 origin(x * Chunk::chunkSize, -Chunk::baseTerrainHeight, z * Chunk::chunkSize);
+                MeshSection column;
+                column.indexCount = 6;
+                column.max = glm::ivec3(Chunk::chunkSize, height(rng), Chunk::chunkSize);
+                records.update(reinterpret_cast<const Chunk*>(&fakeChunks[n++]), origin, &column, 1, 1, 1, true);
+            }
+        }
+        ChunkQuadtree tree;
+        Clock::time_point buildStart = Clock::now();
+        tree.update(records);
+        double buildUs = std::chrono::duration<double, std::micro>(Clock::now() - buildStart).count();
+
+        std::uniform_real_distribution<float> yaw(0.0f, 6.2831853f), pitch(-1.2f, 1.2f);
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1280.0f / 720.0f, 0.1f, 1000.0f);
+        std::vector<uint32_t> scalarVisible(count), batchVisible(count), treeVisible;
+        double scalarNs = 0, batchNs = 0, treeNs = 0;
+        size_t visibleTotal = 0, visitedTotal = 0, mismatches = 0;
+        for (int frame = 0; frame < options.frames; frame++) {
+            float y = yaw(rng), p = pitch(rng);
+            glm::vec3 eye(0.0f, 80.0f, 0.0f);
+            glm::vec3 forward(cos(p) * cos(y), sin(p), cos(p) * sin(y));
+            Frustum frustum;
+            frustum.update(projection * glm::lookAt(eye, eye + forward, glm::vec3(0, 1, 0)));
+
+            Clock::time_point t0 = Clock::now();
+            size_t scalarCount = 0;
+            for (size_t i = 0; i < count; i++) {
+                if (frustum.isBoxInFrustum(glm::vec3(records.minX[i], records.minY[i], records.minZ[i]),
+                    glm::vec3(records.maxX[i], records.maxY[i], records.maxZ[i]))) {
+                    scalarVisible[scalarCount++] = static_cast<uint32_t>(i);
+                }
+            }
+            Clock::time_point t1 = Clock::now();
+            size_t batchCount = frustum.cullBoxes(records.minX.data(), records.minY.data(), records.minZ.data(),
+                records.maxX.data(), records.maxY.data(), records.maxZ.data(), count, batchVisible.data());
+            Clock::time_point t2 = Clock::now();
+            treeVisible.clear();
+            tree.cull(frustum, treeVisible);
+            Clock::time_point t3 = Clock::now();
+
+            scalarNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+            batchNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+            treeNs += std::chrono::duration<double, std::nano>(t3 - t2).count();
+            visibleTotal += batchCount;
+            visitedTotal += tree.nodesVisited();
+
+            //the tree hands them back in z curve order
+            std::sort(treeVisible.begin(), treeVisible.end());
+            bool batchSame = scalarCount == batchCount && std::equal(scalarVisible.begin(), scalarVisible.begin() + scalarCount, batchVisible.begin());
+            bool treeSame = treeVisible.size() == scalarCount && std::equal(treeVisible.begin(), treeVisible.end(), scalarVisible.begin());
+            if (!batchSame || !treeSame) mismatches++;
+        }
+
+        double frames = std::max(1, options.frames);
+        std::cout << std::fixed << std::setprecision(1) << "radius " << radius << ", " << count << " chunks, "
+            << (visibleTotal / frames) << " visible, tree " << tree.nodeCount() << " nodes built in " << buildUs << " us" << std::endl;
+        std::cout << "  one at a time " << (scalarNs / frames / 1000.0) << " us, batched sse " << (batchNs / frames / 1000.0)
+            << " us, quadtree " << (treeNs / frames / 1000.0) << " us (" << (visitedTotal / frames) << " nodes visited)" << std::endl;
+        return mismatches;
+    }
+
+    int runCull(const BenchOptions& options) {
+        std::cout << "cull seed " << options.seed << ", " << options.frames << " random camera directions per radius" << std::endl;
+        std::vector<int> radii = { 8, 16, 32 };
+        if (options.radiusSet) radii = { options.radius };
+
+        size_t mismatches = 0;
+        for (int radius : radii) mismatches += cullAtRadius(options, radius);
+        if (mismatches > 0) {
+            std::cerr << mismatches << " frames where the culls disagreed on what is visible" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    //known answers on a hand placed wall, then the sse / scalar and banded / single thread buffers must match
+    bool checkOcclusion(const std::vector<OccluderBox>& worldOccluders, const glm::mat4& worldViewProj, const glm::vec3& worldEye) {
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1280.0f / 720.0f, 0.1f, 1000.0f);
+        glm::mat4 viewProj = projection * glm::lookAt(glm::vec3(0.0f), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+        OcclusionBuffer buffer;
+        buffer.begin(viewProj, glm::vec3(0.0f));
+        buffer.addOccluder(glm::vec3(-5, -5, -12), glm::vec3(5, 5, -10));
+        buffer.rasterize();
+
+        struct Case { const char* what; glm::vec3 min, max; bool visible; };
+        const Case cases[] = {
+            { "box behind the wall", glm::vec3(-1, -1, -30), glm::vec3(1, 1, -28), false },
+            { "box in front of the wall", glm::vec3(-1, -1, -8), glm::vec3(1, 1, -6), true },
+            { "box beside the wall", glm::vec3(20, -1, -30), glm::vec3(22, 1, -28), true },
+            { "box poking out over the wall", glm::vec3(-1, -1, -30), glm::vec3(1, 40, -28), true },
+            { "box through the near plane", glm::vec3(-1, -1, -30), glm::vec3(1, 1, 1), true },
+        };
+        bool ok = true;
+        for (const Case& test : cases) {
+            if (buffer.isBoxVisible(test.min, test.max) != test.visible) {
+                std::cerr << "occlusion check failed: " << test.what << std::endl;
+                ok = false;
+            }
+        }
+
+        //same occluders every way the buffer can be drawn
+        std::vector<float> reference;
+        for (int threads : { 1, 4 }) {
+            for (bool simd : { false, true }) {
+                OcclusionBuffer other;
+                other.setThreads(threads);
+                other.useSimd = simd;
+                other.begin(worldViewProj, worldEye);
+                for (const OccluderBox& box : worldOccluders) other.addOccluder(box.min, box.max);
+                other.rasterize();
+                if (reference.empty()) reference = other.depth();
+                else if (other.depth() != reference) {
+                    std::cerr << "occlusion buffer differs with " << threads << " threads, simd " << simd << std::endl;
+                    ok = false;
+                }
+            }
+        }
+        std::cout << "occlusion checks " << (ok ? "ok" : "failed") << std::endl;
+        return ok;
+    }
+
+    //split, fit, snap and cull math of the cascades against random cameras and suns, no world needed
+    bool checkShadowCascades(const BenchOptions& options) {
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f), coord(-500.0f, 500.0f);
+        const float fovY = glm::radians(90.0f), aspect = 1280.0f / 720.0f, nearPlane = 0.1f;
+        ShadowCascades::Settings settings;
+        size_t wrong = 0, checks = 2000;
+        auto fail = [&](const char* what) {
+            if (wrong++ < 5) std::cerr << "shadow cascade check failed: " << what << std::endl;
+        };
+
+        for (size_t n = 0; n < checks; n++) {
+            settings.count = 1 + static_cast<int>(n % ShadowCascades::MAX_CASCADES);
+            settings.cached = n % 2 == 1;
+            glm::vec3 eye(coord(rng), coord(rng) * 0.2f, coord(rng));
+            float yaw = unit(rng) * 6.2831853f, pitch = (unit(rng) - 0.5f) * 3.0f;
+            glm::vec3 forward(std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw));
+            glm::mat4 view = glm::lookAt(eye, eye + forward, glm::vec3(0, 1, 0));
+            float elevation = 0.05f + unit(rng) * 1.5f, azimuth = unit(rng) * 6.2831853f;
+            glm::vec3 sun = -glm::vec3(std::cos(elevation) * std::cos(azimuth), std::sin(elevation), std::cos(elevation) * std::sin(azimuth));
+
+            ShadowCascades cascades;
+            cascades.update(settings, view, fovY, aspect, nearPlane, sun);
+            if (cascades.count() != settings.count) fail("cascade count");
+            sun = cascades.lightDirection();//cached mode rounds it
+
+            glm::mat4 cameraToWorld = glm::inverse(view);
+            float tanY = std::tan(fovY * 0.5f), tanX = tanY * aspect;
+            float previous = nearPlane;
+            for (int i = 0; i < cascades.count(); i++) {
+                const ShadowCascades::Cascade& cascade = cascades.cascade(i);
+                if (cascade.nearDistance != previous || cascade.farDistance <= cascade.nearDistance) fail("splits are not increasing and touching");
+                previous = cascade.farDistance;
+
+                //the whole slice is in the box, and so is whatever sits casterReach towards the sun from it
+                for (int corner = 0; corner < 8; corner++) {
+                    float distance = (corner & 4) ? cascade.farDistance : cascade.nearDistance;
+                    glm::vec3 local(((corner & 1) ? 1.0f : -1.0f) * tanX * distance, ((corner & 2) ? 1.0f : -1.0f) * tanY * distance, -distance);
+                    glm::vec3 point = glm::vec3(cameraToWorld * glm::vec4(local, 1.0f));
+                    for (float reach : { 0.0f, settings.casterReach * 0.99f }) {
+                        glm::vec3 clip = glm::vec3(cascade.lightSpace * glm::vec4(point - sun * reach, 1.0f));
+                        if (glm::any(glm::greaterThan(glm::abs(clip), glm::vec3(1.0001f)))) fail(reach > 0.0f ? "caster above the slice is clipped" : "slice corner outside its cascade");
+                        //and two texels in from the edge, so the shadow filter never reads the wrapped side
+                        float margin = 1.0f - 3.99f / settings.resolution;
+                        if (reach == 0.0f && glm::any(glm::greaterThan(glm::abs(glm::vec2(clip)), glm::vec2(margin)))) fail("slice corner in the filter margin");
+                    }
+                }
+                //casters: the slice centre is kept, a box well to the side of the sphere is not
+                glm::vec3 side = glm::normalize(glm::cross(sun, std::abs(sun.y) > 0.99f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0)));
+                if (!cascade.frustum.isBoxInFrustum(cascade.centre - 0.5f, cascade.centre + 0.5f)) fail("slice centre culled");
+                glm::vec3 away = cascade.centre + side * (cascade.radius * 3.0f);
+                if (cascade.frustum.isBoxInFrustum(away - 0.5f, away + 0.5f)) fail("box beside the light box kept");
+            }
+
+            //walking (no turning) moves every cascade by whole texels and keeps its size, so a fixed point keeps its texel fraction
+            glm::vec3 step(unit(rng) * 3.0f, unit(rng) * 0.5f, unit(rng) * 3.0f);
+            ShadowCascades moved;
+            moved.update(settings, glm::lookAt(eye + step, eye + step + forward, glm::vec3(0, 1, 0)), fovY, aspect, nearPlane, sun);
+            //turning keeps the size too
+            ShadowCascades turned;
+            turned.update(settings, glm::lookAt(eye, eye + glm::vec3(-forward.z, forward.y, forward.x), glm::vec3(0, 1, 0)), fovY, aspect, nearPlane, sun);
+            glm::vec4 fixedPoint(eye + forward * 10.0f, 1.0f);
+            for (int i = 0; i < cascades.count(); i++) {
+                if (moved.cascade(i).radius != cascades.cascade(i).radius || turned.cascade(i).radius != cascades.cascade(i).radius) fail("cascade size changed with the camera");
+                float texels = static_cast<float>(settings.resolution);
+                glm::vec2 before = glm::vec2(cascades.cascade(i).shadowSpace * fixedPoint) * texels;
+                glm::vec2 after = glm::vec2(moved.cascade(i).shadowSpace * fixedPoint) * texels;
+                glm::vec2 shift = after - before;
+                if (glm::any(glm::greaterThan(glm::abs(shift - glm::round(shift)), glm::vec2(0.02f)))) fail("cascade moved by part of a texel");
+                //cached tiles stay where they are in the atlas while the box scrolls over them
+                if (settings.cached && glm::any(glm::greaterThan(glm::abs(shift), glm::vec2(0.02f)))) fail("cached texel moved in the atlas");
+            }
+
+            if (settings.cached) {
+                //the first update draws every tile, the same camera again draws none, a change far off to the side
+                //none either, and a changed chunk in the middle of the first slice only the tiles it shades
+                size_t tiles = static_cast<size_t>(settings.tilesPerSide * settings.tilesPerSide);
+                if (cascades.dirtyTiles().size() != tiles * cascades.count()) fail("first cached update didnt draw every tile");
+                cascades.update(settings, view, fovY, aspect, nearPlane, sun);
+                if (!cascades.dirtyTiles().empty()) fail("still camera redrew tiles");
+                glm::vec3 side = glm::normalize(glm::cross(sun, std::abs(sun.y) > 0.99f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0)));
+                glm::vec3 far = cascades.cascade(0).centre + side * (cascades.cascade(cascades.count() - 1).radius * 4.0f);
+                cascades.invalidate(far - 8.0f, far + 8.0f);
+                cascades.update(settings, view, fovY, aspect, nearPlane, sun);
+                if (!cascades.dirtyTiles().empty()) fail("change outside every light box redrew tiles");
+                glm::vec3 centre = cascades.cascade(0).centre;
+                cascades.invalidate(centre - 8.0f, centre + 8.0f);
+                cascades.update(settings, view, fovY, aspect, nearPlane, sun);
+                if (cascades.dirtyTiles().empty()) fail("changed chunk redrew nothing");
+                for (const ShadowCascades::Tile& tile : cascades.dirtyTiles()) {
+                    if (!tile.casters.isBoxInFrustum(centre - 8.0f, centre + 8.0f)) fail("redrawn tile doesnt touch the changed chunk");
+                }
+            }
+        }
+        std::cout << "cascade check: " << checks << " cameras, " << wrong << " wrong" << std::endl;
+        return wrong == 0;
+    }
+
+    //caster volumes against brute force: boxes with a point whose shadow lands in the slice (or tile) must be
+    //kept, marched along the light from sampled points down to the lowest caster height. Also counts how many
+    //boxes the light box alone would have kept
+    bool checkCasterVolumes(const BenchOptions& options) {
+        std::mt19937 rng(static_cast<uint32_t>(options.seed) + 1);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const float fovY = glm::radians(90.0f), aspect = 1280.0f / 720.0f, nearPlane = 0.1f;
+        const float tanY = std::tan(fovY * 0.5f), tanX = tanY * aspect;
+        const size_t cameras = 200, boxesPerCascade = 200;
+        size_t wrong = 0, shading = 0, keptByBox = 0, keptByVolume = 0, tested = 0;
+        std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+        std::vector<uint32_t> visible;
+        std::vector<uint8_t> mustKeep;
+
+        for (size_t n = 0; n < cameras; n++) {
+            ShadowCascades::Settings settings;
+            settings.cached = n % 2 == 1;
+            float bottom = -64.0f, top = 20.0f + unit(rng) * 150.0f;
+            glm::vec3 eye((unit(rng) - 0.5f) * 1000.0f, bottom + unit(rng) * (top - bottom + 20.0f), (unit(rng) - 0.5f) * 1000.0f);
+            float yaw = unit(rng) * 6.2831853f, pitch = (unit(rng) - 0.5f) * 2.5f;
+            glm::vec3 forward(std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw));
+            glm::mat4 view = glm::lookAt(eye, eye + forward, glm::vec3(0, 1, 0));
+            float elevation = 0.1f + unit(rng) * 1.45f, azimuth = unit(rng) * 6.2831853f;
+            glm::vec3 sun = -glm::vec3(std::cos(elevation) * std::cos(azimuth), std::sin(elevation), std::cos(elevation) * std::sin(azimuth));
+
+            ShadowCascades cascades;
+            cascades.setCasterHeights(bottom, top);
+            cascades.update(settings, view, fovY, aspect, nearPlane, sun);
+            sun = cascades.lightDirection();
+
+            for (int i = 0; i < cascades.count(); i++) {
+                const ShadowCascades::Cascade& cascade = cascades.cascade(i);
+                //cached volumes cover whole tiles, so the receivers are the light box's footprint, not just the slice
+                auto receives = [&](const glm::vec3& point) {
+                    glm::vec3 clip = glm::vec3(cascade.lightSpace * glm::vec4(point, 1.0f));
+                    if (glm::any(glm::greaterThan(glm::abs(clip), glm::vec3(1.0f)))) return false;
+                    if (settings.cached) return true;
+                    glm::vec3 local = glm::vec3(view * glm::vec4(point, 1.0f));
+                    float distance = -local.z;
+                    return distance >= cascade.nearDistance && distance <= cascade.farDistance
+                        && std::abs(local.x) <= tanX * distance && std::abs(local.y) <= tanY * distance;
+                };
+
+                minX.clear(); minY.clear(); minZ.clear(); maxX.clear(); maxY.clear(); maxZ.clear();
+                mustKeep.clear();
+                for (size_t b = 0; b < boxesPerCascade; b++) {
+                    //half somewhere in the slice and then some way towards the sun, half anywhere in the light box
+                    glm::vec3 point;
+                    if (b % 2 == 0) {
+                        float distance = cascade.nearDistance + unit(rng) * (cascade.farDistance - cascade.nearDistance);
+                        glm::vec3 local((unit(rng) * 2.0f - 1.0f) * tanX * distance, (unit(rng) * 2.0f - 1.0f) * tanY * distance, -distance);
+                        point = glm::vec3(glm::inverse(view) * glm::vec4(local, 1.0f)) - sun * (unit(rng) * settings.casterReach);
+                    }
+                    else {
+                        glm::vec4 clip(unit(rng) * 2.0f - 1.0f, unit(rng) * 2.0f - 1.0f, unit(rng) * 2.0f - 1.0f, 1.0f);
+                        point = glm::vec3(glm::inverse(cascade.lightSpace) * clip);
+                    }
+                    glm::vec3 size(1.0f + unit(rng) * 15.0f, 1.0f + unit(rng) * 15.0f, 1.0f + unit(rng) * 15.0f);
+                    glm::vec3 boxMin = glm::floor(point), boxMax = boxMin + glm::floor(size);
+                    boxMin.y = std::max(boxMin.y, bottom);
+                    boxMax.y = std::min(boxMax.y, top);
+                    if (boxMin.y >= boxMax.y) continue;
+
+                    //corners, centre and a few points inside, each marched down the light
+                    bool shades = false;
+                    for (int s = 0; s < 16 && !shades; s++) {
+                        glm::vec3 sample = s < 8
+                            ? glm::vec3((s & 1) ? boxMax.x : boxMin.x, (s & 2) ? boxMax.y : boxMin.y, (s & 4) ? boxMax.z : boxMin.z)
+                            : boxMin + (boxMax - boxMin) * glm::vec3(unit(rng), unit(rng), unit(rng));
+                        glm::vec3 clip = glm::vec3(cascade.lightSpace * glm::vec4(sample, 1.0f));
+                        if (glm::any(glm::greaterThan(glm::abs(clip), glm::vec3(1.0f)))) continue;//clipped from the depth map anyway
+                        for (glm::vec3 ray = sample; ray.y >= bottom && !shades; ray += sun * 0.25f) shades = receives(ray);
+                    }
+                    minX.push_back(boxMin.x); minY.push_back(boxMin.y); minZ.push_back(boxMin.z);
+                    maxX.push_back(boxMax.x); maxY.push_back(boxMax.y); maxZ.push_back(boxMax.z);
+                    mustKeep.push_back(shades ? 1 : 0);
+                    shading += shades ? 1 : 0;
+                }
+
+                //same batch kernel the quadtree leaves use
+                size_t count = minX.size();
+                tested += count;
+                visible.resize(count);
+                keptByBox += cascade.frustum.cullBoxes(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), count, visible.data());
+                size_t kept = cascade.casters.cullBoxes(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), count, visible.data());
+                keptByVolume += kept;
+                std::vector<uint8_t> keptFlags(count, 0);
+                for (size_t k = 0; k < kept; k++) keptFlags[visible[k]] = 1;
+                for (size_t k = 0; k < count; k++) {
+                    if (mustKeep[k] && !keptFlags[k] && wrong++ < 5) {
+                        std::cerr << "caster volume check failed: box shading cascade " << i << (settings.cached ? " (cached)" : "") << " was culled" << std::endl;
+                    }
+                }
+
+                //cached tiles: every tile volume keeps the boxes over it, and together they keep what the cascade's does
+                if (settings.cached) {
+                    std::vector<uint8_t> byTiles(count, 0);
+                    for (const ShadowCascades::Tile& tile : cascades.dirtyTiles()) {
+                        if (tile.cascade != i) continue;
+                        size_t tileKept = tile.casters.cullBoxes(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), count, visible.data());
+                        for (size_t k = 0; k < tileKept; k++) byTiles[visible[k]] = 1;
+                    }
+                    for (size_t k = 0; k < count; k++) {
+                        if (mustKeep[k] && !byTiles[k] && wrong++ < 5) std::cerr << "caster volume check failed: box shading a tile was culled" << std::endl;
+                    }
+                }
+            }
+
+            //the whole world below the slices: nothing can cast into them
+            ShadowCascades buried;
+            buried.setCasterHeights(bottom - 200.0f, bottom - 150.0f);
+            buried.update(settings, glm::lookAt(glm::vec3(eye.x, top + 10.0f, eye.z), glm::vec3(eye.x, top + 20.0f, eye.z + 1.0f), glm::vec3(0, 1, 0)), fovY, aspect, nearPlane, sun);
+            glm::vec3 under(eye.x, bottom - 175.0f, eye.z);
+            if (!settings.cached && buried.cascade(0).casters.isBoxInFrustum(under - 1.0f, under + 1.0f)) {
+                if (wrong++ < 5) std::cerr << "caster volume check failed: caster under a camera looking up was kept" << std::endl;
+            }
+        }
+        std::cout << std::fixed << std::setprecision(1) << "caster volume check: " << tested << " boxes, " << shading << " shade a slice or tile, light boxes keep "
+            << keptByBox << ", caster volumes " << keptByVolume << " (" << (100.0 * keptByVolume / std::max<size_t>(1, keptByBox)) << "%), "
+            << wrong << " wrong" << std::endl;
+        return wrong == 0;
+    }
+
+    //shadow atlas size, fill and casters for a few cascade setups, from ground level next to spawn
+    int runShadows(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const int maxLoadFrames = 100000;
+        const size_t legacySide = 8192;//the single depth map this replaced
+
+        bool ok = checkShadowCascades(options);
+        ok = checkCasterVolumes(options) && ok;
+
+        World world(options.radius);
+        world.init(options.seed);
+        Player player(&world);
+        player.spawn(glm::vec3(10, 200, 10));
+
+        RecordingRenderDevice device;
+        device.keepCommands = false;
+        Renderer renderer(device, world);
+        renderer.init();
+
+        std::cout << "shadows seed " << options.seed << ", render distance " << options.radius
+            << ", " << options.frames << " frames per setup, recording device" << std::endl;
+
+        StreamStats loadStats;
+        PlayerInput idle;
+        while ((world.isLoading() || world.hasPendingWork()) && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats, &renderer, &device);
+        }
+        glm::vec3 eye;
+        {
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            eye = glm::vec3(32.5f, surfaceHeight(world, 32, 0) + 2.6f, 0.5f);
+        }
+        device.endFrame();
+
+        std::cout << std::fixed << std::setprecision(1) << "legacy: " << legacySide << "^2 map, "
+            << (legacySide * legacySide * 4 / 1024) << " kb, " << (legacySide * legacySide / 1e6) << "M texels per frame" << std::endl;
+        struct Setup { int count, resolution; };
+        const Setup setups[] = { { 4, 1024 }, { 3, 1024 }, { 4, 2048 }, { 4, 512 } };
+        for (const Setup& setup : setups) {
+            renderer.shadowSettings.count = setup.count;
+            renderer.shadowSettings.resolution = setup.resolution;
+            renderer.shadowSettings.cached = false;
+            device.keepCommands = true;
+            PassTriangles triangles = turnCamera(renderer, device, eye, options.frames);
+            device.keepCommands = false;
+
+            //casters each cascade took from the last frame's light boxes
+            const ShadowCascades& cascades = renderer.getShadowCascades();
+            ChunkQuadtree tree;
+            tree.update(renderer.getChunkRecords());
+            std::vector<uint32_t> casters;
+            size_t atlasSide = cascades.atlasSize();
+            std::cout << setup.count << " x " << setup.resolution << "^2: depth atlas " << (atlasSide * atlasSide * 4 / 1024) << " kb, all textures "
+                << (device.residentTextureBytes() / 1024) << " kb, " << (setup.count * double(setup.resolution) * setup.resolution / 1e6)
+                << "M texels per frame" << std::endl;
+            std::cout << std::setprecision(0) << "  shadow triangles " << triangles.shadow << ", main " << triangles.main << ", casters "
+                << triangles.casters << " a frame, per cascade light box -> caster volume";
+            for (int i = 0; i < cascades.count(); i++) {
+                casters.clear();
+                tree.cull(cascades.cascade(i).frustum, casters);
+                size_t inBox = casters.size();
+                casters.clear();
+                tree.cull(cascades.cascade(i).casters, casters);
+                std::cout << " " << inBox << "->" << casters.size();
+            }
+            std::cout << std::setprecision(1) << ", splits";
+            for (int i = 0; i < cascades.count(); i++) std::cout << " " << cascades.cascade(i).farDistance;
+            std::cout << std::endl;
+        }
+
+        //cached tiles, default 4 x 1024 split into 8 x 8 tiles of 128^2 per cascade
+        renderer.shadowSettings = ShadowCascades::Settings();
+        std::vector<Chunk*> editChunks;
+        {
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            for (int x = -1; x <= 1; x++) {
+                for (int z = -1; z <= 1; z++) {
+                    Chunk* chunk = world.getChunk(eye + glm::vec3(x * 16, 0, z * 16));
+                    if (chunk && chunk->vertexBlock != 0) editChunks.push_back(chunk);
+                }
+            }
+        }
+        struct Scenario { const char* name; float walk, sunSpeed; bool turn; int editEvery; };
+        const Scenario scenarios[] = {
+            { "still, frozen sun", 0.0f, 0.0f, false, 0 },
+            { "turning, frozen sun", 0.0f, 0.0f, true, 0 },
+            { "sprinting, frozen sun", 5.6f, 0.0f, false, 0 },
+            { "turning, sun moving", 0.0f, 1.0f, true, 0 },
+            { "still, a nearby chunk remeshed every 10 frames", 0.0f, 0.0f, false, 10 },
+        };
+        size_t fullTiles = renderer.shadowSettings.count * renderer.shadowSettings.tilesPerSide * renderer.shadowSettings.tilesPerSide;
+        std::cout << "cached " << renderer.shadowSettings.count << " x " << renderer.shadowSettings.resolution << "^2 in "
+            << renderer.shadowSettings.tilesPerSide << "^2 tiles a cascade, " << renderer.shadowSettings.sunStepDegrees
+            << " degree sun steps, " << fullTiles << " tiles is a full redraw" << std::endl;
+        for (const Scenario& scenario : scenarios) {
+            renderer.render(FrameView{ glm::lookAt(eye, eye + glm::vec3(1, -0.3f, 0), glm::vec3(0, 1, 0)), eye, 1280, 720, 20.0f });//settle
+            device.endFrame();
+            double tiles = 0, shadowTriangles = 0, casters = 0;
+            size_t worstTiles = 0;
+            for (int i = 0; i < options.frames; i++) {
+                if (scenario.editEvery > 0 && i % scenario.editEvery == 0 && !editChunks.empty()) {
+                    std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+                    renderer.uploadChunkMesh(*editChunks[(i / scenario.editEvery) % editChunks.size()]);
+                }
+                float yaw = scenario.turn ? 6.2831853f * i / options.frames : 0.0f;
+                glm::vec3 forward(std::cos(-0.3f) * std::cos(yaw), std::sin(-0.3f), std::cos(-0.3f) * std::sin(yaw));
+                glm::vec3 at = eye + glm::vec3(scenario.walk * deltaTime * i, 0.0f, 0.0f);
+                FrameView frame;
+                frame.view = glm::lookAt(at, at + forward, glm::vec3(0, 1, 0));
+                frame.cameraPos = at;
+                frame.width = 1280;
+                frame.height = 720;
+                frame.time = 20.0f + scenario.sunSpeed * deltaTime * i;
+                device.keepCommands = true;
+                renderer.render(frame);
+
+                size_t dirty = renderer.getShadowCascades().dirtyTiles().size();
+                tiles += dirty;
+                worstTiles = std::max(worstTiles, dirty);
+                casters += renderer.getShadowStats().casters;
+                bool shadowPass = false;
+                for (const RecordedCommand& command : device.commands()) {
+                    if (command.call == RecordedCall::BindFramebuffer) shadowPass = command.handle != 0;
+                    if (command.call == RecordedCall::Draw && shadowPass) shadowTriangles += command.count / 3.0;
+                }
+                device.endFrame();
+            }
+            device.keepCommands = false;
+            double frames = std::max(1, options.frames);
+            std::cout << std::setprecision(2) << "  " << scenario.name << ": " << tiles / frames << " tiles a frame (worst " << worstTiles
+                << "), " << std::setprecision(0) << shadowTriangles / frames << " shadow triangles, " << casters / frames << " casters, "
+                << std::setprecision(2) << (tiles / frames) * (renderer.shadowSettings.resolution / renderer.shadowSettings.tilesPerSide)
+                * (renderer.shadowSettings.resolution / renderer.shadowSettings.tilesPerSide) / 1e6 << "M texels a frame" << std::endl;
+        }
+
+        for (const RenderFrameStats& stats : device.frameHistory()) {
+            if (stats.invalidCalls > 0) {
+                std::cerr << "a frame made invalid calls" << std::endl;
+                return 2;
+            }
+        }
+        return ok ? 0 : 1;
+    }
+
+    //frustum culled sections, then the same through the occlusion buffer, from ground level around spawn
+    int runOcclusion(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const int maxLoadFrames = 100000;
+        const float occluderDistance = 96.0f;//Renderer::OCCLUDER_DISTANCE
+
+        World world(options.radius);
+        world.init(options.seed);
+        Player player(&world);
+        player.spawn(glm::vec3(10, 200, 10));
+
+        RecordingRenderDevice device;
+        device.keepCommands = false;
+        Renderer renderer(device, world);
+        renderer.init();
+
+        std::cout << "occlusion seed " << options.seed << ", render distance " << options.radius << ", " << options.frames
+            << " frames, " << OcclusionBuffer::WIDTH << "x" << OcclusionBuffer::HEIGHT << " buffer" << std::endl;
+
+        StreamStats loadStats;
+        PlayerInput idle;
+        while ((world.isLoading() || world.hasPendingWork()) && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats, &renderer, &device);
+        }
+
+        //nothing streams from here on, so the chunks can be read without holding the lock every frame
+        std::vector<OccluderBox> occluders;
+        std::vector<glm::vec3> eyes;
+        {
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            for (auto& pair : world.chunks) {
+                if (pair.second.isActive && pair.second.vertexBlock != 0) appendOccluders(pair.second.mesh, pair.second.chunkPosition, occluders);
+            }
+            //standing on the ground in a ring around spawn, where ridges hide the most
+            for (int spot = 0; spot < 8; spot++) {
+                float angle = 6.2831853f * spot / 8;
+                int x = static_cast<int>(std::round(std::cos(angle) * 32.0f)), z = static_cast<int>(std::round(std::sin(angle) * 32.0f));
+                eyes.push_back(glm::vec3(x + 0.5f, surfaceHeight(world, x, z) + 2.6f, z + 0.5f));
+            }
+        }
+        std::cout << occluders.size() << " solid column boxes" << std::endl;
+
+        const ChunkRenderRecords& records = renderer.getChunkRecords();
+        ChunkQuadtree tree;
+        tree.update(records);
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1280.0f / 720.0f, 0.1f, 1000.0f);
+
+        bool ok = true;
+        int threadCounts[2] = { 1, static_cast<int>(std::min(4u, std::max(1u, std::thread::hardware_concurrency()))) };
+        for (int pass = 0; pass < 2; pass++) {
+            if (pass == 1 && threadCounts[1] == threadCounts[0]) break;
+            OcclusionBuffer buffer;
+            buffer.setThreads(threadCounts[pass]);
+
+            std::vector<uint32_t> visible;
+            double rasterMs = 0, testMs = 0, occluderBoxes = 0, triangles = 0;
+            double sectionsBefore = 0, sectionsAfter = 0, trianglesBefore = 0, trianglesAfter = 0;
+            int frames = std::max(1, options.frames);
+            for (int frame = 0; frame < frames; frame++) {
+                const glm::vec3& eye = eyes[frame * eyes.size() / frames];
+                float yaw = 6.2831853f * frame * eyes.size() / frames;
+                glm::vec3 forward(std::cos(yaw), -0.1f, std::sin(yaw));
+                glm::mat4 viewProj = projection * glm::lookAt(eye, eye + forward, glm::vec3(0, 1, 0));
+                Frustum frustum;
+                frustum.update(viewProj);
+
+                visible.clear();
+                tree.cull(frustum, visible);
+
+                Clock::time_point t0 = Clock::now();
+                buffer.begin(viewProj, eye);
+                occluderBoxes += buffer.addOccluders(occluders, frustum, occluderDistance);
+                buffer.rasterize();
+                Clock::time_point t1 = Clock::now();
+                size_t kept = 0;
+                for (uint32_t i : visible) {
+                    glm::vec3 min(records.minX[i], records.minY[i], records.minZ[i]);
+                    glm::vec3 max(records.maxX[i], records.maxY[i], records.maxZ[i]);
+                    trianglesBefore += records.indexCounts[i] / 3;
+                    if (!buffer.isBoxVisible(min, max)) continue;
+                    trianglesAfter += records.indexCounts[i] / 3;
+                    kept++;
+                }
+                Clock::time_point t2 = Clock::now();
+
+                rasterMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+                testMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+                triangles += buffer.triangleCount();
+                sectionsBefore += visible.size();
+                sectionsAfter += kept;
+
+                if (pass == 0 && frame == 0) ok = checkOcclusion(occluders, viewProj, eye) && ok;
+            }
+
+            std::cout << std::fixed << std::setprecision(1) << threadCounts[pass] << " thread" << (threadCounts[pass] > 1 ? "s" : "") << ": "
+                << (occluderBoxes / frames) << " occluder boxes, " << (triangles / frames) << " triangles rasterized" << std::endl;
+            std::cout << "  sections " << (sectionsBefore / frames) << " -> " << (sectionsAfter / frames)
+                << ", triangles " << std::setprecision(0) << (trianglesBefore / frames) << " -> " << (trianglesAfter / frames)
+                << std::setprecision(1) << " (" << (trianglesBefore > 0 ? 100.0 * (1.0 - trianglesAfter / trianglesBefore) : 0.0) << "% culled)" << std::endl;
+            std::cout << std::setprecision(3) << "  raster " << (rasterMs / frames) << " ms, test " << (testMs / frames) << " ms per frame" << std::endl;
+        }
+        return ok ? 0 : 1;
+    }
+
+    //random adds over a few models: each group has to hold exactly its model's transforms in the order they came,
+    //and a second frame of the same size must reuse the first one's memory
+    bool checkInstanceBatcher(const BenchOptions& options) {
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_int_distribution<uint32_t> pickModel(0, 5);
+        const size_t count = 5000;
+        InstanceBatcher batcher;
+        std::vector<uint32_t> models(count);
+        size_t wrong = 0;
+        std::vector<const glm::mat4*> storage;
+        for (int frame = 0; frame < 2; frame++) {
+            batcher.clear();
+            for (size_t i = 0; i < count; i++) {
+                if (frame == 0) models[i] = pickModel(rng);
+                glm::mat4 transform(1.0f);
+                transform[3] = glm::vec4(static_cast<float>(i), 0.0f, 0.0f, 1.0f);//tags the instance with its add order
+                batcher.add(models[i], transform);
+            }
+
+            size_t seen = 0;
+            for (uint32_t model = 0; model < batcher.modelCount(); model++) {
+                const std::vector<glm::mat4>& instances = batcher.instances(model);
+                size_t next = 0;
+                for (const glm::mat4& transform : instances) {
+                    while (next < count && models[next] != model) next++;
+                    if (next == count || transform[3].x != static_cast<float>(next)) wrong++;
+                    next++;
+                }
+                seen += instances.size();
+                if (frame == 0) storage.push_back(instances.data());
+                else if (storage[model] != instances.data()) wrong++;
+            }
+            if (seen != count || batcher.size() != count) wrong++;
+        }
+        std::cout << "instance batcher check: " << count << " instances over " << batcher.modelCount() << " models, " << wrong << " wrong" << std::endl;
+        return wrong == 0;
+    }
+
+    int runEntities(const BenchOptions& options) {
+        const int frames = std::max(1, std::min(options.frames, 200));
+        World world(1);
+        world.init(options.seed);
+        RecordingRenderDevice device;
+        device.keepCommands = false;
+        Renderer renderer(device, world);
+        renderer.init();
+
+        std::cout << "entities, " << frames << " frames each, recording device, no terrain" << std::endl;
+        bool ok = checkInstanceBatcher(options);
+
+        FrameView frame;
+        glm::vec3 eye(0.0f, 80.0f, -150.0f);
+        frame.view = glm::lookAt(eye, glm::vec3(0.0f, 40.0f, 0.0f), glm::vec3(0, 1, 0));
+        frame.cameraPos = eye;
+        frame.width = 1280;
+        frame.height = 720;
+        frame.time = 20.0f;
+
+        const size_t beeCounts[] = { 0, 100, 1000, 10000 };
+        double baseMs = 0.0;
+        size_t baseDraws = 0, baseUniforms = 0, invalid = 0;
+        bool flat = true;
+        InstanceBatcher batcher;
+        for (size_t bees : beeCounts) {
+            world.entities.clear();
+            world.entityGrid.clear();
+            int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(bees))));
+            for (size_t i = 0; i < bees; i++) {
+                glm::vec3 position(static_cast<float>(i % side) * 3.0f - side * 1.5f, 40.0f + (i % 7), static_cast<float>(i / side) * 3.0f - side * 1.5f);
+                world.spawnBee(position);
+            }
+
+            renderer.render(frame);//first frame sizes the instance buffers
+            device.endFrame();
+            Clock::time_point start = Clock::now();
+            for (int i = 0; i < frames; i++) {
+                renderer.render(frame);
+                device.endFrame();
+            }
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+            const RenderFrameStats& stats = device.frameHistory().back();
+            for (size_t i = device.frameHistory().size() - frames - 1; i < device.frameHistory().size(); i++) {
+                invalid += device.frameHistory()[i].invalidCalls;
+            }
+
+            //the cpu side on its own, what drawMobs does before it talks to the device
+            start = Clock::now();
+            for (int i = 0; i < frames; i++) {
+                batcher.clear();
+                for (size_t e = 0; e < world.entities.size(); e++) batcher.add(0, world.entities.modelMatrix(e));
+            }
+            double batchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+            if (bees == 0) {
+                baseMs = ms;
+                baseDraws = stats.drawCalls;
+                baseUniforms = stats.uniformUploads;
+            }
+            else {
+                //the bee model's batch is the one extra draw
+                if (stats.drawCalls != baseDraws + 1 || stats.uniformUploads != baseUniforms) flat = false;
+            }
+            if (stats.instances != bees + 3) ok = false;//plus the bee, box and sword showcase models
+
+            std::cout << std::fixed << std::setprecision(3) << std::setw(5) << bees << " bees: render " << ms << " ms/frame";
+            if (bees > 0) std::cout << std::setprecision(1) << " (" << (ms - baseMs) * 1000.0 / bees * 1000.0 << " ns per bee)";
+            std::cout << ", " << stats.drawCalls << " draws, " << stats.instances << " instances, " << stats.uniformUploads << " uniform uploads, "
+                << (stats.bufferBytes / 1024) << " kb uploaded, batching " << std::setprecision(3) << batchMs << " ms" << std::endl;
+        }
+        world.entities.clear();
+        world.entityGrid.clear();
+
+        if (!flat) {
+            std::cerr << "draw calls or uniform uploads grew with the bee count" << std::endl;
+            ok = false;
+        }
+        if (invalid > 0) {
+            std::cerr << invalid << " invalid calls" << std::endl;
+            return 2;
+        }
+        return ok ? 0 : 1;
+    }
+
+    //random creates and destroys against a plain list of what should be alive: every live handle has to resolve
+    //to its own entity, every destroyed one has to stop resolving even after its slot is reused
+    bool checkEntityStore(const BenchOptions& options) {
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        EntityStore store;
+        uint32_t model = store.modelHandle("test");
+        std::vector<std::pair<EntityId, float>> live;//handle and the x it was made with
+        std::vector<EntityId> destroyed;
+        size_t wrong = 0, ops = 20000;
+        for (size_t n = 0; n < ops; n++) {
+            if (live.empty() || rng() % 3 != 0) {
+                float tag = static_cast<float>(n);
+                live.push_back({ store.create(model, glm::vec3(tag, 0.0f, 0.0f), 10.0f), tag });
+            }
+            else {
+                size_t pick = rng() % live.size();
+                store.destroy(live[pick].first);
+                destroyed.push_back(live[pick].first);
+                live[pick] = live.back();
+                live.pop_back();
+            }
+        }
+        for (const auto& entity : live) {
+            if (!store.alive(entity.first)) {
+                wrong++;
+                continue;
+            }
+            size_t i = store.indexOf(entity.first);
+            if (!(store.ids[i] == entity.first) || store.posX[i] != entity.second) wrong++;
+        }
+        for (const EntityId& id : destroyed) {
+            if (store.alive(id)) wrong++;
+        }
+        if (store.size() != live.size()) wrong++;
+        std::cout << "entity store check: " << ops << " creates and destroys, " << live.size() << " alive, " << wrong << " wrong" << std::endl;
+        return wrong == 0;
+    }
+
+    //what mobs used to be, kept here to compare against: a heap object per entity updated through a virtual call
+    class ObjectMob
+    {
+    public:
+        virtual ~ObjectMob() {}
+        virtual void update(float deltaTime) = 0;
+        std::string modelPath;
+        glm::vec3 position, velocity;
+        float yaw = 0.0f, health = 10.0f, maxHealth = 10.0f, aiTimer = 0.0f;
+        AIState aiState = AIState::Idle;
+        uint32_t seed = 1;
+    };
+
+    class ObjectBee : public ObjectMob
+    {
+    public:
+        void update(float deltaTime) override {
+            aiTimer -= deltaTime;
+            if (aiTimer <= 0.0f) {
+                if (aiState == AIState::Idle) {
+                    float angle = nextFloat() * 6.2831853f;
+                    aiState = AIState::Wander;
+                    velocity = glm::vec3(std::sin(angle), (nextFloat() - 0.5f) * 0.5f, std::cos(angle)) * EntitySystems::WANDER_SPEED;
+                    yaw = angle;
+                }
+                else {
+                    aiState = AIState::Idle;
+                    velocity = glm::vec3(0.0f);
+                }
+                aiTimer = 1.0f + nextFloat() * 3.0f;
+            }
+            position += velocity * deltaTime;
+            if (health > 0.0f) health = std::fmin(health + EntitySystems::HEALTH_REGEN * deltaTime, maxHealth);
+        }
+
+    private:
+        float nextFloat() {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            return (seed >> 8) * (1.0f / 16777216.0f);
+        }
+    };
+
+    //fnv-1a over every live entity's handle and position bits, in dense order
+    uint64_t hashEntities(const EntityStore& store) {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint32_t value) {
+            hash ^= value;
+            hash *= 1099511628211ull;
+        };
+        for (size_t i = 0; i < store.size(); i++) {
+            uint32_t bits[3];
+            std::memcpy(&bits[0], &store.posX[i], 4);
+            std::memcpy(&bits[1], &store.posY[i], 4);
+            std::memcpy(&bits[2], &store.posZ[i], 4);
+            mix(store.ids[i].index);
+            mix(store.ids[i].generation);
+            for (uint32_t b : bits) mix(b);
+        }
+        return hash;
+    }
+
+    int runEcs(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const size_t count = static_cast<size_t>(options.entities);
+        std::cout << "ecs seed " << options.seed << ", " << count << " entities, " << options.frames << " frames" << std::endl;
+        bool ok = checkEntityStore(options);
+
+        auto spread = [](size_t i) {
+            return glm::vec3(static_cast<float>(i % 317) * 2.0f, 40.0f + (i % 13), static_cast<float>(i / 317) * 2.0f);
+        };
+
+        int threadCounts[] = { 1, std::max(2, options.threads) };
+        uint64_t hashes[2] = {};
+        size_t survivors[2] = {};
+        for (int pass = 0; pass < 2; pass++) {
+            EntityStore store;
+            uint32_t bee = store.modelHandle(World::BEE_MODEL);
+            for (size_t i = 0; i < count; i++) store.create(bee, spread(i), 10.0f);
+
+            EntitySystems systems;
+            systems.setThreads(threadCounts[pass]);
+            systems.tiers.enabled = false;
+            std::mt19937 rng(static_cast<uint32_t>(options.seed));
+            std::vector<double> ai, movement, health, removal, total;
+            for (int frame = 0; frame < options.frames; frame++) {
+                //something has to die now and then or removal is never timed
+                if (frame % 60 == 59 && store.size() > 0) {
+                    for (size_t n = 0; n < store.size() / 100; n++) {
+                        store.changeHealth(store.ids[rng() % store.size()], -6.0f);
+                    }
+                }
+                systems.update(store, deltaTime, glm::vec3(0.0f));
+                const EntitySystemTimes& times = systems.lastTimes();
+                ai.push_back(times.ai);
+                movement.push_back(times.movement);
+                health.push_back(times.health);
+                removal.push_back(times.removal);
+                total.push_back(times.total());
+            }
+            hashes[pass] = hashEntities(store);
+            survivors[pass] = store.size();
+
+            std::cout << std::fixed << std::setprecision(3) << systems.getThreads() << " thread" << (systems.getThreads() > 1 ? "s" : "")
+                << ": total p50 " << percentile(total, 0.50) << " ms, p99 " << percentile(total, 0.99) << " ms per frame, "
+                << store.size() << " left" << std::endl;
+            std::cout << "  ai " << percentile(ai, 0.50) << ", movement " << percentile(movement, 0.50) << ", health "
+                << percentile(health, 0.50) << ", removal p50 " << percentile(removal, 0.50) << " max " << percentile(removal, 1.0) << " ms" << std::endl;
+        }
+
+        //the same work through heap objects, nothing dies here so it is slightly less work than the store did
+        std::vector<std::unique_ptr<ObjectMob>> objects;
+        uint32_t seed = 0x9E3779B9u;
+        for (size_t i = 0; i < count; i++) {
+            objects.push_back(std::make_unique<ObjectBee>());
+            objects.back()->modelPath = World::BEE_MODEL;
+            objects.back()->position = spread(i);
+            seed = seed * 1664525u + 1013904223u;
+            objects.back()->seed = seed | 1u;
+        }
+        std::vector<double> objectMs;
+        for (int frame = 0; frame < options.frames; frame++) {
+            Clock::time_point start = Clock::now();
+            for (auto& object : objects) object->update(deltaTime);
+            objectMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        std::cout << "heap objects, 1 thread: p50 " << percentile(objectMs, 0.50) << " ms, p99 " << percentile(objectMs, 0.99) << " ms per frame" << std::endl;
+
+        if (hashes[0] != hashes[1] || survivors[0] != survivors[1]) {
+            std::cerr << "entities ended up different on " << threadCounts[1] << " threads" << std::endl;
+            ok = false;
+        }
+        return ok ? 0 : 1;
+    }
+
+    //the same checks a tier partition has to pass after standing still for a reclassify cycle. An entity keeps
+    //moving after it is classified, so one within slack blocks of a boundary may be in the tier on either side
+    size_t countMisplaced(const EntitySystems& systems, const EntityStore& store, const glm::vec3& focus, float slack, size_t& stale) {
+        const EntityTierSettings& tiers = systems.tiers;
+        auto tierAt = [&](float distance) {
+            return distance < tiers.nearDistance ? TIER_NEAR : distance < tiers.farDistance ? TIER_MEDIUM : TIER_FAR;
+        };
+        size_t wrong = 0;
+        stale = 0;
+        for (size_t i = 0; i < store.size(); i++) {
+            float distance = glm::length(glm::vec3(store.posX[i], store.posY[i], store.posZ[i]) - focus);
+            EntityTier tier = systems.tierOf(i);
+            if (tier < tierAt(distance - slack) || tier > tierAt(distance + slack)) wrong++;
+            if (tier == TIER_NEAR && store.updatedAt[i] != systems.simulationTime()) stale++;
+        }
+        return wrong;
+    }
+
+    int runLod(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const float walkSpeed = 4.3f;//blocks per second
+        std::cout << "lod, " << options.frames << " frames, player walking at " << walkSpeed << " blocks per second" << std::endl;
+        bool ok = true;
+
+        size_t counts[] = { static_cast<size_t>(options.entities) / 10, static_cast<size_t>(options.entities), static_cast<size_t>(options.entities) * 10 };
+        for (size_t count : counts) {
+            //one entity per 2x2 blocks, centred on the start so the near and medium tiers hold the same whatever the count
+            size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+            float half = side * 1.0f;
+            for (int pass = 0; pass < 2; pass++) {
+                EntityStore store;
+                uint32_t bee = store.modelHandle(World::BEE_MODEL);
+                for (size_t i = 0; i < count; i++) {
+                    store.create(bee, glm::vec3((i % side) * 2.0f - half, 40.0f + (i % 13), (i / side) * 2.0f - half), 10.0f);
+                }
+                EntitySystems systems;
+                systems.setThreads(options.threads);
+                systems.tiers.enabled = pass == 1;
+
+                glm::vec3 focus(0.0f, 45.0f, 0.0f);
+                std::vector<double> total;
+                double entities[TIER_COUNT] = {}, updated[TIER_COUNT] = {}, moved = 0.0;
+                for (int frame = 0; frame < options.frames; frame++) {
+                    focus.x += walkSpeed * deltaTime;
+                    systems.update(store, deltaTime, focus);
+                    total.push_back(systems.lastTimes().total());
+                    const EntityTierStats& stats = systems.lastTierStats();
+                    for (int tier = 0; tier < TIER_COUNT; tier++) {
+                        entities[tier] += stats.entities[tier];
+                        updated[tier] += stats.updated[tier];
+                    }
+                    moved += stats.moved;
+                }
+
+                std::cout << std::fixed << std::setprecision(3) << std::setw(8) << count << " entities, tiers "
+                    << (pass == 1 ? "on " : "off") << ": p50 " << percentile(total, 0.50) << " ms, p99 " << percentile(total, 0.99)
+                    << " ms per frame" << std::endl;
+                if (pass == 0) continue;
+                const char* names[TIER_COUNT] = { "near", "medium", "far" };
+                std::cout << std::setprecision(0);
+                for (int tier = 0; tier < TIER_COUNT; tier++) {
+                    std::cout << "  " << names[tier] << " " << entities[tier] / options.frames << " updated " << updated[tier] / options.frames;
+                }
+                std::cout << ", changed tier " << std::setprecision(1) << moved / options.frames << " per frame" << std::endl;
+
+                //steps too small to move much but big enough to tell this frame's updates from older ones. Medium
+                //entities (and far ones, unless frozen) still have frames of walking saved up, so first they are
+                //given their turns until none of them has, then a full reclassify cycle. What an entity can still walk after it was last
+                //classified is at most its top speed for the time those frames add up to
+                const float checkStep = 1e-6f;
+                int checkFrames = 0;
+                auto savedUp = [&]() {
+                    double longest = 0.0;
+                    for (size_t i = 0; i < store.size(); i++) {
+                        EntityTier tier = systems.tierOf(i);
+                        if (tier == TIER_MEDIUM || (tier == TIER_FAR && systems.tiers.farInterval > 0)) {
+                            longest = std::max(longest, systems.simulationTime() - store.updatedAt[i]);
+                        }
+                    }
+                    return longest;
+                };
+                int drainLimit = 4 * std::max(1, systems.tiers.mediumInterval) + 4;
+                for (; checkFrames < drainLimit && savedUp() > checkStep * (checkFrames + 1); checkFrames++) systems.update(store, checkStep, focus);
+                for (int frame = 0; frame <= systems.tiers.reclassifyFrames; frame++, checkFrames++) systems.update(store, checkStep, focus);
+                float topSpeed = EntitySystems::WANDER_SPEED * std::sqrt(1.0f + 0.25f * 0.25f);
+                float slack = topSpeed * checkStep * checkFrames + 1e-4f;
+                size_t stale;
+                size_t wrong = countMisplaced(systems, store, focus, slack, stale);
+                if (wrong > 0 || stale > 0) {
+                    std::cerr << "  " << wrong << " entities in the wrong tier, " << stale << " near entities not updated" << std::endl;
+                    ok = false;
+                }
+            }
+        }
+        return ok ? 0 : 1;
+    }
+
+    //the grid's answers against walking every entity, ids compared as sorted sets, nearest by distance order
+    size_t checkGridQueries(const EntityGrid& grid, const EntityStore& store, std::mt19937& rng, size_t queries) {
+        auto position = [&store](size_t i) { return glm::vec3(store.posX[i], store.posY[i], store.posZ[i]); };
+        auto byIndex = [](const EntityId& a, const EntityId& b) { return a.index < b.index; };
+        std::uniform_real_distribution<float> across(-280.0f, 280.0f), height(20.0f, 70.0f);
+        size_t wrong = 0;
+        std::vector<EntityId> found, expected;
+        //ties could come back in either order, so compare the distances rather than the ids
+        auto nearestWrong = [&](const glm::vec3& center, size_t k, float maxDistance) {
+            found.clear();
+            grid.queryNearest(center, k, maxDistance, found);
+            std::vector<float> all, got;
+            for (size_t i = 0; i < store.size(); i++) {
+                glm::vec3 offset = position(i) - center;
+                if (glm::dot(offset, offset) <= maxDistance * maxDistance) all.push_back(glm::dot(offset, offset));
+            }
+            std::sort(all.begin(), all.end());
+            all.resize(std::min(all.size(), k));
+            for (const EntityId& id : found) {
+                glm::vec3 offset = position(store.indexOf(id)) - center;
+                got.push_back(glm::dot(offset, offset));
+            }
+            return got != all;
+        };
+        for (size_t q = 0; q < queries; q++) {
+            glm::vec3 center(across(rng), height(rng), across(rng));
+
+            found.clear();
+            expected.clear();
+            grid.queryRange(center, 8.0f, found);
+            for (size_t i = 0; i < store.size(); i++) {
+                glm::vec3 offset = position(i) - center;
+                if (glm::dot(offset, offset) <= 64.0f) expected.push_back(store.ids[i]);
+            }
+            std::sort(found.begin(), found.end(), byIndex);
+            std::sort(expected.begin(), expected.end(), byIndex);
+            if (found != expected) wrong++;
+
+            found.clear();
+            expected.clear();
+            glm::vec3 boxMin = center - glm::vec3(8.0f), boxMax = center + glm::vec3(8.0f);
+            grid.queryBox(boxMin, boxMax, found);
+            for (size_t i = 0; i < store.size(); i++) {
+                glm::vec3 p = position(i);
+                if (glm::all(glm::greaterThanEqual(p, boxMin)) && glm::all(glm::lessThanEqual(p, boxMax))) expected.push_back(store.ids[i]);
+            }
+            std::sort(found.begin(), found.end(), byIndex);
+            std::sort(expected.begin(), expected.end(), byIndex);
+            if (found != expected) wrong++;
+
+            wrong += nearestWrong(center, 8, 32.0f);
+        }
+        //with no distance limit, from inside the area and from far outside it, and asking for more than there are
+        for (const glm::vec3& center : { glm::vec3(0.0f, 40.0f, 0.0f), glm::vec3(-100000.0f, 40.0f, 3000.0f) }) {
+            wrong += nearestWrong(center, 8, std::numeric_limits<float>::infinity());
+            wrong += nearestWrong(center, 8, std::numeric_limits<float>::max());
+            wrong += nearestWrong(center, store.size() + 1, std::numeric_limits<float>::infinity());
+        }
+        return wrong;
+    }
+
+    int runGrid(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const size_t queries = static_cast<size_t>(options.ops);
+        std::cout << "grid seed " << options.seed << ", " << options.frames << " frames of movement, " << queries << " queries of each kind" << std::endl;
+        bool ok = true;
+
+        size_t counts[] = { static_cast<size_t>(options.entities) / 10, static_cast<size_t>(options.entities) };
+        for (size_t count : counts) {
+            std::mt19937 rng(static_cast<uint32_t>(options.seed));
+            std::uniform_real_distribution<float> across(-256.0f, 256.0f), height(30.0f, 60.0f);
+            EntityStore store;
+            uint32_t bee = store.modelHandle(World::BEE_MODEL);
+            for (size_t i = 0; i < count; i++) store.create(bee, glm::vec3(across(rng), height(rng), across(rng)), 10.0f);
+
+            EntityGrid grid;
+            Clock::time_point start = Clock::now();
+            grid.rebuild(store);
+            double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            size_t wrong = checkGridQueries(grid, store, rng, 300);
+
+            //every entity moves every frame so the grid sees the most updates it can
+            EntitySystems systems;
+            systems.tiers.enabled = false;
+            systems.setGrid(&grid);
+            std::vector<double> gridMs;
+            for (int frame = 0; frame < options.frames; frame++) {
+                systems.update(store, deltaTime, glm::vec3(0.0f));
+                gridMs.push_back(systems.lastTimes().grid);
+            }
+            wrong += checkGridQueries(grid, store, rng, 300);
+            if (grid.size() != store.size()) wrong++;
+
+            std::vector<glm::vec3> centers;
+            for (size_t q = 0; q < queries; q++) centers.push_back(glm::vec3(across(rng), height(rng), across(rng)));
+            std::vector<EntityId> found;
+            size_t hits[3] = {};
+            double ms[3];
+            for (int kind = 0; kind < 3; kind++) {
+                start = Clock::now();
+                for (const glm::vec3& center : centers) {
+                    found.clear();
+                    if (kind == 0) hits[kind] += grid.queryRange(center, 8.0f, found);
+                    else if (kind == 1) hits[kind] += grid.queryBox(center - glm::vec3(8.0f), center + glm::vec3(8.0f), found);
+                    else hits[kind] += grid.queryNearest(center, 8, 32.0f, found);
+                }
+                ms[kind] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            }
+
+            //the same range query over every entity, on fewer queries since each one walks them all
+            size_t bruteQueries = std::max<size_t>(1, std::min<size_t>(queries, 200));
+            size_t bruteHits = 0;
+            start = Clock::now();
+            for (size_t q = 0; q < bruteQueries; q++) {
+                for (size_t i = 0; i < store.size(); i++) {
+                    float dx = store.posX[i] - centers[q].x, dy = store.posY[i] - centers[q].y, dz = store.posZ[i] - centers[q].z;
+                    bruteHits += dx * dx + dy * dy + dz * dz <= 64.0f;
+                }
+            }
+            double bruteMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            auto perSecond = [](size_t n, double milliseconds) { return n / std::max(milliseconds, 1e-6) * 1000.0; };
+            std::cout << std::fixed << std::setprecision(3) << std::setw(7) << count << " entities, " << grid.cellCount() << " cells: build "
+                << buildMs << " ms, upkeep p50 " << percentile(gridMs, 0.50) << " ms p99 " << percentile(gridMs, 0.99) << " ms per frame" << std::endl;
+            std::cout << std::setprecision(0) << "  range " << perSecond(queries, ms[0]) << "/s (" << std::setprecision(1) << double(hits[0]) / queries
+                << " found), box " << std::setprecision(0) << perSecond(queries, ms[1]) << "/s (" << std::setprecision(1) << double(hits[1]) / queries
+                << " found), nearest " << std::setprecision(0) << perSecond(queries, ms[2]) << "/s (" << std::setprecision(1) << double(hits[2]) / queries
+                << " found), range over every entity " << std::setprecision(0) << perSecond(bruteQueries, bruteMs) << "/s ("
+                << std::setprecision(1) << double(bruteHits) / bruteQueries << " found)" << std::endl;
+            if (wrong > 0) {
+                std::cerr << "  " << wrong << " queries differ from walking every entity" << std::endl;
+                ok = false;
+            }
+        }
+        return ok ? 0 : 1;
+    }
+
+    //what World::raycastBlock used to do: sample every 0.1 along the ray, taking the lock and finding the chunk each time
+    bool marchRaycast(World& world, const glm::vec3& origin, const glm::vec3& dir, float reach, glm::vec3& hitBlock) {
+        for (float t = 0.0f; t < reach; t += 0.1f) {
+            glm::vec3 position = origin + dir * t;
+            Chunk* chunk = nullptr;
+            {
+                std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+                auto it = world.chunks.find(getChunkKey(static_cast<int>(std::floor(position.x / Chunk::chunkSize)), static_cast<int>(std::floor(position.z / Chunk::chunkSize))));
+                if (it != world.chunks.end()) chunk = &it->second;
+            }
+            if (!chunk) continue;
+            glm::ivec3 local = glm::ivec3(glm::floor(position)) - glm::ivec3(chunk->chunkPosition);
+            if (local.y < 0 || local.y >= Chunk::chunkHeight) continue;
+            if (chunk->blocks[chunk->getBlockIndex(local.x, local.y, local.z)] != BlockType::AIR) {
+                hitBlock = glm::floor(position);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //where the ray goes into the block's box and comes out, false if it misses the box
+    bool rayBox(const glm::vec3& origin, const glm::vec3& dir, const glm::ivec3& block, float& enter, float& exit) {
+        enter = -std::numeric_limits<float>::infinity();
+        exit = std::numeric_limits<float>::infinity();
+        for (int axis = 0; axis < 3; axis++) {
+            float low = static_cast<float>(block[axis]), high = low + 1.0f;
+            if (dir[axis] == 0.0f) {
+                if (origin[axis] < low || origin[axis] > high) return false;
+                continue;
+            }
+            float a = (low - origin[axis]) / dir[axis], b = (high - origin[axis]) / dir[axis];
+            enter = std::max(enter, std::min(a, b));
+            exit = std::min(exit, std::max(a, b));
+        }
+        return enter <= exit && exit >= 0.0f;
+    }
+
+    bool checkRaycastCase(const char* name, const std::vector<glm::ivec3>& solid, const glm::vec3& origin, const glm::vec3& dir, float maxDistance,
+        bool expectHit, const glm::ivec3& block = glm::ivec3(0), const glm::ivec3& normal = glm::ivec3(0), float distance = 0.0f) {
+        auto isSolid = [&solid](const glm::ivec3& b) { return std::find(solid.begin(), solid.end(), b) != solid.end(); };
+        RaycastHit hit;
+        bool got = raycastVoxels(origin, dir, maxDistance, isSolid, hit);
+        bool right = got == expectHit && (!got || (hit.block == block && hit.normal == normal && std::abs(hit.distance - distance) < 1e-5f));
+        if (!right) {
+            std::cerr << "raycast case " << name << ": " << (got ? "hit" : "missed");
+            if (got) std::cerr << " " << hit.block.x << "," << hit.block.y << "," << hit.block.z << " normal " << hit.normal.x << ","
+                << hit.normal.y << "," << hit.normal.z << " at " << hit.distance;
+            std::cerr << std::endl;
+        }
+        return right;
+    }
+
+    bool checkRaycastEdgeCases() {
+        int wrong = 0, cases = 0;
+        auto check = [&](bool right) { cases++; wrong += !right; };
+        glm::vec3 center(0.5f);
+        check(checkRaycastCase("+x", { {3, 0, 0} }, center, glm::vec3(1, 0, 0), 10.0f, true, { 3, 0, 0 }, { -1, 0, 0 }, 2.5f));
+        check(checkRaycastCase("-x negative coords", { {-4, 0, 0} }, glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(-1, 0, 0), 10.0f, true, { -4, 0, 0 }, { 1, 0, 0 }, 2.5f));
+        check(checkRaycastCase("-y", { {0, -3, 0} }, center, glm::vec3(0, -1, 0), 10.0f, true, { 0, -3, 0 }, { 0, 1, 0 }, 2.5f));
+        check(checkRaycastCase("+z", { {0, 0, 2} }, center, glm::vec3(0, 0, 1), 10.0f, true, { 0, 0, 2 }, { 0, 0, -1 }, 1.5f));
+        check(checkRaycastCase("inside", { {0, 0, 0} }, center, glm::vec3(1, 0, 0), 10.0f, true, { 0, 0, 0 }, { 0, 0, 0 }, 0.0f));
+        check(checkRaycastCase("on a boundary going back", { {1, 0, 0} }, glm::vec3(3.0f, 0.5f, 0.5f), glm::vec3(-1, 0, 0), 10.0f, true, { 1, 0, 0 }, { 1, 0, 0 }, 1.0f));
+        //exact ties step z, then y, then x, so the face is the x one
+        check(checkRaycastCase("through an edge", { {1, 1, 0} }, center, glm::vec3(1, 1, 0), 10.0f, true, { 1, 1, 0 }, { -1, 0, 0 }, std::sqrt(0.5f)));
+        check(checkRaycastCase("through a corner", { {1, 1, 1} }, center, glm::vec3(1, 1, 1), 10.0f, true, { 1, 1, 1 }, { -1, 0, 0 }, std::sqrt(0.75f)));
+        check(checkRaycastCase("past an edge", { {1, 0, 0}, {0, 1, 0} }, center, glm::vec3(1, 1, 0), 10.0f, true, { 0, 1, 0 }, { 0, -1, 0 }, std::sqrt(0.5f)));
+        check(checkRaycastCase("clipping a corner", { {2, 1, 0} }, center, glm::vec3(1.52f, 1.48f, 0.0f), 10.0f, true, { 2, 1, 0 }, { -1, 0, 0 },
+            1.5f * glm::length(glm::vec2(1.52f, 1.48f)) / 1.52f));
+        check(checkRaycastCase("at max distance", { {5, 0, 0} }, center, glm::vec3(1, 0, 0), 4.5f, true, { 5, 0, 0 }, { -1, 0, 0 }, 4.5f));
+        check(checkRaycastCase("past max distance", { {5, 0, 0} }, center, glm::vec3(1, 0, 0), 4.49f, false));
+        check(checkRaycastCase("zero max distance", { {0, 0, 0} }, center, glm::vec3(1, 0, 0), 0.0f, true, { 0, 0, 0 }, { 0, 0, 0 }, 0.0f));
+        check(checkRaycastCase("zero direction", { {0, 0, 0} }, center, glm::vec3(0.0f), 10.0f, false));
+        check(checkRaycastCase("unnormalized", { {3, 0, 0} }, center, glm::vec3(10, 0, 0), 10.0f, true, { 3, 0, 0 }, { -1, 0, 0 }, 2.5f));
+        check(checkRaycastCase("nearest of two", { {4, 0, 0}, {2, 0, 0} }, center, glm::vec3(1, 0, 0), 10.0f, true, { 2, 0, 0 }, { -1, 0, 0 }, 1.5f));
+        check(checkRaycastCase("parallel miss", { {3, 1, 0} }, center, glm::vec3(1, 0, 0), 10.0f, false));
+        std::cout << "raycast edge cases: " << cases << " cases, " << wrong << " wrong" << std::endl;
+        return wrong == 0;
+    }
+
+    //random rays through random blocks against intersecting the ray with every block box. Rays that only graze the
+    //nearest box or end right at it are skipped, either answer is right for those
+    bool checkRaycastRandom(const BenchOptions& options) {
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_real_distribution<float> inside(0.0f, 16.0f), any(-1.0f, 1.0f);
+        const float maxDistance = 24.0f;
+        size_t rays = 20000, wrong = 0, skipped = 0, marchWrong = 0, skipWrong = 0;
+        std::vector<glm::ivec3> solid;
+        std::vector<uint8_t> field(16 * 16 * 16);
+        uint8_t cellSolids[4 * 4 * 4], pairSolids[8 * 8 * 8];//blocks in each 4^3 and 2^3 cell, for the skipping traversal
+        for (size_t r = 0; r < rays; r++) {
+            if (r % 1000 == 0) {
+                solid.clear();
+                for (size_t i = 0; i < field.size(); i++) {
+                    //clumped so plenty of cells are empty
+                    glm::ivec3 b(i % 16, (i / 16) % 16, i / 256);
+                    field[i] = (b.x / 4 + b.y / 4 * 2 + b.z / 4 * 3) % 3 == 0 && rng() % 12 == 0;
+                    if (field[i]) solid.push_back(b);
+                }
+                std::fill(cellSolids, cellSolids + 64, uint8_t(0));
+                std::fill(pairSolids, pairSolids + 512, uint8_t(0));
+                for (const glm::ivec3& b : solid) {
+                    cellSolids[b.x / 4 + b.y / 4 * 4 + b.z / 4 * 16]++;
+                    pairSolids[b.x / 2 + b.y / 2 * 8 + b.z / 2 * 64]++;
+                }
+            }
+            auto isSolid = [&field](const glm::ivec3& b) {
+                if (glm::any(glm::lessThan(b, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(b, glm::ivec3(16)))) return false;
+                return field[b.x + b.y * 16 + b.z * 256] != 0;
+            };
+            auto emptySpan = [&](const glm::ivec3& b) {
+                if (glm::any(glm::lessThan(b, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(b, glm::ivec3(16)))) return 16;
+                if (cellSolids[b.x / 4 + b.y / 4 * 4 + b.z / 4 * 16] == 0) return 4;
+                if (pairSolids[b.x / 2 + b.y / 2 * 8 + b.z / 2 * 64] == 0) return 2;
+                return isSolid(b) ? 0 : 1;
+            };
+            glm::vec3 origin(inside(rng), inside(rng), inside(rng));
+            glm::vec3 dir(any(rng), any(rng), any(rng));
+            if (glm::length(dir) < 0.01f) continue;
+            dir = glm::normalize(dir);
+
+            float best = std::numeric_limits<float>::infinity(), bestSpan = 0.0f;
+            for (const glm::ivec3& b : solid) {
+                float enter, exit;
+                if (!rayBox(origin, dir, b, enter, exit)) continue;
+                enter = std::max(enter, 0.0f);
+                if (enter < best) {
+                    best = enter;
+                    bestSpan = exit - enter;
+                }
+            }
+            if ((best < maxDistance + 1.0f && bestSpan < 1e-3f) || std::abs(best - maxDistance) < 1e-3f) {
+                skipped++;
+                continue;
+            }
+            bool expectHit = best <= maxDistance;
+
+            RaycastHit hit;
+            bool got = raycastVoxels(origin, dir, maxDistance, isSolid, hit);
+            bool right = got == expectHit;
+            if (right && got) {
+                float enter, exit;
+                right = std::abs(hit.distance - best) < 1e-4f && rayBox(origin, dir, hit.block, enter, exit)
+                    && std::abs(std::max(enter, 0.0f) - best) < 1e-4f;
+                //the hit point has to be on the face the normal says
+                for (int axis = 0; axis < 3 && right && best > 0.0f; axis++) {
+                    if (hit.normal[axis] == 0) continue;
+                    float face = static_cast<float>(hit.block[axis] + (hit.normal[axis] > 0));
+                    right = std::abs(origin[axis] + dir[axis] * hit.distance - face) < 1e-4f;
+                }
+            }
+            wrong += !right;
+
+            RaycastHit skipHit;
+            bool skipGot = raycastVoxelsSkipping(origin, dir, maxDistance, emptySpan, [](const glm::ivec3&) { return true; }, skipHit);
+            skipWrong += skipGot != got || (got && (skipHit.block != hit.block || skipHit.normal != hit.normal || std::abs(skipHit.distance - hit.distance) > 1e-4f));
+
+            bool marchHit = false;
+            for (float t = 0.0f; t < maxDistance && !marchHit; t += 0.1f) marchHit = isSolid(glm::ivec3(glm::floor(origin + dir * t)));
+            marchWrong += marchHit != expectHit;
+        }
+        std::cout << "raycast random: " << rays << " rays, " << skipped << " grazing skipped, " << wrong << " wrong, skipping empty cells "
+            << skipWrong << " different, old march " << marchWrong << " wrong" << std::endl;
+        return wrong == 0 && skipWrong == 0;
+    }
+
+    int runRaycast(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const int maxLoadFrames = 100000;
+        std::cout << "raycast seed " << options.seed << ", render distance " << options.radius << ", " << options.ops << " rays per reach" << std::endl;
+        bool ok = checkRaycastEdgeCases();
+        ok = checkRaycastRandom(options) && ok;
+
+        World world(options.radius);
+        world.init(options.seed);
+        Player player(&world);
+        player.spawn(glm::vec3(10, 200, 10));
+        StreamStats loadStats;
+        PlayerInput idle;
+        while ((world.isLoading() || world.hasPendingWork()) && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats);
+        }
+        glm::vec3 eye(10.5f, surfaceHeight(world, 10, 10) + 2.6f, 10.5f);
+
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_real_distribution<float> any(-1.0f, 1.0f);
+        std::vector<glm::vec3> dirs;
+        while (dirs.size() < static_cast<size_t>(options.ops)) {
+            glm::vec3 dir(any(rng), any(rng), any(rng));
+            if (glm::length(dir) > 0.01f) dirs.push_back(glm::normalize(dir));
+        }
+        for (float reach : { 5.0f, 64.0f }) {
+            size_t hits = 0, marchHits = 0;
+            RaycastHit hit;
+            Clock::time_point start = Clock::now();
+            for (const glm::vec3& dir : dirs) hits += world.raycast(eye, dir, reach, hit);
+            double ddaMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            glm::vec3 block;
+            start = Clock::now();
+            for (const glm::vec3& dir : dirs) marchHits += marchRaycast(world, eye, dir, reach, block);
+            double marchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            std::cout << std::fixed << std::setprecision(0) << "reach " << reach << ": traversal " << dirs.size() / std::max(ddaMs, 1e-6) * 1000.0
+                << " rays/s (" << hits << " hit), old march " << dirs.size() / std::max(marchMs, 1e-6) * 1000.0 << " rays/s ("
+                << marchHits << " hit)" << std::endl;
+        }
+
+        //line of sight sized rays from anywhere over the loaded area, a little above the ground
+        int span = options.radius * Chunk::chunkSize;
+        std::uniform_int_distribution<int> across(10 - span, 10 + span);
+        std::uniform_real_distribution<float> above(1.5f, 12.0f), level(-0.3f, 0.3f);
+        int threads = std::max(1, options.threads);
+        std::vector<RaycastBatchScratch> scratches(threads);
+        for (size_t count : { size_t(1000), size_t(10000), size_t(100000) }) {
+            std::vector<BlockRay> rays(count);
+            for (BlockRay& ray : rays) {
+                int x = across(rng), z = across(rng);
+                ray.origin = glm::vec3(x + 0.5f, surfaceHeight(world, x, z) + above(rng), z + 0.5f);
+                float angle = any(rng) * 3.14159265f;
+                ray.direction = glm::vec3(std::sin(angle), level(rng), std::cos(angle));
+                ray.maxDistance = 64.0f;
+            }
+            std::vector<RaycastHit> single(count), batch(count);
+            std::vector<uint8_t> singleFlags(count), batchFlags(count);
+
+            Clock::time_point start = Clock::now();
+            for (size_t i = 0; i < count; i++) singleFlags[i] = world.raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance, single[i]);
+            double singleMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            start = Clock::now();
+            world.raycastBatch(rays.data(), count, batch.data(), batchFlags.data(), scratches[0]);
+            double batchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            //a ray through a block edge enters two blocks at once and the batch, having jumped there, can round to the
+            //other one. Then both only have to be solid, at the same distance, with the hit point on the face hit
+            auto onFace = [&](const BlockRay& ray, const RaycastHit& hit) {
+                Chunk* chunk = world.getChunk(glm::vec3(hit.block));
+                if (!chunk) return false;
+                glm::ivec3 local = hit.block - glm::ivec3(chunk->chunkPosition);
+                if (chunk->blocks[chunk->getBlockIndex(local.x, local.y, local.z)] == BlockType::AIR) return false;
+                glm::vec3 point = ray.origin + glm::normalize(ray.direction) * hit.distance;
+                for (int axis = 0; axis < 3; axis++) {
+                    if (point[axis] < hit.block[axis] - 1e-3f || point[axis] > hit.block[axis] + 1.0f + 1e-3f) return false;
+                    if (hit.normal[axis] != 0 && std::abs(point[axis] - (hit.block[axis] + (hit.normal[axis] > 0))) > 1e-3f) return false;
+                }
+                return true;
+            };
+            size_t different = 0, ties = 0;
+            for (size_t i = 0; i < count; i++) {
+                if (singleFlags[i] != batchFlags[i]) different++;
+                else if (singleFlags[i] && (single[i].block != batch[i].block || single[i].normal != batch[i].normal
+                    || std::abs(single[i].distance - batch[i].distance) > 1e-4f)) {
+                    if (std::abs(single[i].distance - batch[i].distance) <= 1e-4f && onFace(rays[i], single[i]) && onFace(rays[i], batch[i])) ties++;
+                    else different++;
+                }
+            }
+
+            //the batch split between worker threads, each with its own scratch, while this thread keeps digging out and
+            //filling in a block like the game thread would. It is a block walled in on every side, so no ray can
+            //reach it and the results stay the same, next to one the rays hit so the edits write the bits they read
+            auto typeAt = [&](const glm::ivec3& block) {
+                Chunk* chunk = world.getChunk(glm::vec3(block));
+                glm::ivec3 local = block - (chunk ? glm::ivec3(chunk->chunkPosition) : glm::ivec3(0));
+                if (!chunk || local.y < 0 || local.y >= Chunk::chunkHeight) return BlockType::AIR;
+                return chunk->blocks[chunk->getBlockIndex(local.x, local.y, local.z)];
+            };
+            auto solidAt = [&](const glm::ivec3& block) { return typeAt(block) != BlockType::AIR; };
+            const glm::ivec3 sides[6] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+            auto walledIn = [&](const glm::ivec3& block) {
+                if (!solidAt(block)) return false;
+                for (const glm::ivec3& side : sides) if (!solidAt(block + side)) return false;
+                return true;
+            };
+            glm::ivec3 edited(0);
+            bool found = false;
+            for (size_t i = 0; i < count && !found; i++) {
+                if (!singleFlags[i]) continue;
+                for (int down = 1; down <= 4 && !found; down++) {
+                    for (const glm::ivec3& side : sides) {
+                        glm::ivec3 block = single[i].block + side - glm::ivec3(0, down, 0);
+                        if (walledIn(block)) {
+                            edited = block;
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            std::fill(batchFlags.begin(), batchFlags.end(), uint8_t(0));
+            start = Clock::now();
+            std::vector<std::future<void>> running;
+            std::atomic<int> finished{ 0 };
+            size_t part = (count + threads - 1) / threads;
+            for (int t = 0; t < threads; t++) {
+                size_t begin = std::min(count, t * part), end = std::min(count, begin + part);
+                running.push_back(std::async(std::launch::async, [&, t, begin, end]() {
+                    world.raycastBatch(rays.data() + begin, end - begin, batch.data() + begin, batchFlags.data() + begin, scratches[t]);
+                    finished++;
+                }));
+            }
+            BlockType editedType = typeAt(edited);
+            size_t edits = 0;
+            for (; finished < threads && found; edits++) world.setBlockAt(glm::vec3(edited), edits % 2 ? editedType : BlockType::AIR);
+            if (found) world.setBlockAt(glm::vec3(edited), editedType);
+            for (std::future<void>& job : running) job.get();
+            double threadedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            for (size_t i = 0; i < count; i++) different += singleFlags[i] != batchFlags[i];
+
+            size_t hits = std::count(singleFlags.begin(), singleFlags.end(), uint8_t(1));
+            std::cout << std::setw(6) << count << " rays (" << hits << " hit): one at a time " << count / std::max(singleMs, 1e-6) * 1000.0
+                << " rays/s, batch " << count / std::max(batchMs, 1e-6) * 1000.0 << " rays/s, batch on " << threads << " thread"
+                << (threads > 1 ? "s " : " ") << count / std::max(threadedMs, 1e-6) * 1000.0 << " rays/s next to " << edits << " block edits, " << ties << " through an edge" << std::endl;
+            if (different > 0) {
+                std::cerr << "  " << different << " batch results differ from World::raycast" << std::endl;
+                ok = false;
+            }
+        }
+        return ok ? 0 : 1;
+    }
+
+    //the chunk's column tops and tallest block against scanning its blocks, and the pyramid's columns against the chunk
+    size_t checkColumnTops(World& world) {
+        size_t wrong = 0;
+        for (auto& pair : world.chunks) {
+            const Chunk& chunk = pair.second;
+            int tallest = -1;
+            for (int z = 0; z < Chunk::chunkSize; z++) {
+                for (int x = 0; x < Chunk::chunkSize; x++) {
+                    int top = -1;
+                    for (int y = Chunk::chunkHeight - 1; y >= 0 && top < 0; y--) {
+                        if (chunk.blocks[chunk.getBlockIndex(x, y, z)] != BlockType::AIR) top = y;
+                    }
+                    tallest = std::max(tallest, top);
+                    int stored = 0;
+                    bool loaded = world.heights.columnTop(static_cast<int>(chunk.chunkPosition.x) + x, static_cast<int>(chunk.chunkPosition.z) + z, stored);
+                    wrong += chunk.columnTops[z * Chunk::chunkSize + x] != top || !loaded || stored != static_cast<int>(chunk.chunkPosition.y) + top;
+                }
+            }
+            wrong += chunk.currentTallestBlock != tallest;
+        }
+        return wrong;
+    }
+
+    //the same answer from every column of every loaded chunk in the box
+    bool bruteRegionHeights(World& world, int minX, int minZ, int maxX, int maxZ, int& low, int& high) {
+        bool any = false;
+        low = std::numeric_limits<int>::max();
+        high = std::numeric_limits<int>::min();
+        for (int z = minZ; z <= maxZ; z++) {
+            for (int x = minX; x <= maxX; x++) {
+                Chunk* chunk = world.getChunk(glm::vec3(x, 0, z));
+                if (!chunk) continue;
+                int localX = x - static_cast<int>(chunk->chunkPosition.x), localZ = z - static_cast<int>(chunk->chunkPosition.z);
+                int top = static_cast<int>(chunk->chunkPosition.y) + chunk->columnTops[localZ * Chunk::chunkSize + localX];
+                low = std::min(low, top);
+                high = std::max(high, top);
+                any = true;
+            }
+        }
+        return any;
+    }
+
+    //visiting every block on the way, with the same world limits as HeightPyramid::raycast
+    bool bruteRaycastTerrain(const HeightPyramid& heights, const glm::vec3& origin, const glm::vec3& dir, float maxDistance, RaycastHit& hit) {
+        int top = 0;
+        auto keepGoing = [&](const glm::ivec3& block) {
+            if ((block.y < HeightPyramid::MIN_Y && dir.y <= 0.0f) || (block.y > heights.highest() && dir.y >= 0.0f)) return false;
+            return heights.columnTop(block.x, block.z, top);
+        };
+        auto isSolid = [&](const glm::ivec3& block) { return block.y <= top; };
+        return raycastVoxels(origin, dir, maxDistance, isSolid, keepGoing, hit);
+    }
+
+    int runHeights(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const int maxLoadFrames = 100000;
+        std::cout << "heights seed " << options.seed << ", render distance " << options.radius << ", " << options.ops << " queries" << std::endl;
+        bool ok = true;
+
+        World world(options.radius);
+        world.init(options.seed);
+        Player player(&world);
+        player.spawn(glm::vec3(10, 200, 10));
+        StreamStats loadStats;
+        PlayerInput idle;
+        while ((world.isLoading() || world.hasPendingWork()) && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats);
+        }
+        std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+        size_t wrong = checkColumnTops(world);
+        std::cout << "generated: " << world.chunks.size() << " chunks, " << world.heights.chunkCount() << " in the pyramid, " << wrong
+            << " columns wrong, highest " << world.heights.highest() << std::endl;
+        ok = wrong == 0 && world.heights.chunkCount() == world.chunks.size() && ok;
+
+        //building and digging around the spawn at the top of columns and anywhere below, and whole columns dug out to
+        //nothing, crossing chunk edges
+        int span = options.radius * Chunk::chunkSize;
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_int_distribution<int> across(10 - span, 10 + span), nearSpawn(-40, 60), depth(0, 40), anyHeight(-Chunk::baseTerrainHeight, Chunk::chunkHeight - Chunk::baseTerrainHeight - 1);
+        size_t edits = 20000;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < edits; i++) {
+            int x = nearSpawn(rng), z = nearSpawn(rng), top = 0;
+            if (!world.heights.columnTop(x, z, top)) continue;
+            switch (rng() % 4) {
+            case 0: world.setBlockAt(glm::vec3(x, std::min(top + 1 + depth(rng) % 8, Chunk::chunkHeight - Chunk::baseTerrainHeight - 1), z), BlockType::STONE); break;
+            case 1: world.setBlockAt(glm::vec3(x, top, z), BlockType::AIR); break;
+            case 2: world.setBlockAt(glm::vec3(x, anyHeight(rng), z), rng() % 2 ? BlockType::AIR : BlockType::STONE); break;
+            default:
+                if (rng() % 16 == 0) {
+                    for (int y = top; y >= -Chunk::baseTerrainHeight; y--) world.setBlockAt(glm::vec3(x, y, z), BlockType::AIR);
+                }
+            }
+        }
+        double editMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        wrong = checkColumnTops(world);
+        std::cout << std::fixed << std::setprecision(2) << "edited: " << edits << " random edits in " << editMs << " ms, " << wrong << " columns wrong" << std::endl;
+        ok = wrong == 0 && ok;
+
+        //regions from a few blocks to the whole world, partly outside the loaded area as well
+        std::uniform_int_distribution<int> width(1, 2 * span + 64), outside(10 - span - 48, 10 + span + 48);
+        size_t queries = static_cast<size_t>(options.ops) / 10, bruteQueries = std::min<size_t>(queries, 2000), loaded = 0;
+        std::vector<glm::ivec4> regions(queries);
+        for (glm::ivec4& region : regions) {
+            int w = rng() % 4 == 0 ? width(rng) : 1 + depth(rng);
+            region.x = outside(rng);
+            region.y = outside(rng);
+            region.z = region.x + w - 1;
+            region.w = region.y + (rng() % 2 ? w : 1 + depth(rng)) - 1;
+        }
+        std::vector<int> lows(queries), highs(queries);
+        std::vector<uint8_t> found(queries);
+        start = Clock::now();
+        for (size_t i = 0; i < queries; i++) found[i] = world.heights.regionRange(regions[i].x, regions[i].y, regions[i].z, regions[i].w, lows[i], highs[i]);
+        double pyramidMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        wrong = 0;
+        start = Clock::now();
+        for (size_t i = 0; i < bruteQueries; i++) {
+            int low = 0, high = 0;
+            bool any = bruteRegionHeights(world, regions[i].x, regions[i].y, regions[i].z, regions[i].w, low, high);
+            wrong += any != (found[i] != 0) || (any && (low != lows[i] || high != highs[i]));
+            loaded += any;
+        }
+        double bruteMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cout << std::setprecision(0) << "regions: pyramid " << queries / std::max(pyramidMs, 1e-6) * 1000.0 << "/s, every column "
+            << bruteQueries / std::max(bruteMs, 1e-6) * 1000.0 << "/s, " << loaded << " of " << bruteQueries << " checked touch the world, "
+            << wrong << " wrong" << std::endl;
+        ok = wrong == 0 && ok;
+
+        //long sight lines from above the ground, flat and looking down, against visiting every block
+        std::uniform_real_distribution<float> any(-1.0f, 1.0f), above(2.0f, 64.0f);
+        size_t rays = static_cast<size_t>(options.ops) / 10, hits = 0;
+        std::vector<BlockRay> sight(rays);
+        for (BlockRay& ray : sight) {
+            int x = across(rng), z = across(rng), top = 0;
+            world.heights.columnTop(x, z, top);
+            ray.origin = glm::vec3(x + 0.5f, top + above(rng), z + 0.5f);
+            float angle = any(rng) * 3.14159265f;
+            ray.direction = glm::vec3(std::sin(angle), -std::abs(any(rng)) * 0.15f, std::cos(angle));
+            ray.maxDistance = rng() % 2 ? 256.0f : std::numeric_limits<float>::infinity();
+        }
+        std::vector<RaycastHit> pyramidHits(rays), bruteHits(rays);
+        std::vector<uint8_t> pyramidFlags(rays), bruteFlags(rays);
+        start = Clock::now();
+        for (size_t i = 0; i < rays; i++) pyramidFlags[i] = world.heights.raycast(sight[i].origin, sight[i].direction, sight[i].maxDistance, pyramidHits[i]);
+        double marchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        start = Clock::now();
+        for (size_t i = 0; i < rays; i++) bruteFlags[i] = bruteRaycastTerrain(world.heights, sight[i].origin, sight[i].direction, sight[i].maxDistance, bruteHits[i]);
+        double everyMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        //a ray through a block edge enters two blocks or faces at once and rounding can pick either, so there the hit
+        //only has to be solid, at the same distance, with the hit point on the face the normal says
+        size_t ties = 0;
+        auto edgeTie = [&](size_t i) {
+            const RaycastHit& hit = pyramidHits[i];
+            int top = 0;
+            if (std::abs(hit.distance - bruteHits[i].distance) > 1e-3f || !world.heights.columnTop(hit.block.x, hit.block.z, top) || hit.block.y > top) return false;
+            glm::vec3 point = sight[i].origin + glm::normalize(sight[i].direction) * hit.distance;
+            for (int axis = 0; axis < 3; axis++) {
+                if (point[axis] < hit.block[axis] - 1e-3f || point[axis] > hit.block[axis] + 1.0f + 1e-3f) return false;
+                if (hit.normal[axis] != 0 && std::abs(point[axis] - (hit.block[axis] + (hit.normal[axis] > 0))) > 1e-3f) return false;
+            }
+            return true;
+        };
+        wrong = 0;
+        for (size_t i = 0; i < rays; i++) {
+            hits += bruteFlags[i];
+            if (pyramidFlags[i] != bruteFlags[i]) wrong++;
+            else if (bruteFlags[i] && (pyramidHits[i].block != bruteHits[i].block || pyramidHits[i].normal != bruteHits[i].normal
+                || std::abs(pyramidHits[i].distance - bruteHits[i].distance) > 1e-3f)) {
+                if (edgeTie(i)) ties++;
+                else wrong++;
+            }
+        }
+        std::cout << "heightfield rays: skipping cells " << rays / std::max(marchMs, 1e-6) * 1000.0 << " rays/s, every block "
+            << rays / std::max(everyMs, 1e-6) * 1000.0 << " rays/s, " << hits << " of " << rays << " hit, " << ties << " through an edge, "
+            << wrong << " different" << std::endl;
+        ok = wrong == 0 && ok;
+        return ok ? 0 : 1;
+    }
+
+    //what Player::playerMovement used to do: move each axis the whole way, then push back out of any solid block in
+    //the 3x3x3 around floor(position) in every chunk the box started in, with a fresh map of those chunks each time
+    BoxMove oldMoveBox(World& world, glm::vec3 position, const AABB& box, glm::vec3 velocity, float deltaTime) {
+        BoxMove move;
+        AABB playerBox = { position + box.min, position + box.max };
+        std::unordered_map<uint64_t, const Chunk*> nearbyChunks;
+        {
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            glm::vec3 minChunkPos = glm::floor(playerBox.min / glm::vec3(Chunk::chunkSize, 1, Chunk::chunkSize)) * glm::vec3(Chunk::chunkSize, 0, Chunk::chunkSize);
+            glm::vec3 maxChunkPos = glm::floor(playerBox.max / glm::vec3(Chunk::chunkSize, 1, Chunk::chunkSize)) * glm::vec3(Chunk::chunkSize, 0, Chunk::chunkSize);
+            for (int x = static_cast<int>(minChunkPos.x); x <= maxChunkPos.x; x += Chunk::chunkSize) {
+                for (int z = static_cast<int>(minChunkPos.z); z <= maxChunkPos.z; z += Chunk::chunkSize) {
+                    uint64_t key = getChunkKey(x / Chunk::chunkSize, z / Chunk::chunkSize);
+                    auto it = world.chunks.find(key);
+                    if (it != world.chunks.end()) nearbyChunks[key] = &it->second;
+                }
+            }
+        }
+        const int order[3] = { 0, 2, 1 };
+        for (int axis : order) {
+            position[axis] += velocity[axis] * deltaTime;
+            playerBox = { position + box.min, position + box.max };
+            for (const auto& pair : nearbyChunks) {
+                glm::vec3 chunkPos = pair.second->chunkPosition;
+                for (int bx = -1; bx <= 1; bx++) {
+                    for (int by = -1; by <= 1; by++) {
+                        for (int bz = -1; bz <= 1; bz++) {
+                            glm::vec3 local = glm::floor(position) + glm::vec3(bx, by, bz) - chunkPos;
+                            if (local.x < 0 || local.x >= Chunk::chunkSize || local.y < 0 || local.y >= Chunk::chunkHeight || local.z < 0 || local.z >= Chunk::chunkSize) continue;
+                            if (pair.second->blocks[pair.second->getBlockIndex(static_cast<int>(local.x), static_cast<int>(local.y), static_cast<int>(local.z))] == BlockType::AIR) continue;
+                            glm::vec3 blockMin = chunkPos + local, blockMax = blockMin + glm::vec3(1.0f);
+                            if (!(playerBox.min.x < blockMax.x && playerBox.max.x > blockMin.x && playerBox.min.y < blockMax.y && playerBox.max.y > blockMin.y
+                                && playerBox.min.z < blockMax.z && playerBox.max.z > blockMin.z)) continue;
+                            if (velocity[axis] > 0) position[axis] = blockMin[axis] - box.max[axis] - 0.001f;
+                            else if (velocity[axis] < 0) position[axis] = blockMax[axis] - box.min[axis] + 0.001f;
+                            move.grounded = move.grounded || (axis == 1 && velocity.y < 0);
+                            velocity[axis] = 0.0f;
+                        }
+                    }
+                }
+            }
+        }
+        move.position = position;
+        move.velocity = velocity;
+        move.steps = 1;
+        return move;
+    }
+
+    bool boxOverlaps(const glm::vec3& boxMin, const glm::vec3& boxMax, const glm::ivec3& block) {
+        return boxMin.x < block.x + 1 && boxMax.x > block.x && boxMin.y < block.y + 1 && boxMax.y > block.y && boxMin.z < block.z + 1 && boxMax.z > block.z;
+    }
+
+    bool checkCollisionCase(const char* name, const std::vector<glm::ivec3>& solid, const glm::vec3& position, const glm::vec3& velocity, float deltaTime,
+        const glm::vec3& expectPosition, const glm::bvec3& expectBlocked, bool expectGrounded) {
+        auto isSolid = [&solid](const glm::ivec3& b) { return std::find(solid.begin(), solid.end(), b) != solid.end(); };
+        AABB box(glm::vec3(-0.3f, 0.0f, -0.3f), glm::vec3(0.3f, 1.8f, 0.3f));
+        BoxMove move = moveBox(position, box, velocity, deltaTime, isSolid);
+        bool right = glm::all(glm::lessThan(glm::abs(move.position - expectPosition), glm::vec3(1e-4f))) && move.blocked == expectBlocked
+            && move.grounded == expectGrounded;
+        for (int axis = 0; axis < 3; axis++) right = right && (move.blocked[axis] ? move.velocity[axis] == 0.0f : move.velocity[axis] == velocity[axis]);
+        if (!right) {
+            std::cerr << std::setprecision(4) << "collision case " << name << ": at " << move.position.x << "," << move.position.y << "," << move.position.z
+                << " blocked " << move.blocked.x << move.blocked.y << move.blocked.z << (move.grounded ? " grounded" : "") << std::endl;
+        }
+        return right;
+    }
+
+    bool checkCollisionCases() {
+        int wrong = 0, cases = 0;
+        auto check = [&](bool right) { cases++; wrong += !right; };
+        std::vector<glm::ivec3> floor, wallX, wallXZ, pillar;
+        for (int x = -1; x <= 1; x++) {
+            for (int z = -1; z <= 1; z++) floor.push_back({ x, 0, z });
+        }
+        for (int y = 0; y <= 2; y++) {
+            for (int i = -5; i <= 5; i++) {
+                wallX.push_back({ 2, y, i });
+                wallXZ.push_back({ 2, y, i });
+                wallXZ.push_back({ i, y, 2 });
+            }
+            pillar.push_back({ 3, y, 3 });
+        }
+        glm::bvec3 none(false), onX(true, false, false), onY(false, true, false), onZ(false, false, true);
+        check(checkCollisionCase("landing", floor, glm::vec3(0.5f, 3.0f, 0.5f), glm::vec3(0, -10, 0), 1.0f, glm::vec3(0.5f, 1.001f, 0.5f), onY, true));
+        //50 blocks in one frame onto a floor one block thick
+        check(checkCollisionCase("fast fall", floor, glm::vec3(0.5f, 50.0f, 0.5f), glm::vec3(0, -3000, 0), 1.0f / 60.0f, glm::vec3(0.5f, 1.001f, 0.5f), onY, true));
+        check(checkCollisionCase("standing", floor, glm::vec3(0.5f, 1.001f, 0.5f), glm::vec3(0, -0.35f, 0), 1.0f / 60.0f, glm::vec3(0.5f, 1.001f, 0.5f), onY, true));
+        check(checkCollisionCase("free fall", {}, glm::vec3(0.5f, 3.0f, 0.5f), glm::vec3(0, -10, 0), 1.0f, glm::vec3(0.5f, -7.0f, 0.5f), none, false));
+        check(checkCollisionCase("ceiling", { {0, 3, 0} }, glm::vec3(0.5f, 0.0f, 0.5f), glm::vec3(0, 5, 0), 1.0f, glm::vec3(0.5f, 1.199f, 0.5f), onY, false));
+        check(checkCollisionCase("wall +x", wallX, glm::vec3(0.5f, 0.0f, 0.5f), glm::vec3(5, 0, 0), 1.0f, glm::vec3(1.699f, 0.0f, 0.5f), onX, false));
+        check(checkCollisionCase("wall -x negative coords", { {-3, 0, -1}, {-3, 1, -1} }, glm::vec3(-0.5f, 0.0f, -0.5f), glm::vec3(-5, 0, 0), 1.0f,
+            glm::vec3(-1.699f, 0.0f, -0.5f), onX, false));
+        check(checkCollisionCase("touching, moving away", wallX, glm::vec3(1.699f, 0.0f, 0.5f), glm::vec3(-1, 0, 0), 1.0f, glm::vec3(0.699f, 0.0f, 0.5f), none, false));
+        check(checkCollisionCase("sliding along a wall", wallX, glm::vec3(0.5f, 0.0f, 0.5f), glm::vec3(5, 0, 3), 1.0f, glm::vec3(1.699f, 0.0f, 3.5f), onX, false));
+        check(checkCollisionCase("into a corner", wallXZ, glm::vec3(0.5f, 0.0f, 0.5f), glm::vec3(5, 0, 5), 1.0f, glm::vec3(1.699f, 0.0f, 1.699f), glm::bvec3(true, false, true), false));
+        //split into half block steps it meets the pillar on z, in one step x would have gone past it first
+        check(checkCollisionCase("cutting a corner", pillar, glm::vec3(0.5f, 0.0f, 0.5f), glm::vec3(6, 0, 6), 1.0f, glm::vec3(6.5f, 0.0f, 2.699f), onZ, false));
+        check(checkCollisionCase("inside a block", { {0, 0, 0} }, glm::vec3(0.5f, 0.0f, 0.5f), glm::vec3(5, 0, 0), 1.0f, glm::vec3(5.5f, 0.0f, 0.5f), none, false));
+        check(checkCollisionCase("standing still", floor, glm::vec3(0.5f, 1.001f, 0.5f), glm::vec3(0.0f), 1.0f / 60.0f, glm::vec3(0.5f, 1.001f, 0.5f), none, false));
+        std::cout << "collision cases: " << cases << " cases, " << wrong << " wrong" << std::endl;
+        return wrong == 0;
+    }
+
+    //single axis sweeps through random blocks against the nearest block ahead of the box worked out from every block,
+    //and whole moves, which must never end overlapping a block the box was not already in, twice for the same bits
+    bool checkCollisionRandom(const BenchOptions& options) {
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_real_distribution<float> inside(0.0f, 16.0f), any(-1.0f, 1.0f), size(0.1f, 2.5f);
+        std::vector<uint8_t> field(16 * 16 * 16);
+        std::vector<glm::ivec3> solid;
+        auto isSolid = [&field](const glm::ivec3& b) {
+            if (glm::any(glm::lessThan(b, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(b, glm::ivec3(16)))) return false;
+            return field[b.x + b.y * 16 + b.z * 256] != 0;
+        };
+        size_t sweeps = 20000, moves = 20000, sweepWrong = 0, overlapping = 0, different = 0;
+        std::vector<BoxMove> first(moves);
+        for (int pass = 0; pass < 2; pass++) {
+            rng.seed(static_cast<uint32_t>(options.seed));
+            for (size_t r = 0; r < sweeps + moves; r++) {
+                if (r % 1000 == 0) {
+                    solid.clear();
+                    for (size_t i = 0; i < field.size(); i++) {
+                        glm::ivec3 b(i % 16, (i / 16) % 16, i / 256);
+                        field[i] = rng() % 10 == 0;
+                        if (field[i]) solid.push_back(b);
+                    }
+                }
+                glm::vec3 position(inside(rng), inside(rng), inside(rng));
+                glm::vec3 half(size(rng) * 0.5f, size(rng) * 0.5f, size(rng) * 0.5f);
+                AABB box(-half, half);
+                bool startsInside = false;
+                for (const glm::ivec3& b : solid) startsInside = startsInside || boxOverlaps(position + box.min, position + box.max, b);
+
+                int axis = rng() % 3;
+                float distance = any(rng) * 20.0f, moved;
+                glm::vec3 velocity(any(rng) * 60.0f, any(rng) * 60.0f, any(rng) * 60.0f);
+                float moveTime = 1.0f / 60.0f * (1 + rng() % 4);
+                if (r < sweeps) {
+                    if (pass == 1) continue;
+                    bool stopped = sweepBoxAxis(position + box.min, position + box.max, axis, distance, isSolid, moved);
+                    //the closest face of a block ahead that the box overlaps on the other two axes
+                    float nearest = std::numeric_limits<float>::infinity();
+                    for (const glm::ivec3& b : solid) {
+                        glm::vec3 shifted = position;
+                        shifted[axis] = static_cast<float>(b[axis]) + 0.5f - (box.min[axis] + box.max[axis]) * 0.5f;//centered on it
+                        if (!boxOverlaps(shifted + box.min, shifted + box.max, b)) continue;
+                        float gap = distance > 0.0f ? b[axis] - (position[axis] + box.max[axis]) : (position[axis] + box.min[axis]) - (b[axis] + 1);
+                        if (gap >= 0.0f) nearest = std::min(nearest, gap);
+                    }
+                    bool expectStop = nearest < std::abs(distance);
+                    //a box ending right at a face, either answer is fine
+                    if (std::abs(nearest - std::abs(distance)) < 1e-3f) continue;
+                    bool right = stopped == expectStop;
+                    if (right && stopped) right = std::abs(moved - (distance > 0.0f ? 1.0f : -1.0f) * (nearest - COLLISION_SKIN)) < 1e-4f;
+                    if (right && !stopped) right = moved == distance;
+                    sweepWrong += !right;
+                    continue;
+                }
+                BoxMove move = moveBox(position, box, velocity, moveTime, isSolid);
+                size_t index = r - sweeps;
+                if (pass == 0) {
+                    first[index] = move;
+                    if (startsInside) continue;
+                    for (const glm::ivec3& b : solid) overlapping += boxOverlaps(move.position + box.min, move.position + box.max, b);
+                }
+                else {
+                    different += std::memcmp(&first[index].position, &move.position, sizeof(glm::vec3)) != 0
+                        || std::memcmp(&first[index].velocity, &move.velocity, sizeof(glm::vec3)) != 0 || first[index].grounded != move.grounded;
+                }
+            }
+        }
+        std::cout << "collision random: " << sweeps << " sweeps, " << sweepWrong << " wrong, " << moves << " moves, " << overlapping
+            << " ended inside a block, " << different << " different the second time" << std::endl;
+        return sweepWrong == 0 && overlapping == 0 && different == 0;
+    }
+
+    int runCollision(const BenchOptions& options) {
+        const float deltaTime = 1.0f / 60.0f;
+        const int maxLoadFrames = 100000;
+        std::cout << "collision seed " << options.seed << ", render distance " << options.radius << ", " << options.ops << " moves, "
+            << options.frames << " frames" << std::endl;
+        bool ok = checkCollisionCases();
+        ok = checkCollisionRandom(options) && ok;
+
+        World world(options.radius);
+        world.init(options.seed);
+        Player player(&world);
+        player.spawn(glm::vec3(10, 200, 10));
+        StreamStats loadStats;
+        PlayerInput idle;
+        while ((world.isLoading() || world.hasPendingWork()) && static_cast<int>(loadStats.frameMs.size()) < maxLoadFrames) {
+            streamFrame(world, player, idle, deltaTime, loadStats);
+        }
+
+        //falling 100 blocks a frame from 90 above the ground
+        AABB box(glm::vec3(-0.3f, 0.0f, -0.3f), glm::vec3(0.3f, 1.8f, 0.3f));
+        int ground = surfaceHeight(world, 10, 10) + 1;
+        glm::vec3 drop(10.5f, ground + 90.0f, 10.5f), fall(0.0f, -6000.0f, 0.0f);
+        BoxMove landed = world.moveBox(drop, box, fall, deltaTime);
+        BoxMove oldLanded = oldMoveBox(world, drop, box, fall, deltaTime);
+        bool landedRight = landed.grounded && std::abs(landed.position.y - (ground + COLLISION_SKIN)) < 1e-3f;
+        std::cout << std::fixed << std::setprecision(3) << "drop onto the ground at " << ground << ": swept lands at " << landed.position.y
+            << ", old scan at " << oldLanded.position.y << std::endl;
+        ok = landedRight && ok;
+
+        //random moves around the spawn, walking speed to falling fast, through World::moveBox and the old scan
+        std::mt19937 rng(static_cast<uint32_t>(options.seed));
+        std::uniform_real_distribution<float> across(-40.0f, 60.0f), any(-1.0f, 1.0f), above(0.0f, 3.0f);
+        std::vector<glm::vec3> starts(options.ops), velocities(options.ops);
+        for (int i = 0; i < options.ops; i++) {
+            float x = across(rng), z = across(rng);
+            starts[i] = glm::vec3(x, surfaceHeight(world, static_cast<int>(std::floor(x)), static_cast<int>(std::floor(z))) + 1.0f + above(rng), z);
+            velocities[i] = glm::vec3(any(rng) * 11.2f, any(rng) * 40.0f, any(rng) * 11.2f);
+        }
+        double sweptMs, oldMs;
+        size_t grounded = 0, oldGrounded = 0, sweptAllocations, oldAllocations;
+        {
+            AllocationCount counted;
+            Clock::time_point start = Clock::now();
+            for (int i = 0; i < options.ops; i++) grounded += world.moveBox(starts[i], box, velocities[i], deltaTime).grounded;
+            sweptMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            sweptAllocations = counted.count;
+        }
+        {
+            AllocationCount counted;
+            Clock::time_point start = Clock::now();
+            for (int i = 0; i < options.ops; i++) oldGrounded += oldMoveBox(world, starts[i], box, velocities[i], deltaTime).grounded;
+            oldMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            oldAllocations = counted.count;
+        }
+        std::cout << std::setprecision(0) << "moves: swept " << options.ops / std::max(sweptMs, 1e-6) * 1000.0 << "/s (" << grounded << " grounded, "
+            << sweptAllocations << " allocations), old scan " << options.ops / std::max(oldMs, 1e-6) * 1000.0 << "/s (" << oldGrounded << " grounded, "
+            << oldAllocations << " allocations)" << std::endl;
+        ok = sweptAllocations == 0 && ok;
+
+        //two players given the same input from the same spot have to stay bit for bit together, and never allocate
+        Player a(&world), b(&world);
+        a.spawn(glm::vec3(10.5f, ground + 0.5f, 10.5f));
+        b.spawn(glm::vec3(10.5f, ground + 0.5f, 10.5f));
+        size_t apart = 0, walkAllocations;
+        {
+            AllocationCount counted;
+            for (int frame = 0; frame < options.frames; frame++) {
+                PlayerInput input;
+                input.forward = (frame / 90) % 4 != 3;
+                input.left = (frame / 45) % 3 == 1;
+                input.sprint = frame % 240 < 120;
+                input.jump = frame % 30 == 0;
+                input.lookX = frame % 200 < 20 ? 4.0f : 0.0f;
+                a.update(deltaTime, input);
+                b.update(deltaTime, input);
+                glm::vec3 pa = a.getCameraPos(), pb = b.getCameraPos();
+                apart += std::memcmp(&pa, &pb, sizeof(glm::vec3)) != 0;
+            }
+            walkAllocations = counted.count;
+        }
+        glm::vec3 end = a.getCameraPos();
+        std::cout << std::setprecision(2) << "walk: " << options.frames << " frames to " << end.x << "," << end.y << "," << end.z << ", "
+            << apart << " frames apart, " << walkAllocations << " allocations" << std::endl;
+        ok = apart == 0 && walkAllocations == 0 && ok;
+        return ok ? 0 : 1;
+    }
+
+    void printUsage() {
+        std::cerr << "usage: HeadlessBench worldgen [--seed N] [--radius R] [--threads T] [--mesh]" << std::endl;
+        std::cerr << "       HeadlessBench stream [--seed N] [--radius R] [--frames F]" << std::endl;
+        std::cerr << "       HeadlessBench frame [--seed N] [--radius R] [--frames F] [--max-draws N] [--max-upload-bytes N] [--max-state-changes N]" << std::endl;
+        std::cerr << "       HeadlessBench alloc [--seed N] [--ops N]" << std::endl;
+        std::cerr << "       HeadlessBench cull [--seed N] [--radius R] [--frames F]" << std::endl;
+        std::cerr << "       HeadlessBench sections [--seed N] [--radius R] [--frames F]" << std::endl;
+        std::cerr << "       HeadlessBench occlusion [--seed N] [--radius R] [--frames F]" << std::endl;
+        std::cerr << "       HeadlessBench shadows [--seed N] [--radius R] [--frames F]" << std::endl;
+        std::cerr << "       HeadlessBench entities [--frames F]" << std::endl;
+        std::cerr << "       HeadlessBench ecs [--seed N] [--entities N] [--frames F] [--threads T]" << std::endl;
+        std::cerr << "       HeadlessBench lod [--entities N] [--frames F] [--threads T]" << std::endl;
+        std::cerr << "       HeadlessBench grid [--seed N] [--entities N] [--frames F] [--ops N]" << std::endl;
+        std::cerr << "       HeadlessBench raycast [--seed N] [--radius R] [--ops N] [--threads T]" << std::endl;
+        std::cerr << "       HeadlessBench heights [--seed N] [--radius R] [--ops N]" << std::endl;
+        std::cerr << "       HeadlessBench collision [--seed N] [--radius R] [--ops N] [--frames F]" << std::endl;
+    }
+
+    bool parseOptions(int argc, char** argv, BenchOptions& options) {
+        for (int i = 2; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            try {
+                if (arg == "--seed" && hasValue) options.seed = std::stoi(argv[++i]);
+                else if (arg == "--radius" && hasValue) {
+                    options.radius = std::stoi(argv[++i]);
+                    options.radiusSet = true;
+                }
+                else if (arg == "--threads" && hasValue) options.threads = std::stoi(argv[++i]);
+                else if (arg == "--frames" && hasValue) options.frames = std::stoi(argv[++i]);
+                else if (arg == "--max-draws" && hasValue) options.maxDraws = std::stoul(argv[++i]);
+                else if (arg == "--max-upload-bytes" && hasValue) options.maxUploadBytes = std::stoul(argv[++i]);
+                else if (arg == "--max-state-changes" && hasValue) options.maxStateChanges = std::stoul(argv[++i]);
+                else if (arg == "--ops" && hasValue) options.ops = std::stoi(argv[++i]);
+                else if (arg == "--entities" && hasValue) options.entities = std::stoi(argv[++i]);
+                else if (arg == "--mesh") options.mesh = true;
+                else {
+                    std::cerr << "unknown or incomplete option: " << arg << std::endl;
+                    return false;
+                }
+            }
+            catch (const std::exception&) {
+                std::cerr << "bad value for " << arg << ": " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        if (options.radius < 0 || options.threads < 1 || options.ops < 0 || options.entities < 0) {
+            std::cerr << "radius, ops and entities must be >= 0 and threads >= 1" << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    std::string mode = argv[1];
+    if (mode == "worldgen") return runWorldgen(options);
+    if (mode == "stream") return runStream(options);
+    if (mode == "frame") return runFrame(options);
+    if (mode == "alloc") return runAlloc(options);
+    if (mode == "cull") return runCull(options);
+    if (mode == "sections") return runSections(options);
+    if (mode == "occlusion") return runOcclusion(options);
+    if (mode == "shadows") return runShadows(options);
+    if (mode == "entities") return runEntities(options);
+    if (mode == "ecs") return runEcs(options);
+    if (mode == "lod") return runLod(options);
+    if (mode == "grid") return runGrid(options);
+    if (mode == "raycast") return runRaycast(options);
+    if (mode == "heights") return runHeights(options);
+    if (mode == "collision") return runCollision(options);
+
+    printUsage();
+    return 1;
+}
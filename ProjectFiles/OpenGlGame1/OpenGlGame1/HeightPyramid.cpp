@@ -0,0 +1,255 @@
+#include "HeightPyramid.h"
+#include "Chunk.h"
+#include "Vec3Hash.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static_assert(HeightPyramid::CHUNK_SIZE == Chunk::chunkSize, "the chunk record's levels assume 16x16 chunk columns");
+static_assert(HeightPyramid::CHUNK_SIZE == 1 << (HeightPyramid::CHUNK_LEVELS - 1), "the chunk record has to end in one cell");
+
+//world blocks to cells of a level, shifting floors negative coordinates too
+static int cellOf(int coordinate, int level) {
+    return coordinate >> level;
+}
+
+static int indexOf(int level, int cellX, int cellZ) {
+    return cellZ * (HeightPyramid::CHUNK_SIZE >> level) + cellX;
+}
+
+const HeightPyramid::ChunkLevels* HeightPyramid::findChunk(int chunkX, int chunkZ) const {
+    auto it = chunks.find(getChunkKey(chunkX, chunkZ));
+    return it != chunks.end() ? &it->second : nullptr;
+}
+
+HeightPyramid::Range HeightPyramid::childRange(int level, int cellX, int cellZ, bool& found) const {
+    if (level == CHUNK_LEVELS - 1) {
+        const ChunkLevels* levels = findChunk(cellX, cellZ);
+        found = levels != nullptr;
+        if (!found) return Range{ 0, 0 };
+        return Range{ levels->low[LEVEL_OFFSET[level]], levels->high[LEVEL_OFFSET[level]] };
+    }
+    const std::unordered_map<uint64_t, Range>& cells = upper[level - CHUNK_LEVELS];
+    auto it = cells.find(getChunkKey(cellX, cellZ));
+    found = it != cells.end();
+    return found ? it->second : Range{ 0, 0 };
+}
+
+//from the 4 cells under it, which are always all there inside a chunk
+bool HeightPyramid::mergeCell(ChunkLevels& levels, int level, int cellX, int cellZ) {
+    int16_t low = INT16_MAX, high = INT16_MIN;
+    for (int child = 0; child < 4; child++) {
+        int index = LEVEL_OFFSET[level - 1] + indexOf(level - 1, cellX * 2 + (child & 1), cellZ * 2 + (child >> 1));
+        low = std::min(low, levels.low[index]);
+        high = std::max(high, levels.high[index]);
+    }
+    int index = LEVEL_OFFSET[level] + indexOf(level, cellX, cellZ);
+    bool changed = levels.low[index] != low || levels.high[index] != high;
+    levels.low[index] = low;
+    levels.high[index] = high;
+    return changed;
+}
+
+//the chunk's own cell changed, redo the cells above it until one comes out the same. Cells only have the loaded
+//children in them
+void HeightPyramid::propagateUp(int chunkX, int chunkZ) {
+    for (int level = CHUNK_LEVELS; level <= TOP_LEVEL; level++) {
+        int cellX = cellOf(chunkX, level - CHUNK_LEVELS + 1);
+        int cellZ = cellOf(chunkZ, level - CHUNK_LEVELS + 1);
+        Range merged{ INT16_MAX, INT16_MIN };
+        for (int child = 0; child < 4; child++) {
+            bool found;
+            Range range = childRange(level - 1, cellX * 2 + (child & 1), cellZ * 2 + (child >> 1), found);
+            if (!found) continue;
+            merged.low = std::min(merged.low, range.low);
+            merged.high = std::max(merged.high, range.high);
+        }
+        auto inserted = upper[level - CHUNK_LEVELS].emplace(getChunkKey(cellX, cellZ), merged);
+        Range& stored = inserted.first->second;
+        if (!inserted.second && stored.low == merged.low && stored.high == merged.high) return;
+        stored = merged;
+    }
+}
+
+void HeightPyramid::setChunk(int chunkX, int chunkZ, const int16_t* tops, int originY) {
+    ChunkLevels& levels = chunks[getChunkKey(chunkX, chunkZ)];
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) {
+        levels.low[i] = levels.high[i] = static_cast<int16_t>(originY + tops[i]);
+        globalHigh = std::max(globalHigh, originY + tops[i]);
+    }
+    for (int level = 1; level < CHUNK_LEVELS; level++) {
+        int cells = CHUNK_SIZE >> level;
+        for (int z = 0; z < cells; z++) {
+            for (int x = 0; x < cells; x++) mergeCell(levels, level, x, z);
+        }
+    }
+    propagateUp(chunkX, chunkZ);
+}
+
+void HeightPyramid::setColumn(int x, int z, int top) {
+    int chunkX = cellOf(x, CHUNK_LEVELS - 1), chunkZ = cellOf(z, CHUNK_LEVELS - 1);
+    auto it = chunks.find(getChunkKey(chunkX, chunkZ));
+    if (it == chunks.end()) return;
+    ChunkLevels& levels = it->second;
+    int localX = x - chunkX * CHUNK_SIZE, localZ = z - chunkZ * CHUNK_SIZE;
+    int index = indexOf(0, localX, localZ);
+    if (levels.high[index] == top) return;
+    levels.low[index] = levels.high[index] = static_cast<int16_t>(top);
+    globalHigh = std::max(globalHigh, top);
+    for (int level = 1; level < CHUNK_LEVELS; level++) {
+        if (!mergeCell(levels, level, localX >> level, localZ >> level)) return;
+    }
+    propagateUp(chunkX, chunkZ);
+}
+
+void HeightPyramid::clear() {
+    chunks.clear();
+    for (std::unordered_map<uint64_t, Range>& cells : upper) cells.clear();
+    globalHigh = MIN_Y - 1;
+}
+
+bool HeightPyramid::columnTop(int x, int z, int& top) const {
+    int chunkX = cellOf(x, CHUNK_LEVELS - 1), chunkZ = cellOf(z, CHUNK_LEVELS - 1);
+    const ChunkLevels* levels = findChunk(chunkX, chunkZ);
+    if (!levels) return false;
+    top = levels->high[indexOf(0, x - chunkX * CHUNK_SIZE, z - chunkZ * CHUNK_SIZE)];
+    return true;
+}
+
+bool HeightPyramid::regionRange(int minX, int minZ, int maxX, int maxZ, int& low, int& high) const {
+    if (minX > maxX || minZ > maxZ) return false;
+    low = INT16_MAX;
+    high = INT16_MIN;
+    bool any = false;
+    for (int cellZ = cellOf(minZ, TOP_LEVEL); cellZ <= cellOf(maxZ, TOP_LEVEL); cellZ++) {
+        for (int cellX = cellOf(minX, TOP_LEVEL); cellX <= cellOf(maxX, TOP_LEVEL); cellX++) {
+            gatherUpper(TOP_LEVEL, cellX, cellZ, minX, minZ, maxX, maxZ, low, high, any);
+        }
+    }
+    return any;
+}
+
+//a cell wholly inside the region is taken as it is, one that only overlaps it goes down to its children
+void HeightPyramid::gatherUpper(int level, int cellX, int cellZ, int minX, int minZ, int maxX, int maxZ, int& low, int& high, bool& any) const {
+    int size = 1 << level;
+    int x0 = cellX * size, z0 = cellZ * size;
+    if (x0 > maxX || z0 > maxZ || x0 + size - 1 < minX || z0 + size - 1 < minZ) return;
+    if (level == CHUNK_LEVELS - 1) {
+        const ChunkLevels* levels = findChunk(cellX, cellZ);
+        if (!levels) return;
+        any = true;
+        gatherChunk(*levels, level, 0, 0, x0, z0, minX, minZ, maxX, maxZ, low, high);
+        return;
+    }
+    bool found;
+    Range range = childRange(level, cellX, cellZ, found);
+    if (!found) return;
+    if (x0 >= minX && z0 >= minZ && x0 + size - 1 <= maxX && z0 + size - 1 <= maxZ) {
+        low = std::min(low, static_cast<int>(range.low));
+        high = std::max(high, static_cast<int>(range.high));
+        any = true;
+        return;
+    }
+    for (int child = 0; child < 4; child++) {
+        gatherUpper(level - 1, cellX * 2 + (child & 1), cellZ * 2 + (child >> 1), minX, minZ, maxX, maxZ, low, high, any);
+    }
+}
+
+void HeightPyramid::gatherChunk(const ChunkLevels& levels, int level, int cellX, int cellZ, int originX, int originZ,
+    int minX, int minZ, int maxX, int maxZ, int& low, int& high) {
+    int size = 1 << level;
+    int x0 = originX + cellX * size, z0 = originZ + cellZ * size;
+    if (x0 > maxX || z0 > maxZ || x0 + size - 1 < minX || z0 + size - 1 < minZ) return;
+    if (level == 0 || (x0 >= minX && z0 >= minZ && x0 + size - 1 <= maxX && z0 + size - 1 <= maxZ)) {
+        int index = LEVEL_OFFSET[level] + indexOf(level, cellX, cellZ);
+        low = std::min(low, static_cast<int>(levels.low[index]));
+        high = std::max(high, static_cast<int>(levels.high[index]));
+        return;
+    }
+    for (int child = 0; child < 4; child++) {
+        gatherChunk(levels, level - 1, cellX * 2 + (child & 1), cellZ * 2 + (child >> 1), originX, originZ, minX, minZ, maxX, maxZ, low, high);
+    }
+}
+
+//the max mip march: the column cell the ray is over is skipped whole when the ray stays above its highest top all the
+//way across it, otherwise it goes down a level, and after a skip it tries a level up again. A single column the ray
+//dips into is the hit, through its side if the ray was already below its top coming in, else through the top
+bool HeightPyramid::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const {
+    float length = glm::length(direction);
+    if (!(length > 0.0f) || !(maxDistance >= 0.0f)) return false;
+    glm::vec3 dir = direction / length;
+    int stepX = dir.x > 0.0f ? 1 : dir.x < 0.0f ? -1 : 0;
+    int stepZ = dir.z > 0.0f ? 1 : dir.z < 0.0f ? -1 : 0;
+    float inverseX = 1.0f / dir.x, inverseZ = 1.0f / dir.z;
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    int columnX = static_cast<int>(std::floor(origin.x)), columnZ = static_cast<int>(std::floor(origin.z));
+    glm::ivec3 normal(0);
+    float distance = 0.0f;
+    int level = CHUNK_LEVELS - 1;
+    const ChunkLevels* levels = nullptr;
+    int chunkX = 0, chunkZ = 0;
+    bool looked = false;
+    while (distance <= maxDistance) {
+        float y = origin.y + dir.y * distance;
+        //the same ends as walking the blocks, under the world going down, over everything going up
+        if ((y < MIN_Y && dir.y <= 0.0f) || (y >= globalHigh + 1 && dir.y >= 0.0f)) return false;
+        int x = cellOf(columnX, CHUNK_LEVELS - 1), z = cellOf(columnZ, CHUNK_LEVELS - 1);
+        if (!looked || x != chunkX || z != chunkZ) {
+            levels = findChunk(x, z);
+            chunkX = x;
+            chunkZ = z;
+            looked = true;
+        }
+        if (!levels) return false;
+
+        int size = 1 << level;
+        int lowX = columnX & -size, lowZ = columnZ & -size;
+        int high = levels->high[LEVEL_OFFSET[level] + indexOf(level, (lowX - chunkX * CHUNK_SIZE) >> level, (lowZ - chunkZ * CHUNK_SIZE) >> level)];
+        float exitX = stepX != 0 ? (lowX + (stepX > 0) * size - origin.x) * inverseX : infinity;
+        float exitZ = stepZ != 0 ? (lowZ + (stepZ > 0) * size - origin.z) * inverseZ : infinity;
+        float exit = std::max(distance, std::min(exitX, exitZ));
+        float lowest = dir.y < 0.0f ? (exit == infinity ? -infinity : origin.y + dir.y * exit) : y;
+
+        //touching the top of a cell on the way down goes in like walking the blocks does, a y step before the
+        //others. An empty column is air all the way down, the world's bottom ends the ray
+        bool over = dir.y < 0.0f ? lowest > high + 1 : lowest >= high + 1;
+        if (!over && high >= MIN_Y) {
+            if (level > 0) {
+                level--;
+                continue;
+            }
+            if (y < high + 1) {
+                hit.block = glm::ivec3(columnX, static_cast<int>(std::floor(y)), columnZ);
+                hit.normal = normal;
+                hit.distance = distance;
+                return true;
+            }
+            distance = (high + 1 - origin.y) / dir.y;
+            if (distance > maxDistance) return false;
+            hit.block = glm::ivec3(columnX, high, columnZ);
+            hit.normal = glm::ivec3(0, 1, 0);
+            hit.distance = distance;
+            return true;
+        }
+
+        if (exit == infinity) return false;
+        distance = exit;
+        normal = glm::ivec3(0);
+        //into the cell past the nearer exit, the other axis is wherever the ray is along it, kept inside this cell
+        if (exitX < exitZ) {
+            columnX = stepX > 0 ? lowX + size : lowX - 1;
+            int at = static_cast<int>(std::floor(origin.z + dir.z * distance));
+            columnZ = std::min(std::max(at, lowZ), lowZ + size - 1);
+            normal.x = -stepX;
+        }
+        else {
+            columnZ = stepZ > 0 ? lowZ + size : lowZ - 1;
+            int at = static_cast<int>(std::floor(origin.x + dir.x * distance));
+            columnX = std::min(std::max(at, lowX), lowX + size - 1);
+            normal.z = -stepZ;
+        }
+        level = std::min(level + 1, CHUNK_LEVELS - 1);
+    }
+    return false;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "VoxelRaycast.h"
+
+//the top block of every loaded column and a min/max mip pyramid over them: a level L cell is 2^L x 2^L columns
+//and knows the lowest and highest top inside it. Levels 0 to 4 live in one record per chunk, the levels above
+//that are a map per level keyed like World::chunks, so a region or a ray looks at a handful of cells instead of
+//every column. Setting a column walks up its cells and stops at the first one that did not change.
+//Unloaded columns are in no cell and never count. Heights are world y. No gl in here
+class HeightPyramid
+{
+public:
+	//a whole chunk column, tops[z * CHUNK_SIZE + x] relative to originY, -1 for a column with no blocks
+	void setChunk(int chunkX, int chunkZ, const int16_t* tops, int originY);
+	void setColumn(int x, int z, int top);//the chunk has to have been set, ignored if not
+	void clear();
+
+	bool columnTop(int x, int z, int& top) const;//false when the column is not loaded
+	//lowest and highest top over the loaded columns in [minX, maxX] x [minZ, maxZ], false when none are loaded
+	bool regionRange(int minX, int minZ, int maxX, int maxZ, int& low, int& high) const;
+	int highest() const { return globalHigh; }//over everything loaded, only ever goes up, MIN_Y - 1 for nothing
+	size_t chunkCount() const { return chunks.size(); }
+
+	//the terrain as a heightfield, everything at or below a column's top is solid, so caves and overhangs are
+	//filled in. For long sight lines and finding the ground far away: it crosses whole cells of up to a chunk
+	//column the ray stays above instead of visiting blocks. Hits the same block as raycastVoxels over that
+	//heightfield. Unloaded columns and leaving the world end the ray as a miss
+	bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const;
+
+	static constexpr int CHUNK_SIZE = 16;//Chunk::chunkSize
+	static constexpr int CHUNK_LEVELS = 5;//levels kept in the chunk record, 16 >> 4 = one cell
+	static constexpr int TOP_LEVEL = 12;//4096 blocks a cell, regions wider than that just visit more of them
+	static constexpr int MIN_Y = -64;//bottom of the world, Chunk::baseTerrainHeight below 0
+
+private:
+	//offsets of each level's cells in the chunk record, 16x16 then 8x8 ... 1x1
+	static constexpr int LEVEL_OFFSET[CHUNK_LEVELS + 1] = { 0, 256, 320, 336, 340, 341 };
+
+	struct ChunkLevels {
+		int16_t low[LEVEL_OFFSET[CHUNK_LEVELS]];
+		int16_t high[LEVEL_OFFSET[CHUNK_LEVELS]];
+	};
+	struct Range {
+		int16_t low, high;
+	};
+
+	std::unordered_map<uint64_t, ChunkLevels> chunks;
+	std::unordered_map<uint64_t, Range> upper[TOP_LEVEL - CHUNK_LEVELS + 1];//levels CHUNK_LEVELS to TOP_LEVEL
+	int globalHigh = MIN_Y - 1;
+
+	const ChunkLevels* findChunk(int chunkX, int chunkZ) const;
+	Range childRange(int level, int cellX, int cellZ, bool& found) const;//a cell of the chunk's own level or above
+	static bool mergeCell(ChunkLevels& levels, int level, int cellX, int cellZ);//true if it changed
+	void propagateUp(int chunkX, int chunkZ);
+	void gatherUpper(int level, int cellX, int cellZ, int minX, int minZ, int maxX, int maxZ, int& low, int& high, bool& any) const;
+	static void gatherChunk(const ChunkLevels& levels, int level, int cellX, int cellZ, int originX, int originZ,
+		int minX, int minZ, int maxX, int maxZ, int& low, int& high);
+};
@@ -0,0 +1,12 @@
+#include "InstanceBatcher.h"
+
+void InstanceBatcher::clear() {
+    for (std::vector<glm::mat4>& group : groups) group.clear();
+    total = 0;
+}
+
+void InstanceBatcher::add(uint32_t model, const glm::mat4& transform) {
+    if (model >= groups.size()) groups.resize(model + 1);
+    groups[model].push_back(transform);
+    total++;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//entity transforms grouped by model, each group goes into its model's instance buffer and out as one instanced draw.
+//Built on the cpu every frame with no gl so headless runs can check and time it. Keeps its storage between
+//frames, so once the entity count settles adding to it never allocates
+class InstanceBatcher
+{
+public:
+	void clear();//empties every group, keeps the memory
+	void add(uint32_t model, const glm::mat4& transform);
+
+	size_t modelCount() const { return groups.size(); }//highest model added + 1, some may be empty
+	const std::vector<glm::mat4>& instances(uint32_t model) const { return groups[model]; }
+	size_t size() const { return total; }
+
+private:
+	std::vector<std::vector<glm::mat4>> groups;//per model, in the order added
+	size_t total = 0;
+};
@@ -2,50 +2,39 @@
 #include <glad/glad.h>//must go before glfw
 #include <GLFW/glfw3.h>
 #include "Main.h"
-#define STB_IMAGE_IMPLEMENTATION  // This tells stb to include the implementation
-#include "stb/stb_image.h"          // Path to the stb_image.h file
-
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/string_cast.hpp>
-#include <random>
 #include <memory>
-#include <unordered_set>
 
-#define CHUNK_SIZE 16
 #define RENDER_DISTANCE 12
-#define SUN_TILT glm::radians(70.0f)
-#define SUN_SPEED 0.1f
-
-FastNoiseLite Main::noiseGen;
-std::unordered_map<glm::ivec2, float, IVec2Hash> Main::noiseCache; 
 
 
-Main::Main() : window(nullptr),width(1280),height(720),player(nullptr)
-                , isInitialLoading(true), currentLoadingRadius(0), maxLoadingRadius(RENDER_DISTANCE) {
+Main::Main() : window(nullptr),width(1280),height(720),player(nullptr), world(RENDER_DISTANCE) {
 
     init();
-    player = std::make_unique<Player>(window,this);  // Use smart pointer for automatic cleanup;//give window to player 
+    player = std::make_unique<Player>(&world);  // Use smart pointer for automatic cleanup
+
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // Register a lambda for the mouse callback
+    glfwSetCursorPosCallback(window, [](GLFWwindow* window, double xpos, double ypos) {
+        Main* mainInstance = static_cast<Main*>(glfwGetWindowUserPointer(window));
+        if (mainInstance) {
+            mainInstance->processMouseMovement(xpos, ypos);
+        }
+     });
 }
 
 Main::~Main() {
     player.reset();
+    renderer.reset();//frees the chunk buffers, needs the context so goes before the window
+    stateCache.reset();
+    device.reset();
     glfwDestroyWindow(window);
     glfwTerminate();
-    delete depthShader;
-}
-
-std::string Main::loadShader(const char* filepath) {
-    std::ifstream file(filepath);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-    //update viewport
-    glViewport(0, 0, width, height);
-
+    //the renderer sets the viewport from these every frame, setting it here would go behind the state cache
     // Update the width and height in the Main class
     Main* mainInstance = static_cast<Main*>(glfwGetWindowUserPointer(window));
     if (mainInstance) {
@@ -66,6 +55,9 @@ void Main::init() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3); 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3); 
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); 
+#if defined(GL_DEBUG_LAYER)
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);//drivers only promise KHR_debug output on debug contexts
+#endif
 
 
     // Create a window
@@ -85,193 +77,17 @@ void Main::init() {
         std::cerr << "Failed to initialize GLAD!" << std::endl;
         exit(-1);
     }
+    GLDebug::init((GLADloadproc)glfwGetProcAddress);
 
     // Set framebuffer size callback  
+    glfwSetWindowUserPointer(window, this);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    createShadowMap();
-
-    //some opengl settings
-    glEnable(GL_CULL_FACE);   // Enable face culling 
-    glCullFace(GL_BACK);      // Cull back faces (only render front faces) 
-    glFrontFace(GL_CCW);      // Define front faces as counterclockwise (CCW) 
-    glEnable(GL_DEPTH_TEST); 
     glfwSwapInterval(1);// 1 = V-Sync on, 0 = V-Sync off 
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);//wireframe mode 
 
-    
-}
-
-void Main::initNoise() {
-
-    if (seed == -1) {
-        std::random_device rd;
-        seed = rd();
-        std::cout << seed;
-    }
-
-    //create noise for world gen
-    noiseGen.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-    noiseGen.SetFrequency(0.03f); // Lower frequency for smoother terrain
-    noiseGen.SetSeed(seed);
-
-    int range = CHUNK_SIZE * RENDER_DISTANCE;
-
-    for (int x = -range; x < range; x++) {
-        for (int z = -range; z < range; z++) {
-
-            noiseCache[{x, z}] = getNoise(static_cast<float>(x), static_cast<float>(z));  // Fixed value 
-        }
-    }
-}
-
-float Main::getNoise(float x, float z) {
-    glm::ivec2 noiseKey(x, z);
-
-    if (noiseCache.find(noiseKey) != noiseCache.end()) {
-        return noiseCache[noiseKey];
-    }
-    else {
-        float biomeValue = getBiomeNoise(x, z); // Low-frequency noise for biome selection
-        float height = remapHeight(getWarpedHeight(x, z,biomeValue), biomeValue);
-        noiseCache[noiseKey] = height;
-        return height;
-    }
-}
-
-// New function: Low-frequency noise to determine biome type
-inline float Main::getBiomeNoise(float x, float z) {
-    float biomeScale = 0.002f; // Very low frequency for large biome areas
-    float biomeNoise = Main::noiseGen.GetNoise(x * biomeScale, z * biomeScale);
-    //return 1;
-    return (biomeNoise + 1.0f) / 2.0f; // Normalize to 0-1
-    
-}
-
-//takes 0 to 1 noise value and assigns height in y
-inline float Main::remapHeight(float noiseValue, float biomeValue) {
-    float minHeight = 32.0f;  // Base height
-    float maxHeight = 150.0f; // Max height (can increase for taller mountains)
-
-    // Define height functions for each biome
-    auto plainsHeight = [](float nv) {
-        float flatness = 0.8f; // Keep plains flattish
-        return flatness * nv;
-        };
-
-    auto hillsHeight = [](float nv) {
-        float flatness = 0.5f;
-        float steepness = 2.0f;
-        return flatness + (1.0f - flatness) * pow((nv - flatness) / (1.0f - flatness), steepness);
-        };
-
-    auto mountainsHeight = [](float nv) {
-        float flatness = 0.3f; // Less flat area for mountains
-        float steepness = 3.0f; // Steeper slopes
-        return flatness + (1.0f - flatness) * pow((nv - flatness) / (1.0f - flatness), steepness);
-        };
-
-    // Interpolate between biomes based on biomeValue
-    float height;
-    if (biomeValue < 0.3f) {
-        height = plainsHeight(noiseValue); // Pure plains
-    }
-    else if (biomeValue < 0.6f) {
-        // Blend plains and hills
-        float t = (biomeValue - 0.3f) / 0.4f; // Transition factor (0 to 1)
-        height = (1.0f - t) * plainsHeight(noiseValue) + t * hillsHeight(noiseValue);
-    }
-    else {
-        // Blend hills and mountains
-        float t = (biomeValue - 0.7f) / 0.3f; // Transition factor (0 to 1)
-        height = (1.0f - t) * hillsHeight(noiseValue) + t * mountainsHeight(noiseValue);
-    }
-
-    // Scale height based on biome
-    float scale;
-    if (biomeValue < 0.3f) {
-        scale = 0.2f; // Low height for plains
-    }
-    else if (biomeValue < 0.6f) {
-        scale = 0.8f; // Moderate height for hills
-    }
-    else {
-        scale = 2.0f; // Full height for mountains
-    }
-
-    return minHeight + height * (maxHeight * scale);
-}
-
-// Updated getWarpedHeight for more variation
-inline float Main::getWarpedHeight(float x, float z, float biomeValue) {
-    float warpScale = 0.2f;
-    float warpX = Main::noiseGen.GetNoise(x * warpScale + 10.0f, z * warpScale + 10.0f) * 15.0f; // Increased warp
-    float warpZ = Main::noiseGen.GetNoise(x * warpScale + 20.0f, z * warpScale + 20.0f) * 15.0f;
-    float warpedX = x + warpX;
-    float warpedZ = z + warpZ;
-
-    float height = 0.0f;
-    float amplitude = 0.9f; // Increased base amplitude for more variation
-    float frequency = (biomeValue > 0.7f) ? 0.08f : 0.3f; // Lower frequency for mountains
-    float lacunarity = 2.0f;
-    float persistence = (biomeValue >= 0.7f) ? 0.7f : 0.6f; // Higher persistence for more detail 
-    int octaves = (biomeValue > 0.7f) ? 5 : 4; //jaggedness
-    float totalAmplitude = 0.0f;
-
-    for (int i = 0; i < octaves; i++) {
-        float sample = Main::noiseGen.GetNoise(warpedX * frequency, warpedZ * frequency);
-        height += sample * amplitude;
-        totalAmplitude += amplitude;
-        amplitude *= persistence;
-        frequency *= lacunarity;
-    }
-
-    // Normalize to 0-1
-    height = (height + totalAmplitude) / (2.0f * totalAmplitude);
-
-    // Amplify peaks in mountain regions
-    if (biomeValue >= 0.7f) {
-        height = pow(height, 0.6f); // Exaggerates peaks; adjust exponent as needed
-    }
-
-    return height;
-}
-
-void Main::createShadowMap() {
-    // Generate and configure depth texture
-    glGenTextures(1, &depthMap); 
-    glBindTexture(GL_TEXTURE_2D, depthMap); 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER); 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor); 
-
-    // Generate and configure framebuffer
-    glGenFramebuffers(1, &depthMapFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
-    glDrawBuffer(GL_NONE); // No color buffer for shadow map
-    glReadBuffer(GL_NONE);
-    
-
-
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (status != GL_FRAMEBUFFER_COMPLETE) {
-        std::cerr << "Shadow map framebuffer incomplete: " << status << std::endl;
-        switch (status) {
-        case GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT:
-            std::cerr << "Incomplete attachment" << std::endl; break;
-        case GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT:
-            std::cerr << "Missing attachment" << std::endl; break;
-        default:
-            std::cerr << "Other error" << std::endl; break;
-        }
-        exit(-1); // Or handle gracefully
-    }
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); 
+    device = std::make_unique<GLRenderDevice>();
+    stateCache = std::make_unique<CachingRenderDevice>(*device);
+    renderer = std::make_unique<Renderer>(*stateCache, world);
 }
 
 void Main::processInput(GLFWwindow* window)
@@ -279,6 +95,20 @@ void Main::processInput(GLFWwindow* window)
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)//check for esc pressed
         glfwSetWindowShouldClose(window, true);
 
+    //movement, look offsets are accumulated by the cursor callback
+    playerInput.forward = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+    playerInput.back = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    playerInput.right = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+    playerInput.left = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    playerInput.jump = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    playerInput.sprint = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS;
+
+    //f3 toggles gl call counts in the title, only there when the build counts them
+    static bool f3WasDown = false;
+    bool f3Down = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+    if (f3Down && !f3WasDown) showGLCalls = !showGLCalls;
+    f3WasDown = f3Down;
+
     //buiilding
     if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
         static double lastBreakTime = 0.0;
@@ -298,586 +128,37 @@ void Main::processInput(GLFWwindow* window)
     }
 }
 
-void Main::createShaders() {
-    shader = new Shader("vertex_shader.glsl", "fragment_shader.glsl");
-    sunShader = new Shader("sunVertex.glsl","sunFragment.glsl");
-    depthShader = new Shader("depth_vertex.glsl", "depth_fragment.glsl");
-    entityShader = new Shader("entity_vertex.glsl", "entity_fragment.glsl");
-
-    if (entityShader->ID == 0) {
-        std::cerr << "Entity shader failed to compile/link" << std::endl;
-        exit(-1);
-    }
-    
-
-    if (sunShader->ID == 0) {
-        std::cerr << "Sun shader failed to compile/link" << std::endl;
-    }
-    std::cout << "Sun shader ID: " << sunShader->ID << std::endl; // Verify ID 
-
-    //chunk shader
-    shader->use();  
-    modelLocation = glGetUniformLocation(shader->ID, "model");
-    viewLocation = glGetUniformLocation(shader->ID, "view");
-    projectionLocation = glGetUniformLocation(shader->ID, "projection");
-    textureLocation = glGetUniformLocation(shader->ID, "ourTexture");
-    lightColourLoc = glGetUniformLocation(shader->ID, "lightColour");
-    lightPosLoc = glGetUniformLocation(shader->ID, "lightPos"); // New
-    sunDirLoc = glGetUniformLocation(shader->ID, "sunDirection");
-    camPosLoc = glGetUniformLocation(shader->ID, "cameraPos");
-
-    //sun shader
-    sunShader->use();
-
-    GLint currentProgram;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    if (currentProgram != sunShader->ID) {
-        std::cerr << "Sun shader not active after use(). Expected: " << sunShader->ID << ", Got: " << currentProgram << std::endl;
-    }
-
-    sunViewLoc = glGetUniformLocation(sunShader->ID, "view");
-    sunProjLoc = glGetUniformLocation(sunShader->ID, "projection");
-    sunSunDirLoc = glGetUniformLocation(sunShader->ID, "sunDirection");
-    sunColourLoc = glGetUniformLocation(sunShader->ID, "sunColour");
-    sunCamPosLoc = glGetUniformLocation(sunShader->ID, "camPos");
-
-    
-    //entity shader
-    entityShader->use();
-    entityModelLoc = glGetUniformLocation(entityShader->ID, "model");
-    entityViewLoc = glGetUniformLocation(entityShader->ID, "view");
-    entityProjLoc = glGetUniformLocation(entityShader->ID, "projection");
-
-    GLint textureLoc = glGetUniformLocation(entityShader->ID, "texture0");
-    if (textureLoc == -1) {
-        std::cerr << "Texture uniform 'texture0' not found in entity shader" << std::endl;
-    } 
-    if (entityModelLoc == -1 || entityViewLoc == -1 || entityProjLoc == -1) {
-        std::cerr << "Missing model/view/projection uniforms in entity shader" << std::endl;
-    }
-
-    //shadow shader
-    depthShader->use();
-    lightSpaceLoc = glGetUniformLocation(depthShader->ID, "lightSpaceMatrix");
-    shadowMapLoc = glGetUniformLocation(depthShader->ID, "shadowMap");
-
-    if (lightSpaceLoc == -1) {
-        std::cerr << "Uniform 'lightSpaceMatrix' not found in depth shader" << std::endl;
-    }
-
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    if (currentProgram != depthShader->ID) {
-        std::cerr << "depth shader not active after use(). Expected: " << depthShader->ID << ", Got: " << currentProgram << std::endl;
-    }
-
-}
-
-void Main::createHighlight() {
-    float vertices[] = {
-        -0.51f, -0.51f, -0.51f,  0.51f, -0.51f, -0.51f,
-         0.51f,  0.51f, -0.51f, -0.51f,  0.51f, -0.51f,
-        -0.51f, -0.51f,  0.51f,  0.51f, -0.51f,  0.51f,
-         0.51f,  0.51f,  0.51f, -0.51f,  0.51f,  0.51f
-    };
-    unsigned int indices[] = {
-        0, 1, 1, 2, 2, 3, 3, 0, // Bottom face
-        4, 5, 5, 6, 6, 7, 7, 4, // Top face
-        0, 4, 1, 5, 2, 6, 3, 7  // Sides
-    };
-
-    glGenVertexArrays(1, &highlightVAO);
-    glGenBuffers(1, &highlightVBO);
-    GLuint EBO;
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(highlightVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, highlightVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glBindVertexArray(0);
-}
-
-void Main::createSun() {
-    // Vertex data for sun quad
-    float sunVertices[] = {
-        -0.5f,  0.5f,  0.0f, 1.0f, // Top-left
-         0.5f,  0.5f,  1.0f, 1.0f, // Top-right
-         0.5f, -0.5f,  1.0f, 0.0f, // Bottom-right
-        -0.5f, -0.5f,  0.0f, 0.0f  // Bottom-left
-    };
-    unsigned int sunIndices[] = { 0, 3, 2, 2, 1, 0 };//reversed winding order
-
-    glGenVertexArrays(1, &sunVAO);
-    glGenBuffers(1, &sunVBO);
-    glGenBuffers(1, &sunEBO);
-
-    glBindVertexArray(sunVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, sunVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(sunVertices), sunVertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sunEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(sunIndices), sunIndices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
-}
-
-void Main::renderShadowMap() {
-    // Render depth map
-    while (glGetError() != GL_NO_ERROR) {}
-
-    glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-    GLenum err = glGetError(); 
-    if (err != GL_NO_ERROR) std::cerr << "Error after glViewport: " << err << std::endl;
-
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    err = glGetError();
-    if (err != GL_NO_ERROR) std::cerr << "Error after glBindFramebuffer: " << err << std::endl;
-
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (status != GL_FRAMEBUFFER_COMPLETE) {
-        std::cerr << "Framebuffer error: " << status << std::endl; 
-        return;
-    }
-
-    glDepthMask(GL_TRUE); // Ensure depth writes are enabled
-    glClear(GL_DEPTH_BUFFER_BIT);
-    err = glGetError();
-    if (err != GL_NO_ERROR) std::cerr << "Error after glClear: " << err << std::endl;
-    depthShader->use();
-
-    GLint currentProgram;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    if (currentProgram != depthShader->ID) {
-        std::cerr << "depth shader not active after use(). Expected: " << depthShader->ID << ", Got: " << currentProgram << std::endl;
-    }
-
-    
-
-    glUniformMatrix4fv(lightSpaceLoc, 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
-     err = glGetError();
-    if (err != GL_NO_ERROR) std::cerr << "Error after unifrm light mat loc: " << err << std::endl;
-
-    //render chunks 1st pass to create shadows
-    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
-    for (const auto& pair : chunks) {
-        const Chunk& chunk = pair.second;
-        if (!chunk.isActive) continue;
-
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), chunk.chunkPosition);
-        glUniformMatrix4fv(glGetUniformLocation(depthShader->ID, "model"), 1, GL_FALSE, glm::value_ptr(model));
-         err = glGetError();
-        if (err != GL_NO_ERROR) std::cerr << "Error after model loc: " << err << std::endl;
-        glBindVertexArray(chunk.VAO);
-         err = glGetError();
-        if (err != GL_NO_ERROR) std::cerr << "Error after bind vao shadow: " << err << std::endl;
-        for (const auto& typePair : chunk.indicesByType) {
-            const auto& indices = typePair.second;
-            if (indices.empty()) continue;
-            glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT,
-                (void*)(chunk.baseIndicesByType.at(typePair.first) * sizeof(unsigned int)));
-        }
-        glBindVertexArray(0);
-    }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    //clear screen for main pass
-    glViewport(0, 0, width, height);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glBindTexture(GL_TEXTURE_2D, 0);
-}
-
-void Main::drawChunks() { 
-    shader->use();
-
-    std::lock_guard<std::recursive_mutex> lock(chunksMutex); // Separate lock for rendering
-    for (const auto& pair : chunks) {
-        
-        const Chunk& chunk = pair.second;
-        const glm::vec3& pos = chunk.chunkPosition;
-
-        // Frustum culling 
-        glm::vec3 min = pos;
-        glm::vec3 max = pos + glm::vec3(CHUNK_SIZE, chunk.currentTallestBlock+1, CHUNK_SIZE);
-        if (!frustum.isBoxInFrustum(min, max)) {
-            continue; // Skip chunks outside the frustum 
-        }
-        if (!chunk.isActive)
-            continue;
-
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
-        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
-
-        glBindVertexArray(chunk.VAO);
-        for (const auto& typePair : chunk.verticesByType) {
-            BlockType type = typePair.first;
-            const auto& indices = chunk.indicesByType.at(type);
-
-            if (indices.empty()) continue;
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, texAtlas);
-            glUniform1i(textureLocation, 0);
-
-            glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT,
-                (void*)(chunk.baseIndicesByType.at(type) * sizeof(unsigned int)));
-        }
-        glBindVertexArray(0);
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-}
-
-void Main::renderSun(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& sunDirection) {
-
-    float sunAngle = glm::dot(sunDirection, glm::vec3(0.0f, 1.0f, 0.0f));
-    float transitionFactor = (-sunAngle + 1.0f) * 0.5f;
-    glm::vec3 sunColour = glm::mix(glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(1.0f, 0.5f, 0.0f), transitionFactor);
-
-    sunShader->use();
-
-
-    glUniformMatrix4fv(sunViewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(sunProjLoc, 1, GL_FALSE, glm::value_ptr(projection));  
-    glUniform3fv(sunSunDirLoc, 1, glm::value_ptr(sunDirection));
-    glUniform3fv(sunColourLoc, 1, glm::value_ptr(sunColour));
-    glUniform3fv(sunCamPosLoc, 1, glm::value_ptr(player->getCameraPos()));
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    //glDisable(GL_DEPTH_TEST); 
-
-    glBindVertexArray(sunVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-    glBindVertexArray(0); 
-    glEnable(GL_DEPTH_TEST); 
-    glDisable(GL_BLEND);  
-    glBindTexture(GL_TEXTURE_2D, 0);
-}
-
-void Main::drawMobs(glm::mat4& view, glm::mat4& projection) {
-
-
-    entityShader->use();
-
-    glUniformMatrix4fv(entityViewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(entityProjLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-
-    glm::mat4 beeTransform = glm::mat4(1.0f);
-    beeTransform = glm::translate(beeTransform, glm::vec3(0.0f, 35.0f, 0.0f));  // Translate to (0, 35, 0)
-    beeTransform = glm::scale(beeTransform, glm::vec3(10.0f));  // Scale by a factor of 10
-    drawModel(beeModelGl, entityShader->ID, beeTransform); 
-
-    glm::mat4 boxTransform = glm::mat4(1.0f);
-    boxTransform = glm::translate(boxTransform, glm::vec3(15.0f, 35.0f, 0.0f));  // Translate to (0, 35, 0)
-    boxTransform = glm::scale(boxTransform, glm::vec3(1.0f));  // Scale by a factor of 10
-    drawModel(cubeModelGl, entityShader->ID, boxTransform);
-
-    glm::mat4 swordTrans = glm::mat4(1.0f);
-    swordTrans = glm::translate(swordTrans, glm::vec3(-15.0f, 35.0f, 0.0f));  // Translate to (0, 35, 0)
-    swordTrans = glm::scale(swordTrans, glm::vec3(4.0f));  // Scale by a factor of 10
-    drawModel(swordModelGl, entityShader->ID, swordTrans);
-    
-        
-    
-}
-
-void Main::drawModel(const ModelGL& model, GLuint shaderID, glm::mat4& modelMatrix) {
-
-    // Upload model matrix
-    GLint modelLoc = glGetUniformLocation(shaderID, "model");
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-
-    // Bind texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, model.textureID);
-    glUniform1i(glGetUniformLocation(shaderID, model.uniformName.c_str()), 0); // or use a generic uniform like "mainTex"
-
-    // Draw
-    glBindVertexArray(model.VAO); 
-    glDrawElements(GL_TRIANGLES, model.indexCount, GL_UNSIGNED_INT, 0); 
-    glBindVertexArray(0); 
-
-}
-
-void Main::render() {
-
-    // set background & clear screen
-    glClearColor(0.1f, 0.4f, 0.6f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); 
-
-    //vie and projection matrices
-    glm::mat4 view = player->getViewMatrix();
-    glm::mat4 projection = glm::perspective(glm::radians(90.0f), (float)width / (float)height, 0.1f, 1000.0f);
-     
-    //whats in current view
-    glm::mat4 viewProj = projection * view; 
-    frustum.update(viewProj); // Update frustum for culling 
-
-    // Rotate sun direction based on time
-    float time = glfwGetTime();
-    float angle = time * SUN_SPEED;
-    glm::vec3 sunDir = glm::normalize(glm::vec3(cos(angle), sin(angle) * sin(SUN_TILT), sin(angle) * cos(SUN_TILT))); // Compute sun direction using a circular motion
-    sunDirection = -sunDir; 
-
-    //shadow code, smaller area gives better shadows with same resolution
-    glm::vec3 playerPos = player->getCameraPos();  
-    glm::mat4 lightProjection = glm::ortho(-100.0f + playerPos.x, 100.0f + playerPos.x,
-        -100.0f + playerPos.z, 100.0f + playerPos.z, 
-        1.0f, 200.0f);
-
-    glm::vec3 lightPos = playerPos - normalize (sunDirection) * 50.0f; // Position sun far along its direction
-    glm::mat4 lightView = glm::lookAt(lightPos, glm::vec3(0.0f), glm::vec3(0.0, 1.0, 0.0));
-    lightSpaceMatrix = lightProjection * lightView;
-
-    renderShadowMap();
-
-    // Ensure default framebuffer and clear errors
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, width, height);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-
-    //use normal shader for cube + chunks
-    shader->use(); 
-
-    // pass view and projection matrices to shader
-    glUniformMatrix4fv(viewLocation, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniform3fv(camPosLoc, 1, glm::value_ptr(player->getCameraPos()));
-    glUniform3fv(sunDirLoc, 1, glm::value_ptr(sunDirection));
-    //glUniformMatrix4fv(lightSpaceLoc, 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
-    
-    
-
-    GLint shadowMapLoc = glGetUniformLocation(shader->ID, "shadowMap"); 
-    glUniform1i(shadowMapLoc, 1); 
-
-    GLint lightSpaceLoc = glGetUniformLocation(shader->ID, "lightSpaceMatrix");
-    glUniformMatrix4fv(lightSpaceLoc, 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix)); 
-
-    // Bind shadow map to texture unit 1 (unit 0 is for texture atlas)
-    glActiveTexture(GL_TEXTURE1); 
-    glBindTexture(GL_TEXTURE_2D, depthMap); 
-
-    // Bind texture atlas to unit 0
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texAtlas);
-    glUniform1i(textureLocation, 0); 
-
-    drawChunks();
-
-    
-
-    raycastBlock();//used to find currently faced blocl
-    // Render highlight if a block is in range
-    if (hasHighlightedBlock) {
-        shader->use();
-        glm::mat4 highlightModel = glm::mat4(1.0f);
-        // Center the highlight by adding (0.5, 0.5, 0.5) to the block position
-        highlightModel = glm::translate(highlightModel, highlightedBlockPos + glm::vec3(0.5f, 0.5f, 0.5f));
-        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(highlightModel));
-        glUniform4f(lightColourLoc, 1.0f, 1.0f, 0.0f, 1.0f); // Yellow highlight
-
-        glBindVertexArray(highlightVAO);
-        glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0); // 24 indices for wireframe
-        glBindVertexArray(0);
-    }
-
-
-    drawMobs(view,projection);
-    
-    
-
-
-    renderSun(view,projection,-sunDirection); 
-
-}
-
-void Main::generateChunkAsync(const glm::vec3& pos) {
-    // Launch async task to generate the chunk
-
-    int chunkX = static_cast<int>(pos.x / CHUNK_SIZE);
-    int chunkZ = static_cast<int>(pos.z / CHUNK_SIZE);
-    uint64_t key = getChunkKey(chunkX, chunkZ);
-
-    chunkGenerationFutures[key] = std::async(std::launch::async, [this, pos,key]() {
-        Chunk chunk(pos, seed, this);
-        std::lock_guard<std::recursive_mutex> lock(chunksMutex); 
-        chunks.emplace(key, std::move(chunk)); // Store in chunks with the uint64_t key
-        }); 
-}
-
-void Main::tryApplyChunkGeneration() {
-    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
-    
-    glfwMakeContextCurrent(window);
-    
-    GLenum err = glGetError();
-    if (err != GL_NO_ERROR) {
-        std::cerr << "Pending OpenGL error before chunk init: " << err << std::endl;
-    } 
-    for (auto it = chunkGenerationFutures.begin(); it != chunkGenerationFutures.end();) {
-        if (it->second.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
-            
-            uint64_t key = it->first; // The key is the uint64_t chunk identifier
-            auto chunkIt = chunks.find(key);
-            if (chunkIt != chunks.end()) {
-                Chunk& chunk = chunkIt->second;
-
-                // Initialize buffers for rendering
-                chunk.initializeBuffers(); 
-
-                chunkModels.emplace_back(glm::translate(glm::mat4(1.0f), chunk.chunkPosition));
-            }
-
-            // Remove the completed future
-            it = chunkGenerationFutures.erase(it); 
-            
-        }
-        else {
-            ++it;
-        }
-    }
-}
-
-void Main::updateChunks(const glm::vec3& playerPosition) {
-    // Calculate the player's chunk position in chunk coordinates
-    glm::ivec3 playerChunkPos(
-        static_cast<int>(floor(playerPosition.x / CHUNK_SIZE)), 
-        0, // Y is fixed at 0 for chunk coordinates
-        static_cast<int>(floor(playerPosition.z / CHUNK_SIZE))
-    );
-    uint64_t playerKey = getChunkKey(playerChunkPos.x, playerChunkPos.z); 
-
-    // Store chunk positions and distances
-    std::vector<std::pair<uint64_t, float>> chunkPositions;
-    int effectiveRenderDistance = isInitialLoading ? currentLoadingRadius : RENDER_DISTANCE;
-    chunkPositions.reserve((2 * effectiveRenderDistance + 1) * (2 * effectiveRenderDistance + 1)); // Preallocate 
+//handles looking
+void Main::processMouseMovement(double xpos, double ypos) {
 
-    for (int x = -effectiveRenderDistance; x <= effectiveRenderDistance; x++) {
-        for (int z = -effectiveRenderDistance; z <= effectiveRenderDistance; z++) {
-            glm::ivec3 chunkPos = playerChunkPos + glm::ivec3(x, 0, z); // Offset in chunk coordinates
-            uint64_t key = getChunkKey(chunkPos.x, chunkPos.z);  
-            glm::vec3 realChunkPos = glm::vec3(chunkPos.x * CHUNK_SIZE, -Chunk::baseTerrainHeight, chunkPos.z * CHUNK_SIZE);
-            
-            // Use Manhattan distance for faster sorting (no square root needed)
-            float distance = std::abs(realChunkPos.x - playerPosition.x) + std::abs(realChunkPos.z - playerPosition.z);
-            chunkPositions.emplace_back(key, distance);
-        }
-    }
-
-    // Sort by distance
-    std::sort(chunkPositions.begin(), chunkPositions.end(),
-        [](const std::pair<uint64_t, float>& a, const std::pair<uint64_t, float>& b) {
-            return a.second < b.second;
-        });
-
-    std::unordered_set<uint64_t> loadedChunks;
-    loadedChunks.reserve(chunkPositions.size());//reduce rehashing
-    int chunksGeneratedThisFrame = 0;
-    const int maxChunksGeneratedPerFrame = isInitialLoading ? 2 : 1; // Load 2 chunks per frame during initial loading
-    
+    if (firstMouse)//stops large 1st jump
     {
-        std::lock_guard<std::recursive_mutex> lock(chunksMutex); // Lock here
-        for (const auto& pair : chunkPositions) {
-            if (chunksGeneratedThisFrame >= maxChunksGeneratedPerFrame) break;
-
-            loadedChunks.insert(pair.first);
-            int chunkX = static_cast<int32_t>(pair.first >> 32); // Extract x
-            int chunkZ = static_cast<int32_t>(pair.first & 0xFFFFFFFF); // Extract z
-            glm::vec3 realChunkPos(chunkX * CHUNK_SIZE, -Chunk::baseTerrainHeight, chunkZ * CHUNK_SIZE);
-
-            if (chunks.find(pair.first) == chunks.end() && chunkGenerationFutures.find(pair.first) == chunkGenerationFutures.end()) {
-                generateChunkAsync(realChunkPos);
-                chunksGeneratedThisFrame++;
-            }
-        } 
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
     }
-    
 
-    // Update the loading radius
-    if (isInitialLoading) {
-        std::lock_guard<std::recursive_mutex> lock(chunksMutex);
-        // Check if all chunks within the current radius are loaded
-        int expectedChunks = (2 * currentLoadingRadius + 1) * (2 * currentLoadingRadius + 1);
-        int loadedChunksCount = 0;
-        for (const auto& pair : chunks) {
-            
-            int dx = std::abs(pair.second.chunkPosition.x / CHUNK_SIZE - playerChunkPos.x);
-            int dz = std::abs(pair.second.chunkPosition.z / CHUNK_SIZE - playerChunkPos.z);
-            if (dx <= currentLoadingRadius && dz <= currentLoadingRadius) {
-                loadedChunksCount++;
-            }
-        }
-        if (loadedChunksCount >= expectedChunks) {
-            currentLoadingRadius++;
-            if (currentLoadingRadius > maxLoadingRadius) {
-                isInitialLoading = false;
-                std::cout << "Initial loading complete! All chunks within render distance loaded." << std::endl;
-            }
-        }
-    }
-
-    // Mark chunks as active/inactive
-    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
-    for (auto& pair : chunks) {
-        if (loadedChunks.find(pair.first) == loadedChunks.end()) {
-            pair.second.isActive = false;
-        }
-        else {
-            pair.second.isActive = true;
-        }
-    }
+    //calculate difference since last frame
+    playerInput.lookX += xpos - lastX;
+    playerInput.lookY += lastY - ypos; // reversed since y-coordinates range from bottom to top
+    lastX = xpos;
+    lastY = ypos;
 }
 
-Chunk* Main::getChunk(const glm::vec3& pos) {
-    std::lock_guard<std::recursive_mutex> lock(chunksMutex); // Keep this for external access
-
-    uint64_t key = getChunkKey(pos.x, pos.z);
-    // Look up the chunk
-    auto it = chunks.find(key);
-    return (it != chunks.end()) ? &it->second : nullptr;
-} 
-
-
-
-void Main::getTextures() {
-
-    int width, height, nrChannels;
-
-    // Load another texture for a different block type, e.g., "stone.jpg"
-    unsigned char* data = stbi_load("../ResourceFiles/textureAtlas.png", &width, &height, &nrChannels, 0);
-    if (!data) {
-        std::cerr << "Failed to load atlas" << std::endl;
-        exit(-1);
-    }
-
-    // Determine texture format based on loaded image
-    GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-   
-    glGenTextures(1, &texAtlas);
-    glBindTexture(GL_TEXTURE_2D, texAtlas);
-    //wrap and fill params
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+void Main::render() {
+    raycastBlock();//used to find currently faced block
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    stbi_image_free(data);
+    FrameView frame;
+    frame.view = player->getViewMatrix();
+    frame.cameraPos = player->getCameraPos();
+    frame.width = static_cast<int>(width);
+    frame.height = static_cast<int>(height);
+    frame.time = glfwGetTime();
+    frame.hasHighlight = hasHighlightedBlock;
+    frame.highlightPos = highlightedBlockPos;
 
+    renderer->render(frame);
+    stateCache->endFrame();
 }
 
 void Main::doFps() {
@@ -898,6 +179,15 @@ void Main::doFps() {
             + "X:" + std::to_string(position.x)
             + " Y:"+ std::to_string(position.y)
             + " Z:"+ std::to_string(position.z);
+#if defined(GL_COUNT_CALLS)
+        if (showGLCalls) {
+            const GLDebug::CallCounts& calls = GLDebug::lastFrame();
+            title += " GL calls: " + std::to_string(calls.total());
+            for (int kind = 0; kind < static_cast<int>(GLCallKind::Count); kind++) {
+                title += std::string(" ") + GLDebug::kindName(static_cast<GLCallKind>(kind)) + " " + std::to_string(calls.calls[kind]);
+            }
+        }
+#endif
 
         glfwSetWindowTitle(window, title.c_str());
     }
@@ -905,343 +195,33 @@ void Main::doFps() {
  
 
 void Main::raycastBlock() {
-    hasHighlightedBlock = false; 
     glm::vec3 rayOrigin = player->getCameraPos();
     glm::vec3 rayDir = glm::normalize(player->getCameraFront());
-    float t = 0.0f;
-    float step = 0.1f;
-
-    for (t = 0.0f; t < reachDistance; t += step) {
-        glm::vec3 currentPos = rayOrigin + rayDir * t;
-
-        // Calculate the chunk position (assuming chunks are keyed at multiples of chunkSize in X and Z)
-        glm::vec3 chunkPos = glm::floor(currentPos / glm::vec3(Chunk::chunkSize, 1, Chunk::chunkSize)) * glm::vec3(Chunk::chunkSize, 0, Chunk::chunkSize);
-        chunkPos.y = -Chunk::baseTerrainHeight; // Set to the fixed Y-position of chunks (adjust as needed)
-
-        // Look up the chunk in the map
-        uint64_t key = getChunkKey(chunkPos.x / CHUNK_SIZE, chunkPos.z / CHUNK_SIZE); 
-        Chunk* chunk = nullptr;
-        { 
-            std::lock_guard<std::recursive_mutex> lock(chunksMutex);
-            auto it = chunks.find(key);
-            if (it != chunks.end()) {
-                chunk = &it->second;
-            }
-        }
-
-        if (chunk) { // Process chunk outside the lock to minimize lock duration
-            int localX = static_cast<int>(currentPos.x - chunk->chunkPosition.x);
-            int localY = static_cast<int>(currentPos.y - chunk->chunkPosition.y);
-            int localZ = static_cast<int>(currentPos.z - chunk->chunkPosition.z);
-
-            if (localX >= 0 && localX < Chunk::chunkSize &&
-                localY >= 0 && localY < Chunk::chunkHeight &&
-                localZ >= 0 && localZ < Chunk::chunkSize) {
-
-                size_t index = chunk->getBlockIndex(localX, localY, localZ);
-                if (chunk->blocks[index] != BlockType::AIR) { // Fixed typo
-                    highlightedBlockPos = glm::vec3(floor(currentPos.x), floor(currentPos.y), floor(currentPos.z));
-                    hasHighlightedBlock = true;
-                    glm::vec3 prevPos = rayOrigin + rayDir * (t - step);
-                    prevBlock = glm::vec3(floor(prevPos.x), floor(prevPos.y), floor(prevPos.z));
-                    return;
-                }
-            }
-        }
+    RaycastHit hit;
+    hasHighlightedBlock = world.raycast(rayOrigin, rayDir, reachDistance, hit);
+    if (hasHighlightedBlock) {
+        highlightedBlockPos = glm::vec3(hit.block);
+        highlightedFace = hit.normal;
     }
 }
 
 void Main::placeBlock() {
 
-    if (hasHighlightedBlock) {
-        glm::vec3 placePos = prevBlock; // Place block on the face indicated by the normal    
+    if (hasHighlightedBlock && highlightedFace != glm::ivec3(0)) {
+        glm::vec3 placePos = highlightedBlockPos + glm::vec3(highlightedFace); // Place block on the face indicated by the normal
 
         if (player->blockIntersects(placePos)) {
             return; // Cancel placement if a player is in the way
         }   
        
-        glm::vec3 chunkPos = glm::floor(placePos / glm::vec3(Chunk::chunkSize, 1, Chunk::chunkSize)) * glm::vec3(Chunk::chunkSize, 0, Chunk::chunkSize);
-        chunkPos.y = -Chunk::baseTerrainHeight; // Adjust if your chunks have a fixed Y
-
-        uint64_t key = getChunkKey(chunkPos.x/ CHUNK_SIZE, chunkPos.z/ CHUNK_SIZE);
-        // Look up the chunk
-        auto it = chunks.find(key);
-        if (it != chunks.end()) {
-            Chunk& chunk = it->second;
-
-            // Calculate local coordinates within the chunk
-            int localX = static_cast<int>(placePos.x - chunkPos.x);
-            int localY = static_cast<int>(placePos.y - chunkPos.y);
-            int localZ = static_cast<int>(placePos.z - chunkPos.z);
-
-            // Check if the local coordinates are within chunk bounds
-            if (localX >= 0 && localX < Chunk::chunkSize &&
-                localY >= 0 && localY < Chunk::chunkHeight &&
-                localZ >= 0 && localZ < Chunk::chunkSize) {
-
-                // Directly set the block at the calculated local position
-                chunk.setBlock(localX, localY, localZ, BlockType::STONE);
-            }
-        }
+        world.setBlockAt(placePos, BlockType::STONE);
     }
 }
 
 void Main::breakBlock() { 
     if (hasHighlightedBlock) {
-
-
-        glm::vec3 chunkPos = glm::floor(highlightedBlockPos / glm::vec3(Chunk::chunkSize, 1, Chunk::chunkSize)) * glm::vec3(Chunk::chunkSize, 0, Chunk::chunkSize);
-        chunkPos.y = -Chunk::baseTerrainHeight; // Adjust if your chunks have a fixed Y
-
-        uint64_t key = getChunkKey(chunkPos.x/CHUNK_SIZE, chunkPos.z/ CHUNK_SIZE);
-        // Look up the chunk
-        auto it = chunks.find(key);;
-        if (it != chunks.end()) {
-            Chunk& chunk = it->second;
-            // Calculate local coordinates
-            int localX = static_cast<int>(highlightedBlockPos.x - chunkPos.x);
-            int localY = static_cast<int>(highlightedBlockPos.y - chunkPos.y);
-            int localZ = static_cast<int>(highlightedBlockPos.z - chunkPos.z);
-
-            // Check bounds and break the block
-            if (localX >= 0 && localX < Chunk::chunkSize &&
-                localY >= 0 && localY < Chunk::chunkHeight &&
-                localZ >= 0 && localZ < Chunk::chunkSize) {
-                chunk.setBlock(localX, localY, localZ, BlockType::AIR);
-            }
-        } 
-    }
-}
-
-// Launch an asynchronous mesh update for a chunk.
-void Main::updateChunkMeshAsync(Chunk& chunk) { 
-
-
-    if (chunk.fullRebuildNeeded && chunk.isActive && activeAsyncTasks < MAX_ASYNC_TASKS()) {
-        // Launch an async task that calls generateMeshData.
-        chunkMeshFutures[chunk.chunkPosition] = std::async(std::launch::async, [&chunk]() {
-            return chunk.generateMeshData();
-            });
-        // Reset the flags on the chunk so we dont launch it again until needed.
-        chunk.fullRebuildNeeded = false;
-        activeAsyncTasks++; 
-    }
-}
-
-// Check if an asynchronous mesh update for the given chunk is ready,and if so, update its OpenGL buffers.
-void Main::tryApplyChunkMeshUpdate(Chunk& chunk) {
-    auto it = chunkMeshFutures.find(chunk.chunkPosition);
-    if (it != chunkMeshFutures.end()) {
-        if (it->second.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
-
-            MeshData newMesh = it->second.get();
-            chunkMeshFutures.erase(it);
-            activeAsyncTasks--;
-
-            chunk.verticesByType = std::move(newMesh.packedVerticesByType);
-            chunk.indicesByType = std::move(newMesh.indicesByType);
-            chunk.baseIndicesByType = std::move(newMesh.baseIndicesByType);
-
-            std::vector<PackedVertex> allVertices;
-            std::vector<unsigned int> allIndices;
-            unsigned int vertexOffset = 0;
-            unsigned int indexOffset = 0;
-            for (auto& pair : chunk.verticesByType) {
-                BlockType type = pair.first;
-                chunk.baseIndicesByType[type] = indexOffset;
-                allVertices.insert(allVertices.end(), pair.second.begin(), pair.second.end());
-                for (unsigned int idx : chunk.indicesByType[type]) {
-                    allIndices.push_back(idx + vertexOffset);
-                }
-                vertexOffset += pair.second.size();
-                indexOffset += chunk.indicesByType[type].size();
-            }
-
-            // Check if buffers are valid
-            if (chunk.VAO == 0 || chunk.VBO == 0 || chunk.EBO == 0) {
-                std::lock_guard<std::mutex> lock(logMutex);
-                std::cerr << "Invalid VAO/VBO/EBO for chunk " << glm::to_string(chunk.chunkPosition) << std::endl;
-                return;
-            }
-
-            glBindVertexArray(chunk.VAO);
-            glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
-
-
-            glBufferData(GL_ARRAY_BUFFER, allVertices.size() * sizeof(PackedVertex), allVertices.data(), GL_DYNAMIC_DRAW);
-
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.EBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, allIndices.size() * sizeof(unsigned int), allIndices.data(), GL_DYNAMIC_DRAW);
-
-
-            
-            glVertexAttribIPointer(0, 3, GL_SHORT, sizeof(PackedVertex), (void*)offsetof(PackedVertex, pos)); 
-            glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(PackedVertex), (void*)offsetof(PackedVertex, colour)); 
-            glVertexAttribIPointer(2, 2, GL_UNSIGNED_SHORT, sizeof(PackedVertex), (void*)offsetof(PackedVertex, tex)); 
-            glVertexAttribIPointer(3, 1, GL_INT, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal)); 
-
-            glEnableVertexAttribArray(0);
-            glEnableVertexAttribArray(1);
-            glEnableVertexAttribArray(2);
-            glEnableVertexAttribArray(3);
-             
-
-            glBindVertexArray(0);
-
-
-            chunk.fullRebuildNeeded = false;                        
-        }
-    }
-}
-
-
-void Main::processChunkMeshingInOrder() {
-
-    std::lock_guard<std::recursive_mutex> lock(chunksMutex); // Single lock for all chunk operations
-    int processedChunks = 0;
-    const int maxChunksPerFrame = 20;//needs to be >1 as 1 is always used for current chunk
-
-    //pos in chunks (eg 0,0,1)
-    glm::ivec3 playerChunkPos = glm::ivec3(
-        floor(player->getCameraPos().x / CHUNK_SIZE),
-        0, // Y is fixed at 0 for chunk coordinates
-        floor(player->getCameraPos().z / CHUNK_SIZE)
-    );
-
-    //pos in world space,locked to chunk ( 0,0,16)
-    glm::vec3 playerChunkRealPos = glm::vec3(
-        playerChunkPos.x * CHUNK_SIZE,
-        -Chunk::baseTerrainHeight,
-        playerChunkPos.z * CHUNK_SIZE
-    );
-
-    uint64_t key = getChunkKey(playerChunkRealPos.x, playerChunkRealPos.z);
-    // Look up the chunk
-    auto playerChunkIt = chunks.find(key);
-     
-    if (playerChunkIt != chunks.end() && processedChunks < maxChunksPerFrame) { 
-        Chunk& playerChunk = playerChunkIt->second; 
-        if (playerChunk.isActive) { 
-            if (playerChunk.fullRebuildNeeded) {  
-                updateChunkMeshAsync(playerChunk); 
-            } 
-            tryApplyChunkMeshUpdate(playerChunk);
-            processedChunks++;
-        }
-    }
-
-    for (auto& pair : chunks) {
-        if (processedChunks >= maxChunksPerFrame) break;
-        Chunk& chunk = pair.second;
-        if (chunk.isActive) {
-            if (chunk.fullRebuildNeeded) {
-                updateChunkMeshAsync(chunk);
-            }
-            tryApplyChunkMeshUpdate(chunk); 
-        }
-    }  
-}
-
-void Main::makeBasicModel() {
-
-    beeModel = OBJLoader::LoadOBJ("../ResourceFiles/bee.obj"); 
-    beeModelGl = createModelGL(beeModel, "../ResourceFiles/BeeAtlas.png", entityShader->ID, "beeTexture");
-
-    cubeModel = OBJLoader::LoadOBJ("../ResourceFiles/coolBox.obj");
-    cubeModelGl = createModelGL(cubeModel, "../ResourceFiles/boxTex.png", entityShader->ID, "boxTexture");
-
-    swordModel = OBJLoader::LoadOBJ("../ResourceFiles/sword.obj");
-    swordModelGl = createModelGL(swordModel, "../ResourceFiles/swordTex.png", entityShader->ID, "swordTexture");
-
-}
-
-ModelGL Main::createModelGL(const OBJData& modelData, const std::string& texturePath, GLuint shaderID, const std::string& uniformName) {
-
-    ModelGL m;
-
-    std::vector<float> vertexData;
-    for (size_t i = 0; i < modelData.positions.size(); ++i) {
-        vertexData.push_back(modelData.positions[i].x);
-        vertexData.push_back(modelData.positions[i].y);
-        vertexData.push_back(modelData.positions[i].z);
-
-        if (!modelData.normals.empty()) {
-            vertexData.push_back(modelData.normals[i].x);
-            vertexData.push_back(modelData.normals[i].y);
-            vertexData.push_back(modelData.normals[i].z);
-        }
-        else {
-            vertexData.insert(vertexData.end(), { 0.0f, 0.0f, 1.0f });
-        }
-
-        if (!modelData.texCoords.empty()) {
-            vertexData.push_back(modelData.texCoords[i].x);
-            vertexData.push_back(modelData.texCoords[i].y);
-        }
-        else {
-            vertexData.insert(vertexData.end(), { 0.0f, 0.0f });
-        }
-    }
-
-    glGenVertexArrays(1, &m.VAO);
-    glGenBuffers(1, &m.VBO);
-    glGenBuffers(1, &m.EBO);
-
-    glBindVertexArray(m.VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, m.VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, modelData.indices.size() * sizeof(unsigned int), modelData.indices.data(), GL_STATIC_DRAW);
-
-    GLsizei stride = 8 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0); // pos
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float))); // normal
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float))); // texcoord
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
-
-    m.textureID = loadTexture(texturePath.c_str());
-    m.indexCount = modelData.indices.size();
-
-    // Bind texture to unit 0 and assign uniform
-    glUseProgram(shaderID);
-    glUniform1i(glGetUniformLocation(shaderID, uniformName.c_str()), 0);
-
-    m.uniformName = uniformName;
-
-    return m;
-}
-
-GLuint Main::loadTexture(const std::string& path) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    // Load image using stb_image
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-        GLenum format = (nrChannels == 3) ? GL_RGB : GL_RGBA;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else {
-        std::cerr << "Failed to load texture: " << path << std::endl;
+        world.setBlockAt(highlightedBlockPos, BlockType::AIR);
     }
-
-    stbi_image_free(data);
-    return textureID;
 }
 
 void Main::run() {
@@ -1252,13 +232,9 @@ void Main::run() {
         std::cerr << "OpenGL error at start of run: 0x" << std::hex << err << std::dec << std::endl;
     } 
    
-    createSun();
-
-    getTextures();  
-    createShaders();
-    createHighlight();
+    renderer->init();
 
-    initNoise();
+    world.init(-1);
 
     // Verify context is still current
     if (!glfwGetCurrentContext()) {
@@ -1268,8 +244,7 @@ void Main::run() {
 
 
     player->spawn(glm::vec3(10,200,10));
-    //entities.push_back(std::make_unique<Bee>(glm::vec3(0, 35, 0)));
-    makeBasicModel();
+    //world.spawnBee(glm::vec3(0, 35, 0));
 
     lastFrame = glfwGetTime();
 
@@ -1286,18 +261,22 @@ void Main::run() {
             deltaTime = maxDeltaTime;
         }
          
-        updateChunks(player->getCameraPos());
-        tryApplyChunkGeneration();
-        player->update(deltaTime, chunks); 
+        world.updateChunks(player->getCameraPos());
+        world.tryApplyChunkGeneration();
         processInput(window); 
-
-        processChunkMeshingInOrder();
-
-        for (auto& entity : entities) {
-            entity->update(deltaTime);
-
+        player->update(deltaTime, playerInput); 
+        playerInput.lookX = playerInput.lookY = 0.0f;
+
+        world.processChunkMeshingInOrder(player->getCameraPos());
+        {
+            std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+            for (Chunk* chunk : world.takeMeshUploads()) {
+                renderer->uploadChunkMesh(*chunk);
+            }
         }
 
+        world.updateEntities(deltaTime, player->getCameraPos());
+
         render();
         doFps();
 
@@ -1,13 +1,38 @@
 #pragma once
-#include <map>
 #include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
 #include "BlockType.h"
 #include "VertexPacking.h"
 
+//one 16 block tall slice of a chunk mesh, a contiguous run of MeshData::indices
+//split into one bucket per face direction (Front z-, Back z+, Left x-, Right x+, Top, Bottom) so
+//buckets facing away from the camera can be skipped, see FaceBuckets.h
+struct MeshSection {
+	static constexpr int faceDirections = 6;
+
+	unsigned int firstIndex = 0;
+	unsigned int indexCount = 0;
+	unsigned int bucketCounts[faceDirections] = {};//indices per direction, buckets follow each other from firstIndex
+	glm::ivec3 min = glm::ivec3(0), max = glm::ivec3(0);//chunk local box around the blocks with faces, min == max when empty
+	//bit a * 6 + b set when air inside the section joins faces a and b (same order as the buckets), for cave culling
+	//everything joined until the mesher has flood filled it, so a section that was never meshed hides nothing
+	static constexpr uint64_t allConnected = (1ull << (faceDirections * faceDirections)) - 1;
+	uint64_t connectivity = allConnected;
+};
 
 struct MeshData {
-	//by type so can apply textures in batches
-	std::map<BlockType, std::vector<PackedVertex>> packedVerticesByType;
-	std::map<BlockType, std::vector<unsigned int>> indicesByType;
-	std::map<BlockType, unsigned int> baseIndicesByType;
-};
\ No newline at end of file
+	static constexpr int sectionHeight = 16;
+	static constexpr int sectionCount = 256 / sectionHeight;//Chunk::chunkHeight
+
+	//section major so each section can be culled and drawn on its own, block types share the atlas so arent split
+	std::vector<PackedVertex> vertices;
+	std::vector<unsigned int> indices;//relative to the chunk's first vertex
+	MeshSection sections[sectionCount];
+
+	//how far up from the bottom of the chunk every column is solid, lowest over each solidCell x solidCell
+	//patch, the boxes the occlusion buffer draws (appendOccluders). 0 = patch has an air gap at the bottom
+	static constexpr int solidCell = 4;
+	static constexpr int solidCells = 16 / solidCell;//per side, Chunk::chunkSize
+	int solidHeights[solidCells * solidCells] = {};
+};
@@ -1,8 +1,6 @@
 #pragma once
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <vector>
-#include <iostream>
 
 struct Vertex
 {
@@ -11,18 +9,15 @@ struct Vertex
 	glm::vec3 normal;
 };
 
+//cpu side of a loaded model, the renderer makes the gpu buffers and texture from this the first time its drawn
 class Model {
 
 public:
-	unsigned int VAO, VBO, EBO;
-	unsigned int textureID;
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
 
-	Model(): VAO(0), VBO(0), EBO(0), textureID(0){}
-	~Model();
-	void draw(unsigned int shaderProgram);
-
-private:
-	void checkGLError(const std::string& stage);
-};
\ No newline at end of file
+	//base colour texture, empty if the model has none
+	std::vector<unsigned char> texturePixels;
+	int textureWidth = 0, textureHeight = 0;
+	int textureChannels = 0;//3 or 4
+};
@@ -8,13 +8,11 @@ class ModelLoader
 public:
 
 	static Model* getModel(const std::string& path);
-	static unsigned int loadFallbackTexture();
 
 private:
-	static unsigned int loadTexture(const tinygltf::Model& model, int textureIndex);
+	static void loadTexture(const tinygltf::Model& gltf, int textureIndex, Model& model);
 	
 	static Model loadGLB(const std::string& path);
 	static std::map<std::string, Model> modelCache; 
-	static void checkGLError(const std::string& stage);
 };
 
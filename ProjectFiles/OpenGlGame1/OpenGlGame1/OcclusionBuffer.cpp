@@ -0,0 +1,263 @@
+#include "OcclusionBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include "Frustum.h"
+#include "MeshData.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_SSE 1
+#endif
+
+namespace {
+    const float NEAR_W = 0.1f;//camera near plane, w in clip space is the view depth
+}
+
+void appendOccluders(const MeshData& mesh, const glm::vec3& origin, std::vector<OccluderBox>& out) {
+    const int cells = MeshData::solidCells;
+    int lowest = 256;//Chunk::chunkHeight
+    for (int height : mesh.solidHeights) lowest = std::min(lowest, height);
+
+    for (int cz = 0; cz < cells; cz++) {
+        for (int cx = 0; cx < cells; cx++) {
+            int height = mesh.solidHeights[cz * cells + cx];
+            if (height <= 0) continue;
+
+            //below the lowest neighbour the sides are covered by the neighbours' own boxes, stopping there
+            //saves drawing every side face down to bedrock. Other chunks aren't known, the chunk's lowest stands in
+            int bottom = height - 1;
+            const int offsets[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+            for (const auto& offset : offsets) {
+                int nx = cx + offset[0], nz = cz + offset[1];
+                bool inside = nx >= 0 && nx < cells && nz >= 0 && nz < cells;
+                bottom = std::min(bottom, inside ? mesh.solidHeights[nz * cells + nx] : lowest);
+            }
+            bottom = std::max(bottom, 0);
+
+            glm::vec3 min = origin + glm::vec3(cx * MeshData::solidCell, bottom, cz * MeshData::solidCell);
+            glm::vec3 max = origin + glm::vec3((cx + 1) * MeshData::solidCell, height, (cz + 1) * MeshData::solidCell);
+            out.push_back({ min, max });
+        }
+    }
+}
+
+OcclusionBuffer::OcclusionBuffer()
+    : viewProj(1.0f), eye(0.0f), depthBuffer(WIDTH * HEIGHT, 0.0f), tileFar((WIDTH / TILE) * (HEIGHT / TILE), 0.0f) {
+}
+
+void OcclusionBuffer::setThreads(int count) {
+    threads = std::max(1, std::min(count, HEIGHT / TILE));
+}
+
+void OcclusionBuffer::begin(const glm::mat4& matrix, const glm::vec3& eyePos) {
+    viewProj = matrix;
+    eye = eyePos;
+    triangles.clear();
+}
+
+void OcclusionBuffer::addOccluder(const glm::vec3& min, const glm::vec3& max) {
+    //only faces the eye is strictly outside of, the rest are back facing or edge on
+    glm::vec3 c[8];
+    for (int i = 0; i < 8; i++) {
+        c[i] = glm::vec3(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z);
+    }
+    if (eye.x < min.x) addQuad(c[0], c[2], c[6], c[4]);
+    if (eye.x > max.x) addQuad(c[1], c[5], c[7], c[3]);
+    if (eye.y < min.y) addQuad(c[0], c[4], c[5], c[1]);
+    if (eye.y > max.y) addQuad(c[2], c[3], c[7], c[6]);
+    if (eye.z < min.z) addQuad(c[0], c[1], c[3], c[2]);
+    if (eye.z > max.z) addQuad(c[4], c[6], c[7], c[5]);
+}
+
+size_t OcclusionBuffer::addOccluders(const std::vector<OccluderBox>& boxes, const Frustum& frustum, float maxDistance) {
+    size_t added = 0;
+    for (const OccluderBox& box : boxes) {
+        glm::vec2 nearest = glm::clamp(glm::vec2(eye.x, eye.z), glm::vec2(box.min.x, box.min.z), glm::vec2(box.max.x, box.max.z));
+        glm::vec2 offset = nearest - glm::vec2(eye.x, eye.z);
+        if (glm::dot(offset, offset) > maxDistance * maxDistance) continue;
+        if (!frustum.isBoxInFrustum(box.min, box.max)) continue;
+        addOccluder(box.min, box.max);
+        added++;
+    }
+    return added;
+}
+
+void OcclusionBuffer::addQuad(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d) {
+    //clip against the near plane, anything behind the eye would project inside out
+    glm::vec4 in[4] = { viewProj * glm::vec4(a, 1.0f), viewProj * glm::vec4(b, 1.0f), viewProj * glm::vec4(c, 1.0f), viewProj * glm::vec4(d, 1.0f) };
+    glm::vec4 out[8];
+    int count = 0;
+    for (int i = 0; i < 4; i++) {
+        const glm::vec4& from = in[i];
+        const glm::vec4& to = in[(i + 1) % 4];
+        bool fromIn = from.w >= NEAR_W, toIn = to.w >= NEAR_W;
+        if (fromIn) out[count++] = from;
+        if (fromIn != toIn) {
+            float t = (NEAR_W - from.w) / (to.w - from.w);
+            out[count++] = from + (to - from) * t;
+        }
+    }
+    for (int i = 2; i < count; i++) addTriangle(out[0], out[i - 1], out[i]);
+}
+
+void OcclusionBuffer::addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+    //screen space with y up, pixel centres at +0.5
+    glm::vec3 v[3];
+    const glm::vec4* clip[3] = { &a, &b, &c };
+    for (int i = 0; i < 3; i++) {
+        float invW = 1.0f / clip[i]->w;
+        v[i] = glm::vec3((clip[i]->x * invW * 0.5f + 0.5f) * WIDTH, (clip[i]->y * invW * 0.5f + 0.5f) * HEIGHT, invW);
+    }
+
+    float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+    if (std::fabs(area) < 1e-6f) return;
+    if (area < 0.0f) {
+        std::swap(v[1], v[2]);
+        area = -area;
+    }
+
+    Triangle tri;
+    tri.minX = std::max(0, static_cast<int>(std::floor(std::min({ v[0].x, v[1].x, v[2].x }))));
+    tri.maxX = std::min(WIDTH - 1, static_cast<int>(std::floor(std::max({ v[0].x, v[1].x, v[2].x }))));
+    tri.minY = std::max(0, static_cast<int>(std::floor(std::min({ v[0].y, v[1].y, v[2].y }))));
+    tri.maxY = std::min(HEIGHT - 1, static_cast<int>(std::floor(std::max({ v[0].y, v[1].y, v[2].y }))));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) return;
+
+    for (int i = 0; i < 3; i++) {
+        const glm::vec3& from = v[i];
+        const glm::vec3& to = v[(i + 1) % 3];
+        tri.edgeA[i] = from.y - to.y;
+        tri.edgeB[i] = to.x - from.x;
+        tri.edgeC[i] = from.x * to.y - from.y * to.x;
+    }
+
+    //1 / w is affine in screen space, pushed back by half a pixel each way so the whole pixel is at least this far
+    tri.depthX = ((v[1].z - v[0].z) * (v[2].y - v[0].y) - (v[2].z - v[0].z) * (v[1].y - v[0].y)) / area;
+    tri.depthY = ((v[2].z - v[0].z) * (v[1].x - v[0].x) - (v[1].z - v[0].z) * (v[2].x - v[0].x)) / area;
+    tri.depthC = v[0].z - tri.depthX * v[0].x - tri.depthY * v[0].y - 0.5f * (std::fabs(tri.depthX) + std::fabs(tri.depthY));
+    triangles.push_back(tri);
+}
+
+void OcclusionBuffer::rasterize() {
+    //bands are whole tile rows so each one also owns its tiles
+    int tileRows = HEIGHT / TILE;
+    int bands = std::min(threads, tileRows);
+    std::vector<std::future<void>> work;
+    for (int band = 1; band < bands; band++) {
+        int rowBegin = tileRows * band / bands * TILE;
+        int rowEnd = tileRows * (band + 1) / bands * TILE;
+        work.push_back(std::async(std::launch::async, [this, rowBegin, rowEnd]() { rasterizeBand(rowBegin, rowEnd); }));
+    }
+    rasterizeBand(0, tileRows / bands * TILE);//same split as tileRows * 1 / bands
+    for (std::future<void>& band : work) band.get();
+}
+
+void OcclusionBuffer::rasterizeBand(int rowBegin, int rowEnd) {
+    std::fill(depthBuffer.begin() + rowBegin * WIDTH, depthBuffer.begin() + rowEnd * WIDTH, 0.0f);
+
+    for (const Triangle& tri : triangles) {
+        int y0 = std::max(tri.minY, rowBegin);
+        int y1 = std::min(tri.maxY, rowEnd - 1);
+        if (y0 > y1) continue;
+        for (int y = y0; y <= y1; y++) {
+            float py = y + 0.5f;
+            float rowEdge[3];
+            for (int i = 0; i < 3; i++) rowEdge[i] = tri.edgeB[i] * py + tri.edgeC[i];
+            float rowEdge0 = rowEdge[0], rowEdge1 = rowEdge[1], rowEdge2 = rowEdge[2];
+            float rowDepth = tri.depthY * py + tri.depthC;
+
+            //where the row is inside all three edges, a pixel wider each side so rounding never loses one,
+            //the per pixel edge tests below have the final say
+            float left = static_cast<float>(tri.minX), right = static_cast<float>(tri.maxX);
+            for (int i = 0; i < 3; i++) {
+                if (tri.edgeA[i] > 0.0f) left = std::max(left, -rowEdge[i] / tri.edgeA[i] - 1.5f);
+                else if (tri.edgeA[i] < 0.0f) right = std::min(right, -rowEdge[i] / tri.edgeA[i] + 0.5f);
+                else if (rowEdge[i] < 0.0f) right = -1.0f;
+            }
+            if (left > right) continue;
+            int x = static_cast<int>(left) & ~3;//4 pixel aligned, the edge tests drop the extra pixels
+            int x1 = static_cast<int>(right);
+            float* row = depthBuffer.data() + y * WIDTH;
+#ifdef OCCLUSION_SSE
+            if (useSimd) {
+                __m128 a0 = _mm_set1_ps(tri.edgeA[0]), a1 = _mm_set1_ps(tri.edgeA[1]), a2 = _mm_set1_ps(tri.edgeA[2]);
+                __m128 r0 = _mm_set1_ps(rowEdge0), r1 = _mm_set1_ps(rowEdge1), r2 = _mm_set1_ps(rowEdge2);
+                __m128 dx = _mm_set1_ps(tri.depthX), rd = _mm_set1_ps(rowDepth);
+                __m128 zero = _mm_setzero_ps();
+                __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f));
+                __m128 step = _mm_set1_ps(4.0f);
+                for (; x <= x1; x += 4) {
+                    __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), r0);
+                    __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), r1);
+                    __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), r2);
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+                    __m128 depth = _mm_add_ps(_mm_mul_ps(dx, px), rd);
+                    __m128 stored = _mm_loadu_ps(row + x);
+                    __m128 nearer = _mm_max_ps(stored, depth);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, stored)));
+                    px = _mm_add_ps(px, step);
+                }
+            }
+#endif
+            for (; x <= x1; x++) {
+                float px = x + 0.5f;
+                float e0 = tri.edgeA[0] * px + rowEdge0;
+                float e1 = tri.edgeA[1] * px + rowEdge1;
+                float e2 = tri.edgeA[2] * px + rowEdge2;
+                if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f) continue;
+                row[x] = std::max(row[x], tri.depthX * px + rowDepth);
+            }
+        }
+    }
+
+    int tilesX = WIDTH / TILE;
+    for (int ty = rowBegin / TILE; ty < rowEnd / TILE; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            float farthest = depthBuffer[ty * TILE * WIDTH + tx * TILE];
+            for (int y = 0; y < TILE; y++) {
+                const float* row = depthBuffer.data() + (ty * TILE + y) * WIDTH + tx * TILE;
+                for (int x = 0; x < TILE; x++) farthest = std::min(farthest, row[x]);
+            }
+            tileFar[ty * tilesX + tx] = farthest;
+        }
+    }
+}
+
+bool OcclusionBuffer::isBoxVisible(const glm::vec3& min, const glm::vec3& max) const {
+    float minX = static_cast<float>(WIDTH), minY = static_cast<float>(HEIGHT), maxX = 0.0f, maxY = 0.0f;
+    float nearest = 0.0f;
+    for (int i = 0; i < 8; i++) {
+        glm::vec4 clip = viewProj * glm::vec4(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0f);
+        if (clip.w < NEAR_W) return true;//crosses the near plane, can't be behind anything
+        float invW = 1.0f / clip.w;
+        float x = (clip.x * invW * 0.5f + 0.5f) * WIDTH;
+        float y = (clip.y * invW * 0.5f + 0.5f) * HEIGHT;
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+        nearest = std::max(nearest, invW);
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor(minX)) - 1);
+    int x1 = std::min(WIDTH - 1, static_cast<int>(std::floor(maxX)) + 1);
+    int y0 = std::max(0, static_cast<int>(std::floor(minY)) - 1);
+    int y1 = std::min(HEIGHT - 1, static_cast<int>(std::floor(maxY)) + 1);
+    if (x0 > x1 || y0 > y1) return false;//off screen
+
+    //hidden only if every pixel has an occluder nearer than the box's nearest corner
+    int tilesX = WIDTH / TILE;
+    for (int ty = y0 / TILE; ty <= y1 / TILE; ty++) {
+        for (int tx = x0 / TILE; tx <= x1 / TILE; tx++) {
+            if (tileFar[ty * tilesX + tx] > nearest) continue;
+            int px0 = std::max(x0, tx * TILE), px1 = std::min(x1, tx * TILE + TILE - 1);
+            int py0 = std::max(y0, ty * TILE), py1 = std::min(y1, ty * TILE + TILE - 1);
+            for (int y = py0; y <= py1; y++) {
+                const float* row = depthBuffer.data() + y * WIDTH;
+                for (int x = px0; x <= px1; x++) {
+                    if (row[x] <= nearest) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class Frustum;
+struct MeshData;
+
+//box of blocks that is solid all the way through, world space
+struct OccluderBox {
+	glm::vec3 min, max;
+};
+
+//appends the solid column boxes of a mesh (MeshData::solidHeights) offset to the chunk origin
+void appendOccluders(const MeshData& mesh, const glm::vec3& origin, std::vector<OccluderBox>& out);
+
+//small cpu depth buffer for occlusion culling. Occluder boxes are rasterized into it, then chunk section
+//boxes are tested against it before they reach the draw list, so terrain hidden behind a ridge is never sent.
+//Depth is 1 / w (0 = nothing drawn, bigger = nearer) as that is linear in screen space. Occluders are sampled
+//at pixel centres with their depth pushed back to the far corner of the pixel, occludees check every pixel
+//their box touches plus a one pixel border, so the only misses left are sub pixel slivers at occluder edges.
+//Rows are split into bands that rasterize on their own threads, 4 pixels at a time with sse. No gl in here.
+class OcclusionBuffer
+{
+public:
+	static const int WIDTH = 256;
+	static const int HEIGHT = 128;
+	static const int TILE = 8;//side of the tiles that keep their farthest depth, to reject most boxes without a pixel loop
+
+	OcclusionBuffer();
+
+	void setThreads(int count);//bands rasterized in parallel, 1 runs on the calling thread
+	bool useSimd = true;//the scalar loop gives the same buffer, kept to check the sse one against
+
+	void begin(const glm::mat4& viewProj, const glm::vec3& eye);//clears the buffer and the queued occluders
+	void addOccluder(const glm::vec3& min, const glm::vec3& max);//queues the faces of the box turned towards the eye
+	//queues every box in the frustum within maxDistance of the eye (on x / z), returns how many
+	size_t addOccluders(const std::vector<OccluderBox>& boxes, const Frustum& frustum, float maxDistance);
+	void rasterize();
+
+	bool isBoxVisible(const glm::vec3& min, const glm::vec3& max) const;
+
+	size_t triangleCount() const { return triangles.size(); }
+	const std::vector<float>& depth() const { return depthBuffer; }
+
+private:
+	//screen space triangle, counter clockwise, edge functions and depth plane set up once for every band
+	struct Triangle {
+		float edgeA[3], edgeB[3], edgeC[3];//inside when edgeA * x + edgeB * y + edgeC >= 0 for all three
+		float depthX, depthY, depthC;//1 / w = depthX * x + depthY * y + depthC, already moved to the pixel's far corner
+		int minX, maxX, minY, maxY;//pixel bounds, clamped to the buffer
+	};
+
+	glm::mat4 viewProj;
+	glm::vec3 eye;
+	int threads = 1;
+	std::vector<Triangle> triangles;
+	std::vector<float> depthBuffer;
+	std::vector<float> tileFar;//smallest 1 / w in each tile
+
+	void addQuad(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d);
+	void addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);//clip space, in front of the near plane
+	void rasterizeBand(int rowBegin, int rowEnd);
+};
@@ -1,27 +1,13 @@
 #include "Player.h"
 #include <iostream>//print
 #include <mutex>
-#include "Main.h"
+#include "World.h"
 #include "Vec3Hash.h"//for get chunk key
 
 
 
-Player::Player(GLFWwindow* window,Main* main) 
-    : window(window), velocity(0.0f), bodyPos(0.0f), cameraFront(0.0f, 0.0f, -1.0f), cameraUp(0.0f, 1.0f, 0.0f), firstMouse(true),grounded(false),main(main) {
-
-
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-    // Set GLFW window user pointer to this instance
-    glfwSetWindowUserPointer(window, this);
-
-    // Register a lambda for the mouse callback
-    glfwSetCursorPosCallback(window, [](GLFWwindow* window, double xpos, double ypos) {
-        Player* player = static_cast<Player*>(glfwGetWindowUserPointer(window));
-        if (player) {
-            player->processMouseMovement(window,static_cast<float>(xpos), static_cast<float>(ypos)); 
-        }
-     });
+Player::Player(World* world) 
+    : velocity(0.0f), bodyPos(0.0f), cameraFront(0.0f, 0.0f, -1.0f), cameraUp(0.0f, 1.0f, 0.0f), grounded(false),world(world) {
 }
 
 void Player::spawn(glm::vec3 spawnPos) {
@@ -29,26 +15,16 @@ void Player::spawn(glm::vec3 spawnPos) {
     cameraPos = bodyPos + glm::vec3(0, eyeLevel, 0);
 }
 
-void Player::update(float deltaTime, const std::unordered_map<uint64_t, Chunk>& chunks) {
+void Player::update(float deltaTime, const PlayerInput& input) {
 
-    playerMovement(deltaTime, chunks);
-}
-
-//handles looking
-void Player::processMouseMovement(GLFWwindow* window, double xpos, double ypos) {
-
-    if (firstMouse)//stops large 1st jump
-    {
-        lastX = xpos;
-        lastY = ypos;
-        firstMouse = false;
+    if (input.lookX != 0.0f || input.lookY != 0.0f) {
+        processMouseMovement(input.lookX, input.lookY);
     }
+    playerMovement(deltaTime, input);
+}
 
-    //calculate difference since last frame
-    float xoffset = xpos - lastX;
-    float yoffset = lastY - ypos; // reversed since y-coordinates range from bottom to top
-    lastX = xpos;
-    lastY = ypos;
+//handles looking, offsets are mouse movement since last frame with y going up
+void Player::processMouseMovement(float xoffset, float yoffset) {
 
     xoffset *= lookSens;
     yoffset *= lookSens;
@@ -70,7 +46,7 @@ void Player::processMouseMovement(GLFWwindow* window, double xpos, double ypos)
     cameraFront = glm::normalize(lookDirection);//set cam front to new direcction
 }
 
-void Player::playerMovement(float deltaTime, const std::unordered_map<uint64_t, Chunk>& chunks) {
+void Player::playerMovement(float deltaTime, const PlayerInput& input) {
     float camSpeed = BASE_SPEED;
 
     // Apply gravity
@@ -80,12 +56,12 @@ void Player::playerMovement(float deltaTime, const std::unordered_map<uint64_t,
     glm::vec3 moveDir(0.0f);
     glm::vec3 right = glm::normalize(glm::cross(cameraFront, cameraUp));
     glm::vec3 forward = glm::normalize(glm::vec3(cameraFront.x, 0.0f, cameraFront.z));
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) moveDir += forward;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) moveDir -= forward;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) moveDir += right;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) moveDir -= right;
+    if (input.forward) moveDir += forward;
+    if (input.back) moveDir -= forward;
+    if (input.right) moveDir += right;
+    if (input.left) moveDir -= right;
      
-    if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) {
+    if (input.sprint) {
         camSpeed *= SPRINT_SPEED;
     } 
 
@@ -100,172 +76,18 @@ void Player::playerMovement(float deltaTime, const std::unordered_map<uint64_t,
     }
 
     // Jump logic 
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && grounded) { 
+    if (input.jump && grounded) { 
         //https://medium.com/%40brazmogu/physics-for-game-dev-a-platformer-physics-cheatsheet-f34b09064558
         velocity.y = sqrt(2.0f * -GRAVITY * JUMP_HEIGHT);
     }
 
-    // Proposed new position (step-by-step for each axis) 
-    glm::vec3 newPos = bodyPos;
-    AABB playerBox = { newPos + playerAABB.min, newPos + playerAABB.max };
-    grounded = false;
-
-    // Player's chunk position
-    glm::vec3 playerChunkPos = glm::floor(newPos / glm::vec3(Chunk::chunkSize, 1.0f, Chunk::chunkSize)) *
-        glm::vec3(Chunk::chunkSize, 0.0f, Chunk::chunkSize);
-    playerChunkPos.y = -Chunk::baseTerrainHeight;
-
-    // Gather nearby chunks based on playerBox boundaries
-    std::unordered_map<uint64_t, const Chunk*> nearbyChunks;
-    {
-        std::lock_guard<std::recursive_mutex> lock(main->chunksMutex);
-
-        // Determine chunk bounds playerBox spans
-        glm::vec3 minChunkPos = glm::floor(playerBox.min / glm::vec3(Chunk::chunkSize, 1, Chunk::chunkSize)) * glm::vec3(Chunk::chunkSize, 0, Chunk::chunkSize);
-        glm::vec3 maxChunkPos = glm::floor(playerBox.max / glm::vec3(Chunk::chunkSize, 1, Chunk::chunkSize)) * glm::vec3(Chunk::chunkSize, 0, Chunk::chunkSize);
-
-        // Check only chunks the playerBox intersects
-        for (int x = minChunkPos.x; x <= maxChunkPos.x; x += Chunk::chunkSize) {
-            for (int z = minChunkPos.z; z <= maxChunkPos.z; z += Chunk::chunkSize) {
-                glm::vec3 checkChunkPos(x, 0, z); // Y typically fixed for chunks
-                uint64_t key = getChunkKey(checkChunkPos.x / Chunk::chunkSize, checkChunkPos.z / Chunk::chunkSize);
-                auto it = main->chunks.find(key);
-                if (it != main->chunks.end()) {
-                    nearbyChunks[key] = &it->second; 
-                }
-            }
-        }
-    }
-
-    // Step 1: Resolve X-axis
-    newPos.x += velocity.x * deltaTime;
-    playerBox = { newPos + playerAABB.min, newPos + playerAABB.max };
-
-
-    for (const auto& pair : nearbyChunks) {//for overlapping chunks
-        glm::vec3 chunkPos = pair.second->chunkPosition;//world pos
-    
-        for (int bx = -1; bx <= 1; bx++) {//check a 3x3x3 block area for collision
-            for (int by = -1; by <= 1; by++) {
-                for (int bz = -1; bz <= 1; bz++) {
-                    glm::vec3 blockWorldPos = glm::floor(newPos) + glm::vec3(bx, by, bz);
-                    int localX = static_cast<int>(blockWorldPos.x - chunkPos.x);
-                    int localY = static_cast<int>(blockWorldPos.y - chunkPos.y);
-                    int localZ = static_cast<int>(blockWorldPos.z - chunkPos.z);
-                    if (localX >= 0 && localX < Chunk::chunkSize &&
-                        localY >= 0 && localY < Chunk::chunkHeight &&
-                        localZ >= 0 && localZ < Chunk::chunkSize) {
-
-                        size_t index = pair.second->getBlockIndex(localX, localY, localZ);
-
-                        if (pair.second->blocks[index] != BlockType::AIR) {
-                            AABB blockBox = {
-                                chunkPos + glm::vec3(localX, localY, localZ),
-                                chunkPos + glm::vec3(localX + 1, localY + 1, localZ + 1)
-                            };
-                            if (intersects(playerBox, blockBox)) {
-                                if (velocity.x > 0) {
-                                    newPos.x = blockBox.min.x - playerAABB.max.x - 0.001f;
-                                }
-                                else if (velocity.x < 0) {
-                                    newPos.x = blockBox.max.x - playerAABB.min.x + 0.001f;
-                                }
-                                velocity.x = 0.0f;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-
-    // Step 2: Resolve Z-axis
-    newPos.z += velocity.z * deltaTime;
-    playerBox = { newPos + playerAABB.min, newPos + playerAABB.max };
-    for (const auto& pair : nearbyChunks) {//for overlapping chunks
-        glm::vec3 chunkPos = pair.second->chunkPosition;//world pos
-
-        for (int bx = -1; bx <= 1; bx++) {//check a 3x3x3 block area for collision
-            for (int by = -1; by <= 1; by++) {
-                for (int bz = -1; bz <= 1; bz++) {
-                    glm::vec3 blockWorldPos = glm::floor(newPos) + glm::vec3(bx, by, bz);
-                    int localX = static_cast<int>(blockWorldPos.x - chunkPos.x);
-                    int localY = static_cast<int>(blockWorldPos.y - chunkPos.y);
-                    int localZ = static_cast<int>(blockWorldPos.z - chunkPos.z);
-                    if (localX >= 0 && localX < Chunk::chunkSize &&
-                        localY >= 0 && localY < Chunk::chunkHeight &&
-                        localZ >= 0 && localZ < Chunk::chunkSize) {
-
-                        size_t index = pair.second->getBlockIndex(localX, localY, localZ);
-
-                        if (pair.second->blocks[index] != BlockType::AIR) {
-                            AABB blockBox = {
-                                chunkPos + glm::vec3(localX, localY, localZ),
-                                chunkPos + glm::vec3(localX + 1, localY + 1, localZ + 1)
-                            };
-                            if (intersects(playerBox, blockBox)) {
-                                if (velocity.z > 0) {
-                                    newPos.z = blockBox.min.z - playerAABB.max.z - 0.001f;
-                                }
-                                else if (velocity.z < 0) {
-                                    newPos.z = blockBox.max.z - playerAABB.min.z + 0.001f;
-                                }
-                                velocity.z = 0.0f;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // Step 3: Resolve Y-axis
-    newPos.y += velocity.y * deltaTime;
-    playerBox = { newPos + playerAABB.min, newPos + playerAABB.max };
-    for (const auto& pair : nearbyChunks) {//for overlapping chunks
-        glm::vec3 chunkPos = pair.second->chunkPosition;//world pos
-
-        for (int bx = -1; bx <= 1; bx++) {//check a 3x3x3 block area for collision
-            for (int by = -1; by <= 1; by++) {
-                for (int bz = -1; bz <= 1; bz++) {
-                    glm::vec3 blockWorldPos = glm::floor(newPos) + glm::vec3(bx, by, bz);
-                    int localX = static_cast<int>(blockWorldPos.x - chunkPos.x);
-                    int localY = static_cast<int>(blockWorldPos.y - chunkPos.y);
-                    int localZ = static_cast<int>(blockWorldPos.z - chunkPos.z);
-                    if (localX >= 0 && localX < Chunk::chunkSize &&
-                        localY >= 0 && localY < Chunk::chunkHeight &&
-                        localZ >= 0 && localZ < Chunk::chunkSize) {
-
-                        size_t index = pair.second->getBlockIndex(localX, localY, localZ);
-
-                        if (pair.second->blocks[index] != BlockType::AIR) {
-                            AABB blockBox = {
-                                chunkPos + glm::vec3(localX, localY, localZ),
-                                chunkPos + glm::vec3(localX + 1, localY + 1, localZ + 1)
-                            };
-                            if (intersects(playerBox, blockBox)) {
-                                if (velocity.y < 0) { // Falling
-                                    newPos.y = blockBox.max.y - playerAABB.min.y + 0.001f;
-                                     
-                                    grounded = true; 
-                                }
-                                else if (velocity.y > 0) { // Jumping 
-                                    newPos.y = blockBox.min.y - playerAABB.max.y - 0.001f; 
-                                     
-                                }
-                               
-                                velocity.y = 0.0f;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
+    // Move through the blocks, x then z then y, sliding along whatever is hit
+    BoxMove move = world->moveBox(bodyPos, playerAABB, velocity, deltaTime);
+    velocity = move.velocity;
+    grounded = move.grounded;
 
     // Update position
-    bodyPos = newPos;
+    bodyPos = move.position;
     cameraPos = bodyPos + glm::vec3(0.0f, eyeLevel, 0.0f);  // Recalculate the camera position as an offset
     
 }
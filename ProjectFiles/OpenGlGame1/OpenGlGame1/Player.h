@@ -3,31 +3,38 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include "Chunk.h"
+#include "VoxelCollision.h"
 
 #include<unordered_map>
 #include "Vec3Hash.h"
 
+class World;//forward declaration
+
 #define GRAVITY -21.0f//as a downwards force
 #define JUMP_HEIGHT 1.2f
 #define SPRINT_SPEED 1.4f
 #define BASE_SPEED 8.0f
 
-//players bounding box(collsisions)
-struct AABB {
-	glm::vec3 min;
-	glm::vec3 max;
-
-	AABB(const glm::vec3& min, const glm::vec3& max) : min(min), max(max) {} 
+//one frame of input, filled by main from glfw or scripted by headless tools
+struct PlayerInput {
+	bool forward = false;
+	bool back = false;
+	bool left = false;
+	bool right = false;
+	bool jump = false;
+	bool sprint = false;
+	float lookX = 0.0f;//mouse movement since last frame
+	float lookY = 0.0f;
 };
  
 class Player
 {
 public:
 
-	Player(GLFWwindow* window, Main* main);
+	Player(World* world);
 	
 	void spawn(glm::vec3 spawnPos); 
-	void update(float deltaTime, const std::unordered_map<uint64_t, Chunk>& chunks);
+	void update(float deltaTime, const PlayerInput& input);
 
 	// Getters for rendering
 	glm::vec3 getCameraPos() const { return cameraPos; }
@@ -39,13 +46,10 @@ public:
 	
 
 private:
-	void processMouseMovement(GLFWwindow* window, double xpos, double ypos);
-	void playerMovement(float deltaTime, const std::unordered_map<uint64_t, Chunk>& chunks);
-
-	GLFWwindow* window;	
+	void processMouseMovement(float xoffset, float yoffset);
+	void playerMovement(float deltaTime, const PlayerInput& input);
 
 	// camera
-	bool firstMouse;//used to ignore the mouses 1st frame to stop a large jump
 	glm::vec3 cameraPos = glm::vec3(0.0f, 120.0f, 3.0f);
 	glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
 	glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
@@ -56,9 +60,6 @@ private:
 
 	const float lookSens = 0.1f;
 
-	//mouse movement
-	float lastX = 400, lastY = 300;
-
 	//movement
 	glm::vec3 bodyPos;
 	float eyeLevel = 1.6f;
@@ -68,6 +69,6 @@ private:
 	AABB playerAABB = { glm::vec3(-0.3f, 0.0f, -0.3f), glm::vec3(0.3f, 1.8f, 0.3f) }; // Example size 
 	bool grounded;
 
-	Main* main;
+	World* world;
 };
 
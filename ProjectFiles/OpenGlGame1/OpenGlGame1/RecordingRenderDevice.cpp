@@ -0,0 +1,317 @@
+#include "RecordingRenderDevice.h"
+
+void RecordingRenderDevice::endFrame() {
+    history.push_back(current);
+    current = RenderFrameStats();
+    recorded.clear();
+}
+
+void RecordingRenderDevice::record(RecordedCall call, unsigned int handle, size_t bytes, size_t count) {
+    if (keepCommands) {
+        recorded.push_back({ call, handle, bytes, count });
+    }
+}
+
+void RecordingRenderDevice::recordState(RecordedCall call, unsigned int handle) {
+    current.stateChanges++;
+    record(call, handle);
+}
+
+//fnv-1a over everything a draw reads that a state cache could get wrong
+void RecordingRenderDevice::hashDrawState(size_t indexCount) {
+    uint64_t hash = current.drawState ? current.drawState : 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    mix(currentFramebuffer);
+    mix(currentProgram);
+    mix(currentVertexArray);
+    for (const auto& bound : boundTextures) {
+        mix(bound.first);
+        mix(bound.second);
+    }
+    for (const auto& bound : boundUniformBuffers) {
+        mix(bound.first);
+        mix(bound.second);
+    }
+    mix(enabledCaps);
+    mix(depthFunc);
+    mix(depthMask);
+    for (int i = 0; i < 4; i++) mix(static_cast<uint32_t>(viewport[i]));
+    if (enabledCaps & (1u << static_cast<unsigned int>(RenderCap::ScissorTest))) {
+        for (int i = 0; i < 4; i++) mix(static_cast<uint32_t>(scissor[i]));
+    }
+    mix(indexCount);
+    current.drawState = hash;
+}
+
+void RecordingRenderDevice::recordUniform(int location, size_t bytes) {
+    if (location < 0) return;//same as gl, -1 is silently ignored
+    if (currentProgram == 0) current.invalidCalls++;
+    current.uniformUploads++;
+    current.uniformBytes += bytes;
+    record(RecordedCall::Uniform, location, bytes);
+}
+
+unsigned int RecordingRenderDevice::createVertexArray() {
+    record(RecordedCall::CreateResource, nextHandle);
+    return nextHandle++;
+}
+
+void RecordingRenderDevice::deleteVertexArray(unsigned int vertexArray) {
+    if (vertexArray == 0) return;
+    if (currentVertexArray == vertexArray) currentVertexArray = 0;
+    record(RecordedCall::DeleteResource, vertexArray);
+}
+
+unsigned int RecordingRenderDevice::createBuffer() {
+    bufferSizes[nextHandle] = 0;
+    record(RecordedCall::CreateResource, nextHandle);
+    return nextHandle++;
+}
+
+void RecordingRenderDevice::deleteBuffer(unsigned int buffer) {
+    auto it = bufferSizes.find(buffer);
+    if (it == bufferSizes.end()) return;
+    for (auto& bound : boundUniformBuffers) {
+        if (bound.second == buffer) bound.second = 0;//gl unbinds deleted objects
+    }
+    bufferBytesTotal -= it->second;
+    bufferSizes.erase(it);
+    record(RecordedCall::DeleteResource, buffer);
+}
+
+void RecordingRenderDevice::bufferData(BufferTarget target, unsigned int buffer, size_t bytes, const void* data, BufferUsage usage) {
+    auto it = bufferSizes.find(buffer);
+    if (it == bufferSizes.end()) {
+        current.invalidCalls++;
+        return;
+    }
+    bufferBytesTotal += bytes - it->second;//buffer data replaces the whole store
+    it->second = bytes;
+
+    if (data) {
+        current.bufferUploads++;
+        current.bufferBytes += bytes;
+    }
+    record(RecordedCall::BufferData, buffer, data ? bytes : 0);
+}
+
+void RecordingRenderDevice::bufferSubData(unsigned int buffer, size_t offset, size_t bytes, const void* data) {
+    auto it = bufferSizes.find(buffer);
+    if (it == bufferSizes.end() || offset + bytes > it->second) {
+        current.invalidCalls++;
+        return;
+    }
+    current.bufferUploads++;
+    current.bufferBytes += bytes;
+    record(RecordedCall::BufferSubData, buffer, bytes);
+}
+
+void RecordingRenderDevice::copyBufferData(unsigned int source, unsigned int destination, size_t sourceOffset, size_t destinationOffset, size_t bytes) {
+    auto from = bufferSizes.find(source);
+    auto to = bufferSizes.find(destination);
+    bool overlaps = source == destination && sourceOffset < destinationOffset + bytes && destinationOffset < sourceOffset + bytes;
+    if (from == bufferSizes.end() || to == bufferSizes.end() || sourceOffset + bytes > from->second
+        || destinationOffset + bytes > to->second || overlaps) {
+        current.invalidCalls++;
+        return;
+    }
+    current.bufferCopies++;
+    current.copyBytes += bytes;
+    record(RecordedCall::CopyBuffer, destination, bytes);
+}
+
+void RecordingRenderDevice::vertexAttrib(const VertexAttrib& attrib) {
+    if (currentVertexArray == 0) current.invalidCalls++;
+    recordState(RecordedCall::VertexAttrib, attrib.index);
+}
+
+unsigned int RecordingRenderDevice::createTexture(const TextureDesc& desc, const void* pixels) {
+    size_t texelSize = desc.format == TextureFormat::RGB ? 3 : 4;//depth is a 32 bit float
+    size_t bytes = static_cast<size_t>(desc.width) * desc.height * texelSize;
+    if (pixels) {
+        current.textureUploads++;
+        current.textureBytes += bytes;
+    }
+    record(RecordedCall::TextureData, nextHandle, pixels ? bytes : 0);
+    textureSizes[nextHandle] = bytes;
+    textureBytesTotal += bytes;
+    return nextHandle++;
+}
+
+void RecordingRenderDevice::deleteTexture(unsigned int texture) {
+    if (texture == 0) return;
+    for (auto& bound : boundTextures) {
+        if (bound.second == texture) bound.second = 0;
+    }
+    auto it = textureSizes.find(texture);
+    if (it != textureSizes.end()) {
+        textureBytesTotal -= it->second;
+        textureSizes.erase(it);
+    }
+    record(RecordedCall::DeleteResource, texture);
+}
+
+unsigned int RecordingRenderDevice::createBufferTexture(unsigned int buffer) {
+    if (bufferSizes.find(buffer) == bufferSizes.end()) current.invalidCalls++;
+    record(RecordedCall::CreateResource, nextHandle);
+    return nextHandle++;
+}
+
+unsigned int RecordingRenderDevice::createDepthTarget(unsigned int depthTexture) {
+    record(RecordedCall::CreateResource, nextHandle);
+    return nextHandle++;
+}
+
+void RecordingRenderDevice::deleteFramebuffer(unsigned int framebuffer) {
+    if (framebuffer == 0) return;
+    if (currentFramebuffer == framebuffer) currentFramebuffer = 0;
+    record(RecordedCall::DeleteResource, framebuffer);
+}
+
+unsigned int RecordingRenderDevice::createProgram(const std::string& vertexPath, const std::string& fragmentPath) {
+    uniformLocations[nextHandle];
+    record(RecordedCall::CreateResource, nextHandle);
+    return nextHandle++;
+}
+
+int RecordingRenderDevice::getUniformLocation(unsigned int program, const char* name) {
+    current.uniformLookups++;
+    auto it = uniformLocations.find(program);
+    if (it == uniformLocations.end()) return -1;
+
+    //no shader source to reflect, so every name exists and gets the next free slot
+    auto& locations = it->second;
+    auto found = locations.find(name);
+    if (found != locations.end()) return found->second;
+    int location = static_cast<int>(locations.size());
+    locations[name] = location;
+    return location;
+}
+
+//every block exists for the same reason every uniform does
+bool RecordingRenderDevice::bindUniformBlock(unsigned int program, const char* block, unsigned int binding) {
+    return uniformLocations.find(program) != uniformLocations.end();
+}
+
+void RecordingRenderDevice::bindFramebuffer(unsigned int framebuffer) {
+    currentFramebuffer = framebuffer;
+    recordState(RecordedCall::BindFramebuffer, framebuffer);
+}
+
+void RecordingRenderDevice::setViewport(int x, int y, int width, int height) {
+    viewport[0] = x;
+    viewport[1] = y;
+    viewport[2] = width;
+    viewport[3] = height;
+    recordState(RecordedCall::Viewport);
+}
+
+void RecordingRenderDevice::setScissor(int x, int y, int width, int height) {
+    scissor[0] = x;
+    scissor[1] = y;
+    scissor[2] = width;
+    scissor[3] = height;
+    recordState(RecordedCall::Scissor);
+}
+
+void RecordingRenderDevice::setClearColour(const glm::vec4& colour) {
+    recordState(RecordedCall::ClearColour);
+}
+
+void RecordingRenderDevice::clear(bool colour, bool depth) {
+    recordState(RecordedCall::Clear);
+}
+
+void RecordingRenderDevice::setEnabled(RenderCap cap, bool enabled) {
+    unsigned int bit = 1u << static_cast<unsigned int>(cap);
+    enabledCaps = enabled ? enabledCaps | bit : enabledCaps & ~bit;
+    recordState(RecordedCall::Enable, static_cast<unsigned int>(cap));
+}
+
+void RecordingRenderDevice::setDepthFunc(DepthFunc func) {
+    depthFunc = static_cast<unsigned int>(func);
+    recordState(RecordedCall::DepthFunc, static_cast<unsigned int>(func));
+}
+
+void RecordingRenderDevice::setDepthMask(bool write) {
+    depthMask = write ? 1 : 0;
+    recordState(RecordedCall::DepthMask, write ? 1 : 0);
+}
+
+void RecordingRenderDevice::useProgram(unsigned int program) {
+    currentProgram = program;
+    recordState(RecordedCall::UseProgram, program);
+}
+
+void RecordingRenderDevice::bindVertexArray(unsigned int vertexArray) {
+    currentVertexArray = vertexArray;
+    recordState(RecordedCall::BindVertexArray, vertexArray);
+}
+
+void RecordingRenderDevice::bindTexture(unsigned int unit, unsigned int texture) {
+    boundTextures[unit * 2] = texture;
+    recordState(RecordedCall::BindTexture, texture);
+}
+
+void RecordingRenderDevice::bindBufferTexture(unsigned int unit, unsigned int texture) {
+    boundTextures[unit * 2 + 1] = texture;
+    recordState(RecordedCall::BindTexture, texture);
+}
+
+void RecordingRenderDevice::bindUniformBuffer(unsigned int binding, unsigned int buffer) {
+    if (buffer != 0 && bufferSizes.find(buffer) == bufferSizes.end()) current.invalidCalls++;
+    boundUniformBuffers[binding] = buffer;
+    recordState(RecordedCall::BindUniformBuffer, buffer);
+}
+
+void RecordingRenderDevice::setUniform(int location, int value) {
+    recordUniform(location, sizeof(int));
+}
+
+void RecordingRenderDevice::setUniform(int location, const glm::vec3& value) {
+    recordUniform(location, sizeof(glm::vec3));
+}
+
+void RecordingRenderDevice::setUniform(int location, const glm::vec4& value) {
+    recordUniform(location, sizeof(glm::vec4));
+}
+
+void RecordingRenderDevice::setUniform(int location, const glm::mat4& value) {
+    recordUniform(location, sizeof(glm::mat4));
+}
+
+void RecordingRenderDevice::drawIndexed(Primitive primitive, size_t indexCount, size_t firstIndex, int baseVertex) {
+    if (currentProgram == 0 || currentVertexArray == 0) current.invalidCalls++;
+    current.drawCalls++;
+    current.drawRanges++;
+    current.indices += indexCount;
+    hashDrawState(indexCount);
+    record(RecordedCall::Draw, currentVertexArray, 0, indexCount);
+}
+
+void RecordingRenderDevice::multiDrawIndexed(Primitive primitive, const int* indexCounts, const size_t* firstIndices, const int* baseVertices, size_t drawCount) {
+    if (currentProgram == 0 || currentVertexArray == 0) current.invalidCalls++;
+    size_t indexCount = 0;
+    for (size_t i = 0; i < drawCount; i++) {
+        if (indexCounts[i] < 0 || baseVertices[i] < 0) current.invalidCalls++;
+        indexCount += indexCounts[i];
+    }
+    current.drawCalls++;
+    current.drawRanges += drawCount;
+    current.indices += indexCount;
+    hashDrawState(indexCount);
+    record(RecordedCall::Draw, currentVertexArray, 0, indexCount);
+}
+
+void RecordingRenderDevice::drawIndexedInstanced(Primitive primitive, size_t indexCount, size_t firstIndex, size_t instanceCount) {
+    if (currentProgram == 0 || currentVertexArray == 0) current.invalidCalls++;
+    current.drawCalls++;
+    current.drawRanges++;
+    current.instances += instanceCount;
+    current.indices += indexCount * instanceCount;
+    hashDrawState(indexCount * instanceCount);
+    record(RecordedCall::Draw, currentVertexArray, 0, indexCount * instanceCount);
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <cstdint>
+#include <string>
+#include "RenderDevice.h"
+
+//what one frame asked of the gpu
+struct RenderFrameStats {
+	size_t drawCalls = 0;
+	size_t drawRanges = 0;//meshes drawn, a multi draw is one call but many ranges
+	size_t instances = 0;//copies drawn by instanced draws, each of those is one call and one range
+	size_t indices = 0;
+	size_t bufferUploads = 0;
+	size_t bufferBytes = 0;
+	size_t bufferCopies = 0;//gpu to gpu, not counted as uploads
+	size_t copyBytes = 0;
+	size_t textureUploads = 0;
+	size_t textureBytes = 0;
+	size_t uniformUploads = 0;
+	size_t uniformBytes = 0;
+	size_t uniformLookups = 0;//getUniformLocation calls, string work the frame loop should never do
+	size_t stateChanges = 0;//binds, enables, viewport, clears, program switches
+	size_t invalidCalls = 0;//draws or uniforms with nothing bound, out of range or overlapping copies, would be gl errors on a real device
+	uint64_t drawState = 0;//hash of the bound state and index count at every draw in order, two frames match when every draw saw the same state
+
+	size_t uploadBytes() const { return bufferBytes + textureBytes; }
+};
+
+enum class RecordedCall {
+	CreateResource, DeleteResource, BufferData, BufferSubData, CopyBuffer, VertexAttrib, TextureData,
+	BindFramebuffer, Viewport, Scissor, ClearColour, Clear, Enable, DepthFunc, DepthMask,
+	UseProgram, BindVertexArray, BindTexture, BindUniformBuffer, Uniform, Draw
+};
+
+struct RecordedCommand {
+	RecordedCall call;
+	unsigned int handle;//buffer, texture, program, vertex array or uniform location the call was about
+	size_t bytes;//bytes uploaded, 0 for calls that upload nothing
+	size_t count;//index count for draws
+};
+
+//null backend: no gpu work at all, just hands out ids and records every call with its byte count
+//a frame is everything since the previous endFrame, so uploads done between frames count towards the frame they feed
+class RecordingRenderDevice : public RenderDevice
+{
+public:
+	bool keepCommands = true;//false only keeps the stats, for long runs
+
+	void endFrame() override;
+
+	const RenderFrameStats& frameStats() const { return current; }//frame in progress, or the last one after endFrame
+	const std::vector<RenderFrameStats>& frameHistory() const { return history; }
+	const std::vector<RecordedCommand>& commands() const { return recorded; }
+	size_t residentBufferBytes() const { return bufferBytesTotal; }//size of every live buffer, like gpu memory use
+	size_t liveBuffers() const { return bufferSizes.size(); }
+	size_t residentTextureBytes() const { return textureBytesTotal; }//same for textures, mipmaps not counted
+
+	unsigned int createVertexArray() override;
+	void deleteVertexArray(unsigned int vertexArray) override;
+	unsigned int createBuffer() override;
+	void deleteBuffer(unsigned int buffer) override;
+	void bufferData(BufferTarget target, unsigned int buffer, size_t bytes, const void* data, BufferUsage usage) override;
+	void bufferSubData(unsigned int buffer, size_t offset, size_t bytes, const void* data) override;
+	void copyBufferData(unsigned int source, unsigned int destination, size_t sourceOffset, size_t destinationOffset, size_t bytes) override;
+	void vertexAttrib(const VertexAttrib& attrib) override;
+
+	unsigned int createTexture(const TextureDesc& desc, const void* pixels) override;
+	void deleteTexture(unsigned int texture) override;
+	unsigned int createBufferTexture(unsigned int buffer) override;
+	unsigned int createDepthTarget(unsigned int depthTexture) override;
+	void deleteFramebuffer(unsigned int framebuffer) override;
+
+	unsigned int createProgram(const std::string& vertexPath, const std::string& fragmentPath) override;
+	int getUniformLocation(unsigned int program, const char* name) override;
+	bool bindUniformBlock(unsigned int program, const char* block, unsigned int binding) override;
+
+	void bindFramebuffer(unsigned int framebuffer) override;
+	void setViewport(int x, int y, int width, int height) override;
+	void setScissor(int x, int y, int width, int height) override;
+	void setClearColour(const glm::vec4& colour) override;
+	void clear(bool colour, bool depth) override;
+	void setEnabled(RenderCap cap, bool enabled) override;
+	void setDepthFunc(DepthFunc func) override;
+	void setDepthMask(bool write) override;
+
+	void useProgram(unsigned int program) override;
+	void bindVertexArray(unsigned int vertexArray) override;
+	void bindTexture(unsigned int unit, unsigned int texture) override;
+	void bindBufferTexture(unsigned int unit, unsigned int texture) override;
+	void bindUniformBuffer(unsigned int binding, unsigned int buffer) override;
+
+	void setUniform(int location, int value) override;
+	void setUniform(int location, const glm::vec3& value) override;
+	void setUniform(int location, const glm::vec4& value) override;
+	void setUniform(int location, const glm::mat4& value) override;
+
+	void drawIndexed(Primitive primitive, size_t indexCount, size_t firstIndex, int baseVertex) override;
+	void multiDrawIndexed(Primitive primitive, const int* indexCounts, const size_t* firstIndices, const int* baseVertices, size_t drawCount) override;
+	void drawIndexedInstanced(Primitive primitive, size_t indexCount, size_t firstIndex, size_t instanceCount) override;
+
+private:
+	unsigned int nextHandle = 1;
+	unsigned int currentProgram = 0;
+	unsigned int currentVertexArray = 0;
+
+	//the rest of the bound state, only read by drawState
+	unsigned int currentFramebuffer = 0;
+	std::map<unsigned int, unsigned int> boundTextures;//unit * 2 + 1 for buffer textures, to texture
+	std::map<unsigned int, unsigned int> boundUniformBuffers;//binding to buffer
+	unsigned int enabledCaps = 0;//bit per RenderCap
+	unsigned int depthFunc = 0, depthMask = 1;
+	int viewport[4] = {}, scissor[4] = {};
+	void hashDrawState(size_t indexCount);
+
+	RenderFrameStats current;
+	std::vector<RenderFrameStats> history;
+	std::vector<RecordedCommand> recorded;
+
+	std::unordered_map<unsigned int, size_t> bufferSizes;
+	size_t bufferBytesTotal = 0;
+	std::unordered_map<unsigned int, size_t> textureSizes;
+	size_t textureBytesTotal = 0;
+	std::unordered_map<unsigned int, std::unordered_map<std::string, int>> uniformLocations;//per program
+
+	void record(RecordedCall call, unsigned int handle = 0, size_t bytes = 0, size_t count = 0);
+	void recordState(RecordedCall call, unsigned int handle = 0);
+	void recordUniform(int location, size_t bytes);
+};
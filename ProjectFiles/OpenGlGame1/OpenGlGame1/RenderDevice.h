@@ -0,0 +1,98 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+#include <cstddef>
+
+//everything the renderer asks the gpu to do goes through this, so the frame can run against real gl
+//(GLRenderDevice) or without any gpu at all (RecordingRenderDevice, used by HeadlessBench and ci)
+//handles are plain ids like gl names, 0 always means none / the default framebuffer
+
+enum class BufferTarget { Vertex, Index, Texture, Uniform };//texture = storage for a buffer texture, uniform = for uniform blocks
+enum class BufferUsage { Static, Dynamic };
+enum class AttribType { Short, UnsignedShort, Int, UnsignedInt, Float };
+enum class Primitive { Triangles, Lines };
+enum class RenderCap { CullFace, DepthTest, Blend, ScissorTest };//blend is always src alpha, 1 - src alpha
+enum class DepthFunc { Less, LessEqual };
+
+enum class TextureFormat { RGB, RGBA, Depth };
+enum class TextureFilter { Nearest, Linear };
+enum class TextureWrap { ClampToEdge, ClampToBorder, Repeat };//border colour is white, only used by the shadow map
+
+struct TextureDesc {
+	int width = 1, height = 1;
+	TextureFormat format = TextureFormat::RGBA;
+	TextureFilter filter = TextureFilter::Linear;
+	TextureWrap wrap = TextureWrap::Repeat;
+	bool mipmaps = false;
+};
+
+//one vertex attribute read from the currently bound vertex buffer into the currently bound vertex array
+struct VertexAttrib {
+	unsigned int index;
+	int components;
+	AttribType type;
+	bool integer;//true keeps ints as ints in the shader (glVertexAttribIPointer), false converts to float
+	size_t stride;
+	size_t offset;
+	unsigned int divisor = 0;//0 reads per vertex, 1 per instance
+};
+
+class RenderDevice
+{
+public:
+	virtual ~RenderDevice() {}
+
+	//resources
+	virtual unsigned int createVertexArray() = 0;
+	virtual void deleteVertexArray(unsigned int vertexArray) = 0;
+	virtual unsigned int createBuffer() = 0;
+	virtual void deleteBuffer(unsigned int buffer) = 0;
+	virtual void bufferData(BufferTarget target, unsigned int buffer, size_t bytes, const void* data, BufferUsage usage) = 0;//leaves buffer bound to target, null data just allocates
+	virtual void bufferSubData(unsigned int buffer, size_t offset, size_t bytes, const void* data) = 0;
+	virtual void copyBufferData(unsigned int source, unsigned int destination, size_t sourceOffset, size_t destinationOffset, size_t bytes) = 0;//gpu side, ranges must not overlap
+	virtual void vertexAttrib(const VertexAttrib& attrib) = 0;
+
+	virtual unsigned int createTexture(const TextureDesc& desc, const void* pixels) = 0;//pixels may be null
+	virtual void deleteTexture(unsigned int texture) = 0;
+	virtual unsigned int createBufferTexture(unsigned int buffer) = 0;//reads buffer as vec4 floats through a samplerBuffer
+	virtual unsigned int createDepthTarget(unsigned int depthTexture) = 0;//framebuffer with only a depth attachment, 0 on failure
+	virtual void deleteFramebuffer(unsigned int framebuffer) = 0;
+
+	virtual unsigned int createProgram(const std::string& vertexPath, const std::string& fragmentPath) = 0;//0 on failure
+	virtual int getUniformLocation(unsigned int program, const char* name) = 0;//-1 if the program has no such uniform, look up once and keep it
+	virtual bool bindUniformBlock(unsigned int program, const char* block, unsigned int binding) = 0;//false if the program has no such block
+
+	//state
+	virtual void bindFramebuffer(unsigned int framebuffer) = 0;
+	virtual void setViewport(int x, int y, int width, int height) = 0;
+	virtual void setScissor(int x, int y, int width, int height) = 0;//clears and draws stay inside it while ScissorTest is on
+	virtual void setClearColour(const glm::vec4& colour) = 0;
+	virtual void clear(bool colour, bool depth) = 0;
+	virtual void setEnabled(RenderCap cap, bool enabled) = 0;
+	virtual void setDepthFunc(DepthFunc func) = 0;
+	virtual void setDepthMask(bool write) = 0;
+
+	virtual void useProgram(unsigned int program) = 0;
+	virtual void bindVertexArray(unsigned int vertexArray) = 0;
+	virtual void bindTexture(unsigned int unit, unsigned int texture) = 0;
+	virtual void bindBufferTexture(unsigned int unit, unsigned int texture) = 0;
+	virtual void bindUniformBuffer(unsigned int binding, unsigned int buffer) = 0;//feeds every block bound to binding
+
+	//uniforms go to the program in use, location -1 is ignored like in gl
+	virtual void setUniform(int location, int value) = 0;
+	virtual void setUniform(int location, const glm::vec3& value) = 0;
+	virtual void setUniform(int location, const glm::vec4& value) = 0;
+	virtual void setUniform(int location, const glm::mat4& value) = 0;
+
+	//draws unsigned int indices from the bound vertex array, firstIndex counts indices not bytes
+	//baseVertex is added to every index, so meshes packed into one shared buffer keep their own 0 based indices
+	virtual void drawIndexed(Primitive primitive, size_t indexCount, size_t firstIndex, int baseVertex = 0) = 0;
+	//drawCount ranges of the bound vertex array in one call, same meaning per range as drawIndexed
+	virtual void multiDrawIndexed(Primitive primitive, const int* indexCounts, const size_t* firstIndices, const int* baseVertices, size_t drawCount) = 0;
+	//the same indices instanceCount times, attributes with a divisor step once per instance
+	virtual void drawIndexedInstanced(Primitive primitive, size_t indexCount, size_t firstIndex, size_t instanceCount) = 0;
+
+	//frame markers, the gl device rolls its call counts over at endFrame, the recording device uses them to split its stats
+	virtual void beginFrame() {}
+	virtual void endFrame() {}
+};
@@ -0,0 +1,645 @@
+#include "Renderer.h"
+#include <iostream>
+#define STB_IMAGE_IMPLEMENTATION  // This tells stb to include the implementation
+#include "stb/stb_image.h"          // Path to the stb_image.h file
+#include <glm/gtc/matrix_transform.hpp>
+#include "ModelLoader.h"
+#include <thread>
+#include <algorithm>
+
+#define SUN_TILT glm::radians(70.0f)
+#define SUN_SPEED 0.1f
+
+Renderer::Renderer(RenderDevice& device, World& world)
+    : device(device), world(world), chunkArena(device, 1 << 20, 3 << 19) {//16mb of vertices, 6mb of indices to start
+}
+
+Renderer::~Renderer() {
+    std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+    for (auto& pair : world.chunks) {
+        releaseChunk(pair.second);
+    }
+}
+
+void Renderer::init() {
+    createShadowMap();
+    chunkArena.init();
+    //a few bands is plenty at 256x128, past that starting the threads costs more than they save
+    occlusion.setThreads(static_cast<int>(std::min(4u, std::max(1u, std::thread::hardware_concurrency()))));
+
+    //some opengl settings, back faces are culled and front faces are counterclockwise by default
+    device.setEnabled(RenderCap::CullFace, true);
+    device.setEnabled(RenderCap::DepthTest, true);
+
+    createSun();
+
+    //texture atlas for every block
+    TextureDesc atlasDesc;
+    atlasDesc.filter = TextureFilter::Nearest;
+    atlasDesc.wrap = TextureWrap::ClampToEdge;
+    atlasDesc.mipmaps = true;
+    texAtlas = loadTexture("../ResourceFiles/textureAtlas.png", atlasDesc);
+
+    createShaders();
+    createHighlight();
+    makeBasicModel();
+}
+
+void Renderer::createShaders() {
+    shader = device.createProgram("vertex_shader.glsl", "fragment_shader.glsl");
+    sunShader = device.createProgram("sunVertex.glsl", "sunFragment.glsl");
+    depthShader = device.createProgram("depth_vertex.glsl", "depth_fragment.glsl");
+    entityShader = device.createProgram("entity_vertex.glsl", "entity_fragment.glsl");
+
+    if (entityShader == 0) {
+        std::cerr << "Entity shader failed to compile/link" << std::endl;
+        exit(-1);
+    }
+    if (sunShader == 0) {
+        std::cerr << "Sun shader failed to compile/link" << std::endl;
+    }
+
+    //view, projection, sun, camera and cascades come from one uniform buffer every program reads
+    frameUniformBuffer = device.createBuffer();
+    device.bufferData(BufferTarget::Uniform, frameUniformBuffer, sizeof(FrameUniforms), nullptr, BufferUsage::Dynamic);
+    device.bindUniformBuffer(FRAME_BLOCK, frameUniformBuffer);
+    for (unsigned int program : { shader, sunShader, entityShader, depthShader }) {
+        if (!device.bindUniformBlock(program, "FrameData", FRAME_BLOCK) && program != depthShader) {
+            std::cerr << "FrameData uniform block not found in a shader" << std::endl;
+        }
+    }
+
+    //chunk shader
+    modelLocation = device.getUniformLocation(shader, "model");
+    textureLocation = device.getUniformLocation(shader, "ourTexture");
+    lightColourLoc = device.getUniformLocation(shader, "lightColour");
+    lightPosLoc = device.getUniformLocation(shader, "lightPos"); // New
+    originsLoc = device.getUniformLocation(shader, "chunkOrigins");
+    useChunkOriginLoc = device.getUniformLocation(shader, "useChunkOrigin");
+
+    //sun shader
+    sunColourLoc = device.getUniformLocation(sunShader, "sunColour");
+
+    //entity shader, the model matrix is a per instance attribute
+    entityTextureLoc = device.getUniformLocation(entityShader, "texture0");
+
+    if (entityTextureLoc == -1) {
+        std::cerr << "Texture uniform 'texture0' not found in entity shader" << std::endl;
+    }
+
+    //shadow shader
+    lightSpaceLoc = device.getUniformLocation(depthShader, "lightSpaceMatrix");
+    shadowMapLoc = device.getUniformLocation(shader, "shadowMap");
+    depthOriginsLoc = device.getUniformLocation(depthShader, "chunkOrigins");
+
+    if (lightSpaceLoc == -1) {
+        std::cerr << "Uniform 'lightSpaceMatrix' not found in depth shader" << std::endl;
+    }
+}
+
+void Renderer::createShadowMap() {
+    if (depthMapSize != 0) {
+        device.deleteFramebuffer(depthMapFBO);
+        device.deleteTexture(depthMap);
+    }
+    depthMapSize = ShadowCascades::atlasSize(shadowSettings);
+
+    TextureDesc depthDesc;
+    depthDesc.width = depthDesc.height = depthMapSize;
+    depthDesc.format = TextureFormat::Depth;
+    depthDesc.filter = TextureFilter::Nearest;
+    depthDesc.wrap = TextureWrap::ClampToBorder;
+    depthMap = device.createTexture(depthDesc, nullptr);
+
+    depthMapFBO = device.createDepthTarget(depthMap);
+    if (depthMapFBO == 0) {
+        std::cerr << "Shadow map framebuffer incomplete" << std::endl;
+        exit(-1); // Or handle gracefully
+    }
+}
+
+void Renderer::createHighlight() {
+    float vertices[] = {
+        -0.51f, -0.51f, -0.51f,  0.51f, -0.51f, -0.51f,
+         0.51f,  0.51f, -0.51f, -0.51f,  0.51f, -0.51f,
+        -0.51f, -0.51f,  0.51f,  0.51f, -0.51f,  0.51f,
+         0.51f,  0.51f,  0.51f, -0.51f,  0.51f,  0.51f
+    };
+    unsigned int indices[] = {
+        0, 1, 1, 2, 2, 3, 3, 0, // Bottom face
+        4, 5, 5, 6, 6, 7, 7, 4, // Top face
+        0, 4, 1, 5, 2, 6, 3, 7  // Sides
+    };
+
+    highlightVAO = device.createVertexArray();
+    highlightVBO = device.createBuffer();
+    highlightEBO = device.createBuffer();
+
+    device.bindVertexArray(highlightVAO);
+    device.bufferData(BufferTarget::Vertex, highlightVBO, sizeof(vertices), vertices, BufferUsage::Static);
+    device.bufferData(BufferTarget::Index, highlightEBO, sizeof(indices), indices, BufferUsage::Static);
+    device.vertexAttrib({ 0, 3, AttribType::Float, false, 3 * sizeof(float), 0 });
+    device.bindVertexArray(0);
+}
+
+void Renderer::createSun() {
+    // Vertex data for sun quad
+    float sunVertices[] = {
+        -0.5f,  0.5f,  0.0f, 1.0f, // Top-left
+         0.5f,  0.5f,  1.0f, 1.0f, // Top-right
+         0.5f, -0.5f,  1.0f, 0.0f, // Bottom-right
+        -0.5f, -0.5f,  0.0f, 0.0f  // Bottom-left
+    };
+    unsigned int sunIndices[] = { 0, 3, 2, 2, 1, 0 };//reversed winding order
+
+    sunVAO = device.createVertexArray();
+    sunVBO = device.createBuffer();
+    sunEBO = device.createBuffer();
+
+    device.bindVertexArray(sunVAO);
+    device.bufferData(BufferTarget::Vertex, sunVBO, sizeof(sunVertices), sunVertices, BufferUsage::Static);
+    device.bufferData(BufferTarget::Index, sunEBO, sizeof(sunIndices), sunIndices, BufferUsage::Static);
+    device.vertexAttrib({ 0, 2, AttribType::Float, false, 4 * sizeof(float), 0 });
+    device.vertexAttrib({ 1, 2, AttribType::Float, false, 4 * sizeof(float), 2 * sizeof(float) });
+    device.bindVertexArray(0);
+}
+
+void Renderer::renderShadowMap(int width, int height) {
+    if (ShadowCascades::atlasSize(shadowSettings) != depthMapSize) createShadowMap();
+    device.bindFramebuffer(depthMapFBO);
+    device.setDepthMask(true); // Ensure depth writes are enabled
+    device.useProgram(depthShader);
+    device.setUniform(depthOriginsLoc, static_cast<int>(ORIGIN_UNIT));
+    shadowStats = ShadowStats();
+
+    if (shadowSettings.cached) {
+        //only the tiles that scrolled in or went stale, each cleared and drawn inside its own slot
+        int slotSize = shadowSettings.resolution / shadowSettings.tilesPerSide;
+        device.setEnabled(RenderCap::ScissorTest, true);
+        for (const ShadowCascades::Tile& tile : shadowCascades.dirtyTiles()) {
+            glm::ivec2 corner = ShadowCascades::tileOf(tile.cascade) * shadowSettings.resolution + tile.slot * slotSize;
+            device.setViewport(corner.x, corner.y, slotSize, slotSize);
+            device.setScissor(corner.x, corner.y, slotSize, slotSize);
+            device.clear(false, true);
+            device.setUniform(lightSpaceLoc, tile.lightSpace);
+            drawShadowCasters(tile.casters);
+        }
+        device.setEnabled(RenderCap::ScissorTest, false);
+    }
+    else {
+        //every cascade into its own tile of the atlas, cleared together
+        device.setViewport(0, 0, depthMapSize, depthMapSize);
+        device.clear(false, true);
+        for (int i = 0; i < shadowCascades.count(); i++) {
+            const ShadowCascades::Cascade& cascade = shadowCascades.cascade(i);
+            glm::ivec2 tile = ShadowCascades::tileOf(i) * shadowSettings.resolution;
+            device.setViewport(tile.x, tile.y, shadowSettings.resolution, shadowSettings.resolution);
+            device.setUniform(lightSpaceLoc, cascade.lightSpace);
+            drawShadowCasters(cascade.casters);
+        }
+    }
+    device.bindFramebuffer(0);
+
+    //clear screen for main pass
+    device.setViewport(0, 0, width, height);
+    device.clear(true, true);
+    device.bindTexture(0, 0);
+}
+
+//only what can shade the pass's region, the rest would be clipped or fall on nothing drawn
+void Renderer::drawShadowCasters(const Frustum& casters) {
+    shadowStats.passes++;
+    if (sectionCulling) {
+        visibleRecords.clear();
+        chunkTree.cull(casters, visibleRecords);
+        shadowStats.casters += visibleRecords.size();
+        //gl culls back faces here too, so faces turned from the light never write depth
+        if (faceBucketCulling)
+            drawList.buildFacingDirection(chunkRecords, chunkArena, visibleRecords, lightForward);
+        else
+            drawList.build(chunkRecords, chunkArena, visibleRecords);
+    }
+    else {
+        drawList.build(chunkRecords, chunkArena, nullptr);
+        shadowStats.casters += chunkRecords.size();
+    }
+    drawChunkList();
+}
+
+void Renderer::drawChunks(const glm::vec3& cameraPos, const glm::mat4& viewProj) {
+    device.useProgram(shader);
+    device.setUniform(modelLocation, glm::mat4(1.0f));//chunk positions come from the origin buffer
+    device.setUniform(useChunkOriginLoc, 1);
+    device.setUniform(originsLoc, static_cast<int>(ORIGIN_UNIT));
+
+    visibleRecords.clear();
+    chunkTree.cull(frustum, visibleRecords);
+    if (sectionCulling && caveCulling) cullCaves(cameraPos);
+    if (sectionCulling && occlusionCulling) cullOccluded(cameraPos, viewProj);
+    if (sectionCulling && faceBucketCulling)
+        drawList.buildFacing(chunkRecords, chunkArena, visibleRecords, cameraPos);
+    else
+        drawList.build(chunkRecords, chunkArena, visibleRecords);
+    drawChunkList();
+
+    device.setUniform(useChunkOriginLoc, 0);
+}
+
+//drops the visible records that are behind nearby solid terrain, keeps the order of the rest
+void Renderer::cullOccluded(const glm::vec3& cameraPos, const glm::mat4& viewProj) {
+    occlusionStats = OcclusionStats();
+    occlusion.begin(viewProj, cameraPos);
+    for (const auto& pair : chunkOccluders) {
+        if (pair.second.active) occlusionStats.occluders += occlusion.addOccluders(pair.second.boxes, frustum, OCCLUDER_DISTANCE);
+    }
+    occlusion.rasterize();
+    occlusionStats.triangles = occlusion.triangleCount();
+
+    size_t kept = 0;
+    for (uint32_t i : visibleRecords) {
+        glm::vec3 min(chunkRecords.minX[i], chunkRecords.minY[i], chunkRecords.minZ[i]);
+        glm::vec3 max(chunkRecords.maxX[i], chunkRecords.maxY[i], chunkRecords.maxZ[i]);
+        if (occlusion.isBoxVisible(min, max)) visibleRecords[kept++] = i;
+    }
+    occlusionStats.tested = visibleRecords.size();
+    occlusionStats.culled = visibleRecords.size() - kept;
+    visibleRecords.resize(kept);
+}
+
+//drops the visible records the camera cant see through air to, the list is left alone when the camera is outside the graph
+void Renderer::cullCaves(const glm::vec3& cameraPos) {
+    if (!sectionGraph.traverse(cameraPos, &frustum, world.renderDistance + 1)) return;
+    size_t kept = 0;
+    for (uint32_t i : visibleRecords) {
+        if (sectionGraph.isVisible(chunkRecords.owner(i), chunkRecords.sectionIndices[i])) visibleRecords[kept++] = i;
+    }
+    visibleRecords.resize(kept);
+}
+
+void Renderer::drawChunkList() {
+    if (drawList.empty()) return;
+    device.bindVertexArray(chunkArena.vertexArray());
+    device.bindBufferTexture(ORIGIN_UNIT, chunkArena.originTexture());
+    device.multiDrawIndexed(Primitive::Triangles, drawList.indexCounts(), drawList.firstIndices(), drawList.baseVertices(), drawList.size());
+    device.bindVertexArray(0);
+}
+
+void Renderer::renderSun() {
+
+    float sunAngle = glm::dot(-sunDirection, glm::vec3(0.0f, 1.0f, 0.0f));
+    float transitionFactor = (-sunAngle + 1.0f) * 0.5f;
+    glm::vec3 sunColour = glm::mix(glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(1.0f, 0.5f, 0.0f), transitionFactor);
+
+    device.useProgram(sunShader);
+
+    device.setUniform(sunColourLoc, sunColour);
+
+    device.setEnabled(RenderCap::Blend, true);
+
+    device.bindVertexArray(sunVAO);
+    device.drawIndexed(Primitive::Triangles, 6, 0);
+
+    device.bindVertexArray(0);
+    device.setEnabled(RenderCap::DepthTest, true);
+    device.setEnabled(RenderCap::Blend, false);
+    device.bindTexture(0, 0);
+}
+
+void Renderer::drawMobs() {
+    instanceBatcher.clear();
+
+    glm::mat4 beeTransform = glm::mat4(1.0f);
+    beeTransform = glm::translate(beeTransform, glm::vec3(0.0f, 35.0f, 0.0f));  // Translate to (0, 35, 0)
+    beeTransform = glm::scale(beeTransform, glm::vec3(10.0f));  // Scale by a factor of 10
+    instanceBatcher.add(beeModelGl.batch, beeTransform);
+
+    glm::mat4 boxTransform = glm::mat4(1.0f);
+    boxTransform = glm::translate(boxTransform, glm::vec3(15.0f, 35.0f, 0.0f));  // Translate to (0, 35, 0)
+    boxTransform = glm::scale(boxTransform, glm::vec3(1.0f));  // Scale by a factor of 10
+    instanceBatcher.add(cubeModelGl.batch, boxTransform);
+
+    glm::mat4 swordTrans = glm::mat4(1.0f);
+    swordTrans = glm::translate(swordTrans, glm::vec3(-15.0f, 35.0f, 0.0f));  // Translate to (0, 35, 0)
+    swordTrans = glm::scale(swordTrans, glm::vec3(4.0f));  // Scale by a factor of 10
+    instanceBatcher.add(swordModelGl.batch, swordTrans);
+
+    const EntityStore& entities = world.entities;
+    while (entityModelHandles.size() < entities.modelCount()) {
+        entityModelHandles.push_back(&getEntityModel(entities.modelPath(static_cast<uint32_t>(entityModelHandles.size()))));
+    }
+    for (size_t i = 0; i < entities.size(); i++) {
+        const ModelGL& model = *entityModelHandles[entities.models[i]];
+        if (model.VAO == 0 || model.indexCount == 0) continue;
+        instanceBatcher.add(model.batch, entities.modelMatrix(i));
+    }
+
+    //mob models arent closed or consistently wound, so no culling for any of them
+    device.useProgram(entityShader);
+    device.setUniform(entityTextureLoc, 0);
+    device.setEnabled(RenderCap::CullFace, false);
+    device.setDepthFunc(DepthFunc::LessEqual);
+
+    for (uint32_t batch = 0; batch < instanceBatcher.modelCount(); batch++) {
+        const std::vector<glm::mat4>& instances = instanceBatcher.instances(batch);
+        if (instances.empty()) continue;
+        const ModelGL& model = *instancedModels[batch];
+
+        //whole store replaced each frame, so the driver can hand back fresh memory instead of waiting on last frame's draw
+        device.bufferData(BufferTarget::Vertex, model.instanceBuffer, instances.size() * sizeof(glm::mat4), instances.data(), BufferUsage::Dynamic);
+        device.bindTexture(0, model.textureID);
+        device.bindVertexArray(model.VAO);
+        device.drawIndexedInstanced(Primitive::Triangles, model.indexCount, 0, instances.size());
+    }
+    device.bindVertexArray(0);
+
+    device.setEnabled(RenderCap::CullFace, true);
+    device.setDepthFunc(DepthFunc::Less);
+}
+
+//per instance model matrix as four vec4 columns, every model gets its own buffer so each draw starts at instance 0
+void Renderer::addInstanceLayout(ModelGL& model) {
+    model.instanceBuffer = device.createBuffer();
+    device.bufferData(BufferTarget::Vertex, model.instanceBuffer, sizeof(glm::mat4), nullptr, BufferUsage::Dynamic);
+    for (unsigned int column = 0; column < 4; column++) {
+        device.vertexAttrib({ INSTANCE_ATTRIB + column, 4, AttribType::Float, false, sizeof(glm::mat4), column * sizeof(glm::vec4), 1 });
+    }
+}
+
+void Renderer::addInstanced(ModelGL& model) {
+    model.batch = static_cast<uint32_t>(instancedModels.size());
+    instancedModels.push_back(&model);
+}
+
+void Renderer::render(const FrameView& frame) {
+
+    //a little compaction every frame instead of a big stall later
+    chunkArena.maintain(ARENA_MOVES_PER_FRAME);
+    {
+        std::lock_guard<std::recursive_mutex> lock(world.chunksMutex);
+        for (Chunk* chunk : world.takeActivityChanges()) {
+            chunkRecords.setActive(chunk, chunk->isActive);
+            auto occluders = chunkOccluders.find(chunk);
+            if (occluders != chunkOccluders.end()) occluders->second.active = chunk->isActive;
+        }
+    }
+
+    // set background & clear screen
+    device.setClearColour(glm::vec4(0.1f, 0.4f, 0.6f, 1.0f));
+    device.clear(true, true);
+
+    //vie and projection matrices
+    glm::mat4 view = frame.view;
+    glm::mat4 projection = glm::perspective(glm::radians(90.0f), (float)frame.width / (float)frame.height, 0.1f, 1000.0f);
+
+    //whats in current view
+    glm::mat4 viewProj = projection * view;
+    frustum.update(viewProj); // Update frustum for culling
+
+    // Rotate sun direction based on time
+    float angle = frame.time * SUN_SPEED;
+    glm::vec3 sunDir = glm::normalize(glm::vec3(cos(angle), sin(angle) * sin(SUN_TILT), sin(angle) * cos(SUN_TILT))); // Compute sun direction using a circular motion
+    sunDirection = -sunDir;
+
+    //shadow cascades follow the camera, each slice of the view gets its own light box
+    //and casters are only looked for between the lowest and highest chunk
+    chunkTree.update(chunkRecords);
+    float casterBottom, casterTop;
+    if (chunkTree.heightRange(casterBottom, casterTop)) shadowCascades.setCasterHeights(casterBottom, casterTop);
+    shadowCascades.update(shadowSettings, view, glm::radians(90.0f), (float)frame.width / (float)frame.height, 0.1f, sunDirection);
+    lightForward = shadowCascades.lightDirection();
+
+    renderShadowMap(frame.width, frame.height);
+
+    // Ensure default framebuffer
+    device.bindFramebuffer(0);
+    device.setViewport(0, 0, frame.width, frame.height);
+    device.clear(true, true);
+
+    //use normal shader for cube + chunks
+    device.useProgram(shader);
+
+    // view, projection, sun and cascades for every program in one upload
+    frameUniforms.view = view;
+    frameUniforms.projection = projection;
+    frameUniforms.cascadeSplits = glm::vec4(0.0f);
+    for (int i = 0; i < shadowCascades.count(); i++) {
+        frameUniforms.shadowMatrices[i] = shadowCascades.cascade(i).shadowSpace;
+        frameUniforms.cascadeSplits[i] = shadowCascades.cascade(i).farDistance;
+    }
+    frameUniforms.cascadeCount = shadowCascades.count();
+    frameUniforms.sunDirection = glm::vec4(sunDirection, 0.0f);
+    frameUniforms.cameraPos = glm::vec4(frame.cameraPos, 1.0f);
+    device.bufferSubData(frameUniformBuffer, 0, sizeof(FrameUniforms), &frameUniforms);
+
+    device.setUniform(shadowMapLoc, 1);
+
+    // Bind shadow map to texture unit 1 (unit 0 is for texture atlas)
+    device.bindTexture(1, depthMap);
+
+    // Bind texture atlas to unit 0
+    device.bindTexture(0, texAtlas);
+    device.setUniform(textureLocation, 0);
+
+    drawChunks(frame.cameraPos, viewProj);
+
+    // Render highlight if a block is in range
+    if (frame.hasHighlight) {
+        device.useProgram(shader);
+        glm::mat4 highlightModel = glm::mat4(1.0f);
+        // Center the highlight by adding (0.5, 0.5, 0.5) to the block position
+        highlightModel = glm::translate(highlightModel, frame.highlightPos + glm::vec3(0.5f, 0.5f, 0.5f));
+        device.setUniform(modelLocation, highlightModel);
+        device.setUniform(lightColourLoc, glm::vec4(1.0f, 1.0f, 0.0f, 1.0f)); // Yellow highlight
+
+        device.bindVertexArray(highlightVAO);
+        device.drawIndexed(Primitive::Lines, 24, 0); // 24 indices for wireframe
+        device.bindVertexArray(0);
+    }
+
+    drawMobs();
+
+    renderSun();
+}
+
+// Upload a freshly meshed chunk (handed over by World::takeMeshUploads) into the chunk arena.
+void Renderer::uploadChunkMesh(Chunk& chunk) {
+    MeshData& mesh = chunk.mesh;
+    invalidateShadows(chunk);
+    chunkArena.upload(chunk, mesh.vertices, mesh.indices);
+    sectionGraph.update(&chunk, chunk.chunkPosition, mesh.sections);//empty meshes too, open air connects
+    if (chunk.vertexBlock == 0) {
+        chunkRecords.remove(&chunk);
+        chunkOccluders.erase(&chunk);
+        return;
+    }
+
+    ChunkOccluders& occluders = chunkOccluders[&chunk];
+    occluders.boxes.clear();
+    appendOccluders(mesh, chunk.chunkPosition, occluders.boxes);
+    occluders.active = chunk.isActive;
+
+    if (sectionCulling) {
+        chunkRecords.update(&chunk, chunk.chunkPosition, mesh.sections, MeshData::sectionCount, chunk.vertexBlock, chunk.indexBlock, chunk.isActive);
+        return;
+    }
+    //whole chunk as one range, column box up to the tallest block
+    MeshSection whole;
+    whole.indexCount = static_cast<unsigned int>(mesh.indices.size());
+    whole.max = glm::ivec3(Chunk::chunkSize, chunk.currentTallestBlock + 1, Chunk::chunkSize);
+    chunkRecords.update(&chunk, chunk.chunkPosition, &whole, 1, chunk.vertexBlock, chunk.indexBlock, chunk.isActive);
+}
+
+void Renderer::releaseChunk(Chunk& chunk) {
+    invalidateShadows(chunk);
+    chunkArena.release(chunk);
+    chunkRecords.remove(&chunk);
+    chunkOccluders.erase(&chunk);
+    sectionGraph.remove(&chunk);
+}
+
+//cached shadow tiles under the chunk's column have its old shape in them
+void Renderer::invalidateShadows(const Chunk& chunk) {
+    glm::vec3 top = glm::vec3(Chunk::chunkSize, chunk.currentTallestBlock + 2, Chunk::chunkSize);
+    shadowCascades.invalidate(chunk.chunkPosition, chunk.chunkPosition + top);
+}
+
+unsigned int Renderer::loadTexture(const std::string& path, TextureDesc desc) {
+    // Load image using stb_image, rgb stays rgb and everything else is expanded to rgba
+    int width, height, nrChannels;
+    if (!stbi_info(path.c_str(), &width, &height, &nrChannels)) {
+        std::cerr << "Failed to load texture: " << path << std::endl;
+        return createFallbackTexture();
+    }
+    int channels = nrChannels == 3 ? 3 : 4;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, channels);
+    if (!data) {
+        std::cerr << "Failed to load texture: " << path << std::endl;
+        return createFallbackTexture();
+    }
+
+    desc.width = width;
+    desc.height = height;
+    desc.format = channels == 3 ? TextureFormat::RGB : TextureFormat::RGBA;
+    unsigned int texture = device.createTexture(desc, data);
+    stbi_image_free(data);
+    return texture;
+}
+
+unsigned int Renderer::createFallbackTexture() {
+    unsigned char data[] = { 255, 255, 255, 255 };
+    return device.createTexture(TextureDesc(), data);
+}
+
+void Renderer::makeBasicModel() {
+
+    beeModel = OBJLoader::LoadOBJ("../ResourceFiles/bee.obj");
+    beeModelGl = createModelGL(beeModel, "../ResourceFiles/BeeAtlas.png", entityShader, "beeTexture");
+
+    cubeModel = OBJLoader::LoadOBJ("../ResourceFiles/coolBox.obj");
+    cubeModelGl = createModelGL(cubeModel, "../ResourceFiles/boxTex.png", entityShader, "boxTexture");
+
+    swordModel = OBJLoader::LoadOBJ("../ResourceFiles/sword.obj");
+    swordModelGl = createModelGL(swordModel, "../ResourceFiles/swordTex.png", entityShader, "swordTexture");
+
+    addInstanced(beeModelGl);
+    addInstanced(cubeModelGl);
+    addInstanced(swordModelGl);
+
+}
+
+ModelGL Renderer::createModelGL(const OBJData& modelData, const std::string& texturePath, unsigned int shaderID, const std::string& uniformName) {
+
+    ModelGL m;
+
+    std::vector<float> vertexData;
+    for (size_t i = 0; i < modelData.positions.size(); ++i) {
+        vertexData.push_back(modelData.positions[i].x);
+        vertexData.push_back(modelData.positions[i].y);
+        vertexData.push_back(modelData.positions[i].z);
+
+        if (!modelData.normals.empty()) {
+            vertexData.push_back(modelData.normals[i].x);
+            vertexData.push_back(modelData.normals[i].y);
+            vertexData.push_back(modelData.normals[i].z);
+        }
+        else {
+            vertexData.insert(vertexData.end(), { 0.0f, 0.0f, 1.0f });
+        }
+
+        if (!modelData.texCoords.empty()) {
+            vertexData.push_back(modelData.texCoords[i].x);
+            vertexData.push_back(modelData.texCoords[i].y);
+        }
+        else {
+            vertexData.insert(vertexData.end(), { 0.0f, 0.0f });
+        }
+    }
+
+    m.VAO = device.createVertexArray();
+    m.VBO = device.createBuffer();
+    m.EBO = device.createBuffer();
+
+    device.bindVertexArray(m.VAO);
+    device.bufferData(BufferTarget::Vertex, m.VBO, vertexData.size() * sizeof(float), vertexData.data(), BufferUsage::Static);
+    device.bufferData(BufferTarget::Index, m.EBO, modelData.indices.size() * sizeof(unsigned int), modelData.indices.data(), BufferUsage::Static);
+
+    //same locations as the gltf models, the entity shader reads texcoords from 1
+    size_t stride = 8 * sizeof(float);
+    device.vertexAttrib({ 0, 3, AttribType::Float, false, stride, 0 }); // pos
+    device.vertexAttrib({ 2, 3, AttribType::Float, false, stride, 3 * sizeof(float) }); // normal
+    device.vertexAttrib({ 1, 2, AttribType::Float, false, stride, 6 * sizeof(float) }); // texcoord
+    addInstanceLayout(m);
+    device.bindVertexArray(0);
+
+    TextureDesc textureDesc;
+    textureDesc.mipmaps = true;
+    m.textureID = loadTexture(texturePath, textureDesc);
+    m.indexCount = modelData.indices.size();
+    m.uniformName = uniformName;
+    m.textureLoc = device.getUniformLocation(shaderID, uniformName.c_str());
+
+    return m;
+}
+
+//gltf models from ModelLoader, uploaded the first time a mob using them is drawn
+const ModelGL& Renderer::getEntityModel(const std::string& path) {
+    auto it = entityModels.find(path);
+    if (it != entityModels.end()) return it->second;
+
+    ModelGL& m = entityModels[path];
+    m = ModelGL{ 0, 0, 0, 0, 0, "texture0", entityTextureLoc };
+
+    Model* model = ModelLoader::getModel(path);
+    if (model->vertices.empty() || model->indices.empty()) {
+        std::cerr << "No model to render for " << path << std::endl;
+        return m;
+    }
+
+    m.VAO = device.createVertexArray();
+    m.VBO = device.createBuffer();
+    m.EBO = device.createBuffer();
+
+    device.bindVertexArray(m.VAO);
+    device.bufferData(BufferTarget::Vertex, m.VBO, model->vertices.size() * sizeof(Vertex), model->vertices.data(), BufferUsage::Static);
+    device.bufferData(BufferTarget::Index, m.EBO, model->indices.size() * sizeof(unsigned int), model->indices.data(), BufferUsage::Static);
+    device.vertexAttrib({ 0, 3, AttribType::Float, false, sizeof(Vertex), offsetof(Vertex, position) });
+    device.vertexAttrib({ 1, 2, AttribType::Float, false, sizeof(Vertex), offsetof(Vertex, texCoord) });
+    device.vertexAttrib({ 2, 3, AttribType::Float, false, sizeof(Vertex), offsetof(Vertex, normal) });
+    addInstanceLayout(m);
+    device.bindVertexArray(0);
+    addInstanced(m);
+
+    if (!model->texturePixels.empty()) {
+        TextureDesc textureDesc;
+        textureDesc.width = model->textureWidth;
+        textureDesc.height = model->textureHeight;
+        textureDesc.format = model->textureChannels == 3 ? TextureFormat::RGB : TextureFormat::RGBA;
+        textureDesc.mipmaps = true;
+        m.textureID = device.createTexture(textureDesc, model->texturePixels.data());
+    }
+    else {
+        m.textureID = createFallbackTexture();
+    }
+    m.indexCount = model->indices.size();
+    return m;
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+
+#include "RenderDevice.h"
+#include "World.h"
+#include "Frustum.h"
+#include "OBJLoader.h"
+#include "Model.h"
+#include "ChunkArena.h"
+#include "ChunkDrawList.h"
+#include "ChunkRenderRecords.h"
+#include "ChunkQuadtree.h"
+#include "OcclusionBuffer.h"
+#include "SectionGraph.h"
+#include "ShadowCascades.h"
+#include "InstanceBatcher.h"
+
+struct ModelGL {
+	unsigned int VAO, VBO, EBO;
+	unsigned int textureID;
+	size_t indexCount;
+	std::string uniformName;
+	int textureLoc = -1;//of uniformName, looked up when the model is made
+	unsigned int instanceBuffer = 0;//this frame's transforms, read as a per instance mat4
+	uint32_t batch = 0;//its group in the instance batcher
+};
+
+//per frame values every program reads from its FrameData uniform block, laid out std140 so it goes
+//into the uniform buffer as is. Must match FrameData in the shaders
+struct FrameUniforms {
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::mat4 shadowMatrices[ShadowCascades::MAX_CASCADES];//world to each cascade's atlas tile
+	glm::vec4 cascadeSplits;//view depth where each cascade ends
+	glm::vec4 sunDirection;//xyz, the way the light travels
+	glm::vec4 cameraPos;
+	int cascadeCount;
+	int padding[3];
+};
+static_assert(sizeof(FrameUniforms) == 448, "FrameUniforms has to keep the std140 layout of FrameData");
+
+//what the occlusion pass did in the last frame
+struct OcclusionStats {
+	size_t occluders = 0;//boxes drawn into the buffer
+	size_t triangles = 0;
+	size_t tested = 0;//records that passed the frustum
+	size_t culled = 0;//of those, hidden behind terrain
+};
+
+//what the shadow pass did in the last frame
+struct ShadowStats {
+	size_t passes = 0;//cascades, or cached tiles, drawn
+	size_t casters = 0;//records culled in, summed over the passes
+};
+
+//everything the renderer needs to know about the frame, filled by main or a headless driver
+struct FrameView {
+	glm::mat4 view;
+	glm::vec3 cameraPos;
+	int width, height;
+	float time;//seconds since start, drives the sun
+	bool hasHighlight = false;
+	glm::vec3 highlightPos = glm::vec3(0.0f);//block the player is looking at
+};
+
+//draws the world through a RenderDevice, has no gl or window code of its own
+//so the whole frame can run against the recording device on machines without a gpu
+class Renderer
+{
+public:
+	Renderer(RenderDevice& device, World& world);
+	~Renderer();
+
+	void init();//shaders, textures, static meshes, shadow map
+	void render(const FrameView& frame);
+
+	//chunk meshes, call with world.chunksMutex held
+	void uploadChunkMesh(Chunk& chunk);
+	void releaseChunk(Chunk& chunk);
+	const ChunkArena& getChunkArena() const { return chunkArena; }
+	const ChunkRenderRecords& getChunkRecords() const { return chunkRecords; }
+	const OcclusionStats& getOcclusionStats() const { return occlusionStats; }
+
+	bool sectionCulling = true;//false goes back to whole chunk records and an unculled shadow pass, for comparisons, applies from each chunk's next upload
+	bool faceBucketCulling = true;//skip face direction buckets turned away from the camera or light, needs sectionCulling
+	bool occlusionCulling = true;//test sections against the cpu depth buffer of nearby solid terrain, needs sectionCulling
+	bool caveCulling = true;//only draw sections the air around the camera can see into, needs sectionCulling
+	const SectionGraph& getSectionGraph() const { return sectionGraph; }
+
+	ShadowCascades::Settings shadowSettings;//read every frame, a new resolution remakes the depth texture
+	const ShadowCascades& getShadowCascades() const { return shadowCascades; }
+	const ShadowStats& getShadowStats() const { return shadowStats; }
+
+private:
+	RenderDevice& device;
+	World& world;
+	Frustum frustum;
+	ChunkArena chunkArena;//all chunk meshes, drawn through one vao
+	static const size_t ARENA_MOVES_PER_FRAME = 4;
+	ChunkRenderRecords chunkRecords;//one per non empty mesh section, what culling reads instead of world.chunks
+	ChunkQuadtree chunkTree;//over chunkRecords, for the shadow and camera passes
+	std::vector<uint32_t> visibleRecords;
+	ChunkDrawList drawList;//rebuilt for each pass
+	SectionGraph sectionGraph;//section connectivity of every uploaded chunk, walked from the camera for cave culling
+
+	//solid terrain boxes per uploaded chunk, drawn into the occlusion buffer when within OCCLUDER_DISTANCE
+	struct ChunkOccluders {
+		std::vector<OccluderBox> boxes;
+		bool active;
+	};
+	std::unordered_map<const Chunk*, ChunkOccluders> chunkOccluders;
+	OcclusionBuffer occlusion;
+	OcclusionStats occlusionStats;
+	static constexpr float OCCLUDER_DISTANCE = 96.0f;
+	static const unsigned int ORIGIN_UNIT = 2;//texture units: 0 atlas, 1 shadow map, 2 chunk origins
+	static const unsigned int FRAME_BLOCK = 0;//uniform buffer binding of FrameData
+
+	//every location is looked up once in createShaders, the frame loop only uses these
+	int
+		modelLocation, textureLocation,
+		lightColourLoc, lightPosLoc,
+		entityTextureLoc;
+
+	int sunColourLoc;
+	FrameUniforms frameUniforms;
+	unsigned int frameUniformBuffer;
+	glm::vec3 sunDirection = glm::vec3(0.0f, -1.0f, -1.0f);//directional light;
+
+	unsigned int shader, sunShader, entityShader, depthShader;//programs
+	unsigned int sunVBO, sunVAO, sunEBO;
+	unsigned int texAtlas;
+	unsigned int highlightVAO, highlightVBO, highlightEBO;
+
+	void createShaders();
+	void createSun();
+	void createHighlight();
+	unsigned int loadTexture(const std::string& path, TextureDesc desc);//white 1x1 texture if the file cant be loaded
+	unsigned int createFallbackTexture();
+
+	//shadow stuff
+	void createShadowMap();
+	void renderShadowMap(int width, int height);
+	void drawShadowCasters(const Frustum& casters);
+	void invalidateShadows(const Chunk& chunk);
+	unsigned int depthMapFBO;
+	unsigned int depthMap;//atlas of every cascade, ShadowCascades::atlasSize texels square
+	int depthMapSize = 0;
+	ShadowCascades shadowCascades;//light boxes for this frame, each also culls its casters
+	ShadowStats shadowStats;
+	glm::vec3 lightForward;//view direction of the shadow map
+	int lightSpaceLoc, shadowMapLoc;
+	int originsLoc, depthOriginsLoc, useChunkOriginLoc;
+
+	void drawChunks(const glm::vec3& cameraPos, const glm::mat4& viewProj);
+	void cullOccluded(const glm::vec3& cameraPos, const glm::mat4& viewProj);
+	void cullCaves(const glm::vec3& cameraPos);
+	void drawChunkList();//the whole draw list in one call, program and uniforms already set
+	void renderSun();
+
+	//mobs and static models
+	OBJData beeModel;
+	ModelGL beeModelGl;
+
+	OBJData cubeModel;
+	ModelGL cubeModelGl;
+
+	OBJData swordModel;
+	ModelGL swordModelGl;
+
+	std::unordered_map<std::string, ModelGL> entityModels;//gpu side of ModelLoader models, made on first draw
+
+	//every model above is drawn instanced, one draw per model with anything to draw
+	InstanceBatcher instanceBatcher;
+	std::vector<const ModelGL*> instancedModels;//by ModelGL::batch
+	static const unsigned int INSTANCE_ATTRIB = 3;//the mat4 takes this and the next three
+	std::vector<const ModelGL*> entityModelHandles;//by EntityStore model handle, resolved once per handle
+
+	void makeBasicModel();
+	void drawMobs();
+	void addInstanceLayout(ModelGL& model);//with the model's vao bound
+	void addInstanced(ModelGL& model);//gives it a batch, the model must stay where it is
+	const ModelGL& getEntityModel(const std::string& path);
+	ModelGL createModelGL(const OBJData& modelData, const std::string& texturePath, unsigned int shaderID, const std::string& uniformName);
+};
@@ -0,0 +1,130 @@
+#include "SectionGraph.h"
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include "Chunk.h"
+#include "Frustum.h"
+
+namespace {
+    //same order as the face buckets, Front z-, Back z+, Left x-, Right x+, Top, Bottom, opposite face is d ^ 1
+    const int stepX[MeshSection::faceDirections] = { 0, 0, -1, 1, 0, 0 };
+    const int stepY[MeshSection::faceDirections] = { 0, 0, 0, 0, 1, -1 };
+    const int stepZ[MeshSection::faceDirections] = { -1, 1, 0, 0, 0, 0 };
+
+    const uint8_t allFaces = (1u << MeshSection::faceDirections) - 1;
+
+    bool joins(uint64_t connectivity, int a, int b) {
+        return (connectivity >> (a * MeshSection::faceDirections + b)) & 1;
+    }
+}
+
+glm::ivec2 SectionGraph::cellAt(const glm::vec3& position) {
+    return glm::ivec2(static_cast<int>(std::floor(position.x / Chunk::chunkSize)), static_cast<int>(std::floor(position.z / Chunk::chunkSize)));
+}
+
+void SectionGraph::update(const Chunk* chunk, const glm::vec3& origin, const MeshSection* sections) {
+    glm::ivec2 cell = cellAt(origin + glm::vec3(0.5f));
+    auto it = cellOf.find(chunk);
+    if (it != cellOf.end() && it->second != cell) remove(chunk);
+    cellOf[chunk] = cell;
+
+    Column& column = columns[cell];
+    for (int s = 0; s < MeshData::sectionCount; s++) column.connectivity[s] = sections[s].connectivity;
+    column.origin = origin;
+}
+
+void SectionGraph::remove(const Chunk* chunk) {
+    auto it = cellOf.find(chunk);
+    if (it == cellOf.end()) return;
+    columns.erase(it->second);
+    cellOf.erase(it);
+}
+
+void SectionGraph::clear() {
+    columns.clear();
+    cellOf.clear();
+    openCells.clear();
+}
+
+bool SectionGraph::traverse(const glm::vec3& eye, const Frustum* frustum, int maxCells) {
+    frame++;
+    visited = 0;
+    glm::ivec2 startCell = cellAt(eye);
+    auto start = columns.find(startCell);
+    if (start == columns.end()) return false;
+    int startSection = static_cast<int>(std::floor((eye.y - start->second.origin.y) / MeshData::sectionHeight));
+    if (startSection < 0 || startSection >= MeshData::sectionCount) return false;
+
+    //breadth first, a section is walked at most once per face it is entered through, as what the air lets the walk
+    //reach from one face says nothing about another. Walks only step away from the eye's section or along its
+    //row / column / layer, which every straight line from the eye does too, so which way a section was first
+    //reached never stops a later walk from it
+    queue.clear();
+    openCells.clear();
+    Column& first = start->second;
+    first.stamp = frame;
+    std::fill(first.walked, first.walked + MeshData::sectionCount, uint8_t(0));
+    first.walked[startSection] = allFaces;
+    first.visible = static_cast<uint16_t>(1u << startSection);
+    queue.push_back({ &first, startCell, startSection, 0xFF });
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        Step step = queue[head];
+        visited++;
+        uint64_t connectivity = step.column->connectivity[step.section];
+        glm::ivec3 fromEye(step.cell.x - startCell.x, step.section - startSection, step.cell.y - startCell.y);
+
+        for (int d = 0; d < MeshSection::faceDirections; d++) {
+            if (step.enteredFace != 0xFF && !joins(connectivity, step.enteredFace, d)) continue;
+
+            int section = step.section + stepY[d];
+            if (section < 0 || section >= MeshData::sectionCount) continue;
+            glm::ivec2 cell = step.cell + glm::ivec2(stepX[d], stepZ[d]);
+            Column* column = step.column;
+            if (cell != step.cell) {
+                auto it = columns.find(cell);
+                if (it != columns.end()) {
+                    column = &it->second;
+                }
+                else {
+                    if (std::abs(cell.x - startCell.x) > maxCells || std::abs(cell.y - startCell.y) > maxCells) continue;
+                    auto open = openCells.try_emplace(cell);
+                    column = &open.first->second;
+                    if (open.second) {
+                        std::fill(column->connectivity, column->connectivity + MeshData::sectionCount, MeshSection::allConnected);
+                        column->origin = glm::vec3(cell.x * Chunk::chunkSize, first.origin.y, cell.y * Chunk::chunkSize);
+                    }
+                }
+            }
+            if (column->stamp != frame) {
+                column->stamp = frame;
+                std::fill(column->walked, column->walked + MeshData::sectionCount, uint8_t(0));
+                column->visible = 0;
+            }
+            uint8_t entered = static_cast<uint8_t>(d ^ 1);
+            if (column->walked[section] & (1u << entered)) continue;
+
+            if (frustum) {
+                glm::vec3 min = column->origin + glm::vec3(0.0f, static_cast<float>(section * MeshData::sectionHeight), 0.0f);
+                glm::vec3 max = min + glm::vec3(Chunk::chunkSize, MeshData::sectionHeight, Chunk::chunkSize);
+                if (!frustum->isBoxInFrustum(min, max)) continue;
+            }
+            //air the walk reached touches this section, so its faces on that side can be seen even when the walk
+            //may not go on into it because it is back towards the eye
+            column->visible |= static_cast<uint16_t>(1u << section);
+            if (stepX[d] * fromEye.x < 0 || stepY[d] * fromEye.y < 0 || stepZ[d] * fromEye.z < 0) continue;
+            column->walked[section] |= static_cast<uint8_t>(1u << entered);
+            queue.push_back({ column, cell, section, entered });
+        }
+    }
+    return true;
+}
+
+bool SectionGraph::isVisible(const Chunk* chunk, int section) const {
+    auto cell = cellOf.find(chunk);
+    if (cell == cellOf.end()) return true;//not in the graph, never culled here
+    auto it = columns.find(cell->second);
+    if (it == columns.end()) return true;
+    const Column& column = it->second;
+    return column.stamp == frame && (column.visible >> section) & 1;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "MeshData.h"
+#include "Vec3Hash.h"
+
+class Chunk;
+class Frustum;
+
+//cave culling, walks the mesh sections outward from the camera's section and only goes on from a section if air
+//inside it joins the face the walk came in through to the face it leaves by (MeshSection::connectivity).
+//A walk never steps back towards the eye's section, so it spreads away from the eye like the view does,
+//and sections outside the frustum end it. Sections the walk or the air it reached touches are drawn, whatever else
+//is behind solid rock from where the eye is, which is most of the caves below the surface and, from inside a
+//cave, most of the surface. Chunks with no mesh yet are walked as open air up to a distance, so a hole in the
+//loaded world never hides what is behind it. No gl in here.
+class SectionGraph
+{
+public:
+	//insert or replace the chunk's column, every chunk should have one even with an empty mesh, as all air joins everything
+	void update(const Chunk* chunk, const glm::vec3& origin, const MeshSection* sections);
+	void remove(const Chunk* chunk);
+	void clear();
+
+	//marks the sections reachable from the eye, false if the eye is not in a loaded section, then nothing should be culled
+	//maxCells is how many chunks out on x or z the walk may go past columns that have no mesh
+	bool traverse(const glm::vec3& eye, const Frustum* frustum, int maxCells);
+	bool isVisible(const Chunk* chunk, int section) const;//by the last traverse that returned true
+
+	size_t columnCount() const { return columns.size(); }
+	size_t sectionsVisited() const { return visited; }//by the last traverse
+
+private:
+	struct Column {
+		uint64_t connectivity[MeshData::sectionCount];
+		glm::vec3 origin;
+		uint32_t stamp = 0;//traverse that last reached this column
+		//only meaningful when stamp is current
+		uint8_t walked[MeshData::sectionCount];//per section, bit per face a walk came in through
+		uint16_t visible = 0;//bit per section, walked or next to air a walk reached
+	};
+	struct Step {
+		Column* column;
+		glm::ivec2 cell;
+		int section;
+		uint8_t enteredFace;//face it came in through, 0xFF for the start section
+	};
+
+	std::unordered_map<glm::ivec2, Column, IVec2Hash> columns;//chunk grid position
+	std::unordered_map<const Chunk*, glm::ivec2> cellOf;
+	std::unordered_map<glm::ivec2, Column, IVec2Hash> openCells;//cells the last walk went through with no column, as open air
+	std::vector<Step> queue;
+	uint32_t frame = 0;
+	size_t visited = 0;
+
+	static glm::ivec2 cellAt(const glm::vec3& position);
+};
@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "GLDebug.h"
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     // 1. Retrieve the vertex/fragment source code from filePath
@@ -42,63 +43,119 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     char infoLog[512];
 
     // Vertex Shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
+    vertex = GL_CALL(Resource, glCreateShader(GL_VERTEX_SHADER));
+    GL_CALL(Resource, glShaderSource(vertex, 1, &vShaderCode, NULL));
+    GL_CALL(Resource, glCompileShader(vertex));
+    GL_CALL(Query, glGetShaderiv(vertex, GL_COMPILE_STATUS, &success));
     if (!success) {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
+        GL_CALL(Query, glGetShaderInfoLog(vertex, 512, NULL, infoLog));
         std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
     }
 
     // Fragment Shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
+    fragment = GL_CALL(Resource, glCreateShader(GL_FRAGMENT_SHADER));
+    GL_CALL(Resource, glShaderSource(fragment, 1, &fShaderCode, NULL));
+    GL_CALL(Resource, glCompileShader(fragment));
+    GL_CALL(Query, glGetShaderiv(fragment, GL_COMPILE_STATUS, &success));
     if (!success) {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
+        GL_CALL(Query, glGetShaderInfoLog(fragment, 512, NULL, infoLog));
         std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
     }
 
     // Shader Program
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    ID = GL_CALL(Resource, glCreateProgram());
+    GL_CALL(Resource, glAttachShader(ID, vertex));
+    GL_CALL(Resource, glAttachShader(ID, fragment));
+    GL_CALL(Resource, glLinkProgram(ID));
+    GL_CALL(Query, glGetProgramiv(ID, GL_LINK_STATUS, &success));
     if (!success) {
-        glGetProgramInfoLog(ID, 512, NULL, infoLog);
+        GL_CALL(Query, glGetProgramInfoLog(ID, 512, NULL, infoLog));
         std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
     }
 
     // Delete shaders as they are now linked
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    GL_CALL(Resource, glDeleteShader(vertex));
+    GL_CALL(Resource, glDeleteShader(fragment));
+
+    if (success) reflect();
+}
+
+//every active uniform and block once, so setting one later never asks the driver for a name
+void Shader::reflect() {
+    char name[256];
+    GLint count = 0;
+    GL_CALL(Query, glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count));
+    for (GLint i = 0; i < count; i++) {
+        GLint size = 0;
+        GLenum type = 0;
+        GL_CALL(Query, glGetActiveUniform(ID, i, sizeof(name), nullptr, &size, &type, name));
+        GLint location = GL_CALL(Query, glGetUniformLocation(ID, name));
+        if (location < 0) continue;//members of uniform blocks have no location
+
+        //arrays come back as name[0], every element gets its own entry and the bare name points at the first
+        std::string base(name);
+        size_t bracket = base.find('[');
+        if (bracket == std::string::npos) {
+            uniforms.add(name, location);
+            continue;
+        }
+        base.resize(bracket);
+        uniforms.add(base.c_str(), location);
+        for (GLint element = 0; element < size; element++) {
+            std::string elementName = base + "[" + std::to_string(element) + "]";
+            uniforms.add(elementName.c_str(), GL_CALL(Query, glGetUniformLocation(ID, elementName.c_str())));
+        }
+    }
+
+    GL_CALL(Query, glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count));
+    for (GLint i = 0; i < count; i++) {
+        GL_CALL(Query, glGetActiveUniformBlockName(ID, i, sizeof(name), nullptr, name));
+        uniformBlocks.add(name, i);
+    }
 }
 
 // Activate the shader program
 void Shader::use() {
-    glUseProgram(ID);
+    GL_CALL(Bind, glUseProgram(ID));
 }
 
 // Utility functions to set uniforms
 void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    setBool(uniformHash(name.c_str()), value);
 }
 
 void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    setInt(uniformHash(name.c_str()), value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    setFloat(uniformHash(name.c_str()), value);
 }
 
 void Shader::setVec4(const std::string& name, glm::vec4 value) const {
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z, value.w);
+    setVec4(uniformHash(name.c_str()), value);
 }
 
 void Shader::setVec3(const std::string& name, glm::vec3 value) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z);
+    setVec3(uniformHash(name.c_str()), value);
+}
+
+void Shader::setBool(uint32_t name, bool value) const {
+    GL_CALL(Uniform, glUniform1i(uniforms.find(name), (int)value));
+}
+
+void Shader::setInt(uint32_t name, int value) const {
+    GL_CALL(Uniform, glUniform1i(uniforms.find(name), value));
+}
+
+void Shader::setFloat(uint32_t name, float value) const {
+    GL_CALL(Uniform, glUniform1f(uniforms.find(name), value));
+}
+
+void Shader::setVec4(uint32_t name, glm::vec4 value) const {
+    GL_CALL(Uniform, glUniform4f(uniforms.find(name), value.x, value.y, value.z, value.w));
+}
+
+void Shader::setVec3(uint32_t name, glm::vec3 value) const {
+    GL_CALL(Uniform, glUniform3f(uniforms.find(name), value.x, value.y, value.z));
 }
@@ -8,11 +8,14 @@
 #include <sstream>
 #include <iostream>
 #include <glm/glm.hpp>
+#include "UniformTable.h"
 
 class Shader
 {
 public:
     unsigned int ID; // Shader program ID
+    UniformTable uniforms;//location of every active uniform, array elements as name[i], filled after linking
+    UniformTable uniformBlocks;//block index of every active uniform block
 
     // Constructor that reads and builds the shader
     Shader(const char* vertexPath, const char* fragmentPath);
@@ -20,13 +23,20 @@ public:
     // Activate the shader program
     void use();
 
-    // Utility functions to set uniforms
+    // Utility functions to set uniforms, by name or by uniformHash("name") to skip hashing the string
     void setBool(const std::string& name, bool value) const;
     void setInt(const std::string& name, int value) const;
     void setFloat(const std::string& name, float value) const;
     void setVec4(const std::string& name, glm::vec4 value) const;
     void setVec3(const std::string& name, glm::vec3 value) const;
-        
+    void setBool(uint32_t name, bool value) const;
+    void setInt(uint32_t name, int value) const;
+    void setFloat(uint32_t name, float value) const;
+    void setVec4(uint32_t name, glm::vec4 value) const;
+    void setVec3(uint32_t name, glm::vec3 value) const;
+
+private:
+    void reflect();
 };
 
 #endif
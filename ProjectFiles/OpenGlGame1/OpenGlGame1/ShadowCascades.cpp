@@ -0,0 +1,245 @@
+#include "ShadowCascades.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+    int wrap(int value, int size) {
+        return ((value % size) + size) % size;
+    }
+
+    bool sameSettings(const ShadowCascades::Settings& a, const ShadowCascades::Settings& b) {
+        return a.count == b.count && a.resolution == b.resolution && a.distance == b.distance && a.splitBlend == b.splitBlend
+            && a.casterReach == b.casterReach && a.cached == b.cached && a.tilesPerSide == b.tilesPerSide && a.sunStepDegrees == b.sunStepDegrees;
+    }
+}
+
+void ShadowCascades::splitDistances(int count, float nearPlane, float farPlane, float lambda, float* splits) {
+    for (int i = 1; i <= count; i++) {
+        float t = static_cast<float>(i) / count;
+        float logarithmic = nearPlane * std::pow(farPlane / nearPlane, t);
+        float even = nearPlane + (farPlane - nearPlane) * t;
+        splits[i - 1] = lambda * logarithmic + (1.0f - lambda) * even;
+    }
+    splits[count - 1] = farPlane;//no rounding gap at the end
+}
+
+//looking down -z, the box starts casterReach behind its top so terrain above it still casts into it
+glm::mat4 ShadowCascades::boxProjection(const glm::vec2& min, const glm::vec2& max, float depthTop, float depthBottom, float casterReach) const {
+    return glm::ortho(min.x, max.x, min.y, max.y, -depthTop - casterReach, -depthBottom) * lightView;
+}
+
+void ShadowCascades::setCasterHeights(float bottom, float top) {
+    casterHeightsSet = true;
+    casterBottom = bottom;
+    casterTop = top;
+}
+
+Frustum ShadowCascades::casterVolume(const glm::vec2& min, const glm::vec2& max, float low, float high) const {
+    if (casterHeightsSet) {
+        //world height is linear in light space, so inside the footprint the band between the caster heights reaches
+        //furthest up and down the light's z at the footprint's corners
+        glm::mat3 toWorld = glm::transpose(glm::mat3(lightView));
+        float heightPerDepth = toWorld[2].y;//how much higher a point is one unit closer to the sun
+        if (std::abs(heightPerDepth) > 1e-4f) {
+            float bandLow = 1e30f, bandHigh = -1e30f;
+            for (int corner = 0; corner < 4; corner++) {
+                glm::vec2 point((corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y);
+                float base = toWorld[0].y * point.x + toWorld[1].y * point.y;
+                float bottom = (casterBottom - base) / heightPerDepth, top = (casterTop - base) / heightPerDepth;
+                bandLow = std::min(bandLow, std::min(bottom, top));
+                bandHigh = std::max(bandHigh, std::max(bottom, top));
+            }
+            low = std::max(low, bandLow);
+            high = std::min(high, bandHigh);
+        }
+    }
+    Frustum volume;
+    if (low > high) {
+        //nothing can be there, planes no box can be inside of
+        for (glm::vec4& plane : volume.planes) plane = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f);
+        return volume;
+    }
+    volume.update(glm::ortho(min.x, max.x, min.y, max.y, -high, -low) * lightView);
+    return volume;
+}
+
+void ShadowCascades::resetCache(const Settings& settings) {
+    int slots = settings.tilesPerSide * settings.tilesPerSide;
+    for (TileCache& cache : caches) {
+        cache.held.assign(slots, glm::ivec2(0));
+        cache.valid.assign(slots, 0);
+    }
+    cachedWith = settings;
+    cacheReady = true;
+}
+
+void ShadowCascades::update(const Settings& settings, const glm::mat4& view, float fovY, float aspect, float nearPlane, const glm::vec3& sunDirection) {
+    cascadeCount = std::max(1, std::min(settings.count, MAX_CASCADES));
+    atlasResolution = atlasSize(settings);
+    dirty.clear();
+
+    glm::vec3 sun = glm::normalize(sunDirection);
+    if (settings.cached) {
+        //round the sun to its step, so the light only turns now and then and the tiles last until it does
+        float step = glm::radians(settings.sunStepDegrees);
+        int turn = static_cast<int>(std::round(6.2831853f / step));
+        glm::ivec2 steps(static_cast<int>(std::round(std::asin(glm::clamp(sun.y, -1.0f, 1.0f)) / step)),
+            wrap(static_cast<int>(std::round(std::atan2(sun.z, sun.x) / step)), turn));
+        if (std::abs(steps.x * step) > 1.5707f) steps.y = 0;//straight up or down, any azimuth is the same sun
+        if (!cacheReady || steps != sunSteps || !sameSettings(settings, cachedWith)) {
+            float elevation = steps.x * step, azimuth = steps.y * step;
+            sunSteps = steps;
+            sunStepped = glm::vec3(std::cos(elevation) * std::cos(azimuth), std::sin(elevation), std::cos(elevation) * std::sin(azimuth));
+            resetCache(settings);
+        }
+        sun = sunStepped;
+    }
+    else {
+        cacheReady = false;
+    }
+    lightDir = sun;
+
+    float splits[MAX_CASCADES];
+    splitDistances(cascadeCount, nearPlane, settings.distance, settings.splitBlend, splits);
+
+    //rotation only, so a texel in light space is the same texel whatever the camera does
+    glm::vec3 up = std::abs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    lightView = glm::lookAt(glm::vec3(0.0f), lightDir, up);
+
+    glm::mat4 cameraToWorld = glm::inverse(view);
+    glm::vec3 eye = glm::vec3(cameraToWorld[3]);
+    glm::vec3 forward = -glm::vec3(cameraToWorld[2]);
+    float tanY = std::tan(fovY * 0.5f);
+    float tanX = tanY * aspect;
+
+    float sliceNear = nearPlane;
+    for (int i = 0; i < cascadeCount; i++) {
+        Cascade& cascade = cascades[i];
+        float sliceFar = splits[i];
+        cascade.nearDistance = sliceNear;
+        cascade.farDistance = sliceFar;
+
+        //smallest sphere through both end rectangles of the slice, its centre sits on the view axis
+        //(a rectangle's corners are at distance d * k off axis, k = sqrt(tanX^2 + tanY^2))
+        float k2 = tanX * tanX + tanY * tanY;
+        float along = 0.5f * (sliceNear + sliceFar) * (1.0f + k2);
+        along = std::min(along, sliceFar);//past that the far rectangle alone decides
+        float nearReach = std::sqrt((along - sliceNear) * (along - sliceNear) + sliceNear * sliceNear * k2);
+        float farReach = std::sqrt((sliceFar - along) * (sliceFar - along) + sliceFar * sliceFar * k2);
+        float radius = std::max(nearReach, farReach);
+        radius = std::ceil(radius * 16.0f) / 16.0f;//float noise in the radius would rescale every texel
+        cascade.radius = radius;
+
+        glm::vec3 centre = eye + forward * along;
+        glm::vec3 lightCentre = glm::vec3(lightView * glm::vec4(centre, 1.0f));
+        glm::vec2 boxMin, boxMax;
+        float depthTop;
+        glm::vec2 wrapOffset(0.0f);
+
+        if (!settings.cached) {
+            //snap the centre to the texel grid in light space, the box is three texels wider on each side than the
+            //sphere so the snapped box still holds it with two to spare for the shadow filter
+            float halfSize = radius * settings.resolution / (settings.resolution - 6.0f);
+            float texel = 2.0f * halfSize / settings.resolution;
+            lightCentre.x = std::floor(lightCentre.x / texel) * texel;
+            lightCentre.y = std::floor(lightCentre.y / texel) * texel;
+            boxMin = glm::vec2(lightCentre) - halfSize;
+            boxMax = glm::vec2(lightCentre) + halfSize;
+            depthTop = lightCentre.z + radius;
+            cascade.lightSpace = boxProjection(boxMin, boxMax, depthTop, lightCentre.z - radius, settings.casterReach);
+
+            //casters: over the slice's own footprint plus the filter border, from its lowest corner up
+            glm::vec3 sliceMin(1e30f), sliceMax(-1e30f);
+            for (int corner = 0; corner < 8; corner++) {
+                float distance = (corner & 4) ? sliceFar : sliceNear;
+                glm::vec3 local(((corner & 1) ? 1.0f : -1.0f) * tanX * distance, ((corner & 2) ? 1.0f : -1.0f) * tanY * distance, -distance);
+                glm::vec3 light = glm::vec3(lightView * (cameraToWorld * glm::vec4(local, 1.0f)));
+                sliceMin = glm::min(sliceMin, light);
+                sliceMax = glm::max(sliceMax, light);
+            }
+            glm::vec2 footprintMin = glm::max(glm::vec2(sliceMin) - 2.0f * texel, boxMin);
+            glm::vec2 footprintMax = glm::min(glm::vec2(sliceMax) + 2.0f * texel, boxMax);
+            cascade.casters = casterVolume(footprintMin, footprintMax, std::max(sliceMin.z, lightCentre.z - radius), depthTop + settings.casterReach);
+        }
+        else {
+            //whole tiles only, one tile and the filter's two texels a side more than the sphere needs
+            //so it fits wherever it sits in the grid
+            TileCache& cache = caches[i];
+            int tiles = settings.tilesPerSide;
+            float tileSize = 2.0f * radius / (tiles - 1 - 4.0f * tiles / settings.resolution);
+            float texel = tileSize * tiles / settings.resolution;
+            glm::ivec2 origin = glm::ivec2(glm::floor((glm::vec2(lightCentre) - radius - 2.0f * texel) / tileSize));
+            boxMin = glm::vec2(origin) * tileSize;
+            boxMax = boxMin + tileSize * tiles;
+            wrapOffset = glm::vec2(origin) / float(tiles);
+
+            //depth range in steps too, moving it changes every stored depth so the whole cascade goes
+            float depthStep = std::max(16.0f, radius);
+            depthTop = std::ceil((lightCentre.z + radius) / depthStep) * depthStep;
+            if (depthTop != cache.depthTop || tileSize != cache.tileSize) std::fill(cache.valid.begin(), cache.valid.end(), uint8_t(0));
+            cache.depthTop = depthTop;
+            cache.tileSize = tileSize;
+            cache.origin = origin;
+
+            //tiles are kept after the camera looks away, so they hold the shadow over all of themselves
+            float depthBottom = depthTop - 2.0f * radius - depthStep;
+            cascade.lightSpace = boxProjection(boxMin, boxMax, depthTop, depthBottom, settings.casterReach);
+            cascade.casters = casterVolume(boxMin, boxMax, depthBottom, depthTop + settings.casterReach);
+            for (int y = 0; y < tiles; y++) {
+                for (int x = 0; x < tiles; x++) {
+                    glm::ivec2 gridTile = origin + glm::ivec2(x, y);
+                    glm::ivec2 slot(wrap(gridTile.x, tiles), wrap(gridTile.y, tiles));
+                    int index = slot.y * tiles + slot.x;
+                    if (cache.valid[index] && cache.held[index] == gridTile) continue;
+                    cache.held[index] = gridTile;
+                    cache.valid[index] = 1;
+
+                    Tile tile;
+                    tile.cascade = i;
+                    tile.slot = slot;
+                    glm::vec2 tileMin = glm::vec2(gridTile) * tileSize;
+                    tile.lightSpace = boxProjection(tileMin, tileMin + tileSize, depthTop, depthBottom, settings.casterReach);
+                    tile.casters = casterVolume(tileMin, tileMin + tileSize, depthBottom, depthTop + settings.casterReach);
+                    dirty.push_back(tile);
+                }
+            }
+        }
+        cascade.centre = glm::vec3(glm::inverse(lightView) * glm::vec4(glm::vec2(boxMin + boxMax) * 0.5f, lightCentre.z, 1.0f));
+        cascade.frustum.update(cascade.lightSpace);
+
+        //clip space to [0,1] over the box, plus the box's place in the grid when its quarter of the atlas wraps
+        glm::mat4 toShadow(1.0f);
+        toShadow = glm::translate(toShadow, glm::vec3(0.5f + wrapOffset.x, 0.5f + wrapOffset.y, 0.5f));
+        toShadow = glm::scale(toShadow, glm::vec3(0.5f));
+        cascade.shadowSpace = toShadow * cascade.lightSpace;
+
+        sliceNear = sliceFar;
+    }
+}
+
+void ShadowCascades::invalidate(const glm::vec3& min, const glm::vec3& max) {
+    if (!cacheReady) return;
+    int tiles = cachedWith.tilesPerSide;
+    for (int i = 0; i < cascadeCount; i++) {
+        TileCache& cache = caches[i];
+        if (cache.tileSize <= 0.0f) continue;
+
+        //the light looks straight down its z, so the box's shadow covers the same light space xy as the box
+        glm::vec2 lightMin(1e30f), lightMax(-1e30f);
+        for (int corner = 0; corner < 8; corner++) {
+            glm::vec3 point((corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z);
+            glm::vec2 light = glm::vec2(lightView * glm::vec4(point, 1.0f));
+            lightMin = glm::min(lightMin, light);
+            lightMax = glm::max(lightMax, light);
+        }
+        glm::ivec2 first = glm::max(glm::ivec2(glm::floor(lightMin / cache.tileSize)), cache.origin);
+        glm::ivec2 last = glm::min(glm::ivec2(glm::floor(lightMax / cache.tileSize)), cache.origin + tiles - 1);
+        for (int y = first.y; y <= last.y; y++) {
+            for (int x = first.x; x <= last.x; x++) {
+                int index = wrap(y, tiles) * tiles + wrap(x, tiles);
+                if (cache.held[index] == glm::ivec2(x, y)) cache.valid[index] = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include "Frustum.h"
+
+//cascaded shadow maps, the camera frustum up to Settings::distance is cut into slices that each get their own
+//orthographic light box, small ones near the eye where shadows need detail and bigger ones further out.
+//All cascades share one square depth texture, laid out as a 2x2 atlas of resolution sized tiles.
+//Boxes are fitted to a sphere around the slice so they keep their size when the camera turns, and moved in whole
+//texels so shadow edges dont crawl when it walks. Only math in here, the renderer draws what it says.
+//
+//In cached mode the sun is quantized to steps and light space is cut into a fixed grid of tiles per cascade.
+//A box only moves in whole tiles and each cascade's quarter of the atlas wraps around (tile i lives in slot
+//i mod tilesPerSide), so when the camera moves only the tiles scrolling in are drawn. Tiles are also redrawn
+//when a chunk whose shadow falls on them changes (invalidate) or the sun steps, everything else is kept.
+class ShadowCascades
+{
+public:
+	static const int MAX_CASCADES = 4;
+	static const int ATLAS_TILES = 2;//per side
+
+	struct Settings {
+		int count = 4;//cascades, 1 to MAX_CASCADES
+		int resolution = 1024;//texels per cascade side
+		float distance = 128.0f;//shadows end this far from the camera
+		float splitBlend = 0.75f;//0 = even splits, 1 = logarithmic (same ratio between every cascade)
+		float casterReach = 192.0f;//how far behind a slice towards the sun casters are still drawn
+		bool cached = true;//false redraws every cascade every frame
+		int tilesPerSide = 8;//per cascade when cached, resolution must be a multiple of it
+		float sunStepDegrees = 1.0f;//when cached, the sun only moves in steps this big
+	};
+
+	struct Cascade {
+		float nearDistance, farDistance;//view distance range of the slice
+		glm::vec3 centre;//of the bounding sphere, world space
+		float radius;
+		glm::mat4 lightSpace;//world to the cascade's clip space
+		//world to the cascade's quarter of the atlas, fract(xy) is the position in it, depth in z
+		glm::mat4 shadowSpace;
+		Frustum frustum;//light box
+		//the part of the light box that can shade the slice: its light space footprint, from the slice up towards
+		//the sun until the rays leave the caster heights. What the shadow pass culls with
+		Frustum casters;
+	};
+
+	//part of a cascade to draw this frame, cached mode only
+	struct Tile {
+		int cascade;
+		glm::ivec2 slot;//in the cascade's quarter, tilesPerSide square
+		glm::mat4 lightSpace;//just this tile, same depth range as its cascade
+		Frustum casters;//the tile's light box cut to the caster heights
+	};
+
+	//fits every cascade to the camera, sunDirection is the way the light travels
+	//in cached mode also lists the tiles that need drawing and assumes they are drawn before the next update
+	void update(const Settings& settings, const glm::mat4& view, float fovY, float aspect, float nearPlane, const glm::vec3& sunDirection);
+	//something inside the box changed, redraw the tiles its shadow can fall on
+	void invalidate(const glm::vec3& min, const glm::vec3& max);
+	//world heights every caster lies between (the chunk bounds), used by the next update. Without them
+	//casters are only limited by the light box
+	void setCasterHeights(float bottom, float top);
+
+	//light box over min..max in light space xy and light space z from low to high, cut down to where
+	//something between the caster heights can be. Outside the world the volume is empty
+	Frustum casterVolume(const glm::vec2& min, const glm::vec2& max, float low, float high) const;
+
+	int count() const { return cascadeCount; }
+	const Cascade& cascade(int i) const { return cascades[i]; }
+	glm::vec3 lightDirection() const { return lightDir; }
+	int atlasSize() const { return atlasResolution; }//texels per side of the whole depth texture
+	const std::vector<Tile>& dirtyTiles() const { return dirty; }//to draw this frame, empty when not cached
+
+	static int atlasSize(const Settings& settings) { return settings.resolution * ATLAS_TILES; }
+	static glm::ivec2 tileOf(int cascade) { return glm::ivec2(cascade % ATLAS_TILES, cascade / ATLAS_TILES); }
+
+	//view distance where each slice ends, lambda blends between even and logarithmic spacing
+	static void splitDistances(int count, float nearPlane, float farPlane, float lambda, float* splits);
+
+private:
+	Cascade cascades[MAX_CASCADES];
+	int cascadeCount = 0;
+	int atlasResolution = 0;
+	glm::vec3 lightDir = glm::vec3(0.0f, -1.0f, 0.0f);
+	glm::mat4 lightView = glm::mat4(1.0f);
+	bool casterHeightsSet = false;
+	float casterBottom = 0.0f, casterTop = 0.0f;
+
+	//what each cascade's slots hold, cached mode only
+	struct TileCache {
+		float tileSize = 0.0f;
+		float depthTop = 0.0f;//light space z the depth range starts at, snapped
+		glm::ivec2 origin = glm::ivec2(0);//grid position of the box's first tile
+		std::vector<glm::ivec2> held;//grid tile in each slot
+		std::vector<uint8_t> valid;
+	};
+	TileCache caches[MAX_CASCADES];
+	Settings cachedWith;
+	glm::ivec2 sunSteps = glm::ivec2(0);//elevation and azimuth of the cached sun, in steps
+	glm::vec3 sunStepped = glm::vec3(0.0f, -1.0f, 0.0f);
+	bool cacheReady = false;
+	std::vector<Tile> dirty;
+
+	void resetCache(const Settings& settings);
+	glm::mat4 boxProjection(const glm::vec2& min, const glm::vec2& max, float depthTop, float depthBottom, float casterReach) const;
+};
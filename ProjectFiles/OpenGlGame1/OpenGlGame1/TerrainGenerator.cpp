@@ -0,0 +1,131 @@
+#include "TerrainGenerator.h"
+#include <cmath>
+
+void TerrainGenerator::init(int seed, int prewarmRange) {
+    this->seed = seed;
+
+    //create noise for world gen
+    noiseGen.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    noiseGen.SetFrequency(0.03f); // Lower frequency for smoother terrain
+    noiseGen.SetSeed(seed);
+
+    noiseCache.clear();
+    for (int x = -prewarmRange; x < prewarmRange; x++) {
+        for (int z = -prewarmRange; z < prewarmRange; z++) {
+
+            noiseCache[{x, z}] = getNoise(static_cast<float>(x), static_cast<float>(z));  // Fixed value 
+        }
+    }
+}
+
+float TerrainGenerator::getNoise(float x, float z) {
+    glm::ivec2 noiseKey(x, z);
+
+    if (noiseCache.find(noiseKey) != noiseCache.end()) {
+        return noiseCache[noiseKey];
+    }
+    else {
+        float biomeValue = getBiomeNoise(x, z); // Low-frequency noise for biome selection
+        float height = remapHeight(getWarpedHeight(x, z,biomeValue), biomeValue);
+        noiseCache[noiseKey] = height;
+        return height;
+    }
+}
+
+// New function: Low-frequency noise to determine biome type
+inline float TerrainGenerator::getBiomeNoise(float x, float z) {
+    float biomeScale = 0.002f; // Very low frequency for large biome areas
+    float biomeNoise = noiseGen.GetNoise(x * biomeScale, z * biomeScale);
+    //return 1;
+    return (biomeNoise + 1.0f) / 2.0f; // Normalize to 0-1
+    
+}
+
+//takes 0 to 1 noise value and assigns height in y
+inline float TerrainGenerator::remapHeight(float noiseValue, float biomeValue) {
+    float minHeight = 32.0f;  // Base height
+    float maxHeight = 150.0f; // Max height (can increase for taller mountains)
+
+    // Define height functions for each biome
+    auto plainsHeight = [](float nv) {
+        float flatness = 0.8f; // Keep plains flattish
+        return flatness * nv;
+        };
+
+    auto hillsHeight = [](float nv) {
+        float flatness = 0.5f;
+        float steepness = 2.0f;
+        return flatness + (1.0f - flatness) * pow((nv - flatness) / (1.0f - flatness), steepness);
+        };
+
+    auto mountainsHeight = [](float nv) {
+        float flatness = 0.3f; // Less flat area for mountains
+        float steepness = 3.0f; // Steeper slopes
+        return flatness + (1.0f - flatness) * pow((nv - flatness) / (1.0f - flatness), steepness);
+        };
+
+    // Interpolate between biomes based on biomeValue
+    float height;
+    if (biomeValue < 0.3f) {
+        height = plainsHeight(noiseValue); // Pure plains
+    }
+    else if (biomeValue < 0.6f) {
+        // Blend plains and hills
+        float t = (biomeValue - 0.3f) / 0.4f; // Transition factor (0 to 1)
+        height = (1.0f - t) * plainsHeight(noiseValue) + t * hillsHeight(noiseValue);
+    }
+    else {
+        // Blend hills and mountains
+        float t = (biomeValue - 0.7f) / 0.3f; // Transition factor (0 to 1)
+        height = (1.0f - t) * hillsHeight(noiseValue) + t * mountainsHeight(noiseValue);
+    }
+
+    // Scale height based on biome
+    float scale;
+    if (biomeValue < 0.3f) {
+        scale = 0.2f; // Low height for plains
+    }
+    else if (biomeValue < 0.6f) {
+        scale = 0.8f; // Moderate height for hills
+    }
+    else {
+        scale = 2.0f; // Full height for mountains
+    }
+
+    return minHeight + height * (maxHeight * scale);
+}
+
+// Updated getWarpedHeight for more variation
+inline float TerrainGenerator::getWarpedHeight(float x, float z, float biomeValue) {
+    float warpScale = 0.2f;
+    float warpX = noiseGen.GetNoise(x * warpScale + 10.0f, z * warpScale + 10.0f) * 15.0f; // Increased warp
+    float warpZ = noiseGen.GetNoise(x * warpScale + 20.0f, z * warpScale + 20.0f) * 15.0f;
+    float warpedX = x + warpX;
+    float warpedZ = z + warpZ;
+
+    float height = 0.0f;
+    float amplitude = 0.9f; // Increased base amplitude for more variation
+    float frequency = (biomeValue > 0.7f) ? 0.08f : 0.3f; // Lower frequency for mountains
+    float lacunarity = 2.0f;
+    float persistence = (biomeValue >= 0.7f) ? 0.7f : 0.6f; // Higher persistence for more detail 
+    int octaves = (biomeValue > 0.7f) ? 5 : 4; //jaggedness
+    float totalAmplitude = 0.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        float sample = noiseGen.GetNoise(warpedX * frequency, warpedZ * frequency);
+        height += sample * amplitude;
+        totalAmplitude += amplitude;
+        amplitude *= persistence;
+        frequency *= lacunarity;
+    }
+
+    // Normalize to 0-1
+    height = (height + totalAmplitude) / (2.0f * totalAmplitude);
+
+    // Amplify peaks in mountain regions
+    if (biomeValue >= 0.7f) {
+        height = pow(height, 0.6f); // Exaggerates peaks; adjust exponent as needed
+    }
+
+    return height;
+}
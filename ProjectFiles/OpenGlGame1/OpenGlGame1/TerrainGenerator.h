@@ -0,0 +1,27 @@
+#pragma once
+#include <FastNoiseLite.h>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <mutex>
+#include "Vec3Hash.h"
+
+//height noise for world gen, kept out of main so chunks can be generated without a window/gl context
+class TerrainGenerator
+{
+public:
+	void init(int seed, int prewarmRange);//prewarmRange is in blocks around the origin, 0 skips the prewarm
+
+	float getNoise(float x, float z);//returns cached height or gens new height, caller holds noiseMutex
+	int getSeed() const { return seed; }
+
+	std::mutex noiseMutex;
+
+private:
+	FastNoiseLite noiseGen;
+	std::unordered_map<glm::ivec2, float, IVec2Hash> noiseCache;
+	int seed = 0;
+
+	inline float getBiomeNoise(float x, float z);
+	inline float remapHeight(float noiseValue, float biomeValue);
+	inline float getWarpedHeight(float x, float z, float biomeValue);
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+//fnv-1a of a uniform name, constexpr so names written in code are hashed by the compiler
+constexpr uint32_t uniformHash(const char* name, uint32_t hash = 2166136261u) {
+	return *name ? uniformHash(name + 1, (hash ^ static_cast<uint8_t>(*name)) * 16777619u) : hash;
+}
+
+//what a program's reflection found, by name hash. Filled once after linking, then lookups are a binary
+//search over a few ints instead of a driver call with a string
+class UniformTable
+{
+public:
+	void add(const char* name, int value) {
+		uint32_t hash = uniformHash(name);
+		auto it = std::lower_bound(entries.begin(), entries.end(), std::make_pair(hash, INT32_MIN));
+		if (it != entries.end() && it->first == hash) {
+			std::cerr << "Uniform name hash collision on " << name << ", keeping the first one" << std::endl;
+			return;
+		}
+		entries.insert(it, std::make_pair(hash, value));
+	}
+
+	int find(uint32_t hash) const {//-1 if the program has nothing by that name
+		auto it = std::lower_bound(entries.begin(), entries.end(), std::make_pair(hash, INT32_MIN));
+		return it != entries.end() && it->first == hash ? it->second : -1;
+	}
+	int find(const char* name) const { return find(uniformHash(name)); }
+
+	size_t size() const { return entries.size(); }
+	void clear() { entries.clear(); }
+
+private:
+	std::vector<std::pair<uint32_t, int>> entries;//sorted by hash
+};
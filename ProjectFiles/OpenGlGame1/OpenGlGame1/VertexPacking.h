@@ -6,6 +6,7 @@
 
 struct PackedVertex {
     int16_t pos[3];       // 3 floats for position (12 bytes)
+    uint16_t originSlot;  // which chunk origin to add in the shader, set by ChunkArena on upload (was padding)
     uint32_t colour;     // Packed RGBA (4 bytes)
     uint16_t tex[2];    // 2 x 16-bit texture coordinates (4 bytes)
     int32_t normal;     // Packed normal using GL_INT_2_10_10_10_REV (4 bytes)
@@ -0,0 +1,93 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cmath>
+#include <algorithm>
+
+//players bounding box(collsisions)
+struct AABB {
+	glm::vec3 min;
+	glm::vec3 max;
+
+	AABB(const glm::vec3& min, const glm::vec3& max) : min(min), max(max) {}
+};
+
+//where a moveBox ended up
+struct BoxMove {
+	glm::vec3 position = glm::vec3(0.0f);
+	glm::vec3 velocity = glm::vec3(0.0f);//the blocked axes zeroed
+	glm::bvec3 blocked = glm::bvec3(false);//ran into a block on that axis
+	bool grounded = false;//blocked going down
+	int steps = 0;//sub steps taken
+};
+
+static constexpr float COLLISION_SKIN = 0.001f;//gap left between a box and the block it stopped at
+static constexpr float MAX_SUBSTEP = 0.5f;//blocks moved on any axis per sub step
+static constexpr int MAX_SUBSTEPS = 16;
+
+//moves the box [min, max] along one axis by distance, stopping COLLISION_SKIN short of the first solid block in
+//the way. Every block the box sweeps through is looked at in order, however far it goes, so nothing is tunneled
+//through. Blocks the box already overlaps are not in the way, so a box stuck in a block can still get out of it.
+//isSolid(const glm::ivec3&) is asked for one layer of blocks across the move at a time, nearest layer first.
+//Returns true if it was stopped
+template <typename IsSolid>
+bool sweepBoxAxis(const glm::vec3& min, const glm::vec3& max, int axis, float distance, IsSolid isSolid, float& moved) {
+	moved = distance;
+	if (distance == 0.0f) return false;
+	int first, last, step;
+	if (distance > 0.0f) {
+		first = static_cast<int>(std::ceil(max[axis]));
+		last = static_cast<int>(std::ceil(max[axis] + distance)) - 1;
+		step = 1;
+	}
+	else {
+		first = static_cast<int>(std::floor(min[axis])) - 1;
+		last = static_cast<int>(std::floor(min[axis] + distance));
+		step = -1;
+	}
+	//the other two axes, the blocks the box overlaps there
+	glm::ivec3 low(static_cast<int>(std::floor(min.x)), static_cast<int>(std::floor(min.y)), static_cast<int>(std::floor(min.z)));
+	glm::ivec3 high(static_cast<int>(std::ceil(max.x)) - 1, static_cast<int>(std::ceil(max.y)) - 1, static_cast<int>(std::ceil(max.z)) - 1);
+	for (int layer = first; layer * step <= last * step; layer += step) {
+		low[axis] = high[axis] = layer;
+		glm::ivec3 block;
+		for (block.x = low.x; block.x <= high.x; block.x++) {
+			for (block.z = low.z; block.z <= high.z; block.z++) {
+				for (block.y = low.y; block.y <= high.y; block.y++) {
+					if (!isSolid(block)) continue;
+					moved = step > 0 ? layer - COLLISION_SKIN - max[axis] : layer + 1 + COLLISION_SKIN - min[axis];
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+//moves a box at position (box is relative to it) by velocity for deltaTime through solid blocks, x then z then y
+//like walking does, sliding along whatever it hits. Fast moves are split into sub steps of at most MAX_SUBSTEP so
+//turning a corner is not decided by one big step, past MAX_SUBSTEPS they just get longer, every step is swept
+//so nothing is passed through either way. No allocation, no gl, the same input always gives the same result
+template <typename IsSolid>
+BoxMove moveBox(const glm::vec3& position, const AABB& box, const glm::vec3& velocity, float deltaTime, IsSolid isSolid) {
+	BoxMove move;
+	move.position = position;
+	move.velocity = velocity;
+	glm::vec3 motion = glm::abs(velocity * deltaTime);
+	float longest = std::max(motion.x, std::max(motion.y, motion.z));
+	move.steps = std::min(std::max(static_cast<int>(std::ceil(longest / MAX_SUBSTEP)), 1), MAX_SUBSTEPS);
+	float stepTime = deltaTime / move.steps;
+	const int order[3] = { 0, 2, 1 };
+	for (int s = 0; s < move.steps; s++) {
+		for (int axis : order) {
+			if (move.velocity[axis] == 0.0f) continue;
+			float moved;
+			bool stopped = sweepBoxAxis(move.position + box.min, move.position + box.max, axis, move.velocity[axis] * stepTime, isSolid, moved);
+			move.position[axis] += moved;
+			if (!stopped) continue;
+			move.grounded = move.grounded || (axis == 1 && move.velocity.y < 0.0f);
+			move.blocked[axis] = true;
+			move.velocity[axis] = 0.0f;
+		}
+	}
+	return move;
+}
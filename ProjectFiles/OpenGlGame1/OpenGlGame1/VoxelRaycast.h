@@ -0,0 +1,126 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cmath>
+#include <limits>
+
+//what a ray ran into
+struct RaycastHit {
+	glm::ivec3 block = glm::ivec3(0);
+	glm::ivec3 normal = glm::ivec3(0);//out of the face the ray went in through, zero when it started inside the block
+	float distance = 0.0f;//along the normalized ray to that face
+};
+
+//Amanatides & Woo grid traversal over unit blocks: visits every block the ray passes through in order, stepping
+//to whichever block boundary is closest next, so it cannot skip a corner and knows the face it crossed. Exact
+//ties, a ray through an edge or corner, step z first, then y, then x.
+//isSolid(const glm::ivec3&) is asked once per block visited, from the one the origin is in outward, and can stop
+//the walk early by returning false from keepGoing(const glm::ivec3&), which has to end it when maxDistance is
+//infinite and nothing is hit. No allocation, no gl
+template <typename IsSolid, typename KeepGoing>
+bool raycastVoxels(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, IsSolid isSolid, KeepGoing keepGoing, RaycastHit& hit) {
+	float length = glm::length(direction);
+	if (!(length > 0.0f) || !(maxDistance >= 0.0f)) return false;
+	glm::vec3 dir = direction / length;
+
+	glm::ivec3 block(static_cast<int>(std::floor(origin.x)), static_cast<int>(std::floor(origin.y)), static_cast<int>(std::floor(origin.z)));
+	glm::ivec3 step(0);
+	glm::vec3 tMax(std::numeric_limits<float>::infinity());//distance to the next boundary on each axis
+	//worked out from the origin every time rather than added up, so it does not drift over long rays
+	auto boundary = [&](int axis) { return (block[axis] + (step[axis] > 0) - origin[axis]) / dir[axis]; };
+	for (int axis = 0; axis < 3; axis++) {
+		if (dir[axis] == 0.0f) continue;
+		step[axis] = dir[axis] > 0.0f ? 1 : -1;
+		tMax[axis] = boundary(axis);
+	}
+
+	glm::ivec3 normal(0);
+	float distance = 0.0f;
+	while (keepGoing(block)) {
+		if (isSolid(block)) {
+			hit.block = block;
+			hit.normal = normal;
+			hit.distance = distance;
+			return true;
+		}
+		int axis = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+		distance = tMax[axis];
+		if (distance > maxDistance) return false;
+		block[axis] += step[axis];
+		tMax[axis] = boundary(axis);
+		normal = glm::ivec3(0);
+		normal[axis] = -step[axis];
+	}
+	return false;
+}
+
+template <typename IsSolid>
+bool raycastVoxels(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, IsSolid isSolid, RaycastHit& hit) {
+	return raycastVoxels(origin, direction, maxDistance, isSolid, [](const glm::ivec3&) { return true; }, hit);
+}
+
+//the same traversal, but emptySpan(const glm::ivec3& block) says how big an empty aligned cube the block is in: 0
+//when the block is solid, 1 when only it is known to be air, or a bigger power of two when the whole cube of that
+//size around it is air, and then the ray jumps straight to where it leaves that cube instead of visiting its
+//blocks. keepGoing is asked first, so it can find whatever emptySpan needs. Hits the same block as raycastVoxels
+//as long as the spans are right
+template <typename EmptySpan, typename KeepGoing>
+bool raycastVoxelsSkipping(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, EmptySpan emptySpan, KeepGoing keepGoing, RaycastHit& hit) {
+	float length = glm::length(direction);
+	if (!(length > 0.0f) || !(maxDistance >= 0.0f)) return false;
+	glm::vec3 dir = direction / length;
+
+	glm::ivec3 block(static_cast<int>(std::floor(origin.x)), static_cast<int>(std::floor(origin.y)), static_cast<int>(std::floor(origin.z)));
+	glm::ivec3 step(0);
+	glm::vec3 tMax(std::numeric_limits<float>::infinity());
+	glm::vec3 inverse = 1.0f / dir;//a multiply per step instead of a divide, these rays are many and short
+	auto boundary = [&](int axis) { return (block[axis] + (step[axis] > 0) - origin[axis]) * inverse[axis]; };
+	for (int axis = 0; axis < 3; axis++) {
+		if (dir[axis] == 0.0f) continue;
+		step[axis] = dir[axis] > 0.0f ? 1 : -1;
+		tMax[axis] = boundary(axis);
+	}
+
+	glm::ivec3 normal(0);
+	float distance = 0.0f;
+	while (keepGoing(block)) {
+		int span = emptySpan(block);
+		if (span == 0) {
+			hit.block = block;
+			hit.normal = normal;
+			hit.distance = distance;
+			return true;
+		}
+		if (span > 1) {
+			//the nearest of the cube's far faces, then the block just past it. Masking the low bits floors
+			//negative coordinates too
+			glm::ivec3 low(block.x & -span, block.y & -span, block.z & -span);
+			glm::vec3 exit(std::numeric_limits<float>::infinity());
+			for (int axis = 0; axis < 3; axis++) {
+				if (step[axis] != 0) exit[axis] = (low[axis] + (step[axis] > 0) * span - origin[axis]) * inverse[axis];
+			}
+			int axis = exit.x < exit.y ? (exit.x < exit.z ? 0 : 2) : (exit.y < exit.z ? 1 : 2);
+			distance = std::max(distance, exit[axis]);
+			if (distance > maxDistance) return false;
+			for (int other = 0; other < 3; other++) {
+				if (other == axis) continue;
+				int at = static_cast<int>(std::floor(origin[other] + dir[other] * distance));
+				block[other] = std::min(std::max(at, low[other]), low[other] + span - 1);
+			}
+			block[axis] = step[axis] > 0 ? low[axis] + span : low[axis] - 1;
+			for (int a = 0; a < 3; a++) {
+				if (step[a] != 0) tMax[a] = boundary(a);
+			}
+			normal = glm::ivec3(0);
+			normal[axis] = -step[axis];
+			continue;
+		}
+		int axis = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+		distance = tMax[axis];
+		if (distance > maxDistance) return false;
+		block[axis] += step[axis];
+		tMax[axis] = boundary(axis);
+		normal = glm::ivec3(0);
+		normal[axis] = -step[axis];
+	}
+	return false;
+}
@@ -0,0 +1,439 @@
+#include "World.h"
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <unordered_set>
+#include <cmath>
+
+const char* const World::BEE_MODEL = "../ResourceFiles/bee.glb";
+
+World::World(int renderDistance)
+    : renderDistance(renderDistance), isInitialLoading(true), currentLoadingRadius(0) {
+    entitySystems.setThreads(static_cast<int>(std::min(4u, std::max(1u, std::thread::hardware_concurrency()))));
+    entitySystems.setGrid(&entityGrid);
+}
+
+World::~World() {
+    //async tasks write into chunks, let them finish before anything is torn down
+    for (auto& pair : chunkGenerationFutures) pair.second.wait();
+    for (auto& pair : chunkMeshFutures) pair.second.wait();
+}
+
+void World::init(int seed) {
+
+    if (seed == -1) {
+        std::random_device rd;
+        seed = rd();
+        std::cout << seed;
+    }
+    this->seed = seed;
+
+    terrain.init(seed, Chunk::chunkSize * renderDistance);
+}
+
+void World::generateChunkAsync(const glm::vec3& pos) {
+    // Launch async task to generate the chunk
+
+    int chunkX = static_cast<int>(pos.x / Chunk::chunkSize);
+    int chunkZ = static_cast<int>(pos.z / Chunk::chunkSize);
+    uint64_t key = getChunkKey(chunkX, chunkZ);
+
+    chunkGenerationFutures[key] = std::async(std::launch::async, [this, pos, key, chunkX, chunkZ]() {
+        Chunk chunk(pos, seed, this);
+        std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+        auto it = chunks.emplace(key, std::move(chunk)).first; // Store in chunks with the uint64_t key
+        heights.setChunk(chunkX, chunkZ, it->second.columnTops, static_cast<int>(it->second.chunkPosition.y));
+        });
+}
+
+void World::tryApplyChunkGeneration() {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+
+    for (auto it = chunkGenerationFutures.begin(); it != chunkGenerationFutures.end();) {
+        if (it->second.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
+            // Remove the completed future, buffers get made by the renderer on first upload
+            it = chunkGenerationFutures.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void World::updateChunks(const glm::vec3& playerPosition) {
+    // Calculate the player's chunk position in chunk coordinates
+    glm::ivec3 playerChunkPos(
+        static_cast<int>(floor(playerPosition.x / Chunk::chunkSize)),
+        0, // Y is fixed at 0 for chunk coordinates
+        static_cast<int>(floor(playerPosition.z / Chunk::chunkSize))
+    );
+
+    // Store chunk positions and distances
+    std::vector<std::pair<uint64_t, float>> chunkPositions;
+    int effectiveRenderDistance = isInitialLoading ? currentLoadingRadius : renderDistance;
+    chunkPositions.reserve((2 * effectiveRenderDistance + 1) * (2 * effectiveRenderDistance + 1)); // Preallocate
+
+    for (int x = -effectiveRenderDistance; x <= effectiveRenderDistance; x++) {
+        for (int z = -effectiveRenderDistance; z <= effectiveRenderDistance; z++) {
+            glm::ivec3 chunkPos = playerChunkPos + glm::ivec3(x, 0, z); // Offset in chunk coordinates
+            uint64_t key = getChunkKey(chunkPos.x, chunkPos.z);
+            glm::vec3 realChunkPos = glm::vec3(chunkPos.x * Chunk::chunkSize, -Chunk::baseTerrainHeight, chunkPos.z * Chunk::chunkSize);
+
+            // Use Manhattan distance for faster sorting (no square root needed)
+            float distance = std::abs(realChunkPos.x - playerPosition.x) + std::abs(realChunkPos.z - playerPosition.z);
+            chunkPositions.emplace_back(key, distance);
+        }
+    }
+
+    // Sort by distance
+    std::sort(chunkPositions.begin(), chunkPositions.end(),
+        [](const std::pair<uint64_t, float>& a, const std::pair<uint64_t, float>& b) {
+            return a.second < b.second;
+        });
+
+    std::unordered_set<uint64_t> loadedChunks;
+    loadedChunks.reserve(chunkPositions.size());//reduce rehashing
+    int chunksGeneratedThisFrame = 0;
+    const int maxChunksGeneratedPerFrame = isInitialLoading ? 2 : 1; // Load 2 chunks per frame during initial loading
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(chunksMutex); // Lock here
+        for (const auto& pair : chunkPositions) {
+            if (chunksGeneratedThisFrame >= maxChunksGeneratedPerFrame) break;
+
+            loadedChunks.insert(pair.first);
+            int chunkX = static_cast<int32_t>(pair.first >> 32); // Extract x
+            int chunkZ = static_cast<int32_t>(pair.first & 0xFFFFFFFF); // Extract z
+            glm::vec3 realChunkPos(chunkX * Chunk::chunkSize, -Chunk::baseTerrainHeight, chunkZ * Chunk::chunkSize);
+
+            if (chunks.find(pair.first) == chunks.end() && chunkGenerationFutures.find(pair.first) == chunkGenerationFutures.end()) {
+                generateChunkAsync(realChunkPos);
+                chunksGeneratedThisFrame++;
+            }
+        }
+    }
+
+
+    // Update the loading radius
+    if (isInitialLoading) {
+        std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+        // Check if all chunks within the current radius are loaded
+        int expectedChunks = (2 * currentLoadingRadius + 1) * (2 * currentLoadingRadius + 1);
+        int loadedChunksCount = 0;
+        for (const auto& pair : chunks) {
+
+            int dx = std::abs(pair.second.chunkPosition.x / Chunk::chunkSize - playerChunkPos.x);
+            int dz = std::abs(pair.second.chunkPosition.z / Chunk::chunkSize - playerChunkPos.z);
+            if (dx <= currentLoadingRadius && dz <= currentLoadingRadius) {
+                loadedChunksCount++;
+            }
+        }
+        if (loadedChunksCount >= expectedChunks) {
+            currentLoadingRadius++;
+            if (currentLoadingRadius > renderDistance) {
+                isInitialLoading = false;
+                std::cout << "Initial loading complete! All chunks within render distance loaded." << std::endl;
+            }
+        }
+    }
+
+    // Mark chunks as active/inactive
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    for (auto& pair : chunks) {
+        bool active = loadedChunks.find(pair.first) != loadedChunks.end();
+        if (pair.second.isActive != active) {
+            pair.second.isActive = active;
+            activityChanges.push_back(&pair.second);
+        }
+    }
+}
+
+Chunk* World::getChunk(const glm::vec3& pos) {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex); // Keep this for external access
+
+    //pos is a world position, chunks are keyed by chunk coords
+    uint64_t key = getChunkKey(static_cast<int>(floor(pos.x / Chunk::chunkSize)), static_cast<int>(floor(pos.z / Chunk::chunkSize)));
+    // Look up the chunk
+    auto it = chunks.find(key);
+    return (it != chunks.end()) ? &it->second : nullptr;
+}
+
+bool World::hasPendingWork() {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    return !chunkGenerationFutures.empty() || !chunkMeshFutures.empty();
+}
+
+// Launch an asynchronous mesh update for a chunk.
+void World::updateChunkMeshAsync(Chunk& chunk) {
+
+
+    if (chunk.fullRebuildNeeded && chunk.isActive && activeAsyncTasks < MAX_ASYNC_TASKS()) {
+        // Launch an async task that calls generateMeshData.
+        chunkMeshFutures[chunk.chunkPosition] = std::async(std::launch::async, [&chunk]() {
+            return chunk.generateMeshData();
+            });
+        // Reset the flags on the chunk so we don't launch it again until needed.
+        chunk.fullRebuildNeeded = false;
+        activeAsyncTasks++;
+    }
+}
+
+// Check if an asynchronous mesh update for the given chunk is ready, and if so queue it for upload.
+void World::tryApplyChunkMeshUpdate(Chunk& chunk) {
+    auto it = chunkMeshFutures.find(chunk.chunkPosition);
+    if (it != chunkMeshFutures.end()) {
+        if (it->second.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
+
+            MeshData newMesh = it->second.get();
+            chunkMeshFutures.erase(it);
+            activeAsyncTasks--;
+
+            chunk.mesh = std::move(newMesh);
+
+            if (std::find(meshUploads.begin(), meshUploads.end(), &chunk) == meshUploads.end()) {
+                meshUploads.push_back(&chunk);
+            }
+        }
+    }
+}
+
+std::vector<Chunk*> World::takeActivityChanges() {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    std::vector<Chunk*> changes;
+    changes.swap(activityChanges);
+    return changes;
+}
+
+std::vector<Chunk*> World::takeMeshUploads() {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    std::vector<Chunk*> uploads;
+    uploads.swap(meshUploads);
+    return uploads;
+}
+
+void World::processChunkMeshingInOrder(const glm::vec3& playerPosition) {
+
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex); // Single lock for all chunk operations
+    int processedChunks = 0;
+    const int maxChunksPerFrame = 20;//needs to be >1 as 1 is always used for current chunk
+
+    //pos in chunks (eg 0,0,1)
+    glm::ivec3 playerChunkPos = glm::ivec3(
+        floor(playerPosition.x / Chunk::chunkSize),
+        0, // Y is fixed at 0 for chunk coordinates
+        floor(playerPosition.z / Chunk::chunkSize)
+    );
+
+    uint64_t key = getChunkKey(playerChunkPos.x, playerChunkPos.z);
+    // Look up the chunk
+    auto playerChunkIt = chunks.find(key);
+
+    if (playerChunkIt != chunks.end() && processedChunks < maxChunksPerFrame) {
+        Chunk& playerChunk = playerChunkIt->second;
+        if (playerChunk.isActive) {
+            if (playerChunk.fullRebuildNeeded) {
+                updateChunkMeshAsync(playerChunk);
+            }
+            tryApplyChunkMeshUpdate(playerChunk);
+            processedChunks++;
+        }
+    }
+
+    for (auto& pair : chunks) {
+        if (processedChunks >= maxChunksPerFrame) break;
+        Chunk& chunk = pair.second;
+        if (chunk.isActive) {
+            if (chunk.fullRebuildNeeded) {
+                updateChunkMeshAsync(chunk);
+            }
+            tryApplyChunkMeshUpdate(chunk);
+        }
+    }
+}
+
+void World::updateEntities(float deltaTime, const glm::vec3& playerPos) {
+    entitySystems.update(entities, deltaTime, playerPos);
+}
+
+EntityId World::spawnBee(const glm::vec3& position) {
+    EntityId id = entities.create(entities.modelHandle(BEE_MODEL), position, 10.0f);
+    entityGrid.insert(id, position);
+    return id;
+}
+
+//chunk column of a block coordinate, rounding down for negatives too
+static int chunkCoord(int block) {
+    return block >= 0 ? block / Chunk::chunkSize : (block + 1) / Chunk::chunkSize - 1;
+}
+
+//one lock for the whole ray, and the chunk map is only searched again when the ray crosses into another column
+bool World::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    const Chunk* chunk = nullptr;
+    glm::ivec3 chunkOrigin(0);
+    int chunkX = 0, chunkZ = 0;
+    bool looked = false;
+    float dirY = direction.y;
+
+    auto keepGoing = [&](const glm::ivec3& block) {
+        int localY = block.y + Chunk::baseTerrainHeight;
+        if ((localY < 0 && dirY <= 0.0f) || (localY >= Chunk::chunkHeight && dirY >= 0.0f)) return false;
+        int x = chunkCoord(block.x);
+        int z = chunkCoord(block.z);
+        if (!looked || x != chunkX || z != chunkZ) {
+            auto it = chunks.find(getChunkKey(x, z));
+            chunk = it != chunks.end() ? &it->second : nullptr;
+            if (chunk) chunkOrigin = glm::ivec3(chunk->chunkPosition);
+            chunkX = x;
+            chunkZ = z;
+            looked = true;
+        }
+        return chunk != nullptr;
+    };
+    auto isSolid = [&](const glm::ivec3& block) {
+        glm::ivec3 local = block - chunkOrigin;
+        if (local.y < 0 || local.y >= Chunk::chunkHeight) return false;
+        return chunk->blocks[chunk->getBlockIndex(local.x, local.y, local.z)] != BlockType::AIR;
+    };
+    return raycastVoxels(origin, direction, maxDistance, isSolid, keepGoing, hit);
+}
+
+//one lock for the whole move. Chunks are remembered by the low bit of their column on each axis, so a box on a
+//chunk corner looks each of its four chunks up once however many blocks it asks about
+BoxMove World::moveBox(const glm::vec3& position, const AABB& box, const glm::vec3& velocity, float deltaTime) {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    const Chunk* cached[4] = {};
+    uint64_t cachedKeys[4] = {};
+    bool known[4] = {};
+
+    auto isSolid = [&](const glm::ivec3& block) {
+        int localY = block.y + Chunk::baseTerrainHeight;
+        if (localY < 0 || localY >= Chunk::chunkHeight) return false;
+        int x = chunkCoord(block.x);
+        int z = chunkCoord(block.z);
+        int slot = (x & 1) | (z & 1) << 1;
+        uint64_t key = getChunkKey(x, z);
+        if (!known[slot] || cachedKeys[slot] != key) {
+            auto it = chunks.find(key);
+            cached[slot] = it != chunks.end() ? &it->second : nullptr;
+            cachedKeys[slot] = key;
+            known[slot] = true;
+        }
+        const Chunk* chunk = cached[slot];
+        if (!chunk) return false;
+        int localX = block.x - x * Chunk::chunkSize;
+        int localZ = block.z - z * Chunk::chunkSize;
+        return ((chunk->occupancy[localY * Chunk::chunkSize + localZ] >> localX) & 1) != 0;
+    };
+    return ::moveBox(position, box, velocity, deltaTime, isSolid);
+}
+
+static_assert(Chunk::baseTerrainHeight % MeshData::sectionHeight == 0, "sections have to line up with world cells");
+
+//chunks are never erased from the map, so a pointer found under chunksMutex stays good after it is released.
+//Their blocks only change in setBlockAt, which is kept out for the whole batch by blocksMutex
+size_t World::raycastBatch(const BlockRay* rays, size_t count, RaycastHit* hits, uint8_t* hitFlags, RaycastBatchScratch& scratch) {
+    const int cell = MeshData::sectionHeight;
+    std::shared_lock<std::shared_mutex> readingBlocks(blocksMutex);
+
+    scratch.order.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        int x = chunkCoord(static_cast<int>(std::floor(rays[i].origin.x)));
+        int z = chunkCoord(static_cast<int>(std::floor(rays[i].origin.z)));
+        uint64_t column = static_cast<uint64_t>(static_cast<uint16_t>(x)) << 16 | static_cast<uint16_t>(z);
+        scratch.order[i] = column << 32 | i;
+    }
+    std::sort(scratch.order.begin(), scratch.order.end());
+    std::fill(scratch.columnKnown, scratch.columnKnown + RaycastBatchScratch::CACHED_COLUMNS, false);
+
+    auto findChunk = [&](int x, int z) {
+        uint64_t key = getChunkKey(x, z);
+        size_t slot = (x & 15) | (z & 15) << 4;
+        if (!scratch.columnKnown[slot] || scratch.columnKeys[slot] != key) {
+            std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+            auto it = chunks.find(key);
+            scratch.columnKeys[slot] = key;
+            scratch.columnChunks[slot] = it != chunks.end() ? &it->second : nullptr;
+            scratch.columnKnown[slot] = true;
+        }
+        return scratch.columnChunks[slot];
+    };
+
+    size_t hitCount = 0;
+    for (uint64_t entry : scratch.order) {
+        uint32_t index = static_cast<uint32_t>(entry);
+        const BlockRay& ray = rays[index];
+        const Chunk* chunk = nullptr;
+        glm::ivec3 chunkOrigin(0);
+        int chunkX = 0, chunkZ = 0;
+        bool looked = false;
+
+        auto keepGoing = [&](const glm::ivec3& block) {
+            int localY = block.y + Chunk::baseTerrainHeight;
+            if ((localY < 0 && ray.direction.y <= 0.0f) || (localY >= Chunk::chunkHeight && ray.direction.y >= 0.0f)) return false;
+            int x = chunkCoord(block.x);
+            int z = chunkCoord(block.z);
+            if (!looked || x != chunkX || z != chunkZ) {
+                chunk = findChunk(x, z);
+                if (chunk) chunkOrigin = glm::ivec3(chunk->chunkPosition);
+                chunkX = x;
+                chunkZ = z;
+                looked = true;
+            }
+            return chunk != nullptr;
+        };
+        //a whole section, then a 4^3 brick, then the block itself
+        auto emptySpan = [&](const glm::ivec3& block) {
+            glm::ivec3 local = block - chunkOrigin;
+            if (local.y < 0 || local.y >= Chunk::chunkHeight) return cell;
+            uint64_t bricks = chunk->sectionBricks[local.y / cell];
+            if (bricks == 0) return cell;
+            if (((bricks >> (local.x / 4 + local.z / 4 * 4 + local.y % cell / 4 * 16)) & 1) == 0) return 4;
+            return ((chunk->occupancy[local.y * Chunk::chunkSize + local.z] >> local.x) & 1) != 0 ? 0 : 1;
+        };
+        bool hit = raycastVoxelsSkipping(ray.origin, ray.direction, ray.maxDistance, emptySpan, keepGoing, hits[index]);
+        hitFlags[index] = hit;
+        hitCount += hit;
+    }
+    return hitCount;
+}
+
+bool World::setBlockAt(const glm::vec3& blockPos, BlockType type) {
+    glm::vec3 chunkPos = glm::floor(blockPos / glm::vec3(Chunk::chunkSize, 1, Chunk::chunkSize)) * glm::vec3(Chunk::chunkSize, 0, Chunk::chunkSize);
+    chunkPos.y = -Chunk::baseTerrainHeight; // Adjust if your chunks have a fixed Y
+
+    uint64_t key = getChunkKey(chunkPos.x / Chunk::chunkSize, chunkPos.z / Chunk::chunkSize);
+    // Look up the chunk
+    std::unique_lock<std::shared_mutex> editingBlocks(blocksMutex);//before chunksMutex, see World.h
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    auto it = chunks.find(key);
+    if (it == chunks.end()) return false;
+
+    Chunk& chunk = it->second;
+    // Calculate local coordinates within the chunk
+    int localX = static_cast<int>(blockPos.x - chunkPos.x);
+    int localY = static_cast<int>(blockPos.y - chunkPos.y);
+    int localZ = static_cast<int>(blockPos.z - chunkPos.z);
+
+    // Check if the local coordinates are within chunk bounds
+    if (localX >= 0 && localX < Chunk::chunkSize &&
+        localY >= 0 && localY < Chunk::chunkHeight &&
+        localZ >= 0 && localZ < Chunk::chunkSize) {
+
+        chunk.setBlock(localX, localY, localZ, type);
+        heights.setColumn(static_cast<int>(chunkPos.x) + localX, static_cast<int>(chunkPos.z) + localZ,
+            static_cast<int>(chunkPos.y) + chunk.columnTops[localZ * Chunk::chunkSize + localX]);
+        return true;
+    }
+    return false;
+}
+
+bool World::regionHeights(int minX, int minZ, int maxX, int maxZ, int& low, int& high) {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    return heights.regionRange(minX, minZ, maxX, maxZ, low, high);
+}
+
+bool World::raycastTerrain(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) {
+    std::lock_guard<std::recursive_mutex> lock(chunksMutex);
+    return heights.raycast(origin, direction, maxDistance, hit);
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <future>//threading
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+
+#include "Chunk.h"
+#include "ChunkSource.h"
+#include "TerrainGenerator.h"
+#include "MeshData.h"
+#include "Vec3Hash.h"
+#include "EntityStore.h"
+#include "EntitySystems.h"
+#include "EntityGrid.h"
+#include "VoxelRaycast.h"
+#include "VoxelCollision.h"
+#include "HeightPyramid.h"
+
+//one ray of a World::raycastBatch
+struct BlockRay {
+	glm::vec3 origin;
+	glm::vec3 direction;
+	float maxDistance;
+};
+
+//working memory for World::raycastBatch, one per calling thread. Reused between batches so they stop allocating
+//once it has grown to the biggest batch
+struct RaycastBatchScratch {
+	static constexpr int CACHED_COLUMNS = 256;//chunk lookups remembered within a batch, by the low 4 bits of x and z
+	std::vector<uint64_t> order;//start column in the high 32 bits and the ray index in the low, sorted
+	uint64_t columnKeys[CACHED_COLUMNS];
+	const Chunk* columnChunks[CACHED_COLUMNS];//null when the chunk is not loaded
+	bool columnKnown[CACHED_COLUMNS];
+};
+
+//gl free world state: chunk storage, async generation + meshing, streaming around the player and entities
+//the renderer only reads chunks and uploads the meshes handed back by takeMeshUploads / takeActivityChanges
+class World : public ChunkSource
+{
+public:
+	//thread count
+	static const size_t MAX_ASYNC_TASKS() {
+		return std::thread::hardware_concurrency();
+	}
+
+	World(int renderDistance);
+	~World();
+
+	void init(int seed);//seed -1 picks a random seed
+
+	Chunk* getChunk(const glm::vec3& pos) override;
+	TerrainGenerator& getTerrain() override { return terrain; }
+
+	//streaming, call once per frame
+	void updateChunks(const glm::vec3& playerPosition);
+	void tryApplyChunkGeneration();
+	void processChunkMeshingInOrder(const glm::vec3& playerPosition);
+	std::vector<Chunk*> takeMeshUploads();//chunks whose cpu mesh changed since last call
+	std::vector<Chunk*> takeActivityChanges();//chunks whose isActive flipped since last call, may repeat
+	bool isLoading() const { return isInitialLoading; }
+	bool hasPendingWork();//generation or meshing still in flight
+
+	//simulation
+	void updateEntities(float deltaTime, const glm::vec3& playerPos);//entities far from playerPos update less often
+	EntityId spawnBee(const glm::vec3& position);
+
+	//building, positions are world space block positions
+	//first non air block along the ray within maxDistance, which can be infinite. Unloaded chunks and the space
+	//above and below the world end the ray as a miss
+	bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit);
+	//the same for many rays at once, for line of sight and the like. Rays are walked grouped by the column they
+	//start in, test the chunks' occupancy bits and jump over empty bricks and sections. Safe to call from several threads at
+	//once, each with its own scratch, and while setBlockAt runs: a batch holds blocksMutex shared for its whole walk and
+	//block edits wait for it. hits[i] and hitFlags[i] are ray i's, returns how many hit
+	size_t raycastBatch(const BlockRay* rays, size_t count, RaycastHit* hits, uint8_t* hitFlags, RaycastBatchScratch& scratch);
+	bool setBlockAt(const glm::vec3& blockPos, BlockType type);
+	//a box at position (box relative to it) moved by velocity for deltaTime through the loaded blocks, see
+	//moveBox in VoxelCollision.h. Unloaded chunks and the space above and below the world are air
+	BoxMove moveBox(const glm::vec3& position, const AABB& box, const glm::vec3& velocity, float deltaTime);
+
+	//terrain height queries through the height pyramid, world space blocks
+	//lowest and highest top block over the loaded columns in the box, false when none of it is loaded
+	bool regionHeights(int minX, int minZ, int maxX, int maxZ, int& low, int& high);
+	//first block along the ray at or below a column's top, see HeightPyramid::raycast
+	bool raycastTerrain(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit);
+
+	std::recursive_mutex chunksMutex;
+	//exclusive while setBlockAt changes a chunk's blocks, shared by raycastBatch which reads them without chunksMutex.
+	//Taken before chunksMutex, never while holding it
+	std::shared_mutex blocksMutex;
+	std::unordered_map<uint64_t, Chunk> chunks;
+
+	EntityStore entities;//every mob, components in flat arrays
+	EntitySystems entitySystems;
+	EntityGrid entityGrid;//chunk column buckets for proximity queries, updated by the entity systems
+	HeightPyramid heights;//top block of every loaded column, kept exact by generation and setBlockAt, guarded by chunksMutex
+	static const char* const BEE_MODEL;
+
+	int seed = -1;
+	const int renderDistance;
+
+private:
+	TerrainGenerator terrain;
+	std::mutex logMutex;
+
+	size_t activeAsyncTasks = 0; // Track running tasks
+
+	//chunk stuff
+	//map to track async tasks for each chunk by its position.
+	std::unordered_map<glm::vec3, std::future<MeshData>, Vec3Hash> chunkMeshFutures;
+	std::unordered_map<uint64_t, std::future<void>> chunkGenerationFutures; // For async chunk generation
+	std::vector<Chunk*> meshUploads;
+	std::vector<Chunk*> activityChanges;
+
+	bool isInitialLoading; // Flag to track initial loading phase
+	int currentLoadingRadius; // Current radius for loading chunks
+
+	void generateChunkAsync(const glm::vec3& pos);
+	void updateChunkMeshAsync(Chunk& chunk);
+	void tryApplyChunkMeshUpdate(Chunk& chunk);
+};
@@ -1,10 +1,12 @@
 #version 330 core
 layout(location = 0) in ivec3 aPos;
+layout(location = 4) in uint aOriginSlot;
 
 uniform mat4 lightSpaceMatrix;
-uniform mat4 model;
+uniform samplerBuffer chunkOrigins;
 
 void main(){
 
-	gl_Position = lightSpaceMatrix * model * vec4(aPos,1.0);
+	vec3 pos = vec3(aPos) + texelFetch(chunkOrigins, int(aOriginSlot)).xyz;
+	gl_Position = lightSpaceMatrix * vec4(pos,1.0);
 }
\ No newline at end of file
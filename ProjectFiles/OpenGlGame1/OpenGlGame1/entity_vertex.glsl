@@ -1,14 +1,21 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+layout (location = 3) in mat4 instanceModel;//one per instance, takes locations 3 to 6
 
 out vec2 TexCoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout(std140) uniform FrameData {//written once a frame by the renderer, must match FrameUniforms
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];//world to the cascade's tile, fract(xy) is the place in it, depth in z
+    vec4 cascadeSplits;//view depth where each cascade ends
+    vec4 sunDirection;//xyz, the way the light travels
+    vec4 cameraPos;
+    int cascadeCount;
+};
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * instanceModel * vec4(aPos, 1.0);
     TexCoord = aTexCoord;
 }
\ No newline at end of file
@@ -5,17 +5,24 @@ in vec4 objectColour;
 in vec2 TexCoord;
 in vec3 FragPos;
 in vec3 Normal;
-in vec4 FragPosLightSpace;
+in float ViewDepth;
 
 uniform vec4 lightColour;
 uniform vec3 lightPos;// Light position in world space
-uniform vec3 sunDirection;
 uniform sampler2D ourTexture;
-uniform sampler2D shadowMap;
-uniform vec3 cameraPos;
+uniform sampler2D shadowMap;//2x2 atlas, one tile per cascade
+layout(std140) uniform FrameData {//written once a frame by the renderer, must match FrameUniforms
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];//world to the cascade's tile, fract(xy) is the place in it, depth in z
+    vec4 cascadeSplits;//view depth where each cascade ends
+    vec4 sunDirection;//xyz, the way the light travels
+    vec4 cameraPos;
+    int cascadeCount;
+};
 
 vec3 sunsetColour();
-float ShadowCalc(vec4 FragPosLightSpace);
+float ShadowCalc(vec3 fragPos, float viewDepth);
 
 void main()
 {
@@ -34,7 +41,7 @@ void main()
 
     //directional
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(-sunDirection);
+    vec3 lightDir = normalize(-sunDirection.xyz);
     
     //smoothly disables light when crossing horizon
     float lightFactor = smoothstep(-0.1,0.1,lightDir.y);
@@ -46,13 +53,13 @@ void main()
         // Specular lighting
         float shininess = 32.0f; // Higher values give sharper highlights
         float specularStrength = 0.75f;
-        vec3 viewDir = normalize(cameraPos - FragPos); // Camera position should be passed to the shader
+        vec3 viewDir = normalize(cameraPos.xyz - FragPos); // Camera position should be passed to the shader
         vec3 reflectDir = reflect(-lightDir, norm); // Reflection of light direction
         float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess) * lightFactor;
         specular = specularStrength * spec * sunColour; 
     
     // Calculate shadow
-    float shadow = ShadowCalc(FragPosLightSpace);
+    float shadow = ShadowCalc(FragPos, ViewDepth);
     
     // Combine lighting with shadow
     vec3 lighting = (ambient + (1.0 - shadow) * (diffuse + specular));
@@ -65,19 +72,26 @@ void main()
 
 }
 
-float ShadowCalc(vec4 fragPosLightSpace)
+float ShadowCalc(vec3 fragPos, float viewDepth)
 {
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w; // Perspective divide
-    projCoords = projCoords * 0.5 + 0.5; // Transform to [0,1]
+    //first cascade that reaches this far, none past the last one
+    int cascade = 0;
+    while (cascade < cascadeCount && viewDepth > cascadeSplits[cascade]) cascade++;
+    if (cascade >= cascadeCount) return 0.0;
+
+    vec3 projCoords = (shadowMatrices[cascade] * vec4(fragPos, 1.0)).xyz;//orthographic, no divide needed
     if (projCoords.z > 1.0) return 0.0; // Outside far plane, no shadow
 
+    //xy wraps around inside this cascade's tile, cached light boxes scroll through it
+    vec2 texelSize = 2.0 / textureSize(shadowMap, 0);//in tile units
+    vec2 tile = vec2(cascade % 2, cascade / 2);
+
     //smooth shadows
     float shadow = 0.0;
     float bias = 0.005;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
     for (int x = -1; x <= 1; ++x) {
         for (int y = -1; y <= 1; ++y) {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+            float pcfDepth = texture(shadowMap, (tile + fract(projCoords.xy + vec2(x, y) * texelSize)) * 0.5).r;
             shadow += projCoords.z - bias > pcfDepth ? 1.0 : 0.0;
         }
     }
@@ -89,7 +103,7 @@ float ShadowCalc(vec4 fragPosLightSpace)
 
 vec3 sunsetColour(){
 
-    float sunAngle = dot(sunDirection, vec3(0.0f,1.0f,0.0f));
+    float sunAngle = dot(sunDirection.xyz, vec3(0.0f,1.0f,0.0f));
 
     
     float transitionFactor = (sunAngle +1.0f) *0.5f;
@@ -4,14 +4,19 @@ layout(location = 1) in vec2 aTexCoord;
 
 out vec2 TexCoord;
 
-uniform mat4 view;
-uniform mat4 projection;
-uniform vec3 sunDirection;
-uniform vec3 camPos;
+layout(std140) uniform FrameData {//written once a frame by the renderer, must match FrameUniforms
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];//world to the cascade's tile, fract(xy) is the place in it, depth in z
+    vec4 cascadeSplits;//view depth where each cascade ends
+    vec4 sunDirection;//xyz, the way the light travels
+    vec4 cameraPos;
+    int cascadeCount;
+};
 
 void main()
 {
-    vec3 sunPos = camPos + normalize(sunDirection) * 500.0; // Far away in sun direction
+    vec3 sunPos = cameraPos.xyz - normalize(sunDirection.xyz) * 500.0; // Far away in sun direction
 
     mat4 billboard = mat4(
         vec4(view[0][0], view[1][0], view[2][0], 0.0), // Right
@@ -3,17 +3,26 @@ layout (location = 0) in ivec3 aPos;
 layout (location = 1) in uint aPackedColour;
 layout (location = 2) in uvec2 aTexCoord;
 layout (location = 3) in int aPackedNormal;
+layout (location = 4) in uint aOriginSlot;//index into chunkOrigins
 
 out vec4 objectColour;//colour to go to frag shader, must be same name
 out vec2 TexCoord;
 out vec3 FragPos;//world space pos
 out vec3 Normal;//normal vector
-out vec4 FragPosLightSpace;//output the shadwos
+out float ViewDepth;//distance in front of the camera, picks the shadow cascade
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix; 
+layout(std140) uniform FrameData {//written once a frame by the renderer, must match FrameUniforms
+    mat4 view;
+    mat4 projection;
+    mat4 shadowMatrices[4];//world to the cascade's tile, fract(xy) is the place in it, depth in z
+    vec4 cascadeSplits;//view depth where each cascade ends
+    vec4 sunDirection;//xyz, the way the light travels
+    vec4 cameraPos;
+    int cascadeCount;
+};
+uniform samplerBuffer chunkOrigins;//xyz = world position of each chunk, filled by ChunkArena
+uniform bool useChunkOrigin;//off for the highlight, its vao has no origin slot
 
 // Unpack the color from a 32-bit unsigned integer.
 vec4 unpackColor(uint packedColour)
@@ -47,6 +56,7 @@ vec3 unpackNormal(int packedNormal)
 void main()
 {
     vec3 pos = vec3(aPos);
+    if (useChunkOrigin) pos += texelFetch(chunkOrigins, int(aOriginSlot)).xyz;
 
     gl_Position = projection * view * model * vec4(pos, 1.0);
     FragPos = vec3(model * vec4(pos, 1.0)); // World-space position
@@ -61,5 +71,5 @@ void main()
 
     //Unpack texture coordinates from the 16-bit range [0, 65535] to [0, 1].
     TexCoord = vec2(aTexCoord)/ 65535.0;
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos,1.0);
+    ViewDepth = -(view * vec4(FragPos, 1.0)).z;
 }
\ No newline at end of file